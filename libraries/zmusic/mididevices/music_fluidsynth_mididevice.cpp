@@ -34,7 +34,9 @@
 
 // HEADER FILES ------------------------------------------------------------
 
+#include <algorithm>
 #include <mutex>
+#include <thread>
 #include <stdio.h>
 #include <stdlib.h>
 #include "mididevice.h"
@@ -206,7 +208,19 @@ FluidSynthMIDIDevice::FluidSynthMIDIDevice(int samplerate, std::vector<std::stri
 	fluid_settings_setint(FluidSettings, "synth.reverb.active", fluidConfig.fluid_reverb);
 	fluid_settings_setint(FluidSettings, "synth.chorus.active", fluidConfig.fluid_chorus);
 	fluid_settings_setint(FluidSettings, "synth.polyphony", fluidConfig.fluid_voices);
-	fluid_settings_setint(FluidSettings, "synth.cpu-cores", fluidConfig.fluid_threads);
+	int threads = fluidConfig.fluid_threads;
+	if (threads == 0)
+	{
+		// Leave a core for the game itself. More than a few threads only adds
+		// synchronization overhead for the voice counts soundfonts actually use.
+		threads = std::max(1, std::min(4, int(std::thread::hardware_concurrency()) - 1));
+	}
+	fluid_settings_setint(FluidSettings, "synth.cpu-cores", threads);
+	if (major > 2 || (major == 2 && minor >= 1))
+	{
+		// Requires FluidSynth 2.1. Samples get loaded when a preset is first selected.
+		fluid_settings_setint(FluidSettings, "synth.dynamic-sample-loading", fluidConfig.fluid_dynamic_samples);
+	}
 	FluidSynth = new_fluid_synth(FluidSettings);
 	if (FluidSynth == NULL)
 	{
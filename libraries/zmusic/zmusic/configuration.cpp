@@ -232,11 +232,12 @@ bool ChangeMusicSetting(ZMusic::EIntConfigKey key, MusInfo *currSong, int value,
 			ChangeAndReturn(fluidConfig.fluid_samplerate, std::max<int>(value, 0), pRealValue);
 			return false;
 
-		// I don't know if this setting even matters for us, since we aren't letting
-		// FluidSynth drives its own output.
+		// This is the number of threads FluidSynth uses to render its voices.
+		// 0 picks one based on the number of CPU cores. It only takes effect
+		// for the next song.
 		case fluid_threads:
-			if (value < 1)
-				value = 1;
+			if (value < 0)
+				value = 0;
 			else if (value > 256)
 				value = 256;
 
@@ -264,6 +265,12 @@ bool ChangeMusicSetting(ZMusic::EIntConfigKey key, MusInfo *currSong, int value,
 
 			ChangeAndReturn(fluidConfig.fluid_chorus_type, value, pRealValue);
 			return false;
+
+		// Only loads the samples of the presets a song actually selects instead of
+		// the entire soundfont. Takes effect for the next song.
+		case fluid_dynamic_samples:
+			ChangeAndReturn(fluidConfig.fluid_dynamic_samples, value, pRealValue);
+			return false;
 			
 		case opl_numchips:
 			if (value <= 0)
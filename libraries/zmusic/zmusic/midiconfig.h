@@ -32,6 +32,7 @@ struct FluidConfig
 	int fluid_threads = 1;
 	int fluid_chorus_voices = 3;
 	int fluid_chorus_type = 0;
+	int fluid_dynamic_samples = false;
 	float fluid_gain = 0.5f;
 	float fluid_reverb_roomsize = 0.61f;
 	float fluid_reverb_damping = 0.23f;
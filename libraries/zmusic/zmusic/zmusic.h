@@ -72,6 +72,8 @@ enum EIntConfigKey
 	snd_mididevice,
 	snd_outputrate,
 
+	fluid_dynamic_samples,	// added last to keep the values above stable
+
 	NUM_INT_CONFIGS
 };
 
@@ -2472,9 +2472,25 @@ bool AM_isLockBoundary (line_t &line, int *lockptr = nullptr)
 void DAutomap::drawWalls (bool allmap)
 {
 	static mline_t l;
-	int lock, color;
+	int lock, color, secret;
 
 	int numportalgroups = am_portaloverlay ? Level->Displacements.size : 0;
+	bool rotated = am_rotate == 1 || (am_rotate == 2 && viewactive);
+
+	// Lines that cannot reach the window are skipped before any work is done
+	// on them. Rotation is around the window's center, so when rotating,
+	// anything that ends up on screen must start out within half the
+	// window's diagonal of it.
+	double cullx1 = m_x, cully1 = m_y, cullx2 = m_x2, cully2 = m_y2;
+	if (rotated)
+	{
+		double radius = sqrt(m_w * m_w + m_h * m_h) / 2;
+		double centerx = m_x + m_w / 2, centery = m_y + m_h / 2;
+		cullx1 = centerx - radius;
+		cullx2 = centerx + radius;
+		cully1 = centery - radius;
+		cully2 = centery + radius;
+	}
 
 	for (int p = numportalgroups - 1; p >= -1; p--)
 	{
@@ -2511,7 +2527,13 @@ void DAutomap::drawWalls (bool allmap)
 			l.b.x = (line.v2->fX() + offset.X);
 			l.b.y = (line.v2->fY() + offset.Y);
 
-			if (am_rotate == 1 || (am_rotate == 2 && viewactive))
+			if (MAX(l.a.x, l.b.x) < cullx1 || MIN(l.a.x, l.b.x) > cullx2 ||
+				MAX(l.a.y, l.b.y) < cully1 || MIN(l.a.y, l.b.y) > cully2)
+			{
+				continue;
+			}
+
+			if (rotated)
 			{
 				rotatePoint(&l.a.x, &l.a.y);
 				rotatePoint(&l.b.x, &l.b.y);
@@ -2538,12 +2560,12 @@ void DAutomap::drawWalls (bool allmap)
 				{
 					drawMline(&l, AMColors.PortalColor);
 				}
-				else if (AM_CheckSecret(&line) == 1)
+				else if ((secret = AM_CheckSecret(&line)) == 1)
 				{
 					// map secret sectors like Boom
 					drawMline(&l, AMColors.SecretSectorColor);
 				}
-				else if (AM_CheckSecret(&line) == 2)
+				else if (secret == 2)
 				{
 					drawMline(&l, AMColors.UnexploredSecretColor);
 				}
@@ -855,6 +855,12 @@ void AddToConsole (int printlevel, const char *text)
 //
 //==========================================================================
 
+// Until the console starts ticking every line is flushed right away so that
+// nothing gets lost if the startup crashes. After that C_Ticker flushes the
+// log once per tic, which keeps heavy console output from turning into one
+// write call per line.
+static bool LogFlushedByTicker;
+
 void WriteLineToLog(FILE *LogFile, const char *outline)
 {
 	// Strip out any color escape sequences before writing to the log file
@@ -884,7 +890,10 @@ void WriteLineToLog(FILE *LogFile, const char *outline)
 	*dstp = 0;
 
 	fputs(copy.Data(), LogFile);
-	fflush(LogFile);
+	if (!LogFlushedByTicker)
+	{
+		fflush(LogFile);
+	}
 }
 
 
@@ -1006,6 +1015,12 @@ void C_Ticker()
 	static int lasttic = 0;
 	consoletic++;
 
+	LogFlushedByTicker = true;
+	if (Logfile != nullptr)
+	{
+		fflush(Logfile);
+	}
+
 	if (lasttic == 0)
 		lasttic = consoletic - 1;
 
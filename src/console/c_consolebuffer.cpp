@@ -164,6 +164,10 @@ void FConsoleBuffer::FormatText(FFont *formatfont, int displaywidth)
 //
 // Delete old content if number of lines gets too large
 //
+// With a full buffer this happens for every new line of output, so the
+// formatted lines of the deleted text are dropped as well instead of
+// throwing away the layout and breaking the entire buffer again.
+//
 //==========================================================================
 
 void FConsoleBuffer::ResizeBuffer(unsigned newsize)
@@ -171,8 +175,25 @@ void FConsoleBuffer::ResizeBuffer(unsigned newsize)
 	if (mConsoleText.Size() > newsize)
 	{
 		unsigned todelete = mConsoleText.Size() - newsize;
+		unsigned formatted = m_BrokenConsoleText.Size();
 		mConsoleText.Delete(0, todelete);
-		mBufferWasCleared = true;
+
+		if (!mBufferWasCleared && todelete < formatted && mBrokenStart.Size() == formatted + 1)
+		{
+			unsigned brokendelete = mBrokenStart[todelete];
+			m_BrokenConsoleText.Delete(0, todelete);
+			mBrokenLines.Delete(0, brokendelete);
+			mBrokenStart.Delete(0, todelete);
+			for (auto &start : mBrokenStart)
+			{
+				start -= brokendelete;
+			}
+			mTextLines = mBrokenLines.Size();
+		}
+		else
+		{
+			mBufferWasCleared = true;
+		}
 	}
 }
 
@@ -36,6 +36,7 @@
 #include <assert.h>
 
 #include "cmdlib.h"
+#include "superfasthash.h"
 #include "configfile.h"
 #include "c_console.h"
 #include "c_dispatch.h"
@@ -63,6 +64,17 @@ bool FBaseCVar::m_UseCallback = false;
 
 FBaseCVar *CVars = NULL;
 
+// Lookups by name go through this instead of walking the whole list. It is
+// a plain array so that it is usable before any static constructors run,
+// and every chain keeps the same newest-first order as CVars.
+enum { CVAR_HASH_SIZE = 1021 };
+static FBaseCVar *CVarHash[CVAR_HASH_SIZE];
+
+static inline FBaseCVar **CVarHashChain(const char *name, size_t namelen)
+{
+	return &CVarHash[MakeKey(name, namelen) % CVAR_HASH_SIZE];
+}
+
 int cvar_defflags;
 
 FBaseCVar::FBaseCVar (const char *var_name, uint32_t flags, void (*callback)(FBaseCVar &))
@@ -95,6 +107,9 @@ FBaseCVar::FBaseCVar (const char *var_name, uint32_t flags, void (*callback)(FBa
 		Name = copystring (var_name);
 		m_Next = CVars;
 		CVars = this;
+		FBaseCVar **chain = CVarHashChain(Name, strlen(Name));
+		m_HashNext = *chain;
+		*chain = this;
 	}
 
 	if (var)
@@ -124,6 +139,15 @@ FBaseCVar::~FBaseCVar ()
 	{
 		FBaseCVar *var, *prev;
 
+		for (FBaseCVar **chain = CVarHashChain(Name, strlen(Name)); *chain != NULL; chain = &(*chain)->m_HashNext)
+		{
+			if (*chain == this)
+			{
+				*chain = m_HashNext;
+				break;
+			}
+		}
+
 		var = FindCVar (Name, &prev);
 
 		if (var == this)
@@ -1368,13 +1392,20 @@ void C_ForgetCVars (void)
 FBaseCVar *FindCVar (const char *var_name, FBaseCVar **prev)
 {
 	FBaseCVar *var;
-	FBaseCVar *dummy;
 
 	if (var_name == NULL)
 		return NULL;
 
 	if (prev == NULL)
-		prev = &dummy;
+	{
+		// Nobody needs the list position so the hash can be used.
+		for (var = *CVarHashChain(var_name, strlen(var_name)); var != NULL; var = var->m_HashNext)
+		{
+			if (stricmp (var->GetName (), var_name) == 0)
+				break;
+		}
+		return var;
+	}
 
 	var = CVars;
 	*prev = NULL;
@@ -1410,7 +1441,7 @@ FBaseCVar *FindCVarSub (const char *var_name, int namelen)
 	if (var_name == NULL)
 		return NULL;
 
-	var = CVars;
+	var = *CVarHashChain(var_name, namelen);
 	while (var)
 	{
 		const char *probename = var->GetName ();
@@ -1420,7 +1451,7 @@ FBaseCVar *FindCVarSub (const char *var_name, int namelen)
 		{
 			break;
 		}
-		var = var->m_Next;
+		var = var->m_HashNext;
 	}
 	return var;
 }
@@ -162,6 +162,7 @@ private:
 
 	void (*m_Callback)(FBaseCVar &);
 	FBaseCVar *m_Next;
+	FBaseCVar *m_HashNext;
 
 	static bool m_UseCallback;
 	static bool m_DoNoSet;
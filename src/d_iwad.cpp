@@ -305,16 +305,33 @@ int FIWadManager::ScanIWAD (const char *iwad)
 
 	mLumpsFound.Resize(mIWadInfos.Size());
 
-	auto CheckLumpName = [=](const char *name)
+	// Map each lump name any of the IWAD definitions checks for to the bits it sets, so
+	// that each lump in the file only needs a single lookup instead of comparing it
+	// against every name of every definition.
+	struct FLumpBit
 	{
-		for (unsigned i = 0; i< mIWadInfos.Size(); i++)
+		unsigned Info;
+		uint32_t Bit;
+	};
+	TMap<FName, TArray<FLumpBit>> lumpbits;
+	for (unsigned i = 0; i< mIWadInfos.Size(); i++)
+	{
+		for (unsigned j = 0; j < mIWadInfos[i].Lumps.Size(); j++)
+		{
+			lumpbits[mIWadInfos[i].Lumps[j]].Push({ i, 1u << j });
+		}
+	}
+
+	auto CheckLumpName = [&](const char *name)
+	{
+		FName lumpname(name, true);	// names not in the name table cannot be in the map either
+		if (lumpname == NAME_None) return;
+		auto bits = lumpbits.CheckKey(lumpname);
+		if (bits != nullptr)
 		{
-			for (unsigned j = 0; j < mIWadInfos[i].Lumps.Size(); j++)
+			for (auto &bit : *bits)
 			{
-				if (!mIWadInfos[i].Lumps[j].CompareNoCase(name))
-				{
-					mLumpsFound[i] |= (1 << j);
-				}
+				mLumpsFound[bit.Info] |= bit.Bit;
 			}
 		}
 	};
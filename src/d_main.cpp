@@ -103,6 +103,7 @@
 #include "r_data/r_vanillatrans.h"
 #include "s_music.h"
 #include "swrenderer/r_swcolormaps.h"
+#include "stats.h"
 
 EXTERN_CVAR(Bool, hud_althud)
 EXTERN_CVAR(Int, vr_mode)
@@ -170,6 +171,7 @@ extern bool gameisdead;
 extern bool demorecording;
 extern bool M_DemoNoPlay;	// [RH] if true, then skip any demos in the loop
 extern bool insave;
+extern bool timingdemo;
 extern TDeletingArray<FLightDefaults *> LightDefaults;
 
 
@@ -251,6 +253,7 @@ bool batchrun;	// just run the startup and collect all error messages in a logfi
 bool AppActive = true;
 
 cycle_t FrameCycles;
+static uint64_t PresentTimeNS;
 
 // [SP] Store the capabilities of the renderer in a global variable, to prevent excessive per-frame processing
 uint32_t r_renderercaps = 0;
@@ -962,7 +965,9 @@ void D_Display ()
 		M_Drawer ();			// menu is drawn even on top of everything
 		if (!hud_toggled)
 			FStat::PrintStat ();
+		uint64_t presentstart = I_nsTime();
 		screen->End2DAndUpdate ();
+		PresentTimeNS += I_nsTime() - presentstart;
 	}
 	else
 	{
@@ -1043,9 +1048,159 @@ void D_ErrorCleanup ()
 //
 //==========================================================================
 
+//==========================================================================
+//
+// Frame time statistics
+//
+// The last FRAME_SAMPLES frames are kept with their time split into the
+// playsim, the rest of the frame's CPU work and presenting, i.e. the swap
+// and any vsync wait. The remainder is spent waiting for the next tic.
+// During a -timedemo every frame is kept so that the percentiles cover
+// the same frames as the reported average.
+//
+//==========================================================================
+
+struct FFrameSample
+{
+	float Total;
+	float Playsim;
+	float Render;
+	float Present;
+};
+
+enum
+{
+	FRAME_SAMPLES = 4096,
+};
+
+static TArray<FFrameSample> FrameSamples;
+static unsigned FrameSampleCount;
+
+static void D_AddFrameSample(uint64_t total, uint64_t playsim, uint64_t display, uint64_t present)
+{
+	if (timingdemo || FrameSamples.Size() < FRAME_SAMPLES)
+	{
+		FrameSamples.Reserve(1);
+	}
+	auto &sample = FrameSamples[FrameSampleCount++ % FrameSamples.Size()];
+	sample.Total = total / 1e6f;
+	sample.Playsim = playsim / 1e6f;
+	sample.Render = (display > present ? display - present : 0) / 1e6f;
+	sample.Present = present / 1e6f;
+}
+
+static unsigned D_FrameSampleCount()
+{
+	return FrameSamples.Size();
+}
+
+// Gets p50, p95, p99 and the maximum of one field. There must be at least one sample.
+static void D_GetFramePercentiles(float FFrameSample::*field, float out[4])
+{
+	TArray<float> times(D_FrameSampleCount(), true);
+	for (unsigned i = 0; i < times.Size(); i++)
+	{
+		times[i] = FrameSamples[i].*field;
+	}
+	std::sort(times.begin(), times.end());
+	auto pct = [&](double p) { return times[MIN<unsigned>(unsigned(times.Size() * p), times.Size() - 1)]; };
+
+	out[0] = pct(0.5);
+	out[1] = pct(0.95);
+	out[2] = pct(0.99);
+	out[3] = times.Last();
+}
+
+static FString D_FramePercentiles(float FFrameSample::*field)
+{
+	float pct[4];
+	D_GetFramePercentiles(field, pct);
+
+	FString out;
+	out.Format("p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f", pct[0], pct[1], pct[2], pct[3]);
+	return out;
+}
+
+void D_ResetFrameTimes()
+{
+	FrameSamples.Clear();
+	FrameSampleCount = 0;
+}
+
+//==========================================================================
+//
+// D_FrameTimesJSON
+//
+// The percentiles as a JSON object, for reports of benchmark runs.
+//
+//==========================================================================
+
+FString D_FrameTimesJSON()
+{
+	static const struct { const char *name; float FFrameSample::*field; } fields[] =
+	{
+		{ "frame", &FFrameSample::Total },
+		{ "playsim", &FFrameSample::Playsim },
+		{ "render", &FFrameSample::Render },
+		{ "present", &FFrameSample::Present },
+	};
+
+	FString out;
+	out.Format("{ \"frames\": %u", D_FrameSampleCount());
+	if (D_FrameSampleCount() > 0)
+	{
+		for (auto &f : fields)
+		{
+			float pct[4];
+			D_GetFramePercentiles(f.field, pct);
+			out.AppendFormat(", \"%s\": { \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }", f.name, pct[0], pct[1], pct[2], pct[3]);
+		}
+	}
+	out += " }";
+	return out;
+}
+
+ADD_STAT(frametimes)
+{
+	FString out;
+	if (D_FrameSampleCount() == 0) return out;
+	out.Format("%u frames, ms\n"
+		"frame   %s\n"
+		"playsim %s\n"
+		"render  %s\n"
+		"present %s",
+		D_FrameSampleCount(),
+		D_FramePercentiles(&FFrameSample::Total).GetChars(),
+		D_FramePercentiles(&FFrameSample::Playsim).GetChars(),
+		D_FramePercentiles(&FFrameSample::Render).GetChars(),
+		D_FramePercentiles(&FFrameSample::Present).GetChars());
+	return out;
+}
+
+CCMD(dumpframetimes)
+{
+	const char *filename = argv.argc() >= 2 ? argv[1] : "frametimes.csv";
+	FileWriter *fw = FileWriter::Open(filename);
+	if (fw == nullptr)
+	{
+		Printf(TEXTCOLOR_RED "Unable to write %s\n", filename);
+		return;
+	}
+	fw->Printf("frame,total_ms,playsim_ms,render_ms,present_ms\n");
+	unsigned count = D_FrameSampleCount();
+	for (unsigned i = FrameSampleCount - count; i != FrameSampleCount; i++)
+	{
+		auto &sample = FrameSamples[i % count];
+		fw->Printf("%u,%.3f,%.3f,%.3f,%.3f\n", i, sample.Total, sample.Playsim, sample.Render, sample.Present);
+	}
+	delete fw;
+	Printf("%u frames written to %s\n", count, filename);
+}
+
 void D_DoomLoop ()
 {
 	int lasttic = 0;
+	uint64_t framestart = I_nsTime();
 
 	// Clamp the timer to TICRATE until the playloop has been entered.
 	r_NoInterpolate = true;
@@ -1091,7 +1246,12 @@ void D_DoomLoop ()
 			}
 			// Update display, next frame, with current state.
 			I_StartTic ();
+			uint64_t displaystart = I_nsTime();
 			D_Display ();
+			uint64_t frameend = I_nsTime();
+			D_AddFrameSample(frameend - framestart, TickerTimeNS, frameend - displaystart, PresentTimeNS);
+			framestart = frameend;
+			TickerTimeNS = PresentTimeNS = 0;
 			S_UpdateMusic();
 			if (wantToRestart)
 			{
@@ -2367,6 +2527,74 @@ static void NewFailure ()
     I_FatalError ("Failed to allocate memory from system heap");
 }
 
+//==========================================================================
+//
+// Startup phase timing
+//
+// Each call to StartupPhase ends the running phase and starts a new one.
+// With -startupprofile <file> the timings get printed at the end of the
+// startup and written to the file as JSON.
+//
+//==========================================================================
+
+struct FStartupPhase
+{
+	const char *Name;
+	cycle_t Time;
+};
+
+static TArray<FStartupPhase> StartupPhases;
+
+static void StartupPhase(const char *name)
+{
+	if (StartupPhases.Size() > 0) StartupPhases.Last().Time.Unclock();
+	auto &phase = StartupPhases[StartupPhases.Reserve(1)];
+	phase.Name = name;
+	phase.Time.Reset();
+	phase.Time.Clock();
+}
+
+static void EndStartupPhases()
+{
+	if (StartupPhases.Size() == 0) return;
+	StartupPhases.Last().Time.Unclock();
+
+	double total = 0;
+	for (auto &phase : StartupPhases) total += phase.Time.TimeMS();
+
+	const char *profile = Args->CheckValue("-startupprofile");
+	if (profile != nullptr)
+	{
+		Printf("Startup phases:\n");
+		for (auto &phase : StartupPhases)
+		{
+			Printf("%10.3f ms  %s\n", phase.Time.TimeMS(), phase.Name);
+		}
+		Printf("%10.3f ms  total\n", total);
+
+		FileWriter *fw = FileWriter::Open(profile);
+		if (fw == nullptr)
+		{
+			Printf(TEXTCOLOR_RED "Unable to write startup profile to %s\n", profile);
+		}
+		else
+		{
+			fw->Printf("{\n\t\"phases\": [\n");
+			for (unsigned i = 0; i < StartupPhases.Size(); i++)
+			{
+				fw->Printf("\t\t{ \"name\": \"%s\", \"ms\": %.3f }%s\n", StartupPhases[i].Name, StartupPhases[i].Time.TimeMS(), i + 1 < StartupPhases.Size() ? "," : "");
+			}
+			fw->Printf("\t],\n\t\"total_ms\": %.3f\n}\n", total);
+			delete fw;
+		}
+	}
+	else
+	{
+		DPrintf(DMSG_NOTIFY, "Startup took %.3f ms\n", total);
+	}
+	StartupPhases.Clear();
+}
+
 //==========================================================================
 //
 // D_DoomMain
@@ -2454,6 +2682,7 @@ static int D_DoomMain_Internal (void)
 
 	do
 	{
+		StartupPhase("Setup");
 		PClass::StaticInit();
 		PType::StaticInit();
 
@@ -2525,12 +2754,14 @@ static int D_DoomMain_Internal (void)
 			Printf("Notice: File hashing is incredibly verbose. Expect loading files to take much longer than usual.\n");
 		}
 
+		StartupPhase("W_Init");
 		if (!batchrun) Printf ("W_Init: Init WADfiles.\n");
 		Wads.InitMultipleFiles (allwads, iwad_info->DeleteLumps);
 		allwads.Clear();
 		allwads.ShrinkToFit();
 		SetMapxxFlag();
 
+		StartupPhase("Config and strings");
 		GameConfig->DoKeySetup(gameinfo.ConfigName);
 
 		// Now that wads are loaded, define mod-specific cvars.
@@ -2554,6 +2785,7 @@ static int D_DoomMain_Internal (void)
 
 		CT_Init ();
 
+		StartupPhase("I_Init and V_Init");
 		if (!restart)
 		{
 			if (!batchrun) Printf ("I_Init: Setting up machine state.\n");
@@ -2584,9 +2816,11 @@ static int D_DoomMain_Internal (void)
 		// Base systems have been inited; enable cvar callbacks
 		FBaseCVar::EnableCallbacks ();
 
+		StartupPhase("S_Init");
 		if (!batchrun) Printf ("S_Init: Setting up sound.\n");
 		S_Init ();
 
+		StartupPhase("ST_Init");
 		if (!batchrun) Printf ("ST_Init: Init startup screen.\n");
 		if (!restart)
 		{
@@ -2602,10 +2836,12 @@ static int D_DoomMain_Internal (void)
 		// [RH] Load sound environments
 		S_ParseReverbDef ();
 
+		StartupPhase("S_InitData");
 		// [RH] Parse any SNDINFO lumps
 		if (!batchrun) Printf ("S_InitData: Load sound definitions.\n");
 		S_InitData ();
 
+		StartupPhase("G_ParseMapInfo");
 		// [RH] Parse through all loaded mapinfo lumps
 		if (!batchrun) Printf ("G_ParseMapInfo: Load map definitions.\n");
 		G_ParseMapInfo (iwad_info->MapInfo);
@@ -2614,17 +2850,21 @@ static int D_DoomMain_Internal (void)
 		// MUSINFO must be parsed after MAPINFO
 		S_ParseMusInfo();
 
+		StartupPhase("TexMan.Init");
 		if (!batchrun) Printf ("Texman.Init: Init texture manager.\n");
 		TexMan.Init();
 		C_InitConback();
 
 		StartScreen->Progress();
+		StartupPhase("V_InitFonts");
 		V_InitFonts();
 
+		StartupPhase("ParseTeamInfo");
 		// [CW] Parse any TEAMINFO lumps.
 		if (!batchrun) Printf ("ParseTeamInfo: Load team definitions.\n");
 		TeamLibrary.ParseTeamInfo ();
 
+		StartupPhase("Actors");
 		R_ParseTrnslate();
 		PClassActor::StaticInit ();
 
@@ -2642,15 +2882,19 @@ static int D_DoomMain_Internal (void)
 
 		StartScreen->Progress ();
 
+		StartupPhase("ParseGLDefs");
 		ParseGLDefs();
 
+		StartupPhase("R_Init");
 		if (!batchrun) Printf ("R_Init: Init %s refresh subsystem.\n", gameinfo.ConfigName.GetChars());
 		StartScreen->LoadingStatus ("Loading graphics", 0x3f);
 		R_Init ();
 
+		StartupPhase("DecalLibrary");
 		if (!batchrun) Printf ("DecalLibrary: Load decals.\n");
 		DecalLibrary.ReadAllDecals ();
 
+		StartupPhase("Dehacked");
 		// Load embedded Dehacked patches
 		D_LoadDehLumps(FromIWAD);
 
@@ -2680,12 +2924,14 @@ static int D_DoomMain_Internal (void)
 		// Create replacements for dehacked pickups
 		FinishDehPatch();
 
+		StartupPhase("M_Init");
 		if (!batchrun) Printf("M_Init: Init menus.\n");
 		M_Init();
 
 		// clean up the compiler symbols which are not needed any longer.
 		RemoveUnusedSymbols();
 
+		StartupPhase("Actor setup");
 		InitActorNumsFromMapinfo();
 		InitSpawnablesFromMapinfo();
 		PClassActor::StaticSetActorNums();
@@ -2700,6 +2946,7 @@ static int D_DoomMain_Internal (void)
 		primaryLevel->BotInfo.spawn_tries = 0;
 		primaryLevel->BotInfo.wanted_botnum = primaryLevel->BotInfo.getspawned.Size();
 
+		StartupPhase("P_Init");
 		if (!batchrun) Printf ("P_Init: Init Playloop state.\n");
 		StartScreen->LoadingStatus ("Init game engine", 0x3f);
 		AM_StaticInit();
@@ -2727,6 +2974,7 @@ static int D_DoomMain_Internal (void)
 			}
 		}
 
+		StartupPhase("D_CheckNetGame");
 		if (!restart)
 		{
 			if (!batchrun) Printf ("D_CheckNetGame: Checking network game status.\n");
@@ -2737,6 +2985,7 @@ static int D_DoomMain_Internal (void)
 			}
 		}
 
+		StartupPhase("Final setup");
 		// [SP] Force vanilla transparency auto-detection to re-detect our game lumps now
 		UpdateVanillaTransparency();
 
@@ -2752,6 +3001,7 @@ static int D_DoomMain_Internal (void)
 		Net_NewMakeTic ();
 		C_RunDelayedCommands();
 		gamestate = GS_STARTUP;
+		EndStartupPhases();
 
 		// enable custom invulnerability map here
 		if (cl_customizeinvulmap)
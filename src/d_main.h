@@ -59,6 +59,8 @@ void D_PageDrawer (void);
 void D_AdvanceDemo (void);
 void D_StartTitle (void);
 bool D_AddFile (TArray<FString> &wadfiles, const char *file, bool check = true, int position = -1);
+void D_ResetFrameTimes();
+FString D_FrameTimesJSON();
 
 
 // [RH] Set this to something to draw an icon during the next screen refresh.
@@ -68,6 +68,7 @@
 #include "vm.h"
 #include "gstrings.h"
 #include "s_music.h"
+#include "stats.h"
 
 EXTERN_CVAR (Int, disableautosave)
 EXTERN_CVAR (Int, autosavecount)
@@ -111,6 +112,7 @@ bool			nodejustleft[MAXNETNODES];				// set when a node just left
 bool	 		remoteresend[MAXNETNODES];				// set when local needs tics
 int 			resendto[MAXNETNODES];					// set when remote needs tics
 int 			resendcount[MAXNETNODES];
+uint64_t		lossytime[MAXNETNODES];					// until when this node's link counts as lossy
 
 uint64_t		lastrecvtime[MAXPLAYERS];				// [RH] Used for pings
 uint64_t		currrecvtime[MAXPLAYERS];
@@ -161,6 +163,30 @@ CUSTOM_CVAR(Int, net_extratic, 0, CVAR_SERVERINFO | CVAR_NOSAVE)
 	}
 }
 
+// When on and net_extratic is 0, nodes that recently lost packets are temporarily
+// sent an extra tic. Turning it off restores plain net_extratic 0 behavior.
+CVAR(Bool, net_autoextratic, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+enum { LOSSY_HOLD_MS = 2000 };
+
+// Print a console message whenever the game had to wait this many
+// milliseconds or more for some node's tics. 0 = never.
+CVAR(Int, net_stallwarn, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+struct FNodeNetStats
+{
+	unsigned Retransmits;		// resend requests received from this node
+	unsigned Missed;			// gaps in the tics received from this node
+	unsigned Stalls;			// times TryRunTics had to wait for this node
+	uint64_t StallMS;
+	uint64_t LongestStallMS;
+};
+
+static FNodeNetStats NodeNetStats[MAXNETNODES];
+static int StallNode = -1;		// node TryRunTics is currently waiting on
+static int StallTic;
+static uint64_t StallStart;
+
 #ifdef _DEBUG
 CVAR(Int, net_fakelatency, 0, 0);
 
@@ -322,6 +348,9 @@ void Net_ClearBuffers ()
 	memset (remoteresend, 0, sizeof(remoteresend));
 	memset (resendto, 0, sizeof(resendto));
 	memset (resendcount, 0, sizeof(resendcount));
+	memset (lossytime, 0, sizeof(lossytime));
+	memset (NodeNetStats, 0, sizeof(NodeNetStats));
+	StallNode = -1;
 	memset (lastrecvtime, 0, sizeof(lastrecvtime));
 	memset (currrecvtime, 0, sizeof(currrecvtime));
 	memset (consistancy, 0, sizeof(consistancy));
@@ -869,6 +898,8 @@ void GetPackets (void)
 			if (debugfile)
 				fprintf (debugfile,"retransmit from %i\n", resendto[netnode]);
 			resendcount[netnode] = RESENDCOUNT;
+			lossytime[netnode] = I_msTime() + LOSSY_HOLD_MS;
+			NodeNetStats[netnode].Retransmits++;
 		}
 		else
 		{
@@ -895,6 +926,8 @@ void GetPackets (void)
 				fprintf (debugfile, "missed tics from %i (%i to %i)\n",
 						 netnode, nettics[netnode], realstart);
 			remoteresend[netnode] = true;
+			lossytime[netnode] = I_msTime() + LOSSY_HOLD_MS;
+			NodeNetStats[netnode].Missed++;
 			continue;
 		}
 
@@ -1110,6 +1143,7 @@ void NetUpdate (void)
 		}
 	}
 
+	uint64_t currenttime = I_msTime();
 	for (i = 0; i < doomcom.numnodes; i++)
 	{
 		uint8_t playerbytes[MAXPLAYERS];
@@ -1161,7 +1195,13 @@ void NetUpdate (void)
 		{
 		case 0:
 		default: 
-			resendto[i] = lowtic; break;
+			// Repeating the previous tic on a link that is dropping packets lets
+			// the other side fill a single lost packet without asking for a resend.
+			if (net_autoextratic && lossytime[i] > currenttime)
+				resendto[i] = MAX(0, lowtic - 1);
+			else
+				resendto[i] = lowtic;
+			break;
 		case 1: resendto[i] = MAX(0, lowtic - 1); break;
 		case 2: resendto[i] = nettics[i]; break;
 		}
@@ -1841,6 +1881,55 @@ static void TicStabilityEnd()
 	stabilityticduration = std::min(stabilityendtime - stabilitystarttime, (uint64_t)1'000'000);
 }
 
+//==========================================================================
+//
+// Stall accounting
+//
+// While TryRunTics is stuck waiting for tics, the time is charged to
+// the node that is furthest behind.
+//
+//==========================================================================
+
+static void Net_EndStall ()
+{
+	if (StallNode < 0)
+		return;
+
+	uint64_t ms = I_msTime() - StallStart;
+	FNodeNetStats &stats = NodeNetStats[StallNode];
+
+	stats.Stalls++;
+	stats.StallMS += ms;
+	stats.LongestStallMS = MAX(stats.LongestStallMS, ms);
+	if (debugfile)
+		fprintf (debugfile, "waited %" PRIu64 " ms for tic %i from node %i\n", ms, StallTic, StallNode);
+	if (net_stallwarn > 0 && ms >= (uint64_t)net_stallwarn)
+		Printf ("Waited %" PRIu64 " ms for %s\n", ms, players[playerfornode[StallNode]].userinfo.GetName());
+	StallNode = -1;
+}
+
+static void Net_BeginStall ()
+{
+	int node = -1;
+
+	for (int i = 0; i < doomcom.numnodes; i++)
+	{
+		if (nodeingame[i] && (node < 0 || nettics[i] < nettics[node]))
+			node = i;
+	}
+	if (node == StallNode)
+		return;
+
+	Net_EndStall ();
+	if (node >= 0)
+	{
+		StallNode = node;
+		StallTic = nettics[node];
+		StallStart = I_msTime();
+	}
+}
+
+
 //
 // TryRunTics
 //
@@ -1949,6 +2038,8 @@ void TryRunTics (void)
 
 		// Check possible stall conditions
 		Net_CheckLastReceived (counts);
+		if (lowtic < gametic + counts)
+			Net_BeginStall ();
 
 		// Update time returned by I_GetTime, but only if we are stuck in this loop
 		if (lowtic < gametic + counts)
@@ -1967,6 +2058,7 @@ void TryRunTics (void)
 	}
 
 	//Tic lowtic is high enough to process this gametic. Clear all possible waiting info
+	Net_EndStall ();
 	hadlate = false;
 	for (i = 0; i < MAXPLAYERS; i++)
 		players[i].waiting = false;
@@ -2936,6 +3028,47 @@ int Net_GetLatency(int *ld, int *ad)
 	return severity;
 }
 
+//==========================================================================
+//
+// STAT netstats
+//
+// Per node delay, loss and stall figures, to find out who is holding
+// up the game.
+//
+//==========================================================================
+
+ADD_STAT(netstats)
+{
+	FString out;
+
+	if (!netgame)
+	{
+		return "Not in a netgame";
+	}
+	out.Format("node  player        delay  ping  nettic  resends  missed  stalls  stall ms  longest\n");
+	for (int i = 0; i < doomcom.numnodes; i++)
+	{
+		if (!nodeingame[i])
+			continue;
+
+		int player = playerfornode[i];
+		int delay = 0;
+		for (int j = 0; j < BACKUPTICS; j++) delay += netdelay[i][j];
+		delay = ((delay / BACKUPTICS) * ticdup) * (1000 / TICRATE);
+
+		const FNodeNetStats &stats = NodeNetStats[i];
+		out.AppendFormat("%4d  %-12s %6d %5d %7d %8u %7u %7u %9llu %8llu\n", i, players[player].userinfo.GetName(),
+			delay, int(currrecvtime[player] - lastrecvtime[player]), nettics[i], stats.Retransmits, stats.Missed,
+			stats.Stalls, (unsigned long long)stats.StallMS, (unsigned long long)stats.LongestStallMS);
+	}
+	if (StallNode >= 0)
+	{
+		out.AppendFormat("Waiting %llu ms for tic %d from node %d\n",
+			(unsigned long long)(I_msTime() - StallStart), StallTic, StallNode);
+	}
+	return out;
+}
+
 // [RH] List "ping" times
 CCMD (pings)
 {
@@ -254,6 +254,98 @@ CCMD (dumpclasses)
 	Printf ("%d classes shown, %d omitted\n", shown, omitted);
 }
 
+//==========================================================================
+//
+// DObject :: AllocMem / FreeMem
+//
+// Objects are short-lived and come in a handful of sizes, so instead of
+// going through the general purpose allocator each time they are carved
+// out of larger slabs and kept on a free list per size when released.
+// This also keeps objects of the same class close to each other in memory.
+// Freed blocks are reused but never returned to the system.
+//
+//==========================================================================
+
+namespace
+{
+	enum
+	{
+		POOL_GRANULARITY = 16,
+		POOL_MAXSIZE = 4096,
+		POOL_SLABSIZE = 64 * 1024,
+	};
+
+	// Kept at 16 bytes so that objects retain malloc's alignment.
+	struct alignas(16) FObjectHeader
+	{
+		size_t SizeClass;	// 0 means the block was allocated separately.
+	};
+
+	struct FFreeBlock
+	{
+		FFreeBlock *Next;
+	};
+
+	FFreeBlock *ObjectFreeLists[POOL_MAXSIZE / POOL_GRANULARITY + 1];
+}
+
+void *DObject::AllocMem(size_t len)
+{
+	size_t total = len + sizeof(FObjectHeader);
+	FObjectHeader *header;
+
+	if (total > POOL_MAXSIZE)
+	{
+		header = (FObjectHeader *)M_Malloc(total);
+		header->SizeClass = 0;
+		return header + 1;
+	}
+
+	size_t sizeclass = (total + POOL_GRANULARITY - 1) / POOL_GRANULARITY;
+	size_t blocksize = sizeclass * POOL_GRANULARITY;
+	if (ObjectFreeLists[sizeclass] == nullptr)
+	{
+		// Link the new slab's blocks in address order so consecutive allocations are adjacent.
+		size_t count = POOL_SLABSIZE / blocksize;
+		uint8_t *slab = (uint8_t *)malloc(count * blocksize);
+		if (slab == nullptr)
+		{
+			I_FatalError("Could not malloc %zu bytes", count * blocksize);
+		}
+		for (size_t i = count; i-- > 0; )
+		{
+			auto block = (FFreeBlock *)(slab + i * blocksize);
+			block->Next = ObjectFreeLists[sizeclass];
+			ObjectFreeLists[sizeclass] = block;
+		}
+	}
+	FFreeBlock *block = ObjectFreeLists[sizeclass];
+	ObjectFreeLists[sizeclass] = block->Next;
+	GC::AllocBytes += blocksize;
+
+	header = (FObjectHeader *)block;
+	header->SizeClass = sizeclass;
+	return header + 1;
+}
+
+void DObject::FreeMem(void *mem)
+{
+	if (mem == nullptr) return;
+
+	auto header = (FObjectHeader *)mem - 1;
+	size_t sizeclass = header->SizeClass;
+	if (sizeclass == 0)
+	{
+		M_Free(header);
+		return;
+	}
+
+	auto block = (FFreeBlock *)header;
+	block->Next = ObjectFreeLists[sizeclass];
+	ObjectFreeLists[sizeclass] = block;
+	GC::AllocBytes -= sizeclass * POOL_GRANULARITY;
+}
+
 //==========================================================================
 //
 //
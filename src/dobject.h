@@ -265,20 +265,24 @@ private:
 
 	void *operator new(size_t len, nonew&)
 	{
-		return M_Malloc(len);
+		return AllocMem(len);
 	}
 public:
 
 	void operator delete (void *mem, nonew&)
 	{
-		M_Free(mem);
+		FreeMem(mem);
 	}
 
 	void operator delete (void *mem)
 	{
-		M_Free(mem);
+		FreeMem(mem);
 	}
 
+	// All object memory comes from here. Small objects are pooled by size.
+	static void *AllocMem(size_t len);
+	static void FreeMem(void *mem);
+
 	// GC fiddling
 
 	// An object is white if either white bit is set.
@@ -343,7 +347,7 @@ protected:
 
 	void operator delete (void *mem, EInPlace *)
 	{
-		M_Free (mem);
+		// The memory belongs to whoever called the in-place constructor.
 	}
 
 	template<typename T, typename... Args>
@@ -73,6 +73,7 @@
 #include "intermission/intermission.h"
 #include "g_levellocals.h"
 #include "events.h"
+#include "stats.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -135,6 +136,12 @@ bool FinalGC;
 
 // PRIVATE DATA DEFINITIONS ------------------------------------------------
 
+static cycle_t StepTime;		// time taken by the most recent Step
+static double CyclePeakMS;		// longest Step of the collection in progress
+static double LastCyclePeakMS;	// longest Step of the previous collection
+static cycle_t PhaseTime[GCS_Finalize + 1];	// time spent in each state during the collection in progress
+static double LastPhaseMS[GCS_Finalize + 1];	// the same for the previous collection
+
 // CODE --------------------------------------------------------------------
 
 //==========================================================================
@@ -284,17 +291,13 @@ static void MarkRoot()
 	Mark(DIntermissionController::CurrentIntermission);
 	Mark(staticEventManager.FirstEventHandler);
 	Mark(staticEventManager.LastEventHandler);
-	for (auto Level : AllLevels())
-		Level->Mark();
-
 	// Mark players.
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
 		if (playeringame[i])
 			players[i].PropagateMark();
 	}
-	// Mark sectors.
-	
+	// Mark sectors. The level's own roots get marked along with them.
 	for (auto Level : AllLevels())
 	{
 		Level->Mark();
@@ -346,7 +349,7 @@ static void Atomic()
 //
 //==========================================================================
 
-static size_t SingleStep()
+static size_t DoSingleStep()
 {
 	switch (State)
 	{
@@ -381,6 +384,8 @@ static size_t SingleStep()
 	case GCS_Finalize:
 		State = GCS_Pause;		// end collection
 		Dept = 0;
+		LastCyclePeakMS = CyclePeakMS;
+		CyclePeakMS = 0;
 		return 0;
 
 	default:
@@ -389,6 +394,24 @@ static size_t SingleStep()
 	}
 }
 
+static size_t SingleStep()
+{
+	EGCState phase = State;
+	PhaseTime[phase].Clock();
+	size_t cost = DoSingleStep();
+	PhaseTime[phase].Unclock();
+
+	if (phase == GCS_Finalize)
+	{
+		for (int i = 0; i <= GCS_Finalize; i++)
+		{
+			LastPhaseMS[i] = PhaseTime[i].TimeMS();
+			PhaseTime[i].Reset();
+		}
+	}
+	return cost;
+}
+
 //==========================================================================
 //
 // Step
@@ -400,12 +423,15 @@ static size_t SingleStep()
 
 void Step()
 {
+	FTraceZone zone("GC::Step");
 	size_t lim = (GCSTEPSIZE/100) * StepMul;
 	size_t olim;
 	if (lim == 0)
 	{
 		lim = (~(size_t)0) / 2;		// no limit
 	}
+	StepTime.Reset();
+	StepTime.Clock();
 	Dept += AllocBytes - Threshold;
 	do
 	{
@@ -430,6 +456,8 @@ void Step()
 		SetThreshold();
 	}
 	StepCount++;
+	StepTime.Unclock();
+	CyclePeakMS = MAX(CyclePeakMS, StepTime.TimeMS());
 }
 
 //==========================================================================
@@ -603,6 +631,10 @@ ADD_STAT(gc)
 		(GC::Threshold + 1023) >> 10,
 		(GC::Estimate + 1023) >> 10,
 		GC::StepCount);
+	out.AppendFormat("  Step:%.3fms  Peak:%.3fms", GC::StepTime.TimeMS(), MAX(GC::CyclePeakMS, GC::LastCyclePeakMS));
+	// Phase times of the last complete collection. Root marking happens in the pause state.
+	out.AppendFormat("\nLast cycle: Roots:%.3fms  Mark:%.3fms  Sweep:%.3fms  Finalize:%.3fms",
+		GC::LastPhaseMS[GC::GCS_Pause], GC::LastPhaseMS[GC::GCS_Propagate], GC::LastPhaseMS[GC::GCS_Sweep], GC::LastPhaseMS[GC::GCS_Finalize]);
 	if (GC::State != GC::GCS_Pause)
 	{
 		out.AppendFormat("  %zuK", (GC::Dept + 1023) >> 10);
@@ -65,7 +65,7 @@
 EXTERN_CVAR(Bool, strictdecorate);
 
 // PUBLIC DATA DEFINITIONS -------------------------------------------------
-FMemArena ClassDataAllocator(32768);	// use this for all static class data that can be released in bulk when the type system is shut down.
+FMemArena ClassDataAllocator(32768, "ClassData");	// use this for all static class data that can be released in bulk when the type system is shut down.
 
 TArray<PClass *> PClass::AllClasses;
 TMap<FName, PClass*> PClass::ClassMap;
@@ -447,7 +447,7 @@ PClass *PClass::FindClass (FName zaname)
 
 DObject *PClass::CreateNew()
 {
-	uint8_t *mem = (uint8_t *)M_Malloc (Size);
+	uint8_t *mem = (uint8_t *)DObject::AllocMem (Size);
 	assert (mem != nullptr);
 
 	// Set this object's defaults before constructing it.
@@ -458,7 +458,7 @@ DObject *PClass::CreateNew()
 
 	if (ConstructNative == nullptr)
 	{
-		M_Free(mem);
+		DObject::FreeMem(mem);
 		I_Error("Attempt to instantiate abstract class %s.", TypeName.GetChars());
 	}
 	ConstructNative (mem);
@@ -600,9 +600,6 @@ void PClass::InitializeDefaults()
 			{
 				memset(Meta, 0, MetaSize);
 			}
-
-			if (MetaSize > 0) memcpy(Meta, ParentClass->Meta, ParentClass->MetaSize);
-			else memset(Meta, 0, MetaSize);
 		}
 	}
 
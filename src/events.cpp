@@ -316,7 +316,7 @@ void EventManager::WorldThingSpawned(AActor* actor)
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingSpawned(actor);
 
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingSpawned(actor);
+		if (handler->WantsThingEvent(ETE_Spawned)) handler->WorldThingSpawned(actor);
 }
 
 void EventManager::WorldThingDied(AActor* actor, AActor* inflictor)
@@ -328,7 +328,7 @@ void EventManager::WorldThingDied(AActor* actor, AActor* inflictor)
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingDied(actor, inflictor);
 
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingDied(actor, inflictor);
+		if (handler->WantsThingEvent(ETE_Died)) handler->WorldThingDied(actor, inflictor);
 }
 
 void EventManager::WorldThingRevived(AActor* actor)
@@ -340,7 +340,7 @@ void EventManager::WorldThingRevived(AActor* actor)
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingRevived(actor);
 
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingRevived(actor);
+		if (handler->WantsThingEvent(ETE_Revived)) handler->WorldThingRevived(actor);
 }
 
 void EventManager::WorldThingDamaged(AActor* actor, AActor* inflictor, AActor* source, int damage, FName mod, int flags, DAngle angle)
@@ -352,7 +352,7 @@ void EventManager::WorldThingDamaged(AActor* actor, AActor* inflictor, AActor* s
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingDamaged(actor, inflictor, source, damage, mod, flags, angle);
 
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingDamaged(actor, inflictor, source, damage, mod, flags, angle);
+		if (handler->WantsThingEvent(ETE_Damaged)) handler->WorldThingDamaged(actor, inflictor, source, damage, mod, flags, angle);
 }
 
 void EventManager::WorldThingDestroyed(AActor* actor)
@@ -366,7 +366,7 @@ void EventManager::WorldThingDestroyed(AActor* actor)
 		return;
 
 	for (DStaticEventHandler* handler = LastEventHandler; handler; handler = handler->prev)
-		handler->WorldThingDestroyed(actor);
+		if (handler->WantsThingEvent(ETE_Destroyed)) handler->WorldThingDestroyed(actor);
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingDestroyed(actor);
 }
@@ -721,6 +721,30 @@ static bool isEmptyInt(VMFunction *func)
 //
 // ===========================================
 
+// Thing events are by far the most frequent ones, so EventManager skips
+// handlers that don't process them without any per-call virtual lookup.
+int DStaticEventHandler::GetThingEvents()
+{
+	static const struct { const char *name; int bit; } thingevents[] =
+	{
+		{ "WorldThingSpawned", ETE_Spawned },
+		{ "WorldThingDied", ETE_Died },
+		{ "WorldThingRevived", ETE_Revived },
+		{ "WorldThingDamaged", ETE_Damaged },
+		{ "WorldThingDestroyed", ETE_Destroyed },
+	};
+
+	auto clss = GetClass();
+	int mask = 0;
+	for (auto &ev : thingevents)
+	{
+		unsigned index = GetVirtualIndex(RUNTIME_CLASS(DStaticEventHandler), ev.name);
+		VMFunction *func = index < clss->Virtuals.Size() ? clss->Virtuals[index] : nullptr;
+		if (func != nullptr && !isEmpty(func)) mask |= ev.bit;
+	}
+	return mask;
+}
+
 void DStaticEventHandler::OnRegister()
 {
 	IFVIRTUAL(DStaticEventHandler, OnRegister)
@@ -15,6 +15,16 @@ enum class EventHandlerType
 	PerMap
 };
 
+// thing events a handler actually processes, see DStaticEventHandler::WantsThingEvent
+enum EThingEvent
+{
+	ETE_Spawned = 1,
+	ETE_Died = 2,
+	ETE_Revived = 4,
+	ETE_Damaged = 8,
+	ETE_Destroyed = 16,
+};
+
 // ==============================================
 //
 //  EventHandler - base class
@@ -32,6 +42,7 @@ public:
 		next = 0;
 		Order = 0;
 		IsUiProcessor = false;
+		ThingEvents = -1;
 	}
 
 	EventManager *owner;
@@ -44,6 +55,16 @@ public:
 	bool IsUiProcessor;
 	bool RequireMouse;
 
+	// ETE_* mask of the thing events this handler's class overrides with non-empty functions.
+	// The class of a handler never changes so this only gets determined once, on first use.
+	int ThingEvents;
+	bool WantsThingEvent(int which)
+	{
+		if (ThingEvents < 0) ThingEvents = GetThingEvents();
+		return !!(ThingEvents & which);
+	}
+	int GetThingEvents();
+
 	// serialization handler. let's keep it here so that I don't get lost in serialized/not serialized fields
 	void Serialize(FSerializer& arc) override
 	{
@@ -121,6 +121,9 @@ CUSTOM_CVAR (Int, cl_maxdecals, 1024, CVAR_ARCHIVE|CVAR_NOINITCALL)
 	}
 }
 
+// Upper limit for impact decals on a single wall. Older ones get removed first.
+CVAR (Int, cl_maxwalldecals, 128, CVAR_ARCHIVE)
+
 
 // [BC] Allow the maximum number of particles to be specified by a cvar (so people
 // with lots of nice hardware can have lots of particles!).
@@ -128,8 +131,8 @@ CUSTOM_CVAR(Int, r_maxparticles, 4000, CVAR_ARCHIVE | CVAR_NOINITCALL)
 {
 	if (self == 0)
 		self = 4000;
-	else if (self > 65535)
-		self = 65535;
+	else if (self > MAX_PARTICLES)
+		self = MAX_PARTICLES;
 	else if (self < 100)
 		self = 100;
 
@@ -79,6 +79,9 @@
 #include "g_levellocals.h"
 #include "events.h"
 
+#include <thread>
+#include <atomic>
+
 
 static FRandom pr_dmspawn ("DMSpawn");
 static FRandom pr_pspawn ("PlayerSpawn");
@@ -111,6 +114,11 @@ CVAR (String, save_dir, "", CVAR_ARCHIVE|CVAR_GLOBALCONFIG);
 CVAR (Bool, cl_waitforsave, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
 CVAR (Bool, enablescriptscreenshot, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
 EXTERN_CVAR (Float, con_midtime);
+EXTERN_CVAR (Int, save_compression);
+
+// Every this many net tics, fold a hash of the whole playsim into the
+// consistency check instead of just the player positions. 0 = disabled.
+CVAR (Int, net_synccheck, 0, CVAR_SERVERINFO);
 
 //==========================================================================
 //
@@ -168,8 +176,6 @@ bool			demonew;				// [RH] Only used around G_InitNew for demos
 int				demover;
 uint8_t*			demobuffer;
 uint8_t*			demo_p;
-uint8_t*			democompspot;
-uint8_t*			demobodyspot;
 size_t			maxdemosize;
 uint8_t*			zdemformend;			// end of FORM ZDEM chunk
 uint8_t*			zdembodyend;			// end of ZDEM BODY chunk
@@ -1010,15 +1016,115 @@ bool G_Responder (event_t *ev)
 }
 
 
+//==========================================================================
+//
+// Full playsim hash for net_synccheck
+//
+// Each subsystem gets its own hash so that a desync can be narrowed
+// down by comparing the values every node logs for the failing tic.
+// Raw bit patterns are hashed so that even the smallest difference in
+// a coordinate shows up.
+//
+//==========================================================================
+
+enum ESyncHash
+{
+	SYNC_Actors,
+	SYNC_Sectors,
+	SYNC_RNG,
+	NUM_SYNCHASHES
+};
+
+static uint32_t SyncHashes[BACKUPTICS][NUM_SYNCHASHES];
+static int SyncHashTic[BACKUPTICS];
+
+static inline uint32_t SyncMix(uint32_t hash, uint64_t val)
+{
+	// FNV-1a, fed 32 bits at a time.
+	hash = (hash ^ uint32_t(val)) * 16777619u;
+	hash = (hash ^ uint32_t(val >> 32)) * 16777619u;
+	return hash;
+}
+
+static inline uint32_t SyncMix(uint32_t hash, double val)
+{
+	uint64_t bits;
+	memcpy(&bits, &val, sizeof(bits));
+	return SyncMix(hash, bits);
+}
+
+static void G_SyncHash(uint32_t *hashes)
+{
+	uint32_t actors = 2166136261u;
+	uint32_t sectors = 2166136261u;
+
+	for (auto Level : AllLevels())
+	{
+		auto it = Level->GetThinkerIterator<AActor>();
+		AActor *mo;
+		while ((mo = it.Next()))
+		{
+			actors = SyncMix(actors, mo->X());
+			actors = SyncMix(actors, mo->Y());
+			actors = SyncMix(actors, mo->Z());
+			actors = SyncMix(actors, mo->Vel.X);
+			actors = SyncMix(actors, mo->Vel.Y);
+			actors = SyncMix(actors, mo->Vel.Z);
+			actors = SyncMix(actors, uint64_t(mo->Angles.Yaw.BAMs()) | (uint64_t(uint32_t(mo->health)) << 32));
+		}
+		for (auto &sec : Level->sectors)
+		{
+			sectors = SyncMix(sectors, sec.floorplane.fD());
+			sectors = SyncMix(sectors, sec.ceilingplane.fD());
+		}
+	}
+	hashes[SYNC_Actors] = actors;
+	hashes[SYNC_Sectors] = sectors;
+	hashes[SYNC_RNG] = FRandom::StaticSumSeeds();
+}
+
+static FString G_SyncHashString()
+{
+	uint32_t h[NUM_SYNCHASHES];
+	FString str;
+
+	G_SyncHash(h);
+	str.Format("actors %08x sectors %08x rng %08x", h[SYNC_Actors], h[SYNC_Sectors], h[SYNC_RNG]);
+	return str;
+}
+
+static void G_ReportSyncHash(int player, int buf, int tic)
+{
+	if (SyncHashTic[buf] != tic)
+	{
+		Printf("Consistency failure for %s at tic %d\n", players[player].userinfo.GetName(), tic);
+		return;
+	}
+	const uint32_t *h = SyncHashes[buf];
+	Printf("Consistency failure for %s at tic %d: actors %08x sectors %08x rng %08x\n",
+		players[player].userinfo.GetName(), tic, h[SYNC_Actors], h[SYNC_Sectors], h[SYNC_RNG]);
+	if (debugfile)
+	{
+		fprintf(debugfile, "%i sync failure for %i: actors %08x sectors %08x rng %08x\n",
+			tic, player, h[SYNC_Actors], h[SYNC_Sectors], h[SYNC_RNG]);
+	}
+}
+
+
 
 //
 // G_Ticker
 // Make ticcmd_ts for the players.
 //
+uint64_t TickerTimeNS;
+
 void G_Ticker ()
 {
 	int i;
 	gamestate_t	oldgamestate;
+	uint64_t tickerstart = I_nsTime();
+
+	G_FinishBackgroundSave(false);
 
 	// do player reborns if needed
 	for (i = 0; i < MAXPLAYERS; i++)
@@ -1130,6 +1236,16 @@ void G_Ticker ()
 	// check, not just the player's x position like BOOM.
 	uint32_t rngsum = FRandom::StaticSumSeeds ();
 
+	// If requested, include the entire playsim every few tics.
+	bool synccheck = netgame && !demoplayback && net_synccheck > 0 &&
+		(gametic % ticdup) == 0 && ((gametic / ticdup) % net_synccheck) == 0;
+	uint32_t synchashes[NUM_SYNCHASHES];
+	if (synccheck)
+	{
+		G_SyncHash(synchashes);
+		rngsum += synchashes[SYNC_Actors] ^ (synchashes[SYNC_Sectors] * 31);
+	}
+
 	//Added by MC: For some of that bot stuff. The main bot function.
 	primaryLevel->BotInfo.Main (primaryLevel);
 
@@ -1173,6 +1289,10 @@ void G_Ticker ()
 				//players[i].inconsistant = 0;
 				if (gametic > BACKUPTICS*ticdup && consistancy[i][buf] != cmd->consistancy)
 				{
+					if (players[i].inconsistant == 0)
+					{
+						G_ReportSyncHash(i, buf, gametic - BACKUPTICS*ticdup);
+					}
 					players[i].inconsistant = gametic - BACKUPTICS*ticdup;
 				}
 				if (players[i].mo)
@@ -1189,6 +1309,16 @@ void G_Ticker ()
 		}
 	}
 
+	if (synccheck)
+	{
+		memcpy(SyncHashes[buf], synchashes, sizeof(synchashes));
+		SyncHashTic[buf] = gametic;
+	}
+	else if ((gametic % ticdup) == 0)
+	{
+		SyncHashTic[buf] = -1;
+	}
+
 	// [ZZ] also tick the UI part of the events
 	primaryLevel->localEventManager->UiTick();
 	C_RunDelayedCommands();
@@ -1231,6 +1361,8 @@ void G_Ticker ()
 
 	// [MK] Additional ticker for UI events right after all others
 	primaryLevel->localEventManager->PostUiTick();
+
+	TickerTimeNS += I_nsTime() - tickerstart;
 }
 
 
@@ -1807,6 +1939,9 @@ void G_DoLoadGame ()
 {
 	bool hidecon;
 
+	// The file to load may still be being written.
+	G_FinishBackgroundSave(true);
+
 	if (gameaction != ga_autoloadgame)
 	{
 		demoplayback = false;
@@ -2210,6 +2345,179 @@ static void PutSavePic (FileWriter *file, int width, int height)
 	}
 }
 
+//==========================================================================
+//
+// Background save writer
+//
+// The game state has to be serialized on the main thread, but compressing
+// the resulting text and writing the file can go on while the game keeps
+// running. The thread only touches what it was handed and must not use
+// M_Malloc, whose bookkeeping belongs to the main thread, or print anything.
+//
+//==========================================================================
+
+CVAR(Bool, save_background, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+struct FBackgroundSave
+{
+	FString Filename;
+	FString Description;
+	bool OkForQuicksave;
+	bool ForceQuicksave;
+	TArray<FString> Names;
+	TArray<FCompressedBuffer> Content;
+	TArray<FString> Texts;		// compressed into Content[FirstText] onward by the thread
+	unsigned FirstText;
+	int CompressionLevel;		// save_compression, read on the main thread
+	bool Written = false;
+	std::atomic<bool> Done{ false };
+	std::thread Thread;
+
+	~FBackgroundSave()
+	{
+		for (auto &c : Content) c.Clean();
+	}
+};
+
+static FBackgroundSave *PendingSave;
+
+// Don't let the process exit in the middle of writing a file.
+static struct FBackgroundSaveGuard
+{
+	~FBackgroundSaveGuard()
+	{
+		if (PendingSave != nullptr) PendingSave->Thread.join();
+	}
+} BackgroundSaveGuard;
+
+static void G_WriteBackgroundSave(FBackgroundSave *save)
+{
+	for (unsigned i = 0; i < save->Texts.Size(); i++)
+	{
+		save->Content[save->FirstText + i] = CompressSerializerOutput(save->Texts[i].GetChars(), (unsigned)save->Texts[i].Len(), save->CompressionLevel);
+	}
+	save->Written = WriteZip(save->Filename, save->Names, save->Content);
+	save->Done = true;
+}
+
+//==========================================================================
+//
+// G_SaveGameWritten
+//
+// Checks the written file and tells the player how it went.
+//
+//==========================================================================
+
+static void G_SaveGameWritten(bool written, const FString &filename, const char *description, bool okForQuicksave, bool forceQuicksave)
+{
+	bool succeeded = false;
+
+	if (written)
+	{
+		// Check whether the file is ok by trying to open it.
+		FResourceFile *test = FResourceFile::OpenResourceFile(filename, true);
+		if (test != nullptr)
+		{
+			delete test;
+			succeeded = true;
+		}
+	}
+
+	if (succeeded)
+	{
+		savegameManager.NotifyNewSave(filename, description, okForQuicksave, forceQuicksave);
+		BackupSaveName = filename;
+
+		if (longsavemessages) Printf("%s (%s)\n", GStrings("GGSAVED"), filename.GetChars());
+		else Printf("%s\n", GStrings("GGSAVED"));
+	}
+	else
+	{
+		Printf(PRINT_HIGH, "%s\n", GStrings("TXT_SAVEFAILED"));
+	}
+}
+
+//==========================================================================
+//
+// G_FinishBackgroundSave
+//
+// Reports a save being written in the background once it is done, or
+// waits for it if wait is set.
+//
+//==========================================================================
+
+void G_FinishBackgroundSave(bool wait)
+{
+	if (PendingSave == nullptr || (!wait && !PendingSave->Done))
+	{
+		return;
+	}
+	PendingSave->Thread.join();
+	G_SaveGameWritten(PendingSave->Written, PendingSave->Filename, PendingSave->Description, PendingSave->OkForQuicksave, PendingSave->ForceQuicksave);
+	delete PendingSave;
+	PendingSave = nullptr;
+}
+
+//==========================================================================
+//
+// G_StartBackgroundSave
+//
+// Takes ownership of everything that goes into the file and hands it to
+// the save thread.
+//
+//==========================================================================
+
+static void G_StartBackgroundSave(const FString &filename, const char *description, bool okForQuicksave, bool forceQuicksave,
+	TArray<unsigned char> *picdata, FSerializer &savegameinfo, FSerializer &savegameglobals, FString *leveltext)
+{
+	auto save = new FBackgroundSave;
+	save->Filename = filename;
+	save->Description = description;
+	save->OkForQuicksave = okForQuicksave;
+	save->ForceQuicksave = forceQuicksave;
+	save->CompressionLevel = save_compression;
+
+	FCompressedBuffer bufpng = { picdata->Size(), picdata->Size(), METHOD_STORED, 0, static_cast<unsigned int>(crc32(0, &(*picdata)[0], picdata->Size())), new char[picdata->Size()] };
+	memcpy(bufpng.mBuffer, &(*picdata)[0], picdata->Size());
+	save->Content.Push(bufpng);
+	save->Names.Push("savepic.png");
+
+	unsigned len;
+	const char *text;
+	save->FirstText = save->Content.Size();
+	text = savegameinfo.GetOutput(&len);
+	save->Texts.Push(FString(text, len));
+	save->Names.Push("info.json");
+	text = savegameglobals.GetOutput(&len);
+	save->Texts.Push(FString(text, len));
+	save->Names.Push("globals.json");
+	if (leveltext != nullptr)
+	{
+		save->Texts.Push(*leveltext);
+		save->Names.Push(G_SnapshotFileName(level.info));
+	}
+	for (unsigned i = 0; i < save->Texts.Size(); i++)
+	{
+		save->Content.Push({ 0, 0, METHOD_STORED, 0, 0, nullptr });
+	}
+
+	// The snapshots of other hub levels stay with their level infos.
+	TArray<FString> names;
+	TArray<FCompressedBuffer> snapshots;
+	G_WriteSnapshots(names, snapshots);
+	for (unsigned i = 0; i < snapshots.Size(); i++)
+	{
+		FCompressedBuffer copy = snapshots[i];
+		copy.mBuffer = new char[copy.mCompressedSize];
+		memcpy(copy.mBuffer, snapshots[i].mBuffer, copy.mCompressedSize);
+		save->Content.Push(copy);
+		save->Names.Push(names[i]);
+	}
+
+	PendingSave = save;
+	save->Thread = std::thread(G_WriteBackgroundSave, save);
+}
+
 void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, const char *description)
 {
 	TArray<FCompressedBuffer> savegame_content;
@@ -2229,13 +2537,21 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 		filename = G_BuildSaveName ("demosave." SAVEGAME_EXT, -1);
 	}
 
+	// Never have two saves in flight, they may well be going to the same file.
+	G_FinishBackgroundSave(true);
+
 	if (cl_waitforsave)
 		I_FreezeTime(true);
 
+	bool background = save_background;
+	FString leveltext;
+	bool havelevel = false;
+
 	insave = true;
 	try
 	{
-		level.SnapshotLevel();
+		if (background) havelevel = level.SnapshotLevelText(leveltext);
+		else level.SnapshotLevel();
 	}
 	catch(CRecoverableError &err)
 	{
@@ -2312,6 +2628,18 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 	}
 
 	auto picdata = savepic.GetBuffer();
+
+	if (background)
+	{
+		G_StartBackgroundSave(filename, description, okForQuicksave, forceQuicksave, picdata,
+			savegameinfo, savegameglobals, havelevel ? &leveltext : nullptr);
+
+		insave = false;
+		if (cl_waitforsave)
+			I_FreezeTime(false);
+		return;
+	}
+
 	FCompressedBuffer bufpng = { picdata->Size(), picdata->Size(), METHOD_STORED, 0, static_cast<unsigned int>(crc32(0, &(*picdata)[0], picdata->Size())), (char*)&(*picdata)[0] };
 
 	savegame_content.Push(bufpng);
@@ -2324,31 +2652,7 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 	G_WriteSnapshots (savegame_filenames, savegame_content);
 	
 
-	bool succeeded = false;
-
-	if (WriteZip(filename, savegame_filenames, savegame_content))
-	{
-		// Check whether the file is ok by trying to open it.
-		FResourceFile *test = FResourceFile::OpenResourceFile(filename, true);
-		if (test != nullptr)
-		{
-			delete test;
-			succeeded = true;
-		}
-	}
-
-	if (succeeded)
-	{
-		savegameManager.NotifyNewSave(filename, description, okForQuicksave, forceQuicksave);
-		BackupSaveName = filename;
-
-		if (longsavemessages) Printf("%s (%s)\n", GStrings("GGSAVED"), filename.GetChars());
-		else Printf("%s\n", GStrings("GGSAVED"));
-	}
-	else
-	{
-		Printf(PRINT_HIGH, "%s\n", GStrings("TXT_SAVEFAILED"));
-	}
+	G_SaveGameWritten(WriteZip(filename, savegame_filenames, savegame_content), filename, description, okForQuicksave, forceQuicksave);
 
 
 	// delete the JSON buffers we created just above. Everything else will
@@ -2421,6 +2725,86 @@ void G_ReadDemoTiccmd (ticcmd_t *cmd, int player)
 
 bool stoprecording;
 
+// While recording, the demo header is written out right away and the
+// BODY chunk is streamed to disk in pieces, so demobuffer only ever
+// holds the last few seconds of ticcmds.
+enum
+{
+	DEMO_FLUSHSIZE = 0x10000,
+};
+
+static FileWriter		*demofile;
+static long				democomppos;		// file offset of the COMP chunk's size field
+static long				demobodypos;		// file offset of the BODY chunk's length field
+static uLong			demobodysize;		// uncompressed bytes of BODY so far
+static uLong			demobodywritten;	// bytes of BODY actually in the file
+static bool				democompressing;
+static bool				demowritefailed;
+static z_stream			demostream;
+
+//==========================================================================
+//
+// G_FlushDemoBody
+//
+// Moves whatever is in demobuffer into the file, compressing it on the
+// way if requested.
+//
+//==========================================================================
+
+static void G_FlushDemoBody (bool finish)
+{
+	uLong len = uLong(demo_p - demobuffer);
+	demobodysize += len;
+
+	if (!democompressing)
+	{
+		if (len > 0 && demofile->Write(demobuffer, len) != len)
+		{
+			demowritefailed = true;
+		}
+		demobodywritten += len;
+	}
+	else
+	{
+		uint8_t out[DEMO_FLUSHSIZE];
+		int r;
+
+		demostream.next_in = demobuffer;
+		demostream.avail_in = len;
+		do
+		{
+			demostream.next_out = out;
+			demostream.avail_out = sizeof(out);
+			r = deflate (&demostream, finish ? Z_FINISH : Z_NO_FLUSH);
+			size_t outlen = sizeof(out) - demostream.avail_out;
+			if (r == Z_STREAM_ERROR || (outlen > 0 && demofile->Write(out, outlen) != outlen))
+			{
+				demowritefailed = true;
+				break;
+			}
+			demobodywritten += uLong(outlen);
+		} while (demostream.avail_out == 0 || (finish && r != Z_STREAM_END));
+	}
+	demo_p = demobuffer;
+}
+
+//==========================================================================
+//
+// G_PatchDemoLong
+//
+//==========================================================================
+
+static void G_PatchDemoLong (long pos, int value)
+{
+	uint8_t buf[4], *p = buf;
+
+	WriteLong (value, &p);
+	if (demofile->Seek(pos, SEEK_SET) != 0 || demofile->Write(buf, 4) != 4)
+	{
+		demowritefailed = true;
+	}
+}
+
 CCMD (stop)
 {
 	stoprecording = true;
@@ -2454,20 +2838,19 @@ void G_WriteDemoTiccmd (ticcmd_t *cmd, int player, int buf)
 	// [RH] Now write out a "normal" ticcmd.
 	WriteUserCmdMessage (&cmd->ucmd, &players[player].cmd.ucmd, &demo_p);
 
+	if (demo_p - demobuffer >= DEMO_FLUSHSIZE)
+	{
+		G_FlushDemoBody (false);
+	}
+
 	// [RH] Bigger safety margin
 	if (demo_p > demobuffer + maxdemosize - 64)
 	{
 		ptrdiff_t pos = demo_p - demobuffer;
-		ptrdiff_t spot = lenspot - demobuffer;
-		ptrdiff_t comp = democompspot - demobuffer;
-		ptrdiff_t body = demobodyspot - demobuffer;
 		// [RH] Allocate more space for the demo
 		maxdemosize += 0x20000;
 		demobuffer = (uint8_t *)M_Realloc (demobuffer, maxdemosize);
 		demo_p = demobuffer + pos;
-		lenspot = demobuffer + spot;
-		democompspot = demobuffer + comp;
-		demobodyspot = demobuffer + body;
 	}
 }
 
@@ -2550,14 +2933,44 @@ void G_BeginRecording (const char *startmap)
 	FinishChunk (&demo_p);
 
 	// Indicate body is compressed
-	StartChunk (COMP_ID, &demo_p);
-	democompspot = demo_p;
-	WriteLong (0, &demo_p);
-	FinishChunk (&demo_p);
+	democompressing = demo_compress;
+	if (democompressing)
+	{
+		StartChunk (COMP_ID, &demo_p);
+		democomppos = long(demo_p - demobuffer);
+		WriteLong (0, &demo_p);
+		FinishChunk (&demo_p);
+	}
 
 	// Begin BODY chunk
 	StartChunk (BODY_ID, &demo_p);
-	demobodyspot = demo_p;
+	demobodypos = long(lenspot - demobuffer);
+	lenspot = NULL;	// patched in the file once the demo is done
+
+	// Everything up to here goes to the file now, the body follows in pieces.
+	demofile = FileWriter::Open (demoname);
+	if (demofile == nullptr)
+	{
+		Printf ("Unable to create demo %s\n", demoname.GetChars());
+		M_Free (demobuffer);
+		demobuffer = demo_p = NULL;
+		demorecording = false;
+		return;
+	}
+	const size_t headersize = demo_p - demobuffer;
+	demowritefailed = demofile->Write (demobuffer, headersize) != headersize;
+	demo_p = demobuffer;
+	demobodysize = demobodywritten = 0;
+
+	if (democompressing)
+	{
+		memset (&demostream, 0, sizeof(demostream));
+		if (deflateInit (&demostream, 9) != Z_OK)
+		{
+			demowritefailed = true;
+			democompressing = false;
+		}
+	}
 }
 
 
@@ -2851,6 +3264,49 @@ void G_TimeDemo (const char* name)
 }
 
 
+//==========================================================================
+//
+// G_WriteTimeDemoReport
+//
+// With -timedemoreport <file> a timed demo also writes its results as
+// JSON so that benchmark runs can be collected and compared by scripts.
+//
+//==========================================================================
+
+EXTERN_CVAR(Int, vid_rendermode)
+
+static void G_WriteTimeDemoReport(int gametics, int realtics)
+{
+	const char *filename = Args->CheckValue("-timedemoreport");
+	if (filename == nullptr) return;
+
+	FileWriter *fw = FileWriter::Open(filename);
+	if (fw == nullptr)
+	{
+		Printf("Unable to write %s\n", filename);
+		return;
+	}
+	FString demo = defdemoname;
+	demo.Substitute("\\", "\\\\");
+	demo.Substitute("\"", "\\\"");
+	fw->Printf("{\n"
+		"\t\"demo\": \"%s\",\n"
+		"\t\"map\": \"%s\",\n"
+		"\t\"rendermode\": %d,\n"
+		"\t\"width\": %d,\n"
+		"\t\"height\": %d,\n"
+		"\t\"gametics\": %d,\n"
+		"\t\"realtics\": %d,\n"
+		"\t\"fps\": %.2f,\n"
+		"\t\"finalstate\": \"%s\",\n"
+		"\t\"frametimes\": %s\n"
+		"}\n",
+		demo.GetChars(), primaryLevel->MapName.GetChars(), *vid_rendermode, screen->GetWidth(), screen->GetHeight(),
+		gametics, realtics, realtics > 0 ? (float)gametics / (float)realtics * (float)TICRATE : 0.f,
+		G_SyncHashString().GetChars(), D_FrameTimesJSON().GetChars());
+	delete fw;
+}
+
 /*
 ===================
 =
@@ -2874,7 +3330,10 @@ bool G_CheckDemoStatus (void)
 		int endtime = 0;
 
 		if (timingdemo)
+		{
 			endtime = I_GetTime () - starttime;
+			G_WriteTimeDemoReport(gametic, endtime);
+		}
 
 		C_RestoreCVars ();		// [RH] Restore cvars demo might have changed
 		M_Free (demobuffer);
@@ -2900,13 +3359,18 @@ bool G_CheckDemoStatus (void)
 				// Trying to get back to a stable state after timing a demo
 				// seems to cause problems. I don't feel like fixing that
 				// right now.
+				// The final playsim state lets regression runs check that
+				// the demo still plays back the way it was recorded.
 				I_FatalError ("timed %i gametics in %i realtics (%.1f fps)\n"
+							  "final state: %s\n"
 							  "(This is not really an error.)", gametic,
-							  endtime, (float)gametic/(float)endtime*(float)TICRATE);
+							  endtime, (float)gametic/(float)endtime*(float)TICRATE,
+							  G_SyncHashString().GetChars());
 			}
 			else
 			{
 				Printf ("Demo ended.\n");
+				Printf ("Final state: %s\n", G_SyncHashString().GetChars());
 			}
 			gameaction = ga_fullconsole;
 			timingdemo = false;
@@ -2922,42 +3386,34 @@ bool G_CheckDemoStatus (void)
 
 	if (demorecording)
 	{
-		uint8_t *formlen;
-
 		WriteByte (DEM_STOP, &demo_p);
-
-		if (demo_compress)
-		{
-			// Now that the entire BODY chunk has been created, replace it with
-			// a compressed version. If the BODY successfully compresses, the
-			// contents of the COMP chunk will be changed to indicate the
-			// uncompressed size of the BODY.
-			uLong len = uLong(demo_p - demobodyspot);
-			uLong outlen = (len + len/100 + 12);
-			TArray<Byte> compressed(outlen, true);
-			int r = compress2 (compressed.Data(), &outlen, demobodyspot, len, 9);
-			if (r == Z_OK && outlen < len)
-			{
-				formlen = democompspot;
-				WriteLong (len, &democompspot);
-				memcpy (demobodyspot, compressed.Data(), outlen);
-				demo_p = demobodyspot + outlen;
-			}
+		G_FlushDemoBody (true);
+		if (democompressing)
+		{
+			deflateEnd (&demostream);
 		}
-		FinishChunk (&demo_p);
-		formlen = demobuffer + 4;
-		WriteLong (int(demo_p - demobuffer - 8), &formlen);
 
-		auto fw = FileWriter::Open(demoname);
-		bool saved = false;
-		if (fw != nullptr)
+		// Pad the BODY chunk and fill in all the lengths that were
+		// unknown when the header was written.
+		if (demobodywritten & 1)
+		{
+			uint8_t pad = 0;
+			if (demofile->Write(&pad, 1) != 1) demowritefailed = true;
+		}
+		long formsize = demofile->Tell();
+		G_PatchDemoLong (demobodypos, int(demobodywritten));
+		if (democompressing)
 		{
-			const size_t size = demo_p - demobuffer;
-			saved = fw->Write(demobuffer, size) == size;
-			delete fw;
-			if (!saved) remove(demoname);
+			G_PatchDemoLong (democomppos, int(demobodysize));
 		}
+		G_PatchDemoLong (4, int(formsize - 8));
+
+		bool saved = !demowritefailed;
+		delete demofile;
+		demofile = nullptr;
+		if (!saved) remove(demoname);
 		M_Free (demobuffer); 
+		demobuffer = demo_p = NULL;
 		demorecording = false;
 		stoprecording = false;
 		if (saved)
@@ -79,6 +79,7 @@ void G_DeferedPlayDemo (const char* demo);
 void G_LoadGame (const char* name, bool hidecon=false);
 
 void G_DoLoadGame (void);
+void G_FinishBackgroundSave (bool wait);
 
 // Called by M_Responder.
 void G_SaveGame (const char *filename, const char *description);
@@ -95,6 +96,7 @@ void G_TimeDemo (const char* name);
 bool G_CheckDemoStatus (void);
 
 void G_Ticker (void);
+extern uint64_t TickerTimeNS;	// total time spent in G_Ticker, for the frame statistics
 bool G_Responder (event_t*	ev);
 
 void G_ScreenShot (const char* filename);
@@ -1158,6 +1158,8 @@ void FLevelLocals::DoLoadLevel(const FString &nextmapname, int position, bool au
 		{
 			starttime = I_GetTime ();
 			firstTime = false;
+			// Only the demo's frames should end up in a -timedemoreport.
+			D_ResetFrameTimes();
 		}
 	}
 
@@ -1713,26 +1715,29 @@ void FLevelLocals::AirControlChanged ()
 //
 //==========================================================================
 
+FString G_SnapshotFileName(const level_info_t *info)
+{
+	FString filename;
+	filename.Format(info == &TheDefaultLevelInfo ? "%s.mapd.json" : "%s.map.json", info->MapName.GetChars());
+	filename.ToLower();
+	return filename;
+}
+
 void G_WriteSnapshots(TArray<FString> &filenames, TArray<FCompressedBuffer> &buffers)
 {
 	unsigned int i;
-	FString filename;
 
 	for (i = 0; i < wadlevelinfos.Size(); i++)
 	{
 		if (wadlevelinfos[i].Snapshot.mCompressedSize > 0)
 		{
-			filename.Format("%s.map.json", wadlevelinfos[i].MapName.GetChars());
-			filename.ToLower();
-			filenames.Push(filename);
+			filenames.Push(G_SnapshotFileName(&wadlevelinfos[i]));
 			buffers.Push(wadlevelinfos[i].Snapshot);
 		}
 	}
 	if (TheDefaultLevelInfo.Snapshot.mCompressedSize > 0)
 	{
-		filename.Format("%s.mapd.json", TheDefaultLevelInfo.MapName.GetChars());
-		filename.ToLower();
-		filenames.Push(filename);
+		filenames.Push(G_SnapshotFileName(&TheDefaultLevelInfo));
 		buffers.Push(TheDefaultLevelInfo.Snapshot);
 	}
 }
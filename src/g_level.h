@@ -35,6 +35,7 @@ void G_ClearSnapshots (void);
 void P_RemoveDefereds ();
 void G_ReadSnapshots (FResourceFile *);
 void G_WriteSnapshots (TArray<FString> &, TArray<FCompressedBuffer> &);
+FString G_SnapshotFileName (const level_info_t *info);
 void G_WriteVisited(FSerializer &arc);
 void G_ReadVisited(FSerializer &arc);
 void G_ClearHubInfo();
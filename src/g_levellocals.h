@@ -154,6 +154,7 @@ private:
 	void UpdatePortal(FLinePortal *port);
 	void CollectLinkedPortals();
 	void CreateLinkedPortals();
+	void BuildGroupPortalLinks();
 	bool ChangePortalLine(line_t *line, int destid);
 	void AddDisplacementForPortal(FSectorPortal *portal);
 	void AddDisplacementForPortal(FLinePortal *portal);
@@ -167,6 +168,7 @@ private:
 
 public:
 	void SnapshotLevel();
+	bool SnapshotLevelText(FString &text);
 	void UnSnapshotLevel(bool hubLoad);
 
 	void FinalizePortals();
@@ -367,6 +369,9 @@ private:	// The engine should never ever access subsectors of the game nodes. Th
 public:
 	sector_t *PointInSectorBuggy(double x, double y);
 	subsector_t *PointInRenderSubsector (fixed_t x, fixed_t y);
+	void PointInSectors(const DVector2 *pos, sector_t **result, unsigned count);
+	void PointInRenderSubsectors(const DVector2 *pos, subsector_t **result, unsigned count);
+	void PackNodes();
 
 	sector_t *PointInSector(const DVector2 &pos)
 	{
@@ -440,6 +445,8 @@ public:
 	TArray<subsector_t> gamesubsectors;
 	TArray<node_t> gamenodes;
 	node_t *headgamenode;
+	FPackedBSP gamebsp;		// packed copies of the game and render nodes
+	FPackedBSP renderbsp;
 	TArray<uint8_t> rejectmatrix;
 	TArray<zone_t>	Zones;
 	TArray<FPolyObj> Polyobjects;
@@ -451,6 +458,8 @@ public:
 	FDisplacementTable Displacements;
 	FPortalBlockmap PortalBlockmap;
 	TArray<FLinePortal*> linkedPortals;	// only the linked portals, this is used to speed up looking for them in P_CollectConnectedGroups.
+	TArray<FLinePortal*> groupLinkedPortals;	// linkedPortals sorted by the groups they are reachable from
+	TArray<unsigned> groupLinkedPortalStart;	// first index into groupLinkedPortals for each group, plus a terminating entry
 	TArray<FSectorPortalGroup *> portalGroups;
 	TArray<FLinePortalSpan> linePortalSpans;
 	FSectionContainer sections;
@@ -629,7 +638,7 @@ public:
 	uint32_t			ActiveParticles;
 	uint32_t			InactiveParticles;
 	TArray<particle_t>	Particles;
-	TArray<uint16_t>	ParticlesInSubsec;
+	TArray<uint32_t>	ParticlesInSubsec;
 	FThinkerCollection Thinkers;
 
 	TArray<DVector2>	Scrolls;		// NULL if no DScrollers in this level
@@ -2273,20 +2273,22 @@ static int PatchText (int oldSize)
 	}
 
 	// Search through most other texts
-	const char *str;
-	do
 	{
-		str = EnglishStrings.MatchString(oldStr);
-		if (str != NULL)
+		// All matches get collected in one pass, since large patches contain many text chunks
+		// and each search has to go through the entire string table.
+		TArray<FName> matches;
+		if (EnglishStrings.MatchStrings(oldStr, matches) > 0)
 		{
 			FString newname = newStr;
 			TableElement te = { LumpFileNum, { newname, newname, newname, newname } };
-			DehStrings.Insert(str, te);
-			EnglishStrings.Remove(str);	// remove entry so that it won't get found again by the next iteration or  by another replacement later
+			for (auto str : matches)
+			{
+				DehStrings.Insert(str, te);
+				EnglishStrings.Remove(str);	// remove entry so that it won't get found again by another replacement later
+			}
 			good = true;
 		}
-	} 
-	while (str != NULL);	// repeat search until the text can no longer be found
+	}
 
 	if (!good)
 	{
@@ -240,6 +240,15 @@ private:
 
 struct FDropItem;
 
+// A flag lookup by name as done by CheckFlag, cached per class.
+struct FCachedFlag
+{
+	unsigned int flagbit;
+	int structoffset;
+	int fieldsize;
+	bool found;
+};
+
 struct FActorInfo
 {
 	TArray<FInternalLightAssociation *> LightAssociations;
@@ -267,6 +276,8 @@ struct FActorInfo
 
 	uint8_t DefaultStateUsage = 0; // state flag defaults for blocks without a qualifier.
 
+	TMap<FName, FCachedFlag> FlagCache;	// not inherited, since subclasses can define their own flags
+
 	FActorInfo() = default;
 	FActorInfo(const FActorInfo & other)
 	{
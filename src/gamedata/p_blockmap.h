@@ -4,6 +4,9 @@
 #include "doomtype.h"
 
 class AActor;
+struct line_t;
+struct FPolyObj;
+struct FLevelLocals;
 
 // [RH] Like msecnode_t, but for the blockmap
 struct FBlockNode
@@ -15,6 +18,7 @@ struct FBlockNode
 	FBlockNode *NextActor;			// next actor in this block
 	FBlockNode **PrevBlock;			// previous block this actor is in
 	FBlockNode *NextBlock;			// next block this actor is in
+	int PackedIndex;				// index of this node's entry in the block's FBlockThings
 
 	static FBlockNode *Create (AActor *who, int x, int y, int group = -1);
 	void Release ();
@@ -22,6 +26,40 @@ struct FBlockNode
 	static FBlockNode *FreeBlocks;
 };
 
+// Packed copy of a block's thing chain for fast iteration.
+// Entries are stored in link order, so walking them backwards yields the
+// same order as following the FBlockNode chain. Unlinking only clears the
+// entry so that indices remain stable while iterators are active.
+// Cleared entries get removed by FBlockmap::CompactThings once per tic, or
+// when too many have piled up. Iterators that are kept across a compaction,
+// like the ones ZScript can hold, notice it through the generation.
+struct FBlockThings
+{
+	TArray<AActor *> Actors;
+	TArray<FBlockNode *> Nodes;
+	TArray<uint8_t> Spanning;		// actor is linked into more than one block
+	unsigned Generation = 0;		// incremented whenever the entries get compacted
+	bool Dirty = false;
+};
+
+// Copy of a block's lines for traces that run in batches, see FBlockmap::BeginLineBatch.
+// Each polyobject in the block is stored as a header followed by its lines,
+// then come the block's own lines. This is the order FBlockLinesIterator uses.
+struct FBlockLineEntry
+{
+	line_t *Line;					// nullptr for polyobject headers
+	FPolyObj *Poly;					// only set for headers
+	int Count;						// only set for headers: number of lines that follow
+	double X1, Y1, X2, Y2;			// vertex positions
+	double DX, DY;					// line delta
+};
+
+struct FBlockLineSpan
+{
+	unsigned First;
+	unsigned Count;
+};
+
 // BLOCKMAP
 // Created from axis aligned bounding box
 // of the map, a rectangular array of
@@ -40,12 +78,22 @@ struct FBlockmap
 	double				bmaporgx;
 	double				bmaporgy;		// origin of block map
 	FBlockNode**		blocklinks; 	// for thing chains
+	FBlockThings*		blockthings = nullptr;	// packed thing chains, parallel to blocklinks
+	TArray<int>			dirtyblocks;	// blocks with cleared entries in blockthings
+	unsigned			clearedthings = 0;	// number of cleared entries in blockthings
+
+	int					linebatch = 0;	// nesting depth of BeginLineBatch
+	int					polylinks = 0;	// changes whenever a polyobject gets linked or unlinked
+	int					batchpolylinks = 0;
+	TArray<FBlockLineEntry>	batchlines;
+	TMap<int, FBlockLineSpan>	batchblocks;
 
 	// mapblocks are used to check movement
 	// against lines and things
 	enum
 	{
-		MAPBLOCKUNITS = 128
+		MAPBLOCKUNITS = 128,
+		MAXCLEAREDTHINGS = 4096		// compact outside the level tick above this many cleared entries
 	};
 
 	inline int GetBlockX(double xpos)
@@ -75,6 +123,22 @@ struct FBlockmap
 
 	bool VerifyBlockMap(int count, unsigned numlines);
 
+	void LinkThing(FBlockNode *node);
+	void UnlinkThing(FBlockNode *node);
+	void RestoreThing(FBlockNode *node);
+	void MarkSpanning(FBlockNode *node);
+	void CompactThings();
+
+	void BeginLineBatch();
+	void EndLineBatch();
+	void ClearLineBatch();
+	void ResetLineBatch()
+	{
+		linebatch = 0;
+		ClearLineBatch();
+	}
+	const FBlockLineEntry *GetBatchLines(FLevelLocals *Level, int x, int y, unsigned &count);
+
 	void Clear()
 	{
 		if (blockmaplump != nullptr)
@@ -87,6 +151,14 @@ struct FBlockmap
 			delete[] blocklinks;
 			blocklinks = nullptr;
 		}
+		if (blockthings != nullptr)
+		{
+			delete[] blockthings;
+			blockthings = nullptr;
+		}
+		dirtyblocks.Clear();
+		clearedthings = 0;
+		ResetLineBatch();
 	}
 
 	~FBlockmap()
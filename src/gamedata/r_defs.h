@@ -559,6 +559,19 @@ struct extsector_t
 		TDeletingArray<F3DFloor *>		ffloors;		// 3D floors in this sector
 		TArray<lightlist_t>				lightlist;		// 3D light list
 		TArray<sector_t*>				attached;		// 3D floors attached to this sector
+
+		struct sortkey
+		{
+			F3DFloor *rover;
+			unsigned int flags;
+			double top, bottom;
+
+			bool operator==(const sortkey &other) const
+			{
+				return rover == other.rover && flags == other.flags && top == other.top && bottom == other.bottom;
+			}
+		};
+		TArray<sortkey>					sortkeys;		// inputs of the last ffloors sort, see P_Recalculate3DFloors
 	} XFloor;
 
 	TArray<vertex_t *> vertices;
@@ -1458,6 +1471,7 @@ struct msecnode_t
 	struct msecnode_t	*m_sprev;	// prev msecnode_t for this sector
 	struct msecnode_t	*m_snext;	// next msecnode_t for this sector
 	bool visited;	// killough 4/4/98, 4/7/98: used in search algorithms
+	unsigned m_index;	// stable index in the node pool, must not be changed.
 };
 
 // use the same memory layout as msecnode_t so both can be used from the same freelist.
@@ -1470,6 +1484,7 @@ struct portnode_t
 	struct portnode_t	*m_sprev;	// prev msecnode_t for this portal
 	struct portnode_t	*m_snext;	// next msecnode_t for this portal
 	bool visited;
+	unsigned m_index;
 };
 
 struct FPolyNode;
@@ -1583,6 +1598,34 @@ struct node_t
 };
 
 
+// Compact copy of a node tree for point-in-subsector lookups, which only
+// need the partition lines. A negative child is the complement of a
+// subsector index, the root is the last node.
+
+struct FPackedNode
+{
+	fixed_t		x;
+	fixed_t		y;
+	fixed_t		dx;
+	fixed_t		dy;
+	int			children[2];
+};
+
+struct FPackedBSP
+{
+	TArray<FPackedNode> Nodes;
+	subsector_t *Subsectors = nullptr;
+
+	void Build(node_t *nodes, unsigned numnodes, subsector_t *subsectors);
+	void Clear()
+	{
+		Nodes.Reset();
+		Subsectors = nullptr;
+	}
+	subsector_t *PointInSubsector(fixed_t x, fixed_t y) const;
+	void PointInSubsectors(const DVector2 *pos, subsector_t **result, unsigned count) const;
+};
+
 // An entire BSP tree.
 
 struct FMiniBSP
@@ -106,13 +106,30 @@ struct CZDFileInStream
 
 struct C7zArchive
 {
+	// Solid archives need to decompress an entire block to get at any file in it.
+	// The most recently used blocks are kept around so that accessing the files
+	// in an order that alternates between blocks does not decompress the same
+	// blocks over and over.
+	enum
+	{
+		MAX_BLOCKS = 4,
+		MAX_CACHED_BYTES = 64 << 20,	// the most recent block is always kept, regardless of size
+	};
+
+	struct FBlock
+	{
+		UInt32 BlockIndex;
+		Byte *OutBuffer;
+		size_t OutBufferSize;
+		unsigned LastUse;
+	};
+
 	CSzArEx DB;
 	CZDFileInStream ArchiveStream;
 	CLookToRead2 LookStream;
 	Byte StreamBuffer[1<<14];
-	UInt32 BlockIndex;
-	Byte *OutBuffer;
-	size_t OutBufferSize;
+	FBlock Blocks[MAX_BLOCKS];
+	unsigned UseCounter;
 
 	C7zArchive(FileReader &file) : ArchiveStream(file)
 	{
@@ -127,35 +144,84 @@ struct C7zArchive
 		LookStream.bufSize = sizeof(StreamBuffer);
 		LookStream.buf = StreamBuffer;
 		SzArEx_Init(&DB);
-		BlockIndex = 0xFFFFFFFF;
-		OutBuffer = NULL;
-		OutBufferSize = 0;
+		for (auto &block : Blocks)
+		{
+			block.BlockIndex = 0xFFFFFFFF;
+			block.OutBuffer = NULL;
+			block.OutBufferSize = 0;
+			block.LastUse = 0;
+		}
+		UseCounter = 0;
 	}
 
 	~C7zArchive()
 	{
-		if (OutBuffer != NULL)
+		for (auto &block : Blocks)
 		{
-			IAlloc_Free(&g_Alloc, OutBuffer);
+			FreeBlock(block);
 		}
 		SzArEx_Free(&DB, &g_Alloc);
 	}
 
+	void FreeBlock(FBlock &block)
+	{
+		if (block.OutBuffer != NULL)
+		{
+			IAlloc_Free(&g_Alloc, block.OutBuffer);
+		}
+		block.BlockIndex = 0xFFFFFFFF;
+		block.OutBuffer = NULL;
+		block.OutBufferSize = 0;
+	}
+
 	SRes Open()
 	{
 		return SzArEx_Open(&DB, &LookStream.vt, &g_Alloc, &g_Alloc);
 	}
 
+	FBlock &FindBlock(UInt32 file_index)
+	{
+		UInt32 blockindex = DB.FileToFolder[file_index];
+		FBlock *oldest = &Blocks[0];
+		for (auto &block : Blocks)
+		{
+			if (block.OutBuffer != NULL && block.BlockIndex == blockindex) return block;
+			if (block.OutBuffer == NULL) oldest = &block;
+			else if (oldest->OutBuffer != NULL && block.LastUse < oldest->LastUse) oldest = &block;
+		}
+		return *oldest;
+	}
+
+	void TrimBlocks(const FBlock &current)
+	{
+		size_t total = 0;
+		for (auto &block : Blocks) if (block.OutBuffer != NULL) total += block.OutBufferSize;
+		while (total > MAX_CACHED_BYTES)
+		{
+			FBlock *oldest = nullptr;
+			for (auto &block : Blocks)
+			{
+				if (&block != &current && block.OutBuffer != NULL && (oldest == nullptr || block.LastUse < oldest->LastUse)) oldest = &block;
+			}
+			if (oldest == nullptr) break;
+			total -= oldest->OutBufferSize;
+			FreeBlock(*oldest);
+		}
+	}
+
 	SRes Extract(UInt32 file_index, char *buffer)
 	{
 		size_t offset, out_size_processed;
+		FBlock &block = FindBlock(file_index);
 		SRes res = SzArEx_Extract(&DB, &LookStream.vt, file_index,
-			&BlockIndex, &OutBuffer, &OutBufferSize,
+			&block.BlockIndex, &block.OutBuffer, &block.OutBufferSize,
 			&offset, &out_size_processed,
 			&g_Alloc, &g_Alloc);
+		block.LastUse = ++UseCounter;
 		if (res == SZ_OK)
 		{
-			memcpy(buffer, OutBuffer + offset, out_size_processed);
+			memcpy(buffer, block.OutBuffer + offset, out_size_processed);
+			TrimBlocks(block);
 		}
 		return res;
 	}
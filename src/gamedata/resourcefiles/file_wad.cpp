@@ -53,6 +53,11 @@ public:
 	int	Position;
 
 	int GetFileOffset() { return Position; }
+	const char *PrefetchSource()
+	{
+		const char * buffer = Owner->Reader.GetBuffer();
+		return buffer != NULL && !Compressed ? buffer + Position : NULL;
+	}
 	FileReader *GetReader()
 	{
 		if(!Compressed)
@@ -34,6 +34,9 @@
 */
 
 #include <time.h>
+#include <vector>
+#include <memory>
+#include <zlib.h>
 #include "file_zip.h"
 #include "cmdlib.h"
 #include "templates.h"
@@ -45,6 +48,64 @@
 
 #define BUFREADCOMMENT (0x400)
 
+//==========================================================================
+//
+// Inflates a deflate lump in one go. Both sizes are known up front, so if
+// the compressed data is directly accessible (mapped or in-memory files)
+// zlib can do the whole job in a single call without the buffering of the
+// stream decompressor. Otherwise the compressed data gets read in with a
+// single read.
+//
+// Returns false if the data could not be decompressed this way.
+//
+//==========================================================================
+
+static bool InflateBuffer(char *dest, int destsize, const Bytef *src, int srcsize)
+{
+	z_stream stream = {};
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+
+	stream.next_in = const_cast<Bytef *>(src);
+	stream.avail_in = srcsize;
+	stream.next_out = (Bytef *)dest;
+	stream.avail_out = destsize;
+	int err = inflate(&stream, Z_FINISH);
+	bool complete = stream.avail_out == 0 && (err == Z_STREAM_END || err == Z_OK || err == Z_BUF_ERROR);
+	inflateEnd(&stream);
+	return complete;
+}
+
+static bool InflateZipLump(char *Cache, FileReader &Reader, int LumpSize, int CompressedSize)
+{
+	const Bytef *src;
+	std::unique_ptr<Bytef[]> readbuf;
+	auto pos = Reader.Tell();
+	const char *buffer = Reader.GetBuffer();
+
+	if (CompressedSize <= 0 || pos + CompressedSize > Reader.GetLength()) return false;
+	if (buffer != nullptr)
+	{
+		src = (const Bytef *)buffer + pos;
+	}
+	else
+	{
+		readbuf.reset(new Bytef[CompressedSize]);
+		if (Reader.Read(readbuf.get(), CompressedSize) != CompressedSize)
+		{
+			Reader.Seek(pos, FileReader::SeekSet);
+			return false;
+		}
+		src = readbuf.get();
+	}
+
+	bool complete = InflateBuffer(Cache, LumpSize, src, CompressedSize);
+
+	// Let the stream decompressor deal with anything unusual so errors get reported the normal way.
+	if (!complete) Reader.Seek(pos, FileReader::SeekSet);
+	else Reader.Seek(pos + CompressedSize, FileReader::SeekSet);
+	return complete;
+}
+
 //==========================================================================
 //
 // Decompression subroutine
@@ -64,6 +125,8 @@ static bool UncompressZipLump(char *Cache, FileReader &Reader, int Method, int L
 		}
 
 		case METHOD_DEFLATE:
+			if (InflateZipLump(Cache, Reader, LumpSize, CompressedSize)) break;
+			// fall through
 		case METHOD_BZIP2:
 		case METHOD_LZMA:
 		{
@@ -159,6 +222,31 @@ static uint32_t Zip_FindCentralDir(FileReader &fin)
 	return uPosFound;
 }
 
+//==========================================================================
+//
+// Checks if a name (with the common prefix already stripped) is one of
+// the definition lumps denoting a ZDoom mod. Called for each entry, so
+// this compares in place instead of building the full names.
+//
+//==========================================================================
+
+static bool IsSpecialZipLump(const char *name)
+{
+	static const char *const prefixes[] = { "mapinfo", "zmapinfo", "gameinfo", "sndinfo", "sbarinfo", "menudef", "gldefs", "animdefs",
+		"decorate.", "zscript." };	// DECORATE and ZSCRIPT are common subdirectory names, so those also need an exact match.
+	static const char *const exact[] = { "decorate", "zscript", "maps/" };
+
+	for (auto p : prefixes)
+	{
+		if (strncmp(name, p, strlen(p)) == 0) return true;
+	}
+	for (auto p : exact)
+	{
+		if (strcmp(name, p) == 0) return true;
+	}
+	return false;
+}
+
 //==========================================================================
 //
 // Zip file
@@ -256,7 +344,7 @@ bool FZipFile::Open(bool quiet)
 		}
 		else
 		{
-			if (name.IndexOf(name0) != 0)
+			if (strncmp(name, name0, name0.Len()) != 0)
 			{
 				name0 = "";
 				break;
@@ -264,19 +352,7 @@ bool FZipFile::Open(bool quiet)
 			else if (!foundspeciallump)
 			{
 				// at least one of the more common definition lumps must be present.
-				if (name.IndexOf(name0 + "mapinfo") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "zmapinfo") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "gameinfo") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "sndinfo") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "sbarinfo") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "menudef") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "gldefs") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "animdefs") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "decorate.") == 0) foundspeciallump = true;	// DECORATE is a common subdirectory name, so the check needs to be a bit different.
-				else if (name.Compare(name0 + "decorate") == 0) foundspeciallump = true;
-				else if (name.IndexOf(name0 + "zscript.") == 0) foundspeciallump = true;	// same here.
-				else if (name.Compare(name0 + "zscript") == 0) foundspeciallump = true;
-				else if (name.Compare(name0 + "maps/") == 0) foundspeciallump = true;
+				foundspeciallump = IsSpecialZipLump(name.GetChars() + name0.Len());
 			}
 		}
 	}
@@ -415,6 +491,27 @@ void FZipLump::SetLumpAddress()
 	Flags &= ~LUMPFZIP_NEEDFILESTART;
 }
 
+//==========================================================================
+//
+// Prefetching is only done for directly addressable data of the two
+// methods that cover almost everything in real mods.
+//
+//==========================================================================
+
+const char *FZipLump::PrefetchSource()
+{
+	const char *buffer = Owner->Reader.GetBuffer();
+	if (buffer == NULL || (Method != METHOD_STORED && Method != METHOD_DEFLATE)) return NULL;
+	if (Flags & LUMPFZIP_NEEDFILESTART) SetLumpAddress();
+	if (Position + (long)CompressedSize > Owner->Reader.GetLength()) return NULL;
+	return buffer + Position;
+}
+
+bool FZipLump::PrefetchDecode(const char *source, char *dest)
+{
+	return Method == METHOD_DEFLATE && InflateBuffer(dest, LumpSize, (const Bytef *)source, CompressedSize);
+}
+
 //==========================================================================
 //
 // Get reader (only returns non-NULL if not encrypted)
@@ -619,7 +716,9 @@ bool WriteZip(const char *filename, TArray<FString> &filenames, TArray<FCompress
 	ltime = localtime(&ttime);
 	auto dostime = time_to_dos(ltime);
 
-	TArray<int> positions;
+	// This may run on the background save thread, so it must not allocate through M_Malloc,
+	// whose bookkeeping belongs to the main thread.
+	std::vector<int> positions;
 
 	if (filenames.Size() != content.Size()) return false;
 
@@ -635,7 +734,7 @@ bool WriteZip(const char *filename, TArray<FString> &filenames, TArray<FCompress
 				remove(filename);
 				return false;
 			}
-			positions.Push(pos);
+			positions.push_back(pos);
 		}
 
 		int dirofs = (int)f->Tell();
@@ -24,6 +24,8 @@ struct FZipLump : public FResourceLump
 
 	virtual FileReader *GetReader();
 	virtual int FillCache();
+	virtual const char *PrefetchSource();
+	virtual bool PrefetchDecode(const char *source, char *dest);
 
 private:
 	void SetLumpAddress();
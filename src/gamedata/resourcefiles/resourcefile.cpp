@@ -35,6 +35,10 @@
 */
 
 #include <zlib.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
 #include "resourcefile.h"
 #include "cmdlib.h"
 #include "w_wad.h"
@@ -42,6 +46,9 @@
 #include "doomstat.h"
 #include "doomtype.h"
 #include "md5.h"
+#include "c_cvars.h"
+#include "stats.h"
+#include "templates.h"
 
 
 //==========================================================================
@@ -69,6 +76,225 @@ public:
 };
 
 
+//==========================================================================
+//
+// Cache of released lumps
+//
+// When the last reference to a lump's data goes away the data is kept
+// around for a while in case it gets requested again, which saves
+// decompressing or reading it once more. Those lumps form a list, most
+// recently released first, and the oldest ones get freed when the list
+// grows beyond the configured size.
+//
+//==========================================================================
+
+static std::mutex &LRUMutex = *new std::mutex;	// never destroyed, resource files can get deleted during static destruction
+static FResourceLump *LRUHead, *LRUTail;
+static size_t LRUBytes;
+static unsigned LRUCount, LRUHits, LRUMisses;
+
+static void LRUTrim(size_t limit);
+
+CUSTOM_CVAR(Int, lump_cachesize, 32, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 0) self = 0;
+	else
+	{
+		std::lock_guard<std::mutex> lock(LRUMutex);
+		LRUTrim(size_t(self) << 20);
+	}
+}
+
+static void LRUUnlink(FResourceLump *lump)
+{
+	if (lump->LRUPrev) lump->LRUPrev->LRUNext = lump->LRUNext;
+	else LRUHead = lump->LRUNext;
+	if (lump->LRUNext) lump->LRUNext->LRUPrev = lump->LRUPrev;
+	else LRUTail = lump->LRUPrev;
+	lump->LRUPrev = lump->LRUNext = NULL;
+	LRUBytes -= lump->LumpSize;
+	LRUCount--;
+}
+
+static void LRUTrim(size_t limit)
+{
+	while (LRUTail != NULL && LRUBytes > limit)
+	{
+		auto lump = LRUTail;
+		LRUUnlink(lump);
+		delete[] lump->Cache;
+		lump->Cache = NULL;
+	}
+}
+
+// Takes ownership of a released lump's data.
+static void LRUAdd(FResourceLump *lump)
+{
+	std::lock_guard<std::mutex> lock(LRUMutex);
+	lump->LRUPrev = NULL;
+	lump->LRUNext = LRUHead;
+	if (LRUHead) LRUHead->LRUPrev = lump;
+	else LRUTail = lump;
+	LRUHead = lump;
+	LRUBytes += lump->LumpSize;
+	LRUCount++;
+	LRUTrim(size_t(*lump_cachesize) << 20);
+}
+
+// Gets a lump's data back if it is still in the list.
+static bool LRURemove(FResourceLump *lump)
+{
+	std::lock_guard<std::mutex> lock(LRUMutex);
+	if (lump->Cache == NULL) return false;		// evicted in the meantime
+	LRUUnlink(lump);
+	return true;
+}
+
+ADD_STAT(lumpcache)
+{
+	FString out;
+	out.Format("Released lumps: %u (%zuK of %dK)  Hits: %u  Misses: %u", LRUCount, (LRUBytes + 1023) >> 10, *lump_cachesize << 10, LRUHits, LRUMisses);
+	return out;
+}
+
+//==========================================================================
+//
+// Prefetcher
+//
+// Reads lumps ahead of use on worker threads. This is limited to lumps
+// whose raw data is directly addressable, i.e. comes from a mapped or
+// in-memory archive, so the workers never need the owner's reader.
+// Compressed lumps get decompressed into a buffer that CacheLump picks
+// up; for uncompressed ones the worker only makes sure the data has
+// been paged in.
+//
+//==========================================================================
+
+enum
+{
+	PREFETCH_NONE,
+	PREFETCH_QUEUED,
+	PREFETCH_RUNNING,
+	PREFETCH_DONE,
+
+	PREFETCH_MAXBYTES = 64 << 20	// limit for data that has been requested but not picked up yet
+};
+
+struct FPrefetchJob
+{
+	FResourceLump *Lump;
+	const char *Source;
+};
+
+struct FPrefetcher
+{
+	std::mutex Mutex;
+	std::condition_variable Work, Done;
+	std::deque<FPrefetchJob> Queue;
+	size_t PendingBytes = 0;
+	bool Started = false;
+};
+
+static FPrefetcher &Prefetcher = *new FPrefetcher;	// never destroyed, for the same reason as above
+
+static void PrefetchThread()
+{
+	std::unique_lock<std::mutex> lock(Prefetcher.Mutex);
+	for (;;)
+	{
+		Prefetcher.Work.wait(lock, [] { return !Prefetcher.Queue.empty(); });
+		auto job = Prefetcher.Queue.front();
+		Prefetcher.Queue.pop_front();
+		auto lump = job.Lump;
+		lump->PrefetchState = PREFETCH_RUNNING;
+		lock.unlock();
+
+		char *data = NULL;
+		if (lump->Flags & LUMPF_COMPRESSED)
+		{
+			data = new char[lump->LumpSize];
+			if (!lump->PrefetchDecode(job.Source, data))
+			{
+				delete[] data;
+				data = NULL;
+			}
+		}
+		else
+		{
+			volatile char sink = 0;
+			for (int i = 0; i < lump->LumpSize; i += 4096) sink += job.Source[i];
+		}
+
+		lock.lock();
+		if (data == NULL)
+		{
+			// Nothing to pick up so the lump doesn't need to wait for anyone.
+			Prefetcher.PendingBytes -= lump->LumpSize;
+			lump->PrefetchState = PREFETCH_NONE;
+		}
+		else
+		{
+			lump->PrefetchData = data;
+			lump->PrefetchState = PREFETCH_DONE;
+		}
+		Prefetcher.Done.notify_all();
+	}
+}
+
+// Returns the prefetched data, if there is any, and takes the lump out of the prefetcher.
+static char *TakePrefetched(FResourceLump *lump)
+{
+	std::unique_lock<std::mutex> lock(Prefetcher.Mutex);
+	if (lump->PrefetchState == PREFETCH_QUEUED)
+	{
+		// Not started yet so the caller may just as well read it itself.
+		for (auto it = Prefetcher.Queue.begin(); it != Prefetcher.Queue.end(); ++it)
+		{
+			if (it->Lump == lump)
+			{
+				Prefetcher.Queue.erase(it);
+				break;
+			}
+		}
+		Prefetcher.PendingBytes -= lump->LumpSize;
+		lump->PrefetchState = PREFETCH_NONE;
+		return NULL;
+	}
+	Prefetcher.Done.wait(lock, [=] { return lump->PrefetchState != PREFETCH_RUNNING; });
+	char *data = lump->PrefetchData;
+	if (lump->PrefetchState == PREFETCH_DONE)
+	{
+		Prefetcher.PendingBytes -= lump->LumpSize;
+	}
+	lump->PrefetchData = NULL;
+	lump->PrefetchState = PREFETCH_NONE;
+	return data;
+}
+
+void FResourceLump::QueuePrefetch()
+{
+	if (Cache != NULL || RefCount != 0 || LumpSize <= 0 || PrefetchState != PREFETCH_NONE) return;
+
+	const char *source = PrefetchSource();
+	if (source == NULL) return;
+
+	std::lock_guard<std::mutex> lock(Prefetcher.Mutex);
+	if (Prefetcher.PendingBytes + LumpSize > PREFETCH_MAXBYTES) return;
+	if (!Prefetcher.Started)
+	{
+		unsigned numthreads = clamp<unsigned>(std::thread::hardware_concurrency() / 2, 1, 4);
+		for (unsigned i = 0; i < numthreads; i++)
+		{
+			std::thread(PrefetchThread).detach();
+		}
+		Prefetcher.Started = true;
+	}
+	Prefetcher.Queue.push_back({ this, source });
+	Prefetcher.PendingBytes += LumpSize;
+	PrefetchState = PREFETCH_QUEUED;
+	Prefetcher.Work.notify_one();
+}
+
 //==========================================================================
 //
 // Base class for resource lumps
@@ -77,8 +303,17 @@ public:
 
 FResourceLump::~FResourceLump()
 {
+	if (PrefetchState != PREFETCH_NONE)
+	{
+		delete[] TakePrefetched(this);
+	}
 	if (Cache != NULL && RefCount >= 0)
 	{
+		if (RefCount == 0)
+		{
+			std::lock_guard<std::mutex> lock(LRUMutex);
+			LRUUnlink(this);
+		}
 		delete [] Cache;
 		Cache = NULL;
 	}
@@ -244,9 +479,26 @@ void *FResourceLump::CacheLump()
 	if (Cache != NULL)
 	{
 		if (RefCount > 0) RefCount++;
+		else if (RefCount == 0 && LRURemove(this))
+		{
+			RefCount = 1;
+			LRUHits++;
+			return Cache;
+		}
 	}
-	else if (LumpSize > 0)
+	if (Cache == NULL && LumpSize > 0)
 	{
+		if (PrefetchState != PREFETCH_NONE)
+		{
+			char *data = TakePrefetched(this);
+			if (data != NULL)
+			{
+				Cache = data;
+				RefCount = 1;
+				return Cache;
+			}
+		}
+		LRUMisses++;
 		FillCache();
 	}
 	return Cache;
@@ -264,8 +516,7 @@ int FResourceLump::ReleaseCache()
 	{
 		if (--RefCount == 0)
 		{
-			delete [] Cache;
-			Cache = NULL;
+			LRUAdd(this);
 		}
 	}
 	return RefCount;
@@ -309,7 +560,8 @@ FResourceFile *FResourceFile::OpenResourceFile(const char *filename, FileReader
 FResourceFile *FResourceFile::OpenResourceFile(const char *filename, bool quiet, bool containeronly)
 {
 	FileReader file;
-	if (!file.OpenFile(filename)) return nullptr;
+	// Mapping the file lets uncompressed lumps be served straight from the mapping without being copied.
+	if (!file.OpenFileMapped(filename)) return nullptr;
 	return DoOpenResourceFile(filename, file, quiet, containeronly);
 }
 
@@ -693,6 +945,12 @@ int FUncompressedLump::FillCache()
 	return 1;
 }
 
+const char *FUncompressedLump::PrefetchSource()
+{
+	const char * buffer = Owner->Reader.GetBuffer();
+	return buffer != NULL ? buffer + Position : NULL;
+}
+
 //==========================================================================
 //
 // Base class for uncompressed resource files
@@ -3,6 +3,7 @@
 #ifndef __RESFILE_H
 #define __RESFILE_H
 
+#include <atomic>
 #include "files.h"
 
 class FResourceFile;
@@ -49,6 +50,10 @@ struct FResourceLump
 	FResourceFile *	Owner;
 	FTexture *		LinkedTexture;
 	int				Namespace;
+	FResourceLump *	LRUPrev;		// links for the cache of released lumps
+	FResourceLump *	LRUNext;
+	std::atomic<uint8_t> PrefetchState;	// only changed under the prefetcher's mutex, but also checked without it
+	char *			PrefetchData;	// guarded by the prefetcher's mutex
 
 	FResourceLump()
 	{
@@ -59,6 +64,9 @@ struct FResourceLump
 		Namespace = 0;	// ns_global
 		*Name = 0;
 		LinkedTexture = NULL;
+		LRUPrev = LRUNext = NULL;
+		PrefetchState = 0;
+		PrefetchData = NULL;
 	}
 
 	virtual ~FResourceLump();
@@ -72,6 +80,14 @@ struct FResourceLump
 
 	void *CacheLump();
 	int ReleaseCache();
+	void QueuePrefetch();
+
+	// For the prefetcher. PrefetchSource gets called on the main thread and returns memory
+	// the lump's raw data can be read from without going through the owner's reader, or
+	// NULL if the lump cannot be prefetched. PrefetchDecode gets called on a worker thread
+	// with that memory for compressed lumps and must only use data that does not change.
+	virtual const char *PrefetchSource() { return NULL; }
+	virtual bool PrefetchDecode(const char *source, char *dest) { return false; }
 
 protected:
 	virtual int FillCache() { return -1; }
@@ -130,6 +146,7 @@ struct FUncompressedLump : public FResourceLump
 	virtual FileReader *GetReader();
 	virtual int FillCache();
 	virtual int GetFileOffset() { return Position; }
+	virtual const char *PrefetchSource();
 
 };
 
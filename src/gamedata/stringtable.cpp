@@ -135,7 +135,10 @@ TArray<TArray<FString>> FStringTable::parseCSV(const TArray<uint8_t> &buffer)
 			cell.Push(0);
 			ProcessEscapes(cell.Data());
 			row.Push(cell.Data());
+			unsigned columns = row.Size();
 			data.Push(std::move(row));
+			// Rows of a spreadsheet all have the same number of columns.
+			row.Grow(columns);
 			cell.Clear();
 		}
 		else
@@ -233,6 +236,20 @@ bool FStringTable::ParseLanguageCSV(int lumpnum, const TArray<uint8_t> &buffer)
 			}
 		}
 
+		// Resolve the tables up front instead of looking them up for every single string.
+		// All tables must be created before any pointer is taken because adding a new
+		// language may move the existing ones around in the map.
+		for (auto &langentry : langrows)
+		{
+			allStrings[langentry.second];
+		}
+		TArray<StringMap *> langtables;
+		for (auto &langentry : langrows)
+		{
+			langtables.Push(allStrings.CheckKey(langentry.second));
+		}
+		auto filenum = Wads.GetLumpFile(lumpnum);
+
 		for (unsigned i = 1; i < data.Size(); i++)
 		{
 			auto &row = data[i];
@@ -249,16 +266,16 @@ bool FStringTable::ParseLanguageCSV(int lumpnum, const TArray<uint8_t> &buffer)
 			{
 				DeleteForLabel(lumpnum, strName);
 			}
-			for (auto &langentry : langrows)
+			for (unsigned j = 0; j < langrows.Size(); j++)
 			{
-				auto str = row[langentry.first];
+				auto &str = row[langrows[j].first];
 				if (str.Len() > 0)
 				{
-					InsertString(lumpnum, langentry.second, strName, str);
+					InsertString(filenum, langrows[j].second, *langtables[j], strName, str);
 				}
 				else
 				{
-					DeleteString(langentry.second, strName);
+					langtables[j]->Remove(strName);
 				}
 			}
 		}
@@ -428,9 +445,14 @@ void FStringTable::DeleteForLabel(int lumpnum, FName label)
 //==========================================================================
 
 void FStringTable::InsertString(int lumpnum, int langid, FName label, const FString &string)
+{
+	InsertString(Wads.GetLumpFile(lumpnum), langid, allStrings[langid], label, string);
+}
+
+void FStringTable::InsertString(int filenum, int langid, StringMap &table, FName label, const FString &string)
 {
 	const char *strlangid = (const char *)&langid;
-	TableElement te = { Wads.GetLumpFile(lumpnum), { string, string, string, string } };
+	TableElement te = { filenum, { string, string, string, string } };
 	long index;
 	while ((index = te.strings[0].IndexOf("@[")) >= 0)
 	{
@@ -451,7 +473,7 @@ void FStringTable::InsertString(int lumpnum, int langid, FName label, const FStr
 			te.strings[i].Substitute(replacee, replacement);
 		}
 	}
-	allStrings[langid].Insert(label, te);
+	table.Insert(label, te);
 }
 
 //==========================================================================
@@ -645,13 +667,38 @@ const char *StringMap::MatchString (const char *string) const
 {
 	StringMap::ConstIterator it(*this);
 	StringMap::ConstPair *pair;
+	size_t len = strlen(string);
 
 	while (it.NextPair(pair))
 	{
-		if (pair->Value.strings[0].CompareNoCase(string) == 0)
+		// Strings of different length can never match, so skip the compare for those.
+		if (pair->Value.strings[0].Len() == len && pair->Value.strings[0].CompareNoCase(string) == 0)
 		{
 			return pair->Key.GetChars();
 		}
 	}
 	return nullptr;
 }
+
+//==========================================================================
+//
+// Collects all labels whose string matches in a single pass over the map.
+//
+//==========================================================================
+
+unsigned StringMap::MatchStrings(const char *string, TArray<FName> &matches) const
+{
+	StringMap::ConstIterator it(*this);
+	StringMap::ConstPair *pair;
+	size_t len = strlen(string);
+
+	matches.Clear();
+	while (it.NextPair(pair))
+	{
+		if (pair->Value.strings[0].Len() == len && pair->Value.strings[0].CompareNoCase(string) == 0)
+		{
+			matches.Push(pair->Key);
+		}
+	}
+	return matches.Size();
+}
@@ -58,6 +58,7 @@ class StringMap : public TMap<FName, TableElement>
 {
 public:
 	const char *MatchString(const char *string) const;
+	unsigned MatchStrings(const char *string, TArray<FName> &matches) const;
 };
 
 
@@ -112,6 +113,7 @@ private:
 	bool LoadLanguageFromSpreadsheet(int lumpnum, const TArray<uint8_t> &buffer);
 	bool readMacros(int lumpnum);
 	void InsertString(int lumpnum, int langid, FName label, const FString &string);
+	void InsertString(int filenum, int langid, StringMap &table, FName label, const FString &string);
 	void DeleteString(int langid, FName label);
 	void DeleteForLabel(int lumpnum, FName label);
 
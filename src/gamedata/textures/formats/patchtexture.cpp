@@ -79,16 +79,18 @@ static bool CheckIfPatch(FileReader & file, bool &isalpha)
 {
 	if (file.GetLength() < 13) return false;	// minimum length of a valid Doom patch
 	
+	// Every lump in the global namespace gets checked here at startup, so look at the
+	// header first and only read the whole lump if it might actually be a patch.
 	file.Seek(0, FileReader::SeekSet);
-	auto data = file.Read(file.GetLength());
-	
-	const patch_t *foo = (const patch_t *)data.Data();
-	
-	int height = LittleShort(foo->height);
-	int width = LittleShort(foo->width);
+	int width = file.ReadInt16();
+	int height = file.ReadInt16();
 	
 	if (height > 0 && height <= 2048 && width > 0 && width <= 2048 && width < file.GetLength()/4)
 	{
+		file.Seek(0, FileReader::SeekSet);
+		auto data = file.Read(file.GetLength());
+		const patch_t *foo = (const patch_t *)data.Data();
+
 		// The dimensions seem like they might be valid for a patch, so
 		// check the column directory for extra security. At least one
 		// column must begin exactly at the end of the column directory,
@@ -44,6 +44,12 @@
 #include "xbr/xbrz_old.h"
 #include "parallel_for.h"
 #include "hwrenderer/textures/hw_material.h"
+#include "m_misc.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "md5.h"
+#include <zlib.h>
+#include <memory>
 
 EXTERN_CVAR(Int, gl_texture_hqresizemult)
 CUSTOM_CVAR(Int, gl_texture_hqresizemode, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_NOINITCALL)
@@ -122,6 +128,111 @@ XBRZ_CVAR(steepdirectionthreshold, 2.2f)
 
 #undef XBRZ_CVAR
 
+CVAR(Bool, gl_texture_hqresize_diskcache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+//===========================================================================
+//
+// Disk cache for upscaled textures
+//
+// The scalers always produce the same output for the same input buffer
+// and settings, so the results get stored under a hash of both in the
+// cache directory. Small images are scaled faster than the file could be
+// opened so they are left out. This can get called from the precacher's
+// worker threads so it must not use anything that isn't thread safe.
+//
+//===========================================================================
+
+enum
+{
+	HQCACHE_MINPIXELS = 32 * 32,
+	HQCACHE_VERSION = 1,
+};
+
+static const FString &UpscaleCachePath()
+{
+	static const FString path = []()
+	{
+		FString p = M_GetCachePath(true);
+		p << "/hqresize";
+		CreatePath(p);
+		return p;
+	}();
+	return path;
+}
+
+static FString UpscaleCacheName(const unsigned char *buffer, int width, int height, int type, int mult)
+{
+	MD5Context md5;
+	int32_t settings[] = { HQCACHE_VERSION, width, height, type, mult, xbrz_colorformat };
+	float xbrzsettings[] = { xbrz_luminanceweight, xbrz_equalcolortolerance, xbrz_centerdirectionbias,
+		xbrz_dominantdirectionthreshold, xbrz_steepdirectionthreshold };
+
+	md5.Update((const uint8_t *)settings, sizeof(settings));
+	if (type == 4 || type == 5) md5.Update((const uint8_t *)xbrzsettings, sizeof(xbrzsettings));
+	md5.Update(buffer, width * height * 4);
+
+	uint8_t digest[16];
+	md5.Final(digest);
+
+	// Copying the shared FString would touch its refcount, which is not thread safe.
+	FString name(UpscaleCachePath().GetChars());
+	name << '/';
+	for (auto b : digest) name.AppendFormat("%02x", b);
+	return name;
+}
+
+static bool ReadUpscaleCache(const FString &filename, FTextureBuffer &texbuffer, int outWidth, int outHeight)
+{
+	FileReader fr;
+	if (!fr.OpenFile(filename)) return false;
+
+	uint32_t header[3];
+	if (fr.Read(header, sizeof(header)) != (long)sizeof(header)) return false;
+	if (LittleLong(header[0]) != (uint32_t)outWidth || LittleLong(header[1]) != (uint32_t)outHeight) return false;
+
+	uLongf unpacked = outWidth * outHeight * 4;
+	uLong packed = LittleLong(header[2]);
+	if ((long)packed != fr.GetLength() - (long)sizeof(header)) return false;
+
+	std::unique_ptr<Bytef[]> source(new Bytef[packed]);
+	auto newBuffer = new unsigned char[unpacked];
+	if (fr.Read(source.get(), packed) != (long)packed ||
+		uncompress(newBuffer, &unpacked, source.get(), packed) != Z_OK || unpacked != uLongf(outWidth * outHeight * 4))
+	{
+		delete[] newBuffer;
+		return false;
+	}
+	delete[] texbuffer.mBuffer;
+	texbuffer.mBuffer = newBuffer;
+	texbuffer.mWidth = outWidth;
+	texbuffer.mHeight = outHeight;
+	return true;
+}
+
+static void WriteUpscaleCache(const FString &filename, const FTextureBuffer &texbuffer)
+{
+	uLong size = texbuffer.mWidth * texbuffer.mHeight * 4;
+	uLongf packed = compressBound(size);
+	std::unique_ptr<Bytef[]> dest(new Bytef[packed]);
+
+	// Speed matters more than size here, this is read back on every launch.
+	if (compress2(dest.get(), &packed, texbuffer.mBuffer, size, 1) != Z_OK) return;
+
+	// Write to a temporary first so that another thread or another instance never sees a partial file.
+	FString tempname;
+	tempname.Format("%s.%p.tmp", filename.GetChars(), (void *)&texbuffer);
+	auto fw = FileWriter::Open(tempname);
+	if (fw == nullptr) return;
+
+	uint32_t header[] = { LittleLong(uint32_t(texbuffer.mWidth)), LittleLong(uint32_t(texbuffer.mHeight)), LittleLong(uint32_t(packed)) };
+	bool ok = fw->Write(header, sizeof(header)) == sizeof(header) && fw->Write(dest.get(), packed) == packed;
+	delete fw;
+	if (!ok || rename(tempname, filename) != 0)
+	{
+		remove(tempname);
+	}
+}
+
 static void scale2x ( uint32_t* inputBuffer, uint32_t* outputBuffer, int inWidth, int inHeight )
 {
 	const int width = 2* inWidth;
@@ -286,13 +397,9 @@ static unsigned char *hqNxAsmHelper( void (*hqNxFunction) ( int*, unsigned char*
 	outWidth = N * inWidth;
 	outHeight = N *inHeight;
 
-	static int initdone = false;
-
-	if (!initdone)
-	{
-		HQnX_asm::InitLUTs();
-		initdone = true;
-	}
+	// This may get called from the precacher's worker threads.
+	static bool initdone = (HQnX_asm::InitLUTs(), true);
+	(void)initdone;
 
 	HQnX_asm::CImage cImageIn;
 	cImageIn.SetImage(inputBuffer, inWidth, inHeight, 32);
@@ -313,13 +420,9 @@ static unsigned char *hqNxHelper( void (HQX_CALLCONV *hqNxFunction) ( unsigned*,
 							  int &outWidth,
 							  int &outHeight )
 {
-	static int initdone = false;
-
-	if (!initdone)
-	{
-		hqxInit();
-		initdone = true;
-	}
+	// This may get called from the precacher's worker threads.
+	static bool initdone = (hqxInit(), true);
+	(void)initdone;
 	outWidth = N * inWidth;
 	outHeight = N *inHeight;
 
@@ -458,7 +561,17 @@ void FTexture::CreateUpsampledTextureBuffer(FTextureBuffer &texbuffer, bool hasA
 
 	if (!checkonly)
 	{
-		if (type == 1)
+		FString cachefile;
+		if (gl_texture_hqresize_diskcache && inWidth * inHeight >= HQCACHE_MINPIXELS)
+		{
+			cachefile = UpscaleCacheName(texbuffer.mBuffer, inWidth, inHeight, type, mult);
+		}
+
+		if (cachefile.IsNotEmpty() && ReadUpscaleCache(cachefile, texbuffer, inWidth * mult, inHeight * mult))
+		{
+			cachefile = "";	// nothing to write back.
+		}
+		else if (type == 1)
 		{
 			if (mult == 2)
 				texbuffer.mBuffer = scaleNxHelper(&scale2x, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
@@ -498,6 +611,11 @@ void FTexture::CreateUpsampledTextureBuffer(FTextureBuffer &texbuffer, bool hasA
 			texbuffer.mBuffer = normalNxHelper(&normalNx, mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
 		else
 			return;
+
+		if (cachefile.IsNotEmpty())
+		{
+			WriteUpscaleCache(cachefile, texbuffer);
+		}
 	}
 	else
 	{
@@ -39,8 +39,10 @@
 #include "image.h"
 #include "w_wad.h"
 #include "files.h"
+#include "c_cvars.h"
+#include "stats.h"
 
-FMemArena FImageSource::ImageArena(32768);
+FMemArena FImageSource::ImageArena(32768, "Images");
 TArray<FImageSource *>FImageSource::ImageForLump;
 int FImageSource::NextID;
 static PrecacheInfo precacheInfo;
@@ -64,6 +66,125 @@ struct PrecacheDataRgba
 TArray<PrecacheDataPaletted> precacheDataPaletted;
 TArray<PrecacheDataRgba> precacheDataRgba;
 
+//===========================================================================
+//
+// Image cache
+//
+// Outside of precaching, every user of an image decodes it again. This
+// keeps the untranslated true color bitmaps of images that have been
+// decoded more than once, least recently used first out, within a
+// memory budget. Images that were only needed once never get stored,
+// so the first decode does not pay for a copy that may never be used.
+//
+//===========================================================================
+
+struct FImageCacheEntry
+{
+	FImageCacheEntry *Prev, *Next;
+	int ImageID;
+	int TransInfo;
+	FBitmap Pixels;
+};
+
+static TMap<int, FImageCacheEntry *> ImageCache;
+static TMap<int, bool> ImagesDecoded;
+static FImageCacheEntry *ImageCacheHead, *ImageCacheTail;
+static size_t ImageCacheBytes;
+static unsigned ImageCacheHits, ImageCacheMisses, ImageCacheRedundant;
+
+static void ImageCacheTrim(size_t budget);
+
+CUSTOM_CVAR(Int, r_imagecachesize, 64, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 0) self = 0;
+	else ImageCacheTrim(size_t(self) << 20);
+}
+
+static size_t ImageCacheSize(const FImageCacheEntry *entry)
+{
+	return size_t(entry->Pixels.GetPitch()) * entry->Pixels.GetHeight();
+}
+
+static void ImageCacheUnlink(FImageCacheEntry *entry)
+{
+	if (entry->Prev) entry->Prev->Next = entry->Next;
+	else ImageCacheHead = entry->Next;
+	if (entry->Next) entry->Next->Prev = entry->Prev;
+	else ImageCacheTail = entry->Prev;
+}
+
+static void ImageCacheLinkFront(FImageCacheEntry *entry)
+{
+	entry->Prev = nullptr;
+	entry->Next = ImageCacheHead;
+	if (ImageCacheHead) ImageCacheHead->Prev = entry;
+	else ImageCacheTail = entry;
+	ImageCacheHead = entry;
+}
+
+static void ImageCacheTrim(size_t budget)
+{
+	while (ImageCacheTail != nullptr && ImageCacheBytes > budget)
+	{
+		auto entry = ImageCacheTail;
+		ImageCacheUnlink(entry);
+		ImageCacheBytes -= ImageCacheSize(entry);
+		ImageCache.Remove(entry->ImageID);
+		delete entry;
+	}
+}
+
+static bool ImageCacheFind(int imageID, FBitmap &bmp, int &trans)
+{
+	auto pentry = ImageCache.CheckKey(imageID);
+	if (pentry == nullptr) return false;
+
+	auto entry = *pentry;
+	ImageCacheUnlink(entry);
+	ImageCacheLinkFront(entry);
+	bmp.Copy(entry->Pixels);
+	trans = entry->TransInfo;
+	ImageCacheHits++;
+	return true;
+}
+
+static void ImageCacheStore(int imageID, const FBitmap &bmp, int trans)
+{
+	ImageCacheMisses++;
+	if (!ImagesDecoded.CheckKey(imageID))
+	{
+		ImagesDecoded.Insert(imageID, true);
+		return;
+	}
+	ImageCacheRedundant++;
+
+	size_t budget = size_t(*r_imagecachesize) << 20;
+	if (size_t(bmp.GetPitch()) * bmp.GetHeight() > budget / 4) return;	// don't let single images flush the entire cache.
+
+	auto entry = new FImageCacheEntry;
+	entry->ImageID = imageID;
+	entry->TransInfo = trans;
+	entry->Pixels.Copy(bmp);
+	ImageCache.Insert(imageID, entry);
+	ImageCacheLinkFront(entry);
+	ImageCacheBytes += ImageCacheSize(entry);
+	ImageCacheTrim(budget);
+}
+
+void FImageSource::ClearImageCache()
+{
+	ImageCacheTrim(0);
+	ImagesDecoded.Clear();
+}
+
+ADD_STAT(imagecache)
+{
+	FString out;
+	out.Format("Cached images: %u (%zuK of %dK)  Hits: %u  Misses: %u  Repeated decodes: %u",
+		ImageCache.CountUsed(), (ImageCacheBytes + 1023) >> 10, *r_imagecachesize << 10, ImageCacheHits, ImageCacheMisses, ImageCacheRedundant);
+	return out;
+}
+
 //===========================================================================
 // 
 // the default just returns an empty texture.
@@ -251,8 +372,12 @@ FBitmap FImageSource::GetCachedBitmap(PalEntry *remap, int conversion, int *ptra
 			{
 				// This is either the only copy needed or some access outside the caching block. In these cases create a new one and directly return it.
 				//Printf("returning fresh copy of %s\n", name.GetChars());
-				ret.Create(Width, Height);
-				trans = CopyPixels(&ret, conversion);
+				if (conversion != normal || !ImageCacheFind(imageID, ret, trans))
+				{
+					ret.Create(Width, Height);
+					trans = CopyPixels(&ret, conversion);
+					if (conversion == normal) ImageCacheStore(imageID, ret, trans);
+				}
 			}
 			else
 			{
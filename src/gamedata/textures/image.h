@@ -78,7 +78,8 @@ public:
 	// Unlile for paletted images there is no variant here that returns a persistent bitmap, because all users have to process the returned image into another format.
 	FBitmap GetCachedBitmap(PalEntry *remap, int conversion, int *trans = nullptr);
 
-	static void ClearImages() { ImageArena.FreeAll(); ImageForLump.Clear(); NextID = 0; }
+	static void ClearImageCache();
+	static void ClearImages() { ClearImageCache(); ImageArena.FreeAll(); ImageForLump.Clear(); NextID = 0; }
 	static FImageSource * GetImage(int lumpnum, ETextureType usetype);
 
 
@@ -684,8 +684,32 @@ bool FTexture::ProcessData(unsigned char * buffer, int w, int h, bool ispatch)
 
 FTextureBuffer FTexture::CreateTexBuffer(int translation, int flags)
 {
+	int exx = !!(flags & CTF_Expand);
+	if (translation <= 0 && PreparedFlags[exx] == flags)
+	{
+		PreparedFlags[exx] = -1;
+		return std::move(PreparedBuffer[exx]);
+	}
+
 	FTextureBuffer result;
+	bool hasAlpha;
+
+	if (DecodeTexBuffer(result, translation, flags, hasAlpha))
+	{
+		PostProcessTexBuffer(result, hasAlpha, !!(flags & CTF_CheckOnly));
+	}
+	return result;
+}
 
+//===========================================================================
+// 
+//	Reads the image data into the buffer. Returns true if the result still
+//	needs to go through PostProcessTexBuffer.
+//
+//===========================================================================
+
+bool FTexture::DecodeTexBuffer(FTextureBuffer &result, int translation, int flags, bool &hasAlpha)
+{
 	unsigned char * buffer = nullptr;
 	int W, H;
 	int isTransparent = -1;
@@ -694,7 +718,7 @@ FTextureBuffer FTexture::CreateTexBuffer(int translation, int flags)
 	if (flags & CTF_CheckHires)
 	{
 		// No image means that this cannot be checked,
-		if (GetImage() && LoadHiresTexture(result, checkonly)) return result;
+		if (GetImage() && LoadHiresTexture(result, checkonly)) return false;
 	}
 	int exx = !!(flags & CTF_Expand);
 
@@ -739,15 +763,47 @@ FTextureBuffer FTexture::CreateTexBuffer(int translation, int flags)
 	result.mBuffer = buffer;
 	result.mWidth = W;
 	result.mHeight = H;
+	hasAlpha = !!isTransparent;
 
 	// Only do postprocessing for image-backed textures. (i.e. not for the burn texture which can also pass through here.)
-	if (GetImage() && flags & CTF_ProcessData) 
+	return GetImage() && (flags & CTF_ProcessData);
+}
+
+//===========================================================================
+// 
+//	Upscaling and edge processing. This only works on the buffer and the
+//	texture's own mask info so it may run off the main thread, as long as
+//	no other thread is processing the same texture at the same time.
+//
+//===========================================================================
+
+void FTexture::PostProcessTexBuffer(FTextureBuffer &result, bool hasAlpha, bool checkonly)
+{
+	CreateUpsampledTextureBuffer(result, hasAlpha, checkonly);
+	if (!checkonly) ProcessData(result.mBuffer, result.mWidth, result.mHeight, false);
+}
+
+//===========================================================================
+// 
+//	Hands a buffer to the next CreateTexBuffer call with the same flags.
+//
+//===========================================================================
+
+void FTexture::SetPreparedTexBuffer(int flags, FTextureBuffer &&buffer)
+{
+	int exx = !!(flags & CTF_Expand);
+	FTextureBuffer discard = std::move(PreparedBuffer[exx]);	// the move assignment does not free the old buffer.
+	PreparedBuffer[exx] = std::move(buffer);
+	PreparedFlags[exx] = flags;
+}
+
+void FTexture::DiscardPreparedTexBuffers()
+{
+	for (int i = 0; i < 2; i++)
 	{
-		CreateUpsampledTextureBuffer(result, !!isTransparent, checkonly);
-		if (!checkonly) ProcessData(result.mBuffer, result.mWidth, result.mHeight, false);
+		FTextureBuffer discard = std::move(PreparedBuffer[i]);
+		PreparedFlags[i] = -1;
 	}
-
-	return result;
 }
 
 //===========================================================================
@@ -588,32 +588,48 @@ void FTextureManager::AddGroup(int wadnum, int ns, ETextureType usetype)
 	int firsttx = Wads.GetFirstLump(wadnum);
 	int lasttx = Wads.GetLastLump(wadnum);
 	FString Name;
+	TArray<int> lumps;
+	TArray<FString> names;
 
 	// Go from first to last so that ANIMDEFS work as expected. However,
 	// to avoid duplicates (and to keep earlier entries from overriding
 	// later ones), the texture is only inserted if it is the one returned
 	// by doing a check by name in the list of wads.
+	// The names get collected first so that they can be checked in one batch.
 
 	for (; firsttx <= lasttx; ++firsttx)
 	{
 		if (Wads.GetLumpNamespace(firsttx) == ns)
 		{
 			Wads.GetLumpName (Name, firsttx);
+		}
+		else if (!(ns == ns_flats && Wads.GetLumpFlags(firsttx) & LUMPF_MAYBEFLAT))
+		{
+			continue;
+		}
+		lumps.Push(firsttx);
+		names.Push(Name);
+	}
+
+	TArray<const char *> namelist(names.Size(), true);
+	TArray<int> found(names.Size(), true);
+	for (unsigned i = 0; i < names.Size(); i++) namelist[i] = names[i].GetChars();
+	Wads.CheckNumForNames(namelist.Data(), namelist.Size(), ns, found.Data());
 
-			if (Wads.CheckNumForName (Name, ns) == firsttx)
+	for (unsigned i = 0; i < lumps.Size(); i++)
+	{
+		if (Wads.GetLumpNamespace(lumps[i]) == ns)
+		{
+			if (found[i] == lumps[i])
 			{
-				CreateTexture (firsttx, usetype);
+				CreateTexture (lumps[i], usetype);
 			}
-			StartScreen->Progress();
 		}
-		else if (ns == ns_flats && Wads.GetLumpFlags(firsttx) & LUMPF_MAYBEFLAT)
+		else if (found[i] < lumps[i])
 		{
-			if (Wads.CheckNumForName (Name, ns) < firsttx)
-			{
-				CreateTexture (firsttx, usetype);
-			}
-			StartScreen->Progress();
+			CreateTexture (lumps[i], usetype);
 		}
+		StartScreen->Progress();
 	}
 }
 
@@ -322,6 +322,12 @@ public:
 	int GetDisplayTopOffset() { return GetScaledTopOffset(0); }
 	double GetDisplayLeftOffsetDouble() { return GetScaledLeftOffsetDouble(0); }
 	double GetDisplayTopOffsetDouble() { return GetScaledTopOffsetDouble(0); }
+	// The area the hardware renderer draws this as a sprite in, at most. This includes the empty
+	// frame FMaterial may add for texture filtering, so it is available before the material is.
+	double GetSpriteLeftOffsetHW() { return (GetLeftOffsetHW() + 1) / Scale.X; }
+	double GetSpriteTopOffsetHW() { return (GetTopOffsetHW() + 1) / Scale.Y; }
+	double GetSpriteWidthHW() { return (Width + 2) / Scale.X; }
+	double GetSpriteHeightHW() { return (Height + 2) / Scale.Y; }
 	
 	
 	bool isValid() const { return UseType != ETextureType::Null; }
@@ -499,9 +505,17 @@ protected:
 
 public:
 	FTextureBuffer CreateTexBuffer(int translation, int flags = 0);
+	bool DecodeTexBuffer(FTextureBuffer &result, int translation, int flags, bool &hasAlpha);
+	void PostProcessTexBuffer(FTextureBuffer &result, bool hasAlpha, bool checkonly);
+	void SetPreparedTexBuffer(int flags, FTextureBuffer &&buffer);
+	void DiscardPreparedTexBuffers();
 	bool GetTranslucency();
 
 private:
+	// Untranslated buffers that were built ahead of time by the precacher, indexed by CTF_Expand.
+	FTextureBuffer PreparedBuffer[2];
+	int PreparedFlags[2] = { -1, -1 };
+
 	int CheckDDPK3();
 	int CheckExternalFile(bool & hascolorkey);
 	bool LoadHiresTexture(FTextureBuffer &texbuffer, bool checkonly);
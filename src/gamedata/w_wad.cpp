@@ -39,6 +39,11 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
 
 #include "doomtype.h"
 #include "m_argv.h"
@@ -52,6 +57,9 @@
 #include "md5.h"
 #include "doomstat.h"
 #include "vm.h"
+#include "m_swap.h"
+#include "templates.h"
+#include "stats.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -123,6 +131,126 @@ void FWadCollection::DeleteAll ()
 	Files.Clear();
 }
 
+//==========================================================================
+//
+// FArchivePreloader
+//
+// Opens the files of a load list on worker threads and reads in the parts
+// of them the directory parsers are going to access, so that the I/O for
+// all files overlaps. The archives themselves are still set up one by one
+// on the main thread in load order, since that code prints and uses the
+// engine's allocators.
+//
+//==========================================================================
+
+class FArchivePreloader
+{
+	const TArray<FString> &Filenames;
+	std::vector<FileReader> Readers;
+	std::vector<bool> Done;
+	std::mutex Lock;
+	std::condition_variable Ready;
+	std::atomic<unsigned> Next{ 0 };
+	std::vector<std::thread> Threads;
+
+	static void Touch(FileReader &fr, long pos, long len)
+	{
+		const char *buffer = fr.GetBuffer();
+		long size = fr.GetLength();
+		if (pos < 0 || pos >= size) return;
+		len = MIN(len, size - pos);
+		if (len <= 0) return;
+		if (buffer != nullptr)
+		{
+			// Mapped files only need one access per page to get them loaded.
+			volatile char sink = 0;
+			for (long i = 0; i < len; i += 4096) sink += buffer[pos + i];
+			sink += buffer[pos + len - 1];
+		}
+		else
+		{
+			char scratch[16384];
+			fr.Seek(pos, FileReader::SeekSet);
+			while (len > 0 && fr.Read(scratch, MIN<long>(len, sizeof(scratch))) > 0) len -= sizeof(scratch);
+		}
+	}
+
+	static void Prefetch(FileReader &fr)
+	{
+		uint32_t header[3];
+		long size = fr.GetLength();
+
+		if (fr.Read(header, sizeof(header)) != sizeof(header)) return;
+		if (!memcmp(header, "IWAD", 4) || !memcmp(header, "PWAD", 4))
+		{
+			Touch(fr, LittleLong(header[2]), long(LittleLong(header[1])) * 16);
+		}
+		else if (!memcmp(header, "PK\x3\x4", 4))
+		{
+			// Find the end of central directory record which says where the directory is.
+			char tail[1024];
+			long tailpos = MAX(0l, size - long(sizeof(tail)));
+			long taillen = size - tailpos;
+			fr.Seek(tailpos, FileReader::SeekSet);
+			if (fr.Read(tail, taillen) != taillen) return;
+			for (long i = taillen - 22; i >= 0; i--)
+			{
+				if (!memcmp(tail + i, "PK\x5\x6", 4))
+				{
+					uint32_t dirsize, dirofs;
+					memcpy(&dirsize, tail + i + 12, 4);
+					memcpy(&dirofs, tail + i + 16, 4);
+					Touch(fr, LittleLong(dirofs), LittleLong(dirsize));
+					break;
+				}
+			}
+		}
+		fr.Seek(0, FileReader::SeekSet);
+	}
+
+	void Work()
+	{
+		unsigned i;
+		while ((i = Next++) < Filenames.Size())
+		{
+			FileReader fr;
+			bool isdir;
+			if (DirEntryExists(Filenames[i], &isdir) && !isdir && fr.OpenFileMapped(Filenames[i]))
+			{
+				Prefetch(fr);
+			}
+			std::lock_guard<std::mutex> lock(Lock);
+			Readers[i] = std::move(fr);
+			Done[i] = true;
+			Ready.notify_all();
+		}
+	}
+
+public:
+	FArchivePreloader(const TArray<FString> &filenames)
+		: Filenames(filenames), Readers(filenames.Size()), Done(filenames.Size())
+	{
+		unsigned numthreads = MIN(MAX(1u, std::thread::hardware_concurrency()), MIN(filenames.Size(), 8u));
+		for (unsigned i = 0; i < numthreads; i++)
+		{
+			Threads.emplace_back([this] { Work(); });
+		}
+	}
+
+	~FArchivePreloader()
+	{
+		Next = Filenames.Size();
+		for (auto &thread : Threads) thread.join();
+	}
+
+	FileReader Get(unsigned i)
+	{
+		std::unique_lock<std::mutex> lock(Lock);
+		Ready.wait(lock, [&] { return Done[i]; });
+		return std::move(Readers[i]);
+	}
+};
+
 //==========================================================================
 //
 // W_InitMultipleFiles
@@ -142,10 +270,13 @@ void FWadCollection::InitMultipleFiles (TArray<FString> &filenames, const TArray
 	DeleteAll();
 	numfiles = 0;
 
+	FArchivePreloader preloader(filenames);
 	for(unsigned i=0;i<filenames.Size(); i++)
 	{
 		int baselump = NumLumps;
-		AddFile (filenames[i]);
+		FileReader reader = preloader.Get(i);
+		if (reader.isOpen()) AddFile (filenames[i], &reader);
+		else AddFile (filenames[i]);	// let AddFile deal with directories and report errors
 		
 		if (i == (unsigned)MaxIwadIndex) MoveLumpsInFolder("after_iwad/");
 		FStringf path("filter/%s", Files.Last()->GetHash().GetChars());
@@ -162,13 +293,11 @@ void FWadCollection::InitMultipleFiles (TArray<FString> &filenames, const TArray
 	FixMacHexen();
 
 	// [RH] Set up hash table
-	Hashes.Resize(6 * NumLumps);
-	FirstLumpIndex = &Hashes[0];
-	NextLumpIndex = &Hashes[NumLumps];
-	FirstLumpIndex_FullName = &Hashes[NumLumps*2];
-	NextLumpIndex_FullName = &Hashes[NumLumps*3];
-	FirstLumpIndex_NoExt = &Hashes[NumLumps*4];
-	NextLumpIndex_NoExt = &Hashes[NumLumps*5];
+	Hashes.Resize(4 * NumLumps);
+	FirstLumpIndex_FullName = &Hashes[0];
+	NextLumpIndex_FullName = &Hashes[NumLumps];
+	FirstLumpIndex_NoExt = &Hashes[NumLumps*2];
+	NextLumpIndex_NoExt = &Hashes[NumLumps*3];
 	InitHashChains ();
 	LumpInfo.ShrinkToFit();
 	Files.ShrinkToFit();
@@ -220,7 +349,7 @@ void FWadCollection::AddFile (const char *filename, FileReader *wadr)
 
 		if (!isdir)
 		{
-			if (!wadreader.OpenFile(filename))
+			if (!wadreader.OpenFileMapped(filename))
 			{ // Didn't find file
 				Printf (TEXTCOLOR_RED "%s: File not found\n", filename);
 				PrintLastError ();
@@ -406,7 +535,6 @@ int FWadCollection::CheckNumForName (const char *name, int space)
 		char uname[8];
 		uint64_t qname;
 	};
-	uint32_t i;
 
 	if (name == NULL)
 	{
@@ -421,24 +549,38 @@ int FWadCollection::CheckNumForName (const char *name, int space)
 	}
 
 	uppercopy (uname, name);
-	i = FirstLumpIndex[LumpNameHash (uname) % NumLumps];
+	return LookupName (qname, LumpNameHash (uname), space);
+}
 
-	while (i != NULL_INDEX)
+int FWadCollection::LookupName (uint64_t qname, uint32_t namehash, int space) const
+{
+	uint32_t i = NULL_INDEX;
+
+	for (uint32_t slot = NameKey (namehash, space); NameTable[slot].Lump != NULL_INDEX; slot = (slot + 1) & NameTableMask)
 	{
-		FResourceLump *lump = LumpInfo[i].lump;
+		if (NameTable[slot].qwName == qname && NameTable[slot].Namespace == space)
+		{
+			i = NameTable[slot].Lump;
+			break;
+		}
+	}
 
-		if (lump->qwName == qname)
+	// If the lump is from one of the special namespaces exclusive to Zips
+	// the check has to be done differently:
+	// If we find a lump with this name in the global namespace that does not come
+	// from a Zip return that. WADs don't know these namespaces and single lumps must
+	// work as well. Whichever of the two comes later in the load order wins.
+	if (space > ns_specialzipdirectory)
+	{
+		for (uint32_t slot = NameKey (namehash, ns_global); NameTable[slot].Lump != NULL_INDEX; slot = (slot + 1) & NameTableMask)
 		{
-			if (lump->Namespace == space) break;
-			// If the lump is from one of the special namespaces exclusive to Zips
-			// the check has to be done differently:
-			// If we find a lump with this name in the global namespace that does not come
-			// from a Zip return that. WADs don't know these namespaces and single lumps must
-			// work as well.
-			if (space > ns_specialzipdirectory && lump->Namespace == ns_global && 
-				!(lump->Flags & LUMPF_ZIPFILE)) break;
+			auto &entry = NameTable[slot];
+			if (entry.qwName == qname && entry.Namespace == ns_global && !(LumpInfo[entry.Lump].lump->Flags & LUMPF_ZIPFILE))
+			{
+				if (i == NULL_INDEX || entry.Lump > i) i = entry.Lump;
+				break;
+			}
 		}
-		i = NextLumpIndex[i];
 	}
 
 	return i != NULL_INDEX ? i : -1;
@@ -446,13 +588,11 @@ int FWadCollection::CheckNumForName (const char *name, int space)
 
 int FWadCollection::CheckNumForName (const char *name, int space, int wadnum, bool exact)
 {
-	FResourceLump *lump;
 	union
 	{
 		char uname[8];
 		uint64_t qname;
 	};
-	uint32_t i;
 
 	if (wadnum < 0)
 	{
@@ -460,20 +600,59 @@ int FWadCollection::CheckNumForName (const char *name, int space, int wadnum, bo
 	}
 
 	uppercopy (uname, name);
-	i = FirstLumpIndex[LumpNameHash (uname) % NumLumps];
 
 	// If exact is true if will only find lumps in the same WAD, otherwise
 	// also those in earlier WADs.
 
-	while (i != NULL_INDEX &&
-		(lump = LumpInfo[i].lump, lump->qwName != qname ||
-		lump->Namespace != space ||
-		 (exact? (LumpInfo[i].wadnum != wadnum) : (LumpInfo[i].wadnum > wadnum)) ))
+	for (uint32_t slot = NameKey (LumpNameHash (uname), space); NameTable[slot].Lump != NULL_INDEX; slot = (slot + 1) & NameTableMask)
 	{
-		i = NextLumpIndex[i];
+		auto &entry = NameTable[slot];
+		if (entry.qwName == qname && entry.Namespace == space)
+		{
+			int entrywad = LumpInfo[entry.Lump].wadnum;
+			if (exact ? (entrywad == wadnum) : (entrywad <= wadnum)) return entry.Lump;
+		}
 	}
+	return -1;
+}
 
-	return i != NULL_INDEX ? i : -1;
+//==========================================================================
+//
+// CheckNumForNames
+//
+// Looks up a whole list of short names in one namespace. The names get
+// hashed in chunks before the table is accessed so that the lookups of
+// a chunk do not depend on each other.
+//
+//==========================================================================
+
+void FWadCollection::CheckNumForNames (const char *const *names, int count, int space, int *results)
+{
+	enum { CHUNK = 64 };
+	union
+	{
+		char uname[8];
+		uint64_t qname;
+	} keys[CHUNK];
+	uint32_t hashes[CHUNK];
+	bool valid[CHUNK];
+
+	for (int base = 0; base < count; base += CHUNK)
+	{
+		int n = MIN<int>(CHUNK, count - base);
+		for (int k = 0; k < n; k++)
+		{
+			const char *name = names[base + k];
+			valid[k] = name != nullptr && (strlen(name) <= 8 || !strpbrk(name, "/."));
+			if (!valid[k]) continue;
+			uppercopy (keys[k].uname, name);
+			hashes[k] = LumpNameHash (keys[k].uname);
+		}
+		for (int k = 0; k < n; k++)
+		{
+			results[base + k] = valid[k] ? LookupName (keys[k].qname, hashes[k], space) : -1;
+		}
+	}
 }
 
 DEFINE_ACTION_FUNCTION(_Wads, CheckNumForName)
@@ -718,23 +897,31 @@ void FWadCollection::InitHashChains (void)
 	char name[8];
 	unsigned int i, j;
 
+	// Keep the name table at most half full.
+	uint32_t size = 16;
+	while (size < NumLumps * 2) size <<= 1;
+	NameTable.Resize(size);
+	NameTableMask = size - 1;
+	for (auto &slot : NameTable) slot.Lump = NULL_INDEX;
+
+	// Insert the names backwards so that later lumps come first when probing.
+	for (i = NumLumps; i-- > 0; )
+	{
+		auto lump = LumpInfo[i].lump;
+		uppercopy (name, lump->Name);
+		for (j = NameKey (LumpNameHash (name), lump->Namespace); NameTable[j].Lump != NULL_INDEX; j = (j + 1) & NameTableMask);
+		NameTable[j] = { lump->qwName, lump->Namespace, i };
+	}
+
 	// Mark all buckets as empty
-	memset (FirstLumpIndex, 255, NumLumps*sizeof(FirstLumpIndex[0]));
-	memset (NextLumpIndex, 255, NumLumps*sizeof(NextLumpIndex[0]));
 	memset (FirstLumpIndex_FullName, 255, NumLumps*sizeof(FirstLumpIndex_FullName[0]));
 	memset (NextLumpIndex_FullName, 255, NumLumps*sizeof(NextLumpIndex_FullName[0]));
 	memset(FirstLumpIndex_NoExt, 255, NumLumps * sizeof(FirstLumpIndex_NoExt[0]));
 	memset(NextLumpIndex_NoExt, 255, NumLumps * sizeof(NextLumpIndex_NoExt[0]));
 
-	// Now set up the chains
+	// Now set up the chains for the full paths
 	for (i = 0; i < (unsigned)NumLumps; i++)
 	{
-		uppercopy (name, LumpInfo[i].lump->Name);
-		j = LumpNameHash (name) % NumLumps;
-		NextLumpIndex[i] = FirstLumpIndex[j];
-		FirstLumpIndex[j] = i;
-
-		// Do the same for the full paths
 		if (LumpInfo[i].lump->FullName.IsNotEmpty())
 		{
 			j = MakeKey(LumpInfo[i].lump->FullName) % NumLumps;
@@ -1404,6 +1591,27 @@ unsigned FWadCollection::GetLumpsInFolder(const char *inpath, TArray<FolderEntry
 	return result.Size();
 }
 
+//==========================================================================
+//
+// PrefetchLumps
+//
+// Lets the lumps get read and decompressed in the background so that
+// they are ready by the time they are used. Lumps that cannot be read
+// that way are left alone.
+//
+//==========================================================================
+
+void FWadCollection::PrefetchLumps (const TArray<int> &lumps)
+{
+	for (int lump : lumps)
+	{
+		if ((unsigned)lump < NumLumps)
+		{
+			LumpInfo[lump].lump->QueuePrefetch();
+		}
+	}
+}
+
 //==========================================================================
 //
 // W_ReadLump
@@ -1414,6 +1622,7 @@ unsigned FWadCollection::GetLumpsInFolder(const char *inpath, TArray<FolderEntry
 
 void FWadCollection::ReadLump (int lump, void *dest)
 {
+	FTraceZone zone("ReadLump");
 	auto lumpr = OpenLumpReader (lump);
 	auto size = lumpr.GetLength ();
 	auto numread = lumpr.Read (dest, size);
@@ -1435,6 +1644,7 @@ void FWadCollection::ReadLump (int lump, void *dest)
 
 TArray<uint8_t> FWadCollection::ReadLumpIntoArray(int lump, int pad)
 {
+	FTraceZone zone("ReadLump");
 	auto lumpr = OpenLumpReader(lump);
 	auto size = lumpr.GetLength();
 	TArray<uint8_t> data(size + pad, true);
@@ -1673,6 +1883,7 @@ FMemLump::~FMemLump ()
 
 FString::FString (ELumpNum lumpnum)
 {
+	FTraceZone zone("ReadLump");
 	auto lumpr = Wads.OpenLumpReader ((int)lumpnum);
 	auto size = lumpr.GetLength ();
 	AllocBuffer (1 + size);
@@ -140,6 +140,7 @@ public:
 	inline int CheckNumForName (const char *name) { return CheckNumForName (name, ns_global); }
 	inline int CheckNumForName (const FString &name) { return CheckNumForName (name.GetChars()); }
 	inline int CheckNumForName (const uint8_t *name, int ns) { return CheckNumForName ((const char *)name, ns); }
+	void CheckNumForNames (const char *const *names, int count, int namespc, int *results);	// batch lookup, same results as calling CheckNumForName for each name
 	inline int GetNumForName (const char *name) { return GetNumForName (name, ns_global); }
 	inline int GetNumForName (const FString &name) { return GetNumForName (name.GetChars(), ns_global); }
 	inline int GetNumForName (const uint8_t *name) { return GetNumForName ((const char *)name); }
@@ -158,6 +159,7 @@ public:
 
 
 	void ReadLump (int lump, void *dest);
+	void PrefetchLumps (const TArray<int> &lumps);	// starts reading the lumps in the background
 	TArray<uint8_t> ReadLumpIntoArray(int lump, int pad = 0);	// reads lump into a writable buffer and optionally adds some padding at the end. (FMemLump isn't writable!)
 	FMemLump ReadLump (int lump);
 	FMemLump ReadLump (const char *name) { return ReadLump (GetNumForName (name)); }
@@ -199,9 +201,18 @@ protected:
 	TArray<FResourceFile *> Files;
 	TArray<LumpRecord> LumpInfo;
 
+	// Open addressing table for 8 character names. The namespace is part of the key and
+	// duplicates are stored newest first along their probe sequence.
+	struct FLumpNameSlot
+	{
+		uint64_t qwName;
+		int Namespace;
+		uint32_t Lump;			// NULL_INDEX for empty slots
+	};
+	TArray<FLumpNameSlot> NameTable;
+	uint32_t NameTableMask = 0;
+
 	TArray<uint32_t> Hashes;	// one allocation for all hash lists.
-	uint32_t *FirstLumpIndex;	// [RH] Hashing stuff moved out of lumpinfo structure
-	uint32_t *NextLumpIndex;
 
 	uint32_t *FirstLumpIndex_FullName;	// The same information for fully qualified paths from .zips
 	uint32_t *NextLumpIndex_FullName;
@@ -216,6 +227,8 @@ protected:
 	int MaxIwadIndex = -1;
 
 	void InitHashChains ();								// [RH] Set up the lumpinfo hashing
+	int LookupName (uint64_t qname, uint32_t namehash, int namespc) const;
+	uint32_t NameKey (uint32_t namehash, int namespc) const { return (namehash ^ (uint32_t(namespc) * 0x9E3779B1u)) & NameTableMask; }
 
 private:
 	void RenameSprites(const TArray<FString> &deletelumps);
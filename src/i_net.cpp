@@ -39,7 +39,8 @@
 #ifdef __WIN32__
 #	define WIN32_LEAN_AND_MEAN
 #	include <windows.h>
-#	include <winsock.h>
+#	include <winsock2.h>
+#	include <ws2tcpip.h>
 #else
 #	include <sys/socket.h>
 #	include <netinet/in.h>
@@ -63,6 +64,7 @@
 #include "m_misc.h"
 #include "doomerrors.h"
 #include "cmdlib.h"
+#include "stats.h"
 
 #include "i_net.h"
 
@@ -143,6 +145,48 @@ struct PreGamePacket
 
 uint8_t TransmitBuffer[TRANSMIT_SIZE];
 
+// Traffic per node, for the netpackets stat. Bytes are counted as sent over the wire.
+static unsigned NodePacketsSent[MAXNETNODES], NodePacketsReceived[MAXNETNODES];
+static uint64_t NodeBytesSent[MAXNETNODES], NodeBytesReceived[MAXNETNODES];
+
+#ifdef __linux__
+// Received datagrams are drained with one recvmmsg call and then handed
+// out one per PacketGet, instead of making one recvfrom call per packet.
+enum { RECV_BATCH = 16 };
+static uint8_t RecvBuffers[RECV_BATCH][TRANSMIT_SIZE];
+static sockaddr_in RecvAddresses[RECV_BATCH];
+static int RecvLengths[RECV_BATCH];
+static int RecvCount, RecvPos;
+
+// Returns false if the socket had nothing to read. If recvmmsg failed,
+// its error is stored in error, since the socket will not report it again.
+static bool FillReceiveRing(int &error)
+{
+	mmsghdr msgs[RECV_BATCH];
+	iovec iovs[RECV_BATCH];
+
+	memset(msgs, 0, sizeof(msgs));
+	for (int i = 0; i < RECV_BATCH; i++)
+	{
+		iovs[i].iov_base = RecvBuffers[i];
+		iovs[i].iov_len = TRANSMIT_SIZE;
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &RecvAddresses[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(RecvAddresses[i]);
+	}
+	int count = recvmmsg(mysocket, msgs, RECV_BATCH, MSG_DONTWAIT, nullptr);
+	for (int i = 0; i < count; i++)
+	{
+		RecvLengths[i] = msgs[i].msg_len;
+	}
+	RecvPos = 0;
+	RecvCount = count > 0 ? count : 0;
+	error = count < 0 ? WSAGetLastError() : 0;
+	return count > 0 || (count < 0 && error != WSAEWOULDBLOCK);
+}
+#endif
+
 //
 // UDPsocket
 //
@@ -227,6 +271,8 @@ void PacketSend (void)
 		c = sendto(mysocket, (char *)TransmitBuffer, size,
 			0, (sockaddr *)&sendaddress[doomcom.remotenode],
 			sizeof(sendaddress[doomcom.remotenode]));
+		NodePacketsSent[doomcom.remotenode]++;
+		NodeBytesSent[doomcom.remotenode] += size;
 	}
 	else
 	{
@@ -240,6 +286,8 @@ void PacketSend (void)
 			c = sendto(mysocket, (char *)doomcom.data, doomcom.datalength,
 				0, (sockaddr *)&sendaddress[doomcom.remotenode],
 				sizeof(sendaddress[doomcom.remotenode]));
+			NodePacketsSent[doomcom.remotenode]++;
+			NodeBytesSent[doomcom.remotenode] += doomcom.datalength;
 		}
 	}
 	//	if (c == -1)
@@ -253,13 +301,39 @@ void PacketSend (void)
 void PacketGet (void)
 {
 	int c;
-	socklen_t fromlen;
 	sockaddr_in fromaddress;
 	int node;
+	uint8_t *packet = TransmitBuffer;
 
-	fromlen = sizeof(fromaddress);
-	c = recvfrom (mysocket, (char*)TransmitBuffer, TRANSMIT_SIZE, 0,
-				  (sockaddr *)&fromaddress, &fromlen);
+#ifdef __linux__
+	int recverror = 0;
+	if (RecvPos >= RecvCount && !FillReceiveRing(recverror))
+	{
+		doomcom.remotenode = -1;		// no packet
+		return;
+	}
+	if (RecvPos < RecvCount)
+	{
+		packet = RecvBuffers[RecvPos];
+		fromaddress = RecvAddresses[RecvPos];
+		c = RecvLengths[RecvPos];
+		RecvPos++;
+	}
+	else
+	{
+		// recvmmsg failed and already consumed the socket's pending error,
+		// so pass that on instead of reading again.
+		memset(&fromaddress, 0, sizeof(fromaddress));
+		c = SOCKET_ERROR;
+		errno = recverror;
+	}
+#else
+	{
+		socklen_t fromlen = sizeof(fromaddress);
+		c = recvfrom (mysocket, (char*)TransmitBuffer, TRANSMIT_SIZE, 0,
+					  (sockaddr *)&fromaddress, &fromlen);
+	}
+#endif
 	node = FindNode (&fromaddress);
 
 	if (node >= 0 && c == SOCKET_ERROR)
@@ -295,11 +369,13 @@ void PacketGet (void)
 	}
 	else if (node >= 0 && c > 0)
 	{
-		doomcom.data[0] = TransmitBuffer[0] & ~NCMD_COMPRESSED;
-		if (TransmitBuffer[0] & NCMD_COMPRESSED)
+		NodePacketsReceived[node]++;
+		NodeBytesReceived[node] += c;
+		doomcom.data[0] = packet[0] & ~NCMD_COMPRESSED;
+		if (packet[0] & NCMD_COMPRESSED)
 		{
 			uLongf msgsize = MAX_MSGLEN - 1;
-			int err = uncompress(doomcom.data + 1, &msgsize, TransmitBuffer + 1, c - 1);
+			int err = uncompress(doomcom.data + 1, &msgsize, packet + 1, c - 1);
 //			Printf("recv %d/%lu\n", c, msgsize + 1);
 			if (err != Z_OK)
 			{
@@ -313,13 +389,13 @@ void PacketGet (void)
 		else
 		{
 //			Printf("recv %d\n", c);
-			memcpy(doomcom.data + 1, TransmitBuffer + 1, c - 1);
+			memcpy(doomcom.data + 1, packet + 1, c - 1);
 		}
 	}
 	else if (c > 0)
 	{	//The packet is not from any in-game node, so we might as well discard it.
 		// Don't show the message for disconnect notifications.
-		if (c != 2 || TransmitBuffer[0] != PRE_FAKE || TransmitBuffer[1] != PRE_DISCONNECT)
+		if (c != 2 || packet[0] != PRE_FAKE || packet[1] != PRE_DISCONNECT)
 		{
 			DPrintf(DMSG_WARNING, "Dropped packet: Unknown host (%s:%d)\n", inet_ntoa(fromaddress.sin_addr), fromaddress.sin_port);
 		}
@@ -358,12 +434,8 @@ void PreSend (const void *buffer, int bufferlen, const sockaddr_in *to)
 
 void BuildAddress (sockaddr_in *address, const char *name)
 {
-	hostent *hostentry;		// host information entry
 	u_short port;
 	const char *portpart;
-	bool isnamed = false;
-	int curchar;
-	char c;
 	FString target;
 
 	address->sin_family = AF_INET;
@@ -385,29 +457,29 @@ void BuildAddress (sockaddr_in *address, const char *name)
 	}
 	address->sin_port = htons(port);
 
-	for (curchar = 0; (c = target[curchar]) ; curchar++)
-	{
-		if ((c < '0' || c > '9') && c != '.')
-		{
-			isnamed = true;
-			break;
-		}
-	}
-
-	if (!isnamed)
+	// The setup packets only have room for IPv4 addresses, so that is
+	// all we ask for, even if the host also has an IPv6 record.
+	addrinfo hints, *result;
+	memset (&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_protocol = IPPROTO_UDP;
+	hints.ai_flags = AI_CANONNAME;
+
+	int err = getaddrinfo (target, NULL, &hints, &result);
+	if (err != 0 || result == NULL)
+		I_FatalError ("getaddrinfo: couldn't find %s\n%s", target.GetChars(), gai_strerror(err));
+
+	address->sin_addr = ((sockaddr_in *)result->ai_addr)->sin_addr;
+	if (result->ai_canonname != NULL && strcmp(result->ai_canonname, target) != 0)
 	{
-		address->sin_addr.s_addr = inet_addr (target);
-		Printf ("Node number %d, address %s\n", doomcom.numnodes, target.GetChars());
+		Printf ("Node number %d, hostname %s\n", doomcom.numnodes, result->ai_canonname);
 	}
 	else
 	{
-		hostentry = gethostbyname (target);
-		if (!hostentry)
-			I_FatalError ("gethostbyname: couldn't find %s\n%s", target.GetChars(), neterror());
-		address->sin_addr.s_addr = *(int *)hostentry->h_addr_list[0];
-		Printf ("Node number %d, hostname %s\n",
-			doomcom.numnodes, hostentry->h_name);
+		Printf ("Node number %d, address %s\n", doomcom.numnodes, inet_ntoa(address->sin_addr));
 	}
+	freeaddrinfo (result);
 }
 
 void CloseNetwork (void)
@@ -437,6 +509,14 @@ void StartNetwork (bool autoPort)
 	netgame = true;
 	multiplayer = true;
 	
+	memset (NodePacketsSent, 0, sizeof(NodePacketsSent));
+	memset (NodePacketsReceived, 0, sizeof(NodePacketsReceived));
+	memset (NodeBytesSent, 0, sizeof(NodeBytesSent));
+	memset (NodeBytesReceived, 0, sizeof(NodeBytesReceived));
+#ifdef __linux__
+	RecvCount = RecvPos = 0;
+#endif
+
 	// create communication socket
 	mysocket = UDPsocket ();
 	BindToLocalPort (mysocket, autoPort ? 0 : DOOMPORT);
@@ -1003,6 +1083,28 @@ void I_NetCmd (void)
 		I_Error ("Bad net cmd: %i\n",doomcom.command);
 }
 
+//==========================================================================
+//
+// STAT netpackets
+//
+//==========================================================================
+
+ADD_STAT(netpackets)
+{
+	FString out;
+	if (!netgame)
+	{
+		return "Not in a netgame";
+	}
+	out.Format("node  player           sent          bytes       received          bytes\n");
+	for (int i = 0; i < doomcom.numnodes; i++)
+	{
+		out.AppendFormat("%4d  %-12s %10u %14llu %14u %14llu\n", i, i == 0 ? "(local)" : players[sendplayer[i]].userinfo.GetName(),
+			NodePacketsSent[i], (unsigned long long)NodeBytesSent[i], NodePacketsReceived[i], (unsigned long long)NodeBytesReceived[i]);
+	}
+	return out;
+}
+
 #ifdef __WIN32__
 const char *neterror (void)
 {
@@ -43,6 +43,9 @@
 #endif
 
 #include <zlib.h>
+#include <thread>
+#include <string>
+#include <vector>
 #include "templates.h"
 #include "m_argv.h"
 #include "c_dispatch.h"
@@ -996,8 +999,82 @@ bool MapLoader::CheckNodes(MapData * map, bool rebuilt, int buildtime)
 
 typedef TArray<uint8_t> MemFile;
 
+//==========================================================================
+//
+// Compressing and writing a node cache is left to a worker thread, so
+// that entering the map does not have to wait for it. Only one cache
+// is in flight at a time; anything that needs the file waits for it.
+//
+//==========================================================================
+
+static struct FNodeCacheWriter
+{
+	// FString's reference counting is not thread safe, so nothing the worker
+	// gets or produces may share a string with the main thread. Its buffers
+	// are std::vectors because M_Malloc's bookkeeping belongs to the main thread.
+	std::thread Thread;
+	std::string Error;	// set by the worker, printed by the main thread
+
+	void Wait()
+	{
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+		if (!Error.empty())
+		{
+			Printf("%s", Error.c_str());
+			Error.clear();
+		}
+	}
+
+	~FNodeCacheWriter()
+	{
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+		// The console is gone by now.
+		if (!Error.empty())
+		{
+			fprintf(stderr, "%s", Error.c_str());
+		}
+	}
+} NodeCacheWriter;
+
+static void WriteCachedNodes(std::string path, std::vector<uint8_t> header, std::vector<uint8_t> ZNodes)
+{
+	uLongf outlen = compressBound(ZNodes.size());
+	const size_t offset = header.size();
+	std::vector<Bytef> compressed(offset + outlen);
+
+	memcpy(compressed.data(), header.data(), offset);
+	int r = compress (compressed.data() + offset, &outlen, ZNodes.data(), ZNodes.size());
+	if (r != Z_OK)
+	{
+		NodeCacheWriter.Error = "Error compressing nodes for " + path + "\n";
+		return;
+	}
+
+	FileWriter *fw = FileWriter::Open(path.c_str());
 
-static FString CreateCacheName(MapData *map, bool create)
+	if (fw != nullptr)
+	{
+		const size_t length = outlen + offset;
+		if (fw->Write(compressed.data(), length) != length)
+		{
+			NodeCacheWriter.Error = "Error saving nodes to file " + path + "\n";
+		}
+		delete fw;
+	}
+	else
+	{
+		NodeCacheWriter.Error = "Cannot open nodes file " + path + " for writing\n";
+	}
+}
+
+
+FString CreateCacheName(MapData *map, bool create, const char *ext)
 {
 	FString path = M_GetCachePath(create);
 	FString lumpname = Wads.GetLumpFullPath(map->lumpnum);
@@ -1007,7 +1084,7 @@ static FString CreateCacheName(MapData *map, bool create)
 
 	lumpname.ReplaceChars('/', '%');
 	lumpname.ReplaceChars(':', '$');
-	path << '/' << lumpname.Right(lumpname.Len() - separator - 1) << ".gzc";
+	path << '/' << lumpname.Right(lumpname.Len() - separator - 1) << ext;
 	return path;
 }
 
@@ -1097,48 +1174,26 @@ void MapLoader::CreateCachedNodes(MapData *map)
 		}
 	}
 
-	uLongf outlen = ZNodes.Size();
-	TArray<Bytef> compressed;
 	int offset = Level->lines.Size() * 8 + 12 + 16;
-	int r;
-	do
-	{
-		compressed.Resize(outlen + offset);
-		r = compress (compressed.Data() + offset, &outlen, &ZNodes[0], ZNodes.Size());
-		if (r == Z_BUF_ERROR)
-		{
-			outlen += 1024;
-		}
-	} 
-	while (r == Z_BUF_ERROR);
+	MemFile header(offset, true);
 
-	memcpy(compressed.Data(), "CACH", 4);
+	memcpy(header.Data(), "CACH", 4);
 	uint32_t len = LittleLong(Level->lines.Size());
-	memcpy(&compressed[4], &len, 4);
-	map->GetChecksum(&compressed[8]);
+	memcpy(&header[4], &len, 4);
+	map->GetChecksum(&header[8]);
 	for (unsigned i = 0; i < Level->lines.Size(); i++)
 	{
 		uint32_t ndx[2] = { LittleLong(uint32_t(Index(Level->lines[i].v1))), LittleLong(uint32_t(Index(Level->lines[i].v2))) };
-		memcpy(&compressed[8 + 16 + 8 * i], ndx, 8);
+		memcpy(&header[8 + 16 + 8 * i], ndx, 8);
 	}
-	memcpy(&compressed[offset - 4], "ZGL3", 4);
+	memcpy(&header[offset - 4], "ZGL3", 4);
 
-	FString path = CreateCacheName(map, true);
-	FileWriter *fw = FileWriter::Open(path);
+	FString path = CreateCacheName(map, true, ".gzc");
 
-	if (fw != nullptr)
-	{
-		const size_t length = outlen + offset;
-		if (fw->Write(compressed.Data(), length) != length)
-		{
-			Printf("Error saving nodes to file %s\n", path.GetChars());
-		}
-		delete fw;
-	}
-	else
-	{
-		Printf("Cannot open nodes file %s for writing\n", path.GetChars());
-	}
+	NodeCacheWriter.Wait();
+	NodeCacheWriter.Thread = std::thread(WriteCachedNodes, std::string(path.GetChars()),
+		std::vector<uint8_t>(header.Data(), header.Data() + header.Size()),
+		std::vector<uint8_t>(ZNodes.Data(), ZNodes.Data() + ZNodes.Size()));
 }
 
 
@@ -1150,9 +1205,10 @@ bool MapLoader::CheckCachedNodes(MapData *map)
 	uint32_t numlin;
 	TArray<uint32_t> verts;
 
-	FString path = CreateCacheName(map, false);
+	FString path = CreateCacheName(map, false, ".gzc");
 	FileReader fr;
 
+	NodeCacheWriter.Wait();
 	if (!fr.OpenFile(path)) return false;
 
 	if (fr.Read(magic, 4) != 4) return false;
@@ -1199,6 +1255,8 @@ bool MapLoader::CheckCachedNodes(MapData *map)
 UNSAFE_CCMD(clearnodecache)
 {
 	TArray<FFileList> list;
+
+	NodeCacheWriter.Wait();
 	FString path = M_GetCachePath(false);
 	path += "/";
 
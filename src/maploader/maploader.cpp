@@ -80,6 +80,8 @@
 #include "hwrenderer/data/flatvertices.h"
 #include "xlat/xlat.h"
 #include "vm.h"
+#include "stats.h"
+#include "c_dispatch.h"
 
 enum
 {
@@ -88,6 +90,7 @@ enum
 
 CVAR (Bool, genblockmap, false, CVAR_SERVERINFO|CVAR_GLOBALCONFIG);
 CVAR (Bool, gennodes, false, CVAR_SERVERINFO|CVAR_GLOBALCONFIG);
+CVAR (Bool, genreject, false, CVAR_SERVERINFO|CVAR_GLOBALCONFIG);
 
 inline bool P_LoadBuildMap(uint8_t *mapdata, size_t len, FMapThing **things, int *numthings)
 {
@@ -2662,6 +2665,7 @@ void MapLoader::LoadBlockMap (MapData * map)
 	count = Level->blockmap.bmapwidth*Level->blockmap.bmapheight;
 	Level->blockmap.blocklinks = new FBlockNode *[count];
 	memset (Level->blockmap.blocklinks, 0, count*sizeof(*Level->blockmap.blocklinks));
+	Level->blockmap.blockthings = new FBlockThings[count];
 	Level->blockmap.blockmap = Level->blockmap.blockmaplump+4;
 }
 
@@ -2952,6 +2956,62 @@ void MapLoader::CalcIndices()
 	}
 }
 
+//==========================================================================
+//
+// Load stage timings
+//
+// LoadLevel records how long each of its steps took so that slow
+// steps on big maps can be spotted. Use maploadtimes to see them.
+//
+//==========================================================================
+
+struct FLoadStageTime
+{
+	const char *Name;
+	double MS;
+};
+
+static TArray<FLoadStageTime> LoadStageTimes;
+static cycle_t LoadStageClock;
+
+static void BeginLoadStages()
+{
+	LoadStageTimes.Clear();
+	LoadStageClock.Reset();
+	LoadStageClock.Clock();
+}
+
+static void EndLoadStage(const char *name)
+{
+	LoadStageClock.Unclock();
+	LoadStageTimes.Push({ name, LoadStageClock.TimeMS() });
+	LoadStageClock.Reset();
+	LoadStageClock.Clock();
+}
+
+static void PrintLoadStages(bool debug)
+{
+	double total = 0;
+	for (auto &stage : LoadStageTimes)
+	{
+		if (debug) DPrintf(DMSG_NOTIFY, "%-20s %9.3f ms\n", stage.Name, stage.MS);
+		else Printf("%-20s %9.3f ms\n", stage.Name, stage.MS);
+		total += stage.MS;
+	}
+	if (debug) DPrintf(DMSG_NOTIFY, "%-20s %9.3f ms\n", "total", total);
+	else Printf("%-20s %9.3f ms\n", "total", total);
+}
+
+CCMD(maploadtimes)
+{
+	if (LoadStageTimes.Size() == 0)
+	{
+		Printf("No map has been loaded yet.\n");
+		return;
+	}
+	PrintLoadStages(false);
+}
+
 //==========================================================================
 //
 //
@@ -2962,6 +3022,8 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 {
 	const int *oldvertextable  = nullptr;
 
+	BeginLoadStages();
+
 	// note: most of this ordering is important 
 	ForceNodeBuild = gennodes;
 
@@ -3025,6 +3087,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 
 
 	LoadStrifeConversations(map, lumpname);
+	EndLoadStage("scripts");
 
 	FMissingTextureTracker missingtex;
 
@@ -3053,6 +3116,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	{
 		ParseTextMap(map, missingtex);
 	}
+	EndLoadStage("map data");
 
 	CalcIndices();
 	PostProcessLevel(checksum);
@@ -3060,6 +3124,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	LoopSidedefs(true);
 
 	SummarizeMissingTextures(missingtex);
+	EndLoadStage("postprocessing");
 	bool reloop = false;
 
 	if (!ForceNodeBuild)
@@ -3193,10 +3258,14 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	
 	// set the head node for gameplay purposes. If the separate gamenodes array is not empty, use that, otherwise use the render nodes.
 	Level->headgamenode = Level->gamenodes.Size() > 0 ? &Level->gamenodes[Level->gamenodes.Size() - 1] : Level->nodes.Size() ? &Level->nodes[Level->nodes.Size() - 1] : nullptr;
+	Level->PackNodes();
+	EndLoadStage("nodes");
 
 	LoadBlockMap(map);
+	EndLoadStage("blockmap");
 
 	LoadReject(map, false);
+	EndLoadStage("reject");
 	GroupLines(false);
 	FloodZones();
 	SetRenderSector();
@@ -3205,6 +3274,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 
 	// Create the item indices, after the last function which may change the data has run.
 	CalcIndices();
+	EndLoadStage("line grouping");
 
 	Level->bodyqueslot = 0;
 	// phares 8/10/98: Clear body queue so the corpses from previous games are
@@ -3214,6 +3284,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 		p = nullptr;
 
 	CreateSections(Level);
+	EndLoadStage("sections");
 
 	// [RH] Spawn slope creating things first.
 	SpawnSlopeMakers(&MapThingsConverted[0], &MapThingsConverted[MapThingsConverted.Size()], oldvertextable);
@@ -3221,6 +3292,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 
 	// Spawn 3d floors - must be done before spawning things so it can't be done in P_SpawnSpecials
 	Spawn3DFloors();
+	EndLoadStage("slopes and 3D floors");
 
 	SpawnThings(position);
 
@@ -3237,8 +3309,11 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 		delete[] oldvertextable;
 	}
 
+	EndLoadStage("things");
+
 	// set up world state
 	SpawnSpecials();
+	EndLoadStage("specials");
 
 	// disable reflective planes on sloped sectors.
 	for (auto &sec : Level->sectors)
@@ -3263,12 +3338,17 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	}
 
 	SWRenderer->SetColormap(Level);	//The SW renderer needs to do some special setup for the level's default colormap.
+	EndLoadStage("render data");
 	InitPortalGroups(Level);
 	P_InitHealthGroups(Level);
 
 	if (reloop) LoopSidedefs(false);
 	PO_Init();				// Initialize the polyobjs
+	BuildReject(map);		// needs the portal setup to decide if it can be done.
 	if (!Level->IsReentering())
 		Level->FinalizePortals();	// finalize line portals after polyobjects have been initialized. This info is needed for properly flagging them.
+	EndLoadStage("portals and polyobjects");
+	LoadStageClock.Unclock();
+	PrintLoadStages(true);
 }
 
@@ -295,6 +295,9 @@ public:
 	void LoadSideDefs2(MapData *map, FMissingTextureTracker &missingtex);
 	void LoadBlockMap(MapData * map);
 	void LoadReject(MapData * map, bool junk);
+	bool CheckCachedReject(MapData *map);
+	void CreateCachedReject(MapData *map);
+	void BuildReject(MapData *map);
 	void LoadBehavior(MapData * map);
 	void GetPolySpots(MapData * map, TArray<FNodeBuilder::FPolyStart> &spots, TArray<FNodeBuilder::FPolyStart> &anchors);
 	void GroupLines(bool buildmap);
@@ -0,0 +1,500 @@
+//-----------------------------------------------------------------------------
+//
+// Copyright 2026 The GZDoom team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+//-----------------------------------------------------------------------------
+//
+/*
+** reject.cpp
+** Builds a REJECT table for maps that do not provide a usable one.
+**
+** The GL subsectors are convex, so every point inside one can see every
+** point on its boundary. Sight lines are flowed from each sector through
+** chains of two-sided segs and minisegs, and each new seg is clipped
+** against the separating lines between the first seg of the chain and the
+** one it was reached through. A sight line that exists in the map can never
+** be discarded this way, only some that do not exist may be kept.
+** Heights, ML_BLOCKSIGHT and polyobjects are ignored because all of them
+** can change during play, so the resulting table is purely 2D.
+**
+*/
+
+#include <zlib.h>
+#include "doomtype.h"
+#include "p_local.h"
+#include "m_misc.h"
+#include "g_levellocals.h"
+#include "p_setup.h"
+#include "maploader.h"
+#include "files.h"
+#include "i_time.h"
+#include "parallel_for.h"
+#include "c_cvars.h"
+#include "printf.h"
+
+EXTERN_CVAR(Bool, genreject)
+EXTERN_CVAR(Bool, gl_cachenodes)
+EXTERN_CVAR(Float, gl_cachetime)
+
+FString CreateCacheName(MapData *map, bool create, const char *ext);
+
+enum
+{
+	REJECT_CACHE_VERSION = 1,
+	MAX_REJECT_SECTORS = 32768,	// larger tables would take more memory than they are worth.
+	MAX_FLOW_STEPS = 250000,	// per source sector. Sectors that need more are assumed to see everything.
+	MAX_FLOW_DEPTH = 512,		// keeps the recursion within the stack size of worker threads.
+};
+
+static const double REJECT_EPSILON = 1. / 256;
+
+struct FRejectWinding
+{
+	DVector2 v1, v2;
+};
+
+struct FRejectPortal
+{
+	FRejectWinding w;
+	DVector2 normal;	// points into the destination cell
+	int dest;
+};
+
+struct FRejectCell
+{
+	unsigned firstportal;
+	unsigned numportals;
+	int sector;
+};
+
+struct FRejectData
+{
+	TArray<FRejectCell> cells;
+	TArray<FRejectPortal> portals;
+	TArray<TArray<int>> sectorcells;
+	TArray<TArray<int>> visible;
+	TArray<uint8_t> overflow;
+};
+
+struct FRejectWorker
+{
+	const FRejectData *data;
+	TArray<uint8_t> inchain;
+	TArray<int> sectorstamp;
+	TArray<int> *visible;
+	int stamp;
+	int steps;
+	int depth;
+
+	void Init(const FRejectData *d, unsigned numsectors)
+	{
+		data = d;
+		if (inchain.Size() != d->cells.Size() || sectorstamp.Size() != numsectors)
+		{
+			inchain.Resize(d->cells.Size());
+			memset(inchain.Data(), 0, inchain.Size());
+			sectorstamp.Resize(numsectors);
+			memset(sectorstamp.Data(), 0, sectorstamp.Size() * sizeof(int));
+			stamp = 0;
+		}
+	}
+
+	void Mark(int cell)
+	{
+		int sec = data->cells[cell].sector;
+		if (sectorstamp[sec] != stamp)
+		{
+			sectorstamp[sec] = stamp;
+			visible->Push(sec);
+		}
+	}
+
+	bool Exhausted() const
+	{
+		return steps > MAX_FLOW_STEPS;
+	}
+};
+
+static thread_local FRejectWorker RejectWorker;
+
+//===========================================================================
+//
+// Clips a winding to the front side of the line through 'org' with normal 'n'
+// Returns false if nothing remains.
+//
+//===========================================================================
+
+static bool ClipWinding(FRejectWinding &w, const DVector2 &org, const DVector2 &n)
+{
+	double d1 = (w.v1 - org) | n;
+	double d2 = (w.v2 - org) | n;
+
+	if (d1 >= -REJECT_EPSILON && d2 >= -REJECT_EPSILON) return true;
+	if (d1 < -REJECT_EPSILON && d2 < -REJECT_EPSILON) return false;
+
+	DVector2 mid = w.v1 + (w.v2 - w.v1) * (d1 / (d1 - d2));
+	if (d1 < 0) w.v1 = mid;
+	else w.v2 = mid;
+	return true;
+}
+
+//===========================================================================
+//
+// Clips 'target' to the part that can be reached by straight lines
+// passing through both 'source' and 'pass'.
+//
+//===========================================================================
+
+static bool ClipToSeparators(const FRejectWinding &source, const FRejectWinding &pass, FRejectWinding &target)
+{
+	const DVector2 *sv[2] = { &source.v1, &source.v2 };
+	const DVector2 *pv[2] = { &pass.v1, &pass.v2 };
+
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			DVector2 dir = *pv[j] - *sv[i];
+			double len = dir.Length();
+			if (len < REJECT_EPSILON) continue;
+			DVector2 n(-dir.Y / len, dir.X / len);
+
+			double ds = (*sv[1 - i] - *sv[i]) | n;
+			double dp = (*pv[1 - j] - *sv[i]) | n;
+
+			// Only lines that have both windings on opposite sides separate anything.
+			// Degenerate cases are skipped, which can only make the result larger.
+			if (fabs(ds) < REJECT_EPSILON || fabs(dp) < REJECT_EPSILON) continue;
+			if ((ds < 0) == (dp < 0)) continue;
+
+			if (dp < 0) n = -n;
+			if (!ClipWinding(target, *sv[i], n)) return false;
+		}
+	}
+	return true;
+}
+
+//===========================================================================
+//
+// Recursive flow through all portals leading out of 'cell'
+//
+//===========================================================================
+
+static void Flow(FRejectWorker &w, int cell, const FRejectPortal &first, const FRejectWinding &source, const FRejectWinding &pass)
+{
+	auto &c = w.data->cells[cell];
+
+	if (++w.depth > MAX_FLOW_DEPTH)
+	{
+		w.steps = MAX_FLOW_STEPS + 1;
+	}
+	w.inchain[cell] = true;
+
+	for (unsigned i = 0; i < c.numportals && !w.Exhausted(); i++)
+	{
+		auto &p = w.data->portals[c.firstportal + i];
+		if (w.inchain[p.dest]) continue;	// a straight line cannot enter the same convex cell twice.
+		w.steps++;
+
+		FRejectWinding target = p.w;
+		if (!ClipWinding(target, first.w.v1, first.normal)) continue;
+		if (!ClipToSeparators(source, pass, target)) continue;
+
+		FRejectWinding newsource = source;
+		if (!ClipToSeparators(target, pass, newsource)) continue;
+
+		w.Mark(p.dest);
+		Flow(w, p.dest, first, newsource, target);
+	}
+
+	w.inchain[cell] = false;
+	w.depth--;
+}
+
+//===========================================================================
+//
+// Collects all sectors that may be visible from one sector
+//
+//===========================================================================
+
+static void FlowSector(FRejectWorker &w, int sector)
+{
+	auto &data = *w.data;
+	w.stamp++;
+	w.steps = 0;
+	w.depth = 0;
+
+	for (auto cell : data.sectorcells[sector])
+	{
+		auto &c = data.cells[cell];
+		w.Mark(cell);
+		w.inchain[cell] = true;
+
+		for (unsigned i = 0; i < c.numportals && !w.Exhausted(); i++)
+		{
+			auto &first = data.portals[c.firstportal + i];
+			auto &next = data.cells[first.dest];
+			w.Mark(first.dest);
+			w.inchain[first.dest] = true;
+
+			// Everything behind the first portal's cell is reachable through its own portals without clipping.
+			for (unsigned j = 0; j < next.numportals && !w.Exhausted(); j++)
+			{
+				auto &pass = data.portals[next.firstportal + j];
+				if (w.inchain[pass.dest]) continue;
+
+				FRejectWinding passw = pass.w;
+				if (!ClipWinding(passw, first.w.v1, first.normal)) continue;
+
+				w.Mark(pass.dest);
+				Flow(w, pass.dest, first, first.w, passw);
+			}
+			w.inchain[first.dest] = false;
+		}
+		w.inchain[cell] = false;
+	}
+}
+
+//===========================================================================
+//
+// Sets up the cells and portals from the GL nodes.
+// Returns false if the nodes are not suitable.
+//
+//===========================================================================
+
+static bool CollectRejectCells(FLevelLocals *Level, FRejectData &data)
+{
+	unsigned numsubsectors = Level->subsectors.Size();
+	if (numsubsectors == 0) return false;
+
+	data.cells.Resize(numsubsectors);
+	data.sectorcells.Resize(Level->sectors.Size());
+	TArray<DVector2> centers(numsubsectors, true);
+
+	for (unsigned i = 0; i < numsubsectors; i++)
+	{
+		auto &sub = Level->subsectors[i];
+		if (sub.numlines == 0 || sub.sector == nullptr) return false;
+
+		DVector2 center(0, 0);
+		for (unsigned j = 0; j < sub.numlines; j++)
+		{
+			center += sub.firstline[j].v1->fPos();
+		}
+		centers[i] = center / sub.numlines;
+		data.cells[i].sector = sub.sector->Index();
+		data.sectorcells[sub.sector->Index()].Push(i);
+	}
+
+	for (unsigned i = 0; i < numsubsectors; i++)
+	{
+		auto &sub = Level->subsectors[i];
+		auto &cell = data.cells[i];
+
+		// If the map depends on its original nodes for gameplay the GL subsectors need not agree with them.
+		// Such maps are left alone if any subsector seems to belong to a different sector.
+		bool checkgamenodes = Level->gamenodes.Size() > 0;
+		if (checkgamenodes && Level->PointInSector(centers[i]) != sub.sector) return false;
+
+		cell.firstportal = data.portals.Size();
+		for (unsigned j = 0; j < sub.numlines; j++)
+		{
+			seg_t *seg = &sub.firstline[j];
+			DVector2 v1 = seg->v1->fPos(), v2 = seg->v2->fPos();
+
+			if (checkgamenodes)
+			{
+				DVector2 mid = (v1 + v2) / 2;
+				DVector2 inside = mid + (centers[i] - mid).Unit() * 0.5;
+				if (Level->PointInSector(inside) != sub.sector) return false;
+			}
+
+			if (seg->linedef != nullptr && seg->backsector == nullptr) continue;	// one-sided wall
+			if (seg->PartnerSeg == nullptr || seg->PartnerSeg->Subsector == nullptr) return false;
+
+			DVector2 dir = v2 - v1;
+			double len = dir.Length();
+			if (len < REJECT_EPSILON) continue;
+
+			FRejectPortal portal;
+			portal.w = { v1, v2 };
+			portal.dest = seg->PartnerSeg->Subsector->Index();
+			portal.normal = DVector2(-dir.Y / len, dir.X / len);
+			if (((centers[portal.dest] - v1) | portal.normal) < 0) portal.normal = -portal.normal;
+			data.portals.Push(portal);
+		}
+		cell.numportals = data.portals.Size() - cell.firstportal;
+	}
+	return true;
+}
+
+//===========================================================================
+//
+// Cached reject tables are stored next to the cached nodes.
+//
+//===========================================================================
+
+bool MapLoader::CheckCachedReject(MapData *map)
+{
+	char magic[4] = { 0,0,0,0 };
+	uint8_t md5[16];
+	uint8_t md5map[16];
+	uint32_t header[3];
+
+	FString path = CreateCacheName(map, false, ".gzr");
+	FileReader fr;
+
+	if (!fr.OpenFile(path)) return false;
+
+	if (fr.Read(magic, 4) != 4) return false;
+	if (memcmp(magic, "REJC", 4)) return false;
+
+	if (fr.Read(header, 12) != 12) return false;
+	if (LittleLong(header[0]) != REJECT_CACHE_VERSION) return false;
+	if (LittleLong(header[1]) != Level->sectors.Size()) return false;
+
+	if (fr.Read(md5, 16) != 16) return false;
+	map->GetChecksum(md5map);
+	if (memcmp(md5, md5map, 16)) return false;
+
+	uLongf rejectsize = LittleLong(header[2]);
+	if (rejectsize != (Level->sectors.Size() * Level->sectors.Size() + 7) / 8) return false;
+
+	auto compressed = fr.Read(fr.GetLength() - fr.Tell());
+	TArray<uint8_t> reject(rejectsize, true);
+	if (uncompress(reject.Data(), &rejectsize, compressed.Data(), compressed.Size()) != Z_OK || rejectsize != reject.Size()) return false;
+
+	Level->rejectmatrix = std::move(reject);
+	return true;
+}
+
+void MapLoader::CreateCachedReject(MapData *map)
+{
+	const int offset = 4 + 12 + 16;
+	uLongf outlen = compressBound(Level->rejectmatrix.Size());
+	TArray<Bytef> compressed(outlen + offset, true);
+
+	if (compress(compressed.Data() + offset, &outlen, Level->rejectmatrix.Data(), Level->rejectmatrix.Size()) != Z_OK) return;
+
+	memcpy(compressed.Data(), "REJC", 4);
+	uint32_t header[3] = { LittleLong(uint32_t(REJECT_CACHE_VERSION)), LittleLong(Level->sectors.Size()), LittleLong(Level->rejectmatrix.Size()) };
+	memcpy(&compressed[4], header, 12);
+	map->GetChecksum(&compressed[16]);
+
+	FString path = CreateCacheName(map, true, ".gzr");
+	FileWriter *fw = FileWriter::Open(path);
+
+	if (fw != nullptr)
+	{
+		const size_t length = outlen + offset;
+		if (fw->Write(compressed.Data(), length) != length)
+		{
+			Printf("Error saving reject table to file %s\n", path.GetChars());
+		}
+		delete fw;
+	}
+	else
+	{
+		Printf("Cannot open reject file %s for writing\n", path.GetChars());
+	}
+}
+
+//===========================================================================
+//
+// Builds a reject table if the map does not have one.
+// This must be called after the portal groups have been set up.
+//
+//===========================================================================
+
+void MapLoader::BuildReject(MapData *map)
+{
+	if (!genreject || Level->rejectmatrix.Size() > 0 || Level->maptype == MAPTYPE_BUILD) return;
+
+	// Sight can pass through line portals and linked sectors, which this cannot handle.
+	if (Level->Displacements.size > 1 || Level->linePortals.Size() > 0) return;
+
+	unsigned numsectors = Level->sectors.Size();
+	if (numsectors < 2 || numsectors > MAX_REJECT_SECTORS) return;
+
+	if (CheckCachedReject(map)) return;
+
+	uint64_t starttime = I_msTime();
+
+	FRejectData data;
+	if (!CollectRejectCells(Level, data))
+	{
+		DPrintf(DMSG_NOTIFY, "Unable to build a reject table for this map\n");
+		return;
+	}
+
+	data.visible.Resize(numsectors);
+	data.overflow.Resize(numsectors);
+	memset(data.overflow.Data(), 0, numsectors);
+
+	const int count = numsectors;
+	const int slice = 16;
+	FRejectData *pdata = &data;
+	parallel_for(0, count, slice, [=](int start)
+	{
+		auto &w = RejectWorker;
+		w.Init(pdata, count);
+		int end = MIN(start + slice, count);
+		for (int i = start; i < end; i++)
+		{
+			w.visible = &pdata->visible[i];
+			FlowSector(w, i);
+			pdata->overflow[i] = w.Exhausted();
+		}
+	});
+
+	// Everything starts out rejected, then all visible pairs get cleared in both directions
+	// so that the table stays symmetric even where the floating point math was not.
+	auto &reject = Level->rejectmatrix;
+	reject.Resize((numsectors * numsectors + 7) / 8);
+	memset(reject.Data(), 0xff, reject.Size());
+
+	auto clear = [&](unsigned s1, unsigned s2)
+	{
+		unsigned pnum = s1 * numsectors + s2;
+		reject[pnum >> 3] &= ~(1 << (pnum & 7));
+		pnum = s2 * numsectors + s1;
+		reject[pnum >> 3] &= ~(1 << (pnum & 7));
+	};
+
+	int overflows = 0;
+	for (unsigned i = 0; i < numsectors; i++)
+	{
+		clear(i, i);
+		if (data.overflow[i])
+		{
+			for (unsigned j = 0; j < numsectors; j++) clear(i, j);
+			overflows++;
+		}
+		else for (auto j : data.visible[i])
+		{
+			clear(i, j);
+		}
+	}
+
+	uint64_t buildtime = I_msTime() - starttime;
+	DPrintf(DMSG_NOTIFY, "Reject table built in %.3f seconds (%d sectors unrestricted)\n", buildtime * 0.001, overflows);
+
+	if (gl_cachenodes && buildtime / 1000.f >= gl_cachetime)
+	{
+		DPrintf(DMSG_NOTIFY, "Caching reject table\n");
+		CreateCachedReject(map);
+	}
+}
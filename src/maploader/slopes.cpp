@@ -32,6 +32,7 @@
 **
 */
 
+#include <algorithm>
 #include "doomtype.h"
 #include "p_local.h"
 #include "cmdlib.h"
@@ -252,17 +253,40 @@ void MapLoader::VavoomSlope(sector_t * sec, int id, const DVector3 &pos, int whi
 void MapLoader::SetSlopesFromVertexHeights(FMapThing *firstmt, FMapThing *lastmt, const int *oldvertextable)
 {
 	TMap<int, double> vt_heights[2];
+	TArray<unsigned> sortedverts;
 	FMapThing *mt;
 	bool vt_found = false;
 
+	// Vertices sorted by position, so that each vertex height thing can
+	// find the vertices it sits on without checking all of them.
+	auto lessthan = [&](unsigned a, unsigned b)
+	{
+		auto &va = Level->vertexes[a], &vb = Level->vertexes[b];
+		return va.fX() < vb.fX() || (va.fX() == vb.fX() && va.fY() < vb.fY());
+	};
+
 	for (mt = firstmt; mt < lastmt; ++mt)
 	{
 		if (mt->info != NULL && mt->info->Type == NULL)
 		{
 			if (mt->info->Special == SMT_VertexFloorZ || mt->info->Special == SMT_VertexCeilingZ)
 			{
-				for (unsigned i = 0; i < Level->vertexes.Size(); i++)
+				if (sortedverts.Size() == 0 && Level->vertexes.Size() > 0)
+				{
+					sortedverts.Resize(Level->vertexes.Size());
+					for (unsigned i = 0; i < sortedverts.Size(); i++) sortedverts[i] = i;
+					std::sort(sortedverts.begin(), sortedverts.end(), lessthan);
+				}
+
+				// Find the run of vertices at exactly this spot.
+				auto first = std::lower_bound(sortedverts.begin(), sortedverts.end(), mt->pos.XY(), [&](unsigned v, const DVector2 &pos)
+				{
+					auto &vv = Level->vertexes[v];
+					return vv.fX() < pos.X || (vv.fX() == pos.X && vv.fY() < pos.Y);
+				});
+				for (auto it = first; it != sortedverts.end(); ++it)
 				{
+					unsigned i = *it;
 					if (Level->vertexes[i].fX() == mt->pos.X && Level->vertexes[i].fY() == mt->pos.Y)
 					{
 						if (mt->info->Special == SMT_VertexFloorZ)
@@ -275,6 +299,7 @@ void MapLoader::SetSlopesFromVertexHeights(FMapThing *firstmt, FMapThing *lastmt
 						}
 						vt_found = true;
 					}
+					else break;
 				}
 				mt->EdNum = 0;
 			}
@@ -386,11 +386,19 @@ bool P_CheckMapData(const char *mapname)
 //
 // Hashes a map based on its header, THINGS, LINEDEFS, SIDEDEFS, SECTORS,
 // and BEHAVIOR lumps. Node-builder generated lumps are not included.
+// The compatibility lookup, the node and reject caches and the level
+// itself all ask for it, so it is only calculated once.
 //
 //===========================================================================
 
 void MapData::GetChecksum(uint8_t cksum[16])
 {
+	if (HasChecksum)
+	{
+		memcpy(cksum, Checksum, 16);
+		return;
+	}
+
 	MD5Context md5;
 
 	if (isText)
@@ -409,5 +417,7 @@ void MapData::GetChecksum(uint8_t cksum[16])
 	{
 		md5.Update(Reader(ML_BEHAVIOR), Size(ML_BEHAVIOR));
 	}
-	md5.Final(cksum);
+	md5.Final(Checksum);
+	HasChecksum = true;
+	memcpy(cksum, Checksum, 16);
 }
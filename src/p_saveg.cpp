@@ -1056,6 +1056,35 @@ void FLevelLocals::SnapshotLevel()
 	}
 }
 
+//==========================================================================
+//
+// Archives the current level like SnapshotLevel but returns the
+// uncompressed text instead of storing it, so that it can be compressed
+// by the background save writer.
+//
+//==========================================================================
+
+bool FLevelLocals::SnapshotLevelText(FString &text)
+{
+	info->Snapshot.Clean();
+
+	if (info->isValid())
+	{
+		FSerializer arc(this);
+
+		if (arc.OpenWriter(save_formatted))
+		{
+			unsigned len;
+			SaveVersion = SAVEVER;
+			Serialize(arc, false);
+			const char *out = arc.GetOutput(&len);
+			text = FString(out, len);
+			return true;
+		}
+	}
+	return false;
+}
+
 //==========================================================================
 //
 // Unarchives the current level based on its snapshot
@@ -215,6 +215,8 @@ void FLevelLocals::ClearPortals()
 	Displacements.Create(1);
 	linePortals.Clear();
 	linkedPortals.Clear();
+	groupLinkedPortals.Clear();
+	groupLinkedPortalStart.Clear();
 	sectorPortals.Resize(2);
 	PortalBlockmap.Clear();
 
@@ -314,11 +316,14 @@ void FLevelLocals::ClearLevelData()
 	vertexes.Clear();
 	nodes.Clear();
 	gamenodes.Reset();
+	gamebsp.Clear();
+	renderbsp.Clear();
 	subsectors.Clear();
 	gamesubsectors.Reset();
 	rejectmatrix.Clear();
 	Zones.Clear();
 	blockmap.Clear();
+	P_ResetSecnodes();
 	Polyobjects.Clear();
 
 	for (auto &pb : PolyBlockMap)
@@ -62,6 +62,8 @@ private:
 		FileReader Reader;
 	} MapLumps[ML_MAX];
 	FileReader nofile;
+	uint8_t Checksum[16];
+	bool HasChecksum = false;
 public:
 	bool HasBehavior = false;
 	bool Encrypted = false;
@@ -38,6 +38,7 @@
 #include "events.h"
 #include "actorinlines.h"
 #include "g_game.h"
+#include "stats.h"
 
 extern gamestate_t wipegamestate;
 extern uint8_t globalfreeze, globalchangefreeze;
@@ -76,6 +77,7 @@ bool P_CheckTickerPaused ()
 //
 void P_Ticker (void)
 {
+	FTraceZone zone("P_Ticker");
 	int i;
 
 	for (auto Level : AllLevels())
@@ -159,6 +161,13 @@ void P_Ticker (void)
 			ac->ClearInterpolation();
 		}
 
+		// No native blockmap iterator can be active here so this is the place to clean up what got unlinked during the last tic.
+		Level->blockmap.CompactThings();
+
+		// Hitscan batches never span tics, so this ends any that a script left
+		// open, for example because the VM aborted in the middle of an attack.
+		Level->blockmap.ResetLineBatch();
+
 		P_ThinkParticles(Level);	// [RH] make the particles think
 
 		for (i = 0; i < MAXPLAYERS; i++)
@@ -47,6 +47,7 @@
 
 EXTERN_CVAR (Bool, cl_spreaddecals)
 EXTERN_CVAR (Int, cl_maxdecals)
+EXTERN_CVAR (Int, cl_maxwalldecals)
 
 
 //----------------------------------------------------------------------------
@@ -668,6 +669,27 @@ void DImpactDecal::CheckMax ()
 {
 	static int SpawnCounter;
 
+	// Walls keep their decals in the order they were created, so the first
+	// impact decal on this one is the oldest.
+	if (cl_maxwalldecals > 0 && Side != nullptr)
+	{
+		DBaseDecal *oldest = nullptr;
+		int count = 0;
+		for (DBaseDecal *decal = Side->AttachedDecals; decal != nullptr; decal = decal->WallNext)
+		{
+			if (decal->IsKindOf(RUNTIME_CLASS(DImpactDecal)))
+			{
+				if (oldest == nullptr) oldest = decal;
+				count++;
+			}
+		}
+		if (count > cl_maxwalldecals && oldest != this)
+		{
+			oldest->Destroy();
+			Level->ImpactDecalCount--;
+		}
+	}
+
 	if (++Level->ImpactDecalCount >= cl_maxdecals)
 	{
 		DThinker *thinker = Level->FirstThinker (STAT_AUTODECAL);
@@ -64,11 +64,24 @@
 #include "a_dynlight.h"
 #include "actorinlines.h"
 #include "memarena.h"
+#include "stats.h"
 
-static FMemArena DynLightArena(sizeof(FDynamicLight) * 200);
+static FMemArena DynLightArena(sizeof(FDynamicLight) * 200, "DynLights");
 static TArray<FDynamicLight*> FreeList;
+static FMemArena LightNodeArena(sizeof(FLightNode) * 1024, "LightNodes");
+static TArray<FLightNode*> FreeLightNodes;
 static FRandom randLight;
 
+// Lookup for the nodes of the light currently being relinked, so that
+// AddLightNode does not have to search long node lists for every target.
+static TMap<void *, FLightNode *> RelinkNodes;
+static bool RelinkUseMap;
+enum { RELINK_MAP_THRESHOLD = 16 };
+
+// Relink statistics for the last complete tic.
+static int RelinkTime, RelinkCount, LastRelinkCount;
+static int LinkedNodeCount;
+
 extern TArray<FLightDefaults *> StateLights;
 
 
@@ -427,7 +440,20 @@ FLightNode * AddLightNode(FLightNode ** thread, void * linkto, FDynamicLight * l
 {
 	FLightNode * node;
 
-	node = nextnode;
+	if (RelinkUseMap)
+	{
+		FLightNode **pnode = RelinkNodes.CheckKey(linkto);
+		if (pnode != nullptr)
+		{
+			(*pnode)->lightsource = light;
+			return(nextnode);
+		}
+		node = nullptr;
+	}
+	else
+	{
+		node = nextnode;
+	}
 	while (node)
     {
 		if (node->targ==linkto)   // Already have a node for this sector?
@@ -441,7 +467,10 @@ FLightNode * AddLightNode(FLightNode ** thread, void * linkto, FDynamicLight * l
 	// Couldn't find an existing node for this sector. Add one at the head
 	// of the list.
 	
-	node = new FLightNode;
+	if (FreeLightNodes.Size() > 0) FreeLightNodes.Pop(node);
+	else node = (FLightNode *)LightNodeArena.Alloc(sizeof(FLightNode));
+	LinkedNodeCount++;
+	if (RelinkUseMap) RelinkNodes[linkto] = node;
 	
 	node->targ = linkto;
 	node->lightsource = light; 
@@ -484,7 +513,8 @@ static FLightNode * DeleteLightNode(FLightNode * node)
 		
 		// Return this node to the freelist
 		tn=node->nextTarget;
-		delete node;
+		FreeLightNodes.Push(node);
+		LinkedNodeCount--;
 		return(tn);
 	}
 	return(nullptr);
@@ -662,18 +692,38 @@ void FDynamicLight::LinkLight()
 {
 	// mark the old light nodes
 	FLightNode * node;
+	int numnodes = 0;
+
+	if (Level->maptime != RelinkTime)
+	{
+		LastRelinkCount = RelinkCount;
+		RelinkCount = 0;
+		RelinkTime = Level->maptime;
+	}
+	RelinkCount++;
 	
 	node = touching_sides;
 	while (node)
     {
 		node->lightsource = nullptr;
 		node = node->nextTarget;
+		numnodes++;
     }
 	node = touching_sector;
 	while (node)
 	{
 		node->lightsource = nullptr;
 		node = node->nextTarget;
+		numnodes++;
+	}
+
+	// Sides and sections are never the same object, so one map can hold both lists.
+	RelinkUseMap = numnodes > RELINK_MAP_THRESHOLD;
+	if (RelinkUseMap)
+	{
+		RelinkNodes.Clear();
+		for (node = touching_sides; node; node = node->nextTarget) RelinkNodes[node->targ] = node;
+		for (node = touching_sector; node; node = node->nextTarget) RelinkNodes[node->targ] = node;
 	}
 
 	if (radius>0)
@@ -686,6 +736,7 @@ void FDynamicLight::LinkLight()
 		CollectWithinRadius(Pos, sect, float(radius*radius));
 
 	}
+	RelinkUseMap = false;
 		
 	// Now delete any nodes that won't be used. These are the ones where
 	// m_thing is still nullptr.
@@ -714,6 +765,19 @@ void FDynamicLight::LinkLight()
 }
 
 
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+ADD_STAT(lightlinks)
+{
+	FString out;
+	out.Format("Light relinks = %d per tic, %d light nodes", LastRelinkCount, LinkedNodeCount);
+	return out;
+}
+
 //==========================================================================
 //
 // Deletes the link lists
@@ -820,6 +820,9 @@ public:
 	// Enter the crash state
 	void Crash();
 
+	// True if an actor at rest can skip the movement part of Tick
+	bool CanSleep();
+
 	// Return starting health adjusted by skill level
 	double AttackOffset(double offset = 0);
 	int SpawnHealth() const;
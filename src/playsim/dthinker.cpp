@@ -67,6 +67,13 @@ static TMap<FName, ProfileInfo> Profiles;
 static unsigned int profilethinkers, profilelimit;
 DThinker *NextToThink;
 
+// Runs the read-only part of the monster AI (sight checks) in parallel
+// before the serial tick. The results are only used when they are
+// guaranteed to be the same, so this does not affect demo or net sync.
+// The results go into the sight cache, so this needs sv_sightcache.
+CVAR(Bool, think_multithreaded, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+EXTERN_CVAR(Bool, sv_sightcache)
+
 //==========================================================================
 //
 //
@@ -88,6 +95,17 @@ void FThinkerCollection::Link(DThinker *thinker, int statnum)
 	list->AddTail(thinker);
 }
 
+//==========================================================================
+//
+// Number of thinkers that ran their full Tick in the last RunThinkers call.
+//
+//==========================================================================
+
+int FThinkerCollection::AwakeCount() const
+{
+	return ThinkCount - SleepingCount;
+}
+
 //==========================================================================
 //
 //
@@ -96,9 +114,11 @@ void FThinkerCollection::Link(DThinker *thinker, int statnum)
 
 void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 {
+	FTraceZone zone("RunThinkers");
 	int i, count;
 
 	ThinkCount = 0;
+	SleepingCount = 0;
 	ThinkCycles.Reset();
 	BotSupportCycles.Reset();
 	ActionCycles.Reset();
@@ -106,6 +126,11 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 
 	ThinkCycles.Clock();
 
+	if (think_multithreaded && sv_sightcache)
+	{
+		P_PlanSightChecks(Level);
+	}
+
 	if (!profilethinkers)
 	{
 		// Tick every thinker left from last time
@@ -712,7 +737,7 @@ DEFINE_ACTION_FUNCTION(DThinker, PostBeginPlay)
 void DThinker::CallPostBeginPlay()
 {
 	ObjectFlags |= OF_Spawned;
-	IFVIRTUAL(DThinker, PostBeginPlay)
+	IFOVERRIDENVIRTUAL(DThinker, PostBeginPlay)
 	{
 		// Without the type cast this picks the 'void *' assignment...
 		VMValue params[1] = { (DObject*)this };
@@ -849,7 +874,9 @@ DEFINE_ACTION_FUNCTION(DThinker, Tick)
 
 void DThinker::CallTick()
 {
-	IFVIRTUAL(DThinker, Tick)
+	// Classes that do not override Tick in ZScript still have DThinker's
+	// native thunk in this slot, which does nothing but call Tick() again.
+	IFOVERRIDENVIRTUAL(DThinker, Tick)
 	{
 		// Without the type cast this picks the 'void *' assignment...
 		VMValue params[1] = { (DObject*)this };
@@ -1004,6 +1031,7 @@ DThinker *FThinkerIterator::Next (bool exact)
 ADD_STAT (think)
 {
 	FString out;
-	out.Format ("Think time = %04.2f ms - %d thinkers, Action = %04.2f ms", ThinkCycles.TimeMS(), ThinkCount, ActionCycles.TimeMS());
+	out.Format ("Think time = %04.2f ms - %d thinkers (%d awake, %d sleeping), Action = %04.2f ms", ThinkCycles.TimeMS(), ThinkCount,
+		primaryLevel->Thinkers.AwakeCount(), primaryLevel->Thinkers.SleepingCount, ActionCycles.TimeMS());
 	return out;
 }
@@ -84,6 +84,10 @@ struct FThinkerCollection
 	void MarkRoots();
 	DThinker *FirstThinker(int statnum);
 	void Link(DThinker *thinker, int statnum);
+	int AwakeCount() const;
+
+	// Actors that skipped their movement code in the last RunThinkers call.
+	int SleepingCount = 0;
 
 private:
 	FThinkerList Thinkers[MAX_STATNUM + 2];
@@ -2137,6 +2137,7 @@ void FParser::SF_SetLineBlocking(void)
 			{
 				Level->lines[i].flags = (Level->lines[i].flags & ~(ML_BLOCKING | ML_BLOCKEVERYTHING)) | blocking;
 			}
+			P_InvalidateSightCache();
 		}
 	}
 }
@@ -3801,6 +3802,7 @@ void FParser::SF_SetLineTrigger()
 				(f & ~(ML_MONSTERSCANACTIVATE | ML_REPEAT_SPECIAL | ML_SPAC_MASK | ML_FIRSTSIDEONLY));
 
 		}
+		P_InvalidateSightCache();
 	}
 }
 
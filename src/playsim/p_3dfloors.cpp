@@ -295,6 +295,44 @@ bool P_CheckFor3DCeilingHit(AActor * mo, double z, bool trigger)
 	return false;
 }
 
+//==========================================================================
+//
+// Checks whether the inputs to the ffloors sort have changed since it
+// last ran. The sort only depends on the order, flags and heights at the
+// center spot of the non-dynamic floors and running it again on its own
+// output reproduces that output, so if none of these changed it can be
+// skipped, together with reallocating all the dynamic clip floors.
+//
+//==========================================================================
+
+static bool P_3DFloorSortChanged(sector_t *sector)
+{
+	static TArray<extsector_t::xfloor::sortkey> newkeys;
+	auto &x = sector->e->XFloor;
+
+	newkeys.Clear();
+	for (auto rover : x.ffloors)
+	{
+		if (rover->flags & FF_DYNAMIC) continue;
+
+		extsector_t::xfloor::sortkey &key = newkeys[newkeys.Reserve(1)];
+		key.rover = rover;
+		key.flags = (rover->flags & FF_CLIPPED) ? (rover->flags & ~FF_CLIPPED) | FF_EXISTS : rover->flags;
+		key.top = rover->top.plane->ZatPoint(sector->centerspot);
+		key.bottom = rover->bottom.plane->ZatPoint(sector->centerspot);
+	}
+	if (newkeys.Size() == x.sortkeys.Size())
+	{
+		unsigned i;
+		for (i = 0; i < newkeys.Size() && newkeys[i] == x.sortkeys[i]; i++)
+		{
+		}
+		if (i == newkeys.Size()) return false;
+	}
+	std::swap(newkeys, x.sortkeys);
+	return true;
+}
+
 //==========================================================================
 //
 // P_Recalculate3DFloors
@@ -324,7 +362,7 @@ void P_Recalculate3DFloors(sector_t * sector)
 
 	// Sort the floors top to bottom for quicker access here and later
 	// Translucent and swimmable floors are split if they overlap with solid ones.
-	if (ffloors.Size()>1)
+	if (ffloors.Size()>1 && P_3DFloorSortChanged(sector))
 	{
 		TArray<F3DFloor*> oldlist = std::move(ffloors);
 
@@ -563,6 +601,9 @@ void FLevelLocals::ClearDynamic3DFloorData()
 	{
 		TArray<F3DFloor*> & ffloors = sec.e->XFloor.ffloors;
 
+		// the sort needs to run again to recreate what gets removed here.
+		sec.e->XFloor.sortkeys.Clear();
+
 		// delete the dynamic stuff
 		for (unsigned i = 0; i < ffloors.Size(); i++)
 		{
@@ -926,8 +926,7 @@ void ACSStringPool::PoolEntry::Unlock(int levelnum)
 
 ACSStringPool::ACSStringPool()
 {
-	memset(PoolBuckets, 0xFF, sizeof(PoolBuckets));
-	FirstFreeEntry = 0;
+	Clear();
 }
 
 //============================================================================
@@ -941,8 +940,35 @@ ACSStringPool::ACSStringPool()
 void ACSStringPool::Clear()
 {
 	Pool.Clear();
-	memset(PoolBuckets, 0xFF, sizeof(PoolBuckets));
+	PoolBuckets.Resize(MIN_BUCKETS);
+	memset(PoolBuckets.Data(), 0xFF, PoolBuckets.Size() * sizeof(unsigned int));
 	FirstFreeEntry = 0;
+	NumLive = 0;
+	NumBytes = 0;
+}
+
+//============================================================================
+//
+// ACSStringPool :: Rehash
+//
+// Rebuilds the hash chains of all live strings for a new bucket count.
+//
+//============================================================================
+
+void ACSStringPool::Rehash(unsigned int numbuckets)
+{
+	PoolBuckets.Resize(numbuckets);
+	memset(PoolBuckets.Data(), 0xFF, PoolBuckets.Size() * sizeof(unsigned int));
+	for (unsigned int i = 0; i < Pool.Size(); ++i)
+	{
+		PoolEntry *entry = &Pool[i];
+		if (entry->Next != FREE_ENTRY)
+		{
+			unsigned int b = Bucket(entry->Hash);
+			entry->Next = PoolBuckets[b];
+			PoolBuckets[b] = i;
+		}
+	}
 }
 
 //============================================================================
@@ -959,26 +985,24 @@ int ACSStringPool::AddString(const char *str)
 	if (str == nullptr) str = "";
 	size_t len = strlen(str);
 	unsigned int h = SuperFastHash(str, len);
-	unsigned int bucketnum = h % NUM_BUCKETS;
-	int i = FindString(str, len, h, bucketnum);
+	int i = FindString(str, len, h);
 	if (i >= 0)
 	{
 		return i | STRPOOL_LIBRARYID_OR;
 	}
 	FString fstr(str);
-	return InsertString(fstr, h, bucketnum);
+	return InsertString(fstr, h);
 }
 
 int ACSStringPool::AddString(FString &str)
 {
 	unsigned int h = SuperFastHash(str.GetChars(), str.Len());
-	unsigned int bucketnum = h % NUM_BUCKETS;
-	int i = FindString(str, str.Len(), h, bucketnum);
+	int i = FindString(str, str.Len(), h);
 	if (i >= 0)
 	{
 		return i | STRPOOL_LIBRARYID_OR;
 	}
-	return InsertString(str, h, bucketnum);
+	return InsertString(str, h);
 }
 
 //============================================================================
@@ -1140,7 +1164,7 @@ void ACSStringPool::PurgeStrings()
 {
 	// Clear the hash buckets. We'll rebuild them as we decide what strings
 	// to keep and which to toss.
-	memset(PoolBuckets, 0xFF, sizeof(PoolBuckets));
+	memset(PoolBuckets.Data(), 0xFF, PoolBuckets.Size() * sizeof(unsigned int));
 	size_t usedcount = 0, freedcount = 0;
 	for (unsigned int i = 0; i < Pool.Size(); ++i)
 	{
@@ -1150,6 +1174,8 @@ void ACSStringPool::PurgeStrings()
 			if (entry->Locks.Size() == 0 && !entry->Mark)
 			{
 				freedcount++;
+				NumLive--;
+				NumBytes -= entry->Str.Len() + 1;
 				// Mark this entry as free.
 				entry->Next = FREE_ENTRY;
 				if (i < FirstFreeEntry)
@@ -1163,7 +1189,7 @@ void ACSStringPool::PurgeStrings()
 			{
 				usedcount++;
 				// Rehash this entry.
-				unsigned int h = entry->Hash % NUM_BUCKETS;
+				unsigned int h = Bucket(entry->Hash);
 				entry->Next = PoolBuckets[h];
 				PoolBuckets[h] = i;
 				// Remove MarkString's mark.
@@ -1182,9 +1208,9 @@ void ACSStringPool::PurgeStrings()
 //
 //============================================================================
 
-int ACSStringPool::FindString(const char *str, size_t len, unsigned int h, unsigned int bucketnum)
+int ACSStringPool::FindString(const char *str, size_t len, unsigned int h)
 {
-	unsigned int i = PoolBuckets[bucketnum];
+	unsigned int i = PoolBuckets[Bucket(h)];
 	while (i != NO_ENTRY)
 	{
 		PoolEntry *entry = &Pool[i];
@@ -1207,7 +1233,7 @@ int ACSStringPool::FindString(const char *str, size_t len, unsigned int h, unsig
 //
 //============================================================================
 
-int ACSStringPool::InsertString(FString &str, unsigned int h, unsigned int bucketnum)
+int ACSStringPool::InsertString(FString &str, unsigned int h)
 {
 	unsigned int index = FirstFreeEntry;
 	if (index >= MIN_GC_SIZE && index == Pool.Max())
@@ -1228,6 +1254,13 @@ int ACSStringPool::InsertString(FString &str, unsigned int h, unsigned int bucke
 	{ // Scan for the next free entry
 		FindFirstFreeEntry(FirstFreeEntry + 1);
 	}
+	// Keep the hash chains short. This has to be done after the collection
+	// above, which rebuilds the buckets.
+	if (NumLive >= PoolBuckets.Size() * 2)
+	{
+		Rehash(PoolBuckets.Size() * 2);
+	}
+	unsigned int bucketnum = Bucket(h);
 	PoolEntry *entry = &Pool[index];
 	entry->Str = str;
 	entry->Hash = h;
@@ -1235,6 +1268,8 @@ int ACSStringPool::InsertString(FString &str, unsigned int h, unsigned int bucke
 	entry->Mark = false;
 	entry->Locks.Clear();
 	PoolBuckets[bucketnum] = index;
+	NumLive++;
+	NumBytes += str.Len() + 1;
 	return index | STRPOOL_LIBRARYID_OR;
 }
 
@@ -1294,10 +1329,12 @@ void ACSStringPool::ReadStrings(FSerializer &file, const char *key)
 							("locks", Pool[ii].Locks);
 
 						unsigned h = SuperFastHash(Pool[ii].Str, Pool[ii].Str.Len());
-						unsigned bucketnum = h % NUM_BUCKETS;
+						unsigned bucketnum = Bucket(h);
 						Pool[ii].Hash = h;
 						Pool[ii].Next = PoolBuckets[bucketnum];
 						PoolBuckets[bucketnum] = ii;
+						NumLive++;
+						NumBytes += Pool[ii].Str.Len() + 1;
 					}
 					file.EndObject();
 				}
@@ -1306,6 +1343,13 @@ void ACSStringPool::ReadStrings(FSerializer &file, const char *key)
 	}
 
 	FindFirstFreeEntry(FirstFreeEntry);
+
+	unsigned int numbuckets = MIN_BUCKETS;
+	while (NumLive >= numbuckets * 2) numbuckets *= 2;
+	if (numbuckets != PoolBuckets.Size())
+	{
+		Rehash(numbuckets);
+	}
 }
 
 //============================================================================
@@ -6193,6 +6237,7 @@ doplaysound:			if (funcIndex == ACSF_PlayActorSound)
 				{
 					Level->lines[line].activation = args[1];
 				}
+				P_InvalidateSightCache();
 			}
 			break;
 
@@ -6765,8 +6810,34 @@ PClass *DLevelScript::GetClassForIndex(int index) const
 	return PClass::FindActor(Level->Behaviors.LookupString(index));
 }
 
+//============================================================================
+//
+// FACSProfileScope
+//
+// Lets the script profiler see ACS scripts in its call tree.
+//
+//============================================================================
+
+struct FACSProfileScope
+{
+	bool Active;
+
+	FACSProfileScope(int script) : Active(VMProfiling)
+	{
+		if (Active)
+		{
+			VMProfileEnter((uintptr_t(intptr_t(script)) << 1) | 1, [](uintptr_t key) { return ScriptPresentation(int(intptr_t(key) >> 1)); });
+		}
+	}
+	~FACSProfileScope()
+	{
+		if (Active) VMProfileLeave();
+	}
+};
+
 int DLevelScript::RunScript()
 {
+	FACSProfileScope profile(script);
 	DACSThinker *controller = Level->ACSThinker;
 	ACSLocalVariables locals(Localvars);
 	ACSLocalArrays noarrays;
@@ -6841,6 +6912,14 @@ int DLevelScript::RunScript()
 		break;
 	}
 
+	// A script that is still waiting has nothing else to do this tic. The
+	// code after the interpreter loop would only store the unchanged pc.
+	if (state != SCRIPT_Running && state != SCRIPT_PleaseRemove &&
+		state != SCRIPT_DivideBy0 && state != SCRIPT_ModulusBy0)
+	{
+		return resultValue;
+	}
+
 	FACSStack stackobj;
 	FACSStackMemory& Stack = stackobj.buffer;
 	int &sp = stackobj.sp;
@@ -8332,6 +8411,7 @@ scriptwait:
 			if (activationline != NULL)
 			{
 				activationline->special = 0;
+				P_InvalidateSightCache();
 				DPrintf(DMSG_SPAMMY, "Cleared line special on line %d\n", activationline->Index());
 			}
 			break;
@@ -8939,6 +9019,7 @@ scriptwait:
 						break;
 					}
 				}
+				P_InvalidateSightCache();
 
 				sp -= 2;
 			}
@@ -8987,6 +9068,7 @@ scriptwait:
 					DPrintf(DMSG_SPAMMY, "Set special on line %d (id %d) to %d(%d,%d,%d,%d,%d)\n",
 						linenum, STACK(7), specnum, arg0, STACK(4), STACK(3), STACK(2), STACK(1));
 				}
+				P_InvalidateSightCache();
 				sp -= 7;
 			}
 			break;
@@ -10768,5 +10850,5 @@ CCMD(acsprofile)
 
 ADD_STAT(ACS)
 {
-	return FStringf("ACS time: %f ms", ACSTime.TimeMS());
+	return FStringf("ACS time: %f ms, %u strings (%zu bytes)", ACSTime.TimeMS(), GlobalACSStrings.LiveCount(), GlobalACSStrings.LiveBytes());
 }
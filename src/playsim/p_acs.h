@@ -116,13 +116,17 @@ public:
 	void UnlockForLevel(int level)	;
 	void ReadStrings(FSerializer &file, const char *key);
 	void WriteStrings(FSerializer &file, const char *key) const;
+	unsigned int LiveCount() const { return NumLive; }
+	size_t LiveBytes() const { return NumBytes; }
 
 private:
-	int FindString(const char *str, size_t len, unsigned int h, unsigned int bucketnum);
-	int InsertString(FString &str, unsigned int h, unsigned int bucketnum);
+	int FindString(const char *str, size_t len, unsigned int h);
+	int InsertString(FString &str, unsigned int h);
 	void FindFirstFreeEntry(unsigned int base);
+	void Rehash(unsigned int numbuckets);
+	unsigned int Bucket(unsigned int h) const { return h & (PoolBuckets.Size() - 1); }
 
-	enum { NUM_BUCKETS = 251 };
+	enum { MIN_BUCKETS = 256 };			// Must be a power of 2. Grows with the number of live strings.
 	enum { FREE_ENTRY = 0xFFFFFFFE };	// Stored in PoolEntry's Next field
 	enum { NO_ENTRY = 0xFFFFFFFF };
 	enum { MIN_GC_SIZE = 100 };			// Don't auto-collect until there are this many strings
@@ -138,8 +142,10 @@ private:
 		void Unlock(int levelnum);
 	};
 	TArray<PoolEntry> Pool;
-	unsigned int PoolBuckets[NUM_BUCKETS];
+	TArray<unsigned int> PoolBuckets;
 	unsigned int FirstFreeEntry;
+	unsigned int NumLive;
+	size_t NumBytes;
 };
 extern ACSStringPool GlobalACSStrings;
 
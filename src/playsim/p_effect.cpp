@@ -129,7 +129,7 @@ void P_InitParticles (FLevelLocals *Level)
 		num = r_maxparticles;
 
 	// This should be good, but eh...
-	int NumParticles = clamp<int>(num, 100, 65535);
+	int NumParticles = clamp<int>(num, 100, MAX_PARTICLES);
 
 	Level->Particles.Resize(NumParticles);
 	P_ClearParticles (Level);
@@ -157,13 +157,16 @@ void P_FindParticleSubsectors (FLevelLocals *Level)
 		Level->ParticlesInSubsec.Reserve (Level->subsectors.Size() - Level->ParticlesInSubsec.Size());
 	}
 
-	fillshort (&Level->ParticlesInSubsec[0], Level->subsectors.Size(), NO_PARTICLE);
+	for (unsigned i = 0; i < Level->subsectors.Size(); i++)
+	{
+		Level->ParticlesInSubsec[i] = NO_PARTICLE;
+	}
 
 	if (!r_particles)
 	{
 		return;
 	}
-	for (uint16_t i = Level->ActiveParticles; i != NO_PARTICLE; i = Level->Particles[i].tnext)
+	for (uint32_t i = Level->ActiveParticles; i != NO_PARTICLE; i = Level->Particles[i].tnext)
 	{
 		 // Try to reuse the subsector from the last portal check, if still valid.
 		if (Level->Particles[i].subsector == nullptr) Level->Particles[i].subsector = Level->PointInRenderSubsector(Level->Particles[i].Pos);
@@ -212,9 +215,15 @@ void P_InitEffects ()
 
 void P_ThinkParticles (FLevelLocals *Level)
 {
-	int i;
+	static TArray<particle_t *> moved;
+	static TArray<DVector2> movedpos;
+	static TArray<subsector_t *> movedssec;
+	uint32_t i;
 	particle_t *particle, *prev;
 
+	moved.Clear();
+	movedpos.Clear();
+
 	i = Level->ActiveParticles;
 	prev = NULL;
 	while (i != NO_PARTICLE)
@@ -248,7 +257,19 @@ void P_ThinkParticles (FLevelLocals *Level)
 		particle->Pos.Y = newxy.Y;
 		particle->Pos.Z += particle->Vel.Z;
 		particle->Vel += particle->Acc;
-		particle->subsector = Level->PointInRenderSubsector(particle->Pos);
+		moved.Push(particle);
+		movedpos.Push(particle->Pos.XY());
+		prev = particle;
+	}
+
+	// Find the new subsectors of all moved particles in one go.
+	movedssec.Resize(moved.Size());
+	Level->PointInRenderSubsectors(movedpos.Data(), movedssec.Data(), moved.Size());
+
+	for (unsigned j = 0; j < moved.Size(); j++)
+	{
+		particle = moved[j];
+		particle->subsector = movedssec[j];
 		sector_t *s = particle->subsector->sector;
 		// Handle crossing a sector portal.
 		if (!s->PortalBlocksMovement(sector_t::ceiling))
@@ -267,7 +288,6 @@ void P_ThinkParticles (FLevelLocals *Level)
 				particle->subsector = NULL;
 			}
 		}
-		prev = particle;
 	}
 }
 
@@ -315,13 +335,15 @@ particle_t *JitterParticle (FLevelLocals *Level, int ttl, double drift)
 
 	if (particle) {
 		int i;
+		uint32_t rnd[6];
 
+		M_Random.GenRand32(rnd, 6);
 		// Set initial velocities
 		for (i = 3; i; i--)
-			particle->Vel[i] = ((1./4096) * (M_Random () - 128) * drift);
+			particle->Vel[i] = ((1./4096) * (int(rnd[3 - i] & 255) - 128) * drift);
 		// Set initial accelerations
 		for (i = 3; i; i--)
-			particle->Acc[i] = ((1./16384) * (M_Random () - 128) * drift);
+			particle->Acc[i] = ((1./16384) * (int(rnd[6 - i] & 255) - 128) * drift);
 
 		particle->alpha = 1.f;	// fully opaque
 		particle->ttl = ttl;
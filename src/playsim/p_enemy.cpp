@@ -1254,13 +1254,16 @@ int P_LookForMonsters (AActor *actor)
 AActor *LookForTIDInBlock (AActor *lookee, int index, void *extparams)
 {
 	FLookExParams *params = (FLookExParams *)extparams;
-	FBlockNode *block;
 	AActor *link;
 	AActor *other;
 	
-	for (block = lookee->Level->blockmap.blocklinks[index]; block != NULL; block = block->NextActor)
+	auto &things = lookee->Level->blockmap.blockthings[index];
+
+	for (int i = things.Actors.Size() - 1; i >= 0; i--)
 	{
-		link = block->Me;
+		link = things.Actors[i];
+		if (link == nullptr)
+			continue;
 
         if (!(link->flags & MF_SHOOTABLE))
 			continue;			// not shootable (observer or dead)
@@ -1424,14 +1427,17 @@ int P_LookForTID (AActor *actor, INTBOOL allaround, FLookExParams *params)
 
 AActor *LookForEnemiesInBlock (AActor *lookee, int index, void *extparam)
 {
-	FBlockNode *block;
 	AActor *link;
 	AActor *other;
 	FLookExParams *params = (FLookExParams *)extparam;
 	
-	for (block = lookee->Level->blockmap.blocklinks[index]; block != NULL; block = block->NextActor)
+	auto &things = lookee->Level->blockmap.blockthings[index];
+
+	for (int i = things.Actors.Size() - 1; i >= 0; i--)
 	{
-		link = block->Me;
+		link = things.Actors[i];
+		if (link == nullptr)
+			continue;
 
         if (!(link->flags & MF_SHOOTABLE))
 			continue;			// not shootable (observer or dead)
@@ -758,7 +758,7 @@ DEFINE_ACTION_FUNCTION(AActor, Die)
 
 void AActor::CallDie(AActor *source, AActor *inflictor, int dmgflags, FName MeansOfDeath)
 {
-	IFVIRTUAL(AActor, Die)
+	IFOVERRIDENVIRTUAL(AActor, Die)
 	{
 		VMValue params[] = { (DObject*)this, source, inflictor, dmgflags, MeansOfDeath.GetIndex() };
 		VMCall(func, params, 5, nullptr, 0);
@@ -1509,7 +1509,7 @@ DEFINE_ACTION_FUNCTION(AActor, DamageMobj)
 
 int P_DamageMobj(AActor *target, AActor *inflictor, AActor *source, int damage, FName mod, int flags, DAngle angle)
 {
-	IFVIRTUALPTR(target, AActor, DamageMobj)
+	IFOVERRIDENVIRTUALPTR(target, AActor, DamageMobj)
 	{
 		VMValue params[7] = { target, inflictor, source, damage, mod.GetIndex(), flags, angle.Degrees };
 		VMReturn ret;
@@ -1658,7 +1658,7 @@ DEFINE_ACTION_FUNCTION(AActor, OkayToSwitchTarget)
 
 bool AActor::CallOkayToSwitchTarget(AActor *other)
 {
-	IFVIRTUAL(AActor, OkayToSwitchTarget)
+	IFOVERRIDENVIRTUAL(AActor, OkayToSwitchTarget)
 	{
 		VMValue params[] = { (DObject*)this, other };
 		int retv;
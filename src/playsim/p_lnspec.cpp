@@ -2754,6 +2754,7 @@ FUNC(LS_Line_SetBlocking)
 	{
 		Level->lines[line].flags = (Level->lines[line].flags & ~clearflags) | setflags;
 	}
+	P_InvalidateSightCache();
 	return true;
 }
 
@@ -3250,6 +3251,7 @@ FUNC(LS_GlassBreak)
 	ln->flags &= ~(ML_BLOCKING|ML_BLOCKEVERYTHING);
 	switched = P_ChangeSwitchTexture (ln->sidedef[0], false, 0, &quest1);
 	ln->special = 0;
+	P_InvalidateSightCache();
 	if (ln->sidedef[1] != NULL)
 	{
 		switched |= P_ChangeSwitchTexture (ln->sidedef[1], false, 0, &quest2);
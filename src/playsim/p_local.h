@@ -273,6 +273,8 @@ enum ESightFlags
 };
 
 void	P_ResetSightCounters (bool full);
+void	P_PlanSightChecks (FLevelLocals *Level);
+void	P_InvalidateSightCache ();
 bool	P_TalkFacing (AActor *player);
 void	P_UseLines (player_t* player);
 int	P_UsePuzzleItem (AActor *actor, int itemType);
@@ -403,6 +405,7 @@ int	P_RadiusAttack (AActor *spot, AActor *source, int damage, int distance,
 
 void	P_DelSeclist(msecnode_t *, msecnode_t *sector_t::*seclisthead);
 void	P_DelSeclist(portnode_t *, portnode_t *FLinePortal::*seclisthead);
+void	P_ResetSecnodes();
 
 template<class nodetype, class linktype>
 nodetype *P_AddSecnode(linktype *s, AActor *thing, nodetype *nextnode, nodetype *&sec_thinglist);
@@ -5641,6 +5641,7 @@ int P_UsePuzzleItem(AActor *PuzzleItemUser, int PuzzleItemType)
 			int args[3] = { in->d.line->args[2], in->d.line->args[3], in->d.line->args[4] };
 			P_StartScript(PuzzleItemUser->Level, PuzzleItemUser, in->d.line, in->d.line->args[1], NULL, args, 3, ACS_ALWAYS);
 			in->d.line->special = 0;
+			P_InvalidateSightCache();
 			return true;
 		}
 		// Check thing
@@ -5861,7 +5862,7 @@ int P_RadiusAttack(AActor *bombspot, AActor *bombsource, int bombdamage, int bom
 
 	P_GeometryRadiusAttack(bombspot, bombsource, bombdamage, bombdistance, bombmod, fulldamagedistance);
 
-	TArray<AActor*> targets;
+	TSmallArray<AActor*, 32> targets;
 	int count = 0;
 	while ((it.Next(&cres)))
 	{
@@ -6612,6 +6613,8 @@ bool P_ChangeSector(sector_t *sector, int crunch, double amt, int floorOrCeil, b
 	cpos.sector = sector;
 	cpos.instant = instant;
 
+	P_InvalidateSightCache();
+
 	// Also process all sectors that have 3D floors transferred from the
 	// changed sector.
 	if (sector->e->XFloor.attached.Size() && floorOrCeil != 2)
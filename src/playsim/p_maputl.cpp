@@ -340,6 +340,7 @@ void AActor::UnlinkFromWorld (FLinkContext *ctx)
 				block->NextActor->PrevActor = block->PrevActor;
 			}
 			*(block->PrevActor) = block->NextActor;
+			Level->blockmap.UnlinkThing(block);
 			FBlockNode *next = block->NextBlock;
 			block->Release ();
 			block = next;
@@ -551,10 +552,18 @@ void AActor::LinkToWorld(FLinkContext *ctx, bool spawningmapthing, sector_t *sec
 						node->NextBlock = NULL;
 						(*alink) = node;
 						alink = &node->NextBlock;
+						Level->blockmap.LinkThing(node);
 					}
 				}
 			}
 		}
+		if (BlockNode != nullptr && BlockNode->NextBlock != nullptr)
+		{
+			for (FBlockNode *node = BlockNode; node != nullptr; node = node->NextBlock)
+			{
+				Level->blockmap.MarkSpanning(node);
+			}
+		}
 	}
 	// Portal links cannot be done unless the level is fully initialized.
 	if (!spawningmapthing) UpdateRenderSectorList();
@@ -709,6 +718,88 @@ line_t *FBlockLinesIterator::Next()
 	}
 }
 
+//===========================================================================
+//
+// FBlockmap :: BeginLineBatch
+//
+// While a batch is active, path traversals read the lines of each block
+// from a compact copy that is only built once, instead of going through
+// the blockmap lists and the line and vertex structures each time.
+// This is meant for attacks that fire many traces from the same spot.
+//
+//===========================================================================
+
+void FBlockmap::BeginLineBatch()
+{
+	if (linebatch++ == 0) ClearLineBatch();
+}
+
+void FBlockmap::EndLineBatch()
+{
+	if (linebatch > 0 && --linebatch == 0) ClearLineBatch();
+}
+
+void FBlockmap::ClearLineBatch()
+{
+	batchlines.Clear();
+	batchblocks.Clear();
+	batchpolylinks = polylinks;
+}
+
+//===========================================================================
+//
+// FBlockmap :: GetBatchLines
+//
+//===========================================================================
+
+const FBlockLineEntry *FBlockmap::GetBatchLines(FLevelLocals *Level, int x, int y, unsigned &count)
+{
+	count = 0;
+	if (!isValidBlock(x, y)) return nullptr;
+
+	// Polyobjects change the contents of the blocks they move through.
+	// Very large batches get flushed to keep the memory use in check.
+	if (batchpolylinks != polylinks || batchlines.Size() > 65536) ClearLineBatch();
+
+	unsigned offset = y*bmapwidth + x;
+	auto span = batchblocks.CheckKey(offset);
+	if (span == nullptr)
+	{
+		auto addline = [&](line_t *ld)
+		{
+			FBlockLineEntry &entry = batchlines[batchlines.Reserve(1)];
+			entry.Line = ld;
+			entry.Poly = nullptr;
+			entry.Count = 0;
+			entry.X1 = ld->v1->fX();
+			entry.Y1 = ld->v1->fY();
+			entry.X2 = ld->v2->fX();
+			entry.Y2 = ld->v2->fY();
+			entry.DX = ld->Delta().X;
+			entry.DY = ld->Delta().Y;
+		};
+
+		span = &batchblocks.Insert(offset, { batchlines.Size(), 0 });
+		polyblock_t *polyLink = Level->PolyBlockMap.Size() > offset ? Level->PolyBlockMap[offset] : nullptr;
+		for (; polyLink != nullptr; polyLink = polyLink->next)
+		{
+			if (polyLink->polyobj == nullptr) continue;
+			FBlockLineEntry &header = batchlines[batchlines.Reserve(1)];
+			header.Line = nullptr;
+			header.Poly = polyLink->polyobj;
+			header.Count = polyLink->polyobj->Linedefs.Size();
+			for (auto ld : polyLink->polyobj->Linedefs) addline(ld);
+		}
+		for (int *list = GetLines(x, y); *list != -1; list++)
+		{
+			addline(&Level->lines[*list]);
+		}
+		span->Count = batchlines.Size() - span->First;
+	}
+	count = span->Count;
+	return &batchlines[span->First];
+}
+
 //===========================================================================
 //
 // FMultiBlockLinesIterator :: FMultiBlockLinesIterator
@@ -895,7 +986,9 @@ FBlockThingsIterator::FBlockThingsIterator(FLevelLocals *l)
 	minx = maxx = 0;
 	miny = maxy = 0;
 	ClearHash();
-	block = NULL;
+	things = nullptr;
+	thingindex = 0;
+	generation = 0;
 }
 
 FBlockThingsIterator::FBlockThingsIterator(FLevelLocals *l, int _minx, int _miny, int _maxx, int _maxy)
@@ -945,12 +1038,16 @@ void FBlockThingsIterator::StartBlock(int x, int y)
 	cury = y;
 	if (Level->blockmap.isValidBlock(x, y))
 	{
-		block = Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x];
+		things = &Level->blockmap.blockthings[y*Level->blockmap.bmapwidth + x];
+		thingindex = things->Actors.Size();
+		generation = things->Generation;
 	}
 	else
 	{
 		// invalid block
-		block = NULL;
+		things = nullptr;
+		thingindex = 0;
+		generation = 0;
 	}
 }
 
@@ -977,16 +1074,27 @@ AActor *FBlockThingsIterator::Next(bool centeronly)
 {
 	for (;;)
 	{
-		while (block != NULL)
+		// The block got compacted while this iterator was kept across tics.
+		// Entries only ever move down, so clamping is enough to stay in range.
+		if (things != nullptr && generation != things->Generation)
+		{
+			thingindex = MIN(thingindex, (int)things->Actors.Size());
+			generation = things->Generation;
+		}
+
+		// The packed list is walked backwards to get the same order as the block node chain.
+		while (thingindex > 0)
 		{
-			AActor *me = block->Me;
-			FBlockNode *mynode = block;
+			AActor *me = things->Actors[--thingindex];
 			HashEntry *entry;
 			int i;
 
-			block = block->NextActor;
+			if (me == nullptr)
+			{ // unlinked while iterating
+				continue;
+			}
 			// Don't recheck things that were already checked
-			if (mynode->NextBlock == NULL && mynode->PrevBlock == &me->BlockNode)
+			if (!things->Spanning[thingindex])
 			{ // This actor doesn't span blocks, so we know it can only ever be checked once.
 				return me;
 			}
@@ -1161,7 +1269,107 @@ void FMultiBlockThingsIterator::Reset()
 //
 //===========================================================================
 
-TArray<intercept_t> FPathTraverse::intercepts(128);
+thread_local TArray<intercept_t> FPathTraverse::intercepts(128);
+
+//===========================================================================
+//
+// FPathTraverse :: SortIntercepts
+//
+// Stable sort of the intercepts collected by init, so that Next can return
+// them in order instead of searching for the closest one on every call.
+// Intercepts with the same frac keep the order in which they were added,
+// which is what the linear search used to return as well.
+//
+//===========================================================================
+
+static inline uint64_t InterceptKey(double frac)
+{
+	if (frac != frac) return ~(uint64_t)0;	// NaNs never get returned, so keep them at the end.
+	if (frac == 0) frac = 0;				// make -0 and +0 compare equal
+	uint64_t bits;
+	memcpy(&bits, &frac, sizeof(bits));
+	return (bits & 0x8000000000000000ull) ? ~bits : bits | 0x8000000000000000ull;
+}
+
+void FPathTraverse::SortIntercepts()
+{
+	static thread_local TArray<uint64_t> keys, tempkeys;
+	static thread_local TArray<intercept_t> temp;
+
+	intercept_pos = intercept_index;
+	intercept_end = intercepts.Size();
+
+	unsigned num = intercept_end - intercept_index;
+	if (num < 2) return;
+
+	intercept_t *in = &intercepts[intercept_index];
+	keys.Resize(num);
+	for (unsigned i = 0; i < num; i++)
+	{
+		keys[i] = InterceptKey(in[i].frac);
+	}
+
+	if (num <= 64)
+	{
+		for (unsigned i = 1; i < num; i++)
+		{
+			uint64_t key = keys[i];
+			if (keys[i - 1] <= key) continue;
+			intercept_t item = in[i];
+			unsigned j = i;
+			do
+			{
+				keys[j] = keys[j - 1];
+				in[j] = in[j - 1];
+			} while (--j > 0 && keys[j - 1] > key);
+			keys[j] = key;
+			in[j] = item;
+		}
+		return;
+	}
+
+	// LSD radix sort over the 8 bytes of the key. Most bytes are the same for
+	// all intercepts of a trace, so those passes get skipped.
+	unsigned counts[8][256] = {};
+	for (unsigned i = 0; i < num; i++)
+	{
+		for (int b = 0; b < 8; b++)
+		{
+			counts[b][(keys[i] >> (b * 8)) & 255]++;
+		}
+	}
+
+	temp.Resize(num);
+	tempkeys.Resize(num);
+	intercept_t *src = in, *dst = temp.Data();
+	uint64_t *srckeys = keys.Data(), *dstkeys = tempkeys.Data();
+
+	for (int b = 0; b < 8; b++)
+	{
+		unsigned *cnt = counts[b];
+		if (cnt[(srckeys[0] >> (b * 8)) & 255] == num) continue;
+
+		unsigned sum = 0;
+		for (int d = 0; d < 256; d++)
+		{
+			unsigned c = cnt[d];
+			cnt[d] = sum;
+			sum += c;
+		}
+		for (unsigned i = 0; i < num; i++)
+		{
+			unsigned o = cnt[(srckeys[i] >> (b * 8)) & 255]++;
+			dst[o] = src[i];
+			dstkeys[o] = srckeys[i];
+		}
+		std::swap(src, dst);
+		std::swap(srckeys, dstkeys);
+	}
+	if (src != in)
+	{
+		memcpy(in, src, num * sizeof(intercept_t));
+	}
+}
 
 
 //===========================================================================
@@ -1178,6 +1386,12 @@ TArray<intercept_t> FPathTraverse::intercepts(128);
 
 void FPathTraverse::AddLineIntercepts(int bx, int by)
 {
+	if (Level->blockmap.linebatch > 0)
+	{
+		AddBatchedLineIntercepts(bx, by);
+		return;
+	}
+
 	FBlockLinesIterator it(Level, bx, by, bx, by, true);
 	line_t *ld;
 
@@ -1210,6 +1424,60 @@ void FPathTraverse::AddLineIntercepts(int bx, int by)
 }
 
 
+//===========================================================================
+//
+// FPathTraverse :: AddBatchedLineIntercepts
+//
+// Same as above, but uses the block's copy from the active line batch.
+// The results are identical, including the order of the intercepts.
+//
+//===========================================================================
+
+void FPathTraverse::AddBatchedLineIntercepts(int bx, int by)
+{
+	unsigned count;
+	const FBlockLineEntry *entry = Level->blockmap.GetBatchLines(Level, bx, by, count);
+
+	for (const FBlockLineEntry *end = entry + count; entry < end; entry++)
+	{
+		if (entry->Line == nullptr)
+		{
+			if (entry->Poly->validcount == validcount)
+			{
+				entry += entry->Count;
+			}
+			else
+			{
+				entry->Poly->validcount = validcount;
+			}
+			continue;
+		}
+
+		line_t *ld = entry->Line;
+		if (ld->validcount == validcount) continue;
+		ld->validcount = validcount;
+
+		int s1 = P_PointOnDivlineSide (entry->X1, entry->Y1, &trace);
+		int s2 = P_PointOnDivlineSide (entry->X2, entry->Y2, &trace);
+		
+		if (s1 == s2) continue;	// line isn't crossed
+		
+		divline_t dl = { entry->X1, entry->Y1, entry->DX, entry->DY };
+		double frac = P_InterceptVector (&trace, &dl);
+
+		if (frac < Startfrac || frac > 1.) continue;	// behind source or beyond end point
+			
+		intercept_t newintercept;
+
+		newintercept.frac = frac;
+		newintercept.isaline = true;
+		newintercept.done = false;
+		newintercept.d.line = ld;
+		intercepts.Push (newintercept);
+	}
+}
+
+
 //===========================================================================
 //
 // FPathTraverse :: AddThingIntercepts
@@ -1396,6 +1664,22 @@ intercept_t *FPathTraverse::Next()
 {
 	intercept_t *in = NULL;
 
+	// As long as no nested traversal has added its own intercepts on top of
+	// ours, the next one is simply the first unused one in the sorted range.
+	if (intercepts.Size() == intercept_end)
+	{
+		while (intercept_pos < intercept_end && intercepts[intercept_pos].done)
+		{
+			intercept_pos++;
+		}
+		if (intercept_pos == intercept_end) return NULL;
+		in = &intercepts[intercept_pos];
+		if (!(in->frac <= 1.)) return NULL;	// checked everything in range
+		intercept_pos++;
+		in->done = true;
+		return in;
+	}
+
 	double dist = FLT_MAX;
 	for (unsigned scanpos = intercept_index; scanpos < intercepts.Size (); scanpos++)
 	{
@@ -1626,6 +1910,7 @@ void FPathTraverse::init(double x1, double y1, double x2, double y2, int flags,
 			break;
 		}
 	}
+	SortIntercepts();
 }
 
 //===========================================================================
@@ -1796,23 +2081,24 @@ static AActor *RoughBlockCheck (AActor *mo, int index, void *param)
 {
 	BlockCheckInfo *info = (BlockCheckInfo *)param;
 
-	FBlockNode *link;
+	auto &things = mo->Level->blockmap.blockthings[index];
 
-	for (link = mo->Level->blockmap.blocklinks[index]; link != NULL; link = link->NextActor)
+	for (int i = things.Actors.Size() - 1; i >= 0; i--)
 	{
-		if (link->Me != mo)
+		AActor *link = things.Actors[i];
+		if (link != nullptr && link != mo)
 		{
-			if (info->onlyseekable && !mo->CanSeek(link->Me))
+			if (info->onlyseekable && !mo->CanSeek(link))
 			{
 				continue;
 			}
-			if (info->frontonly && P_PointOnDivlineSide(link->Me->X(), link->Me->Y(), &info->frontline) != 0)
+			if (info->frontonly && P_PointOnDivlineSide(link->X(), link->Y(), &info->frontline) != 0)
 			{
 				continue;
 			}
-			if (mo->IsOkayToAttack (link->Me))
+			if (mo->IsOkayToAttack (link))
 			{
-				return link->Me;
+				return link;
 			}
 		}
 	}
@@ -1937,6 +2223,129 @@ int P_VanillaPointOnLineSide(double x, double y, const line_t* line)
 	return 1;			// back side
 }
 
+//==========================================================================
+//
+// FPackedBSP :: Build
+//
+// Copies the partition lines and children of a node tree into a dense
+// array, so that descending it touches 24 bytes per node instead of a
+// full node_t with its bounding boxes.
+//
+//==========================================================================
+
+void FPackedBSP::Build(node_t *nodes, unsigned numnodes, subsector_t *subsectors)
+{
+	Nodes.Resize(numnodes);
+	Subsectors = subsectors;
+	for (unsigned i = 0; i < numnodes; i++)
+	{
+		FPackedNode &pn = Nodes[i];
+		pn.x = nodes[i].x;
+		pn.y = nodes[i].y;
+		pn.dx = nodes[i].dx;
+		pn.dy = nodes[i].dy;
+		for (int j = 0; j < 2; j++)
+		{
+			void *child = nodes[i].children[j];
+			if ((size_t)child & 1)
+			{
+				pn.children[j] = ~int((subsector_t *)((uint8_t *)child - 1) - subsectors);
+			}
+			else
+			{
+				pn.children[j] = int((node_t *)child - nodes);
+			}
+		}
+	}
+}
+
+//==========================================================================
+//
+// FPackedBSP :: PointInSubsector
+//
+// Same test as R_PointOnSide.
+//
+//==========================================================================
+
+subsector_t *FPackedBSP::PointInSubsector(fixed_t x, fixed_t y) const
+{
+	const FPackedNode *nodes = Nodes.Data();
+	int n = Nodes.Size() - 1;
+	do
+	{
+		const FPackedNode &node = nodes[n];
+		n = node.children[DMulScale32(y - node.y, node.dx, node.x - x, node.dy) > 0];
+	} while (n >= 0);
+	return &Subsectors[~n];
+}
+
+//==========================================================================
+//
+// FPackedBSP :: PointInSubsectors
+//
+// Descends the tree for several points in lockstep, so that the memory
+// accesses for the different points can overlap.
+//
+//==========================================================================
+
+void FPackedBSP::PointInSubsectors(const DVector2 *pos, subsector_t **result, unsigned count) const
+{
+	enum { LANES = 4 };
+	const FPackedNode *nodes = Nodes.Data();
+	const int head = Nodes.Size() - 1;
+
+	for (unsigned i = 0; i < count; i += LANES)
+	{
+		unsigned lanes = MIN<unsigned>(LANES, count - i);
+		fixed_t x[LANES], y[LANES];
+		int n[LANES];
+
+		for (unsigned k = 0; k < lanes; k++)
+		{
+			x[k] = FloatToFixed(pos[i + k].X);
+			y[k] = FloatToFixed(pos[i + k].Y);
+			n[k] = head;
+		}
+
+		unsigned active;
+		do
+		{
+			active = 0;
+			for (unsigned k = 0; k < lanes; k++)
+			{
+				if (n[k] >= 0)
+				{
+					const FPackedNode &node = nodes[n[k]];
+					n[k] = node.children[DMulScale32(y[k] - node.y, node.dx, node.x - x[k], node.dy) > 0];
+					active += n[k] >= 0;
+				}
+			}
+		} while (active > 0);
+
+		for (unsigned k = 0; k < lanes; k++)
+		{
+			result[i + k] = &Subsectors[~n[k]];
+		}
+	}
+}
+
+//==========================================================================
+//
+// FLevelLocals :: PackNodes
+//
+// Must be called whenever the node trees or headgamenode change.
+//
+//==========================================================================
+
+void FLevelLocals::PackNodes()
+{
+	if (nodes.Size() > 0) renderbsp.Build(nodes.Data(), nodes.Size(), subsectors.Data());
+	else renderbsp.Clear();
+
+	if (gamenodes.Size() > 0) gamebsp.Build(gamenodes.Data(), gamenodes.Size(), gamesubsectors.Data());
+	else gamebsp = renderbsp;
+}
+
 //==========================================================================
 //
 // P_PointInSubsector
@@ -1952,6 +2361,10 @@ subsector_t *FLevelLocals::PointInSubsector(double x, double y)
 
 	fixed_t xx = FloatToFixed(x);
 	fixed_t yy = FloatToFixed(y);
+	if (gamebsp.Nodes.Size() > 0)
+	{
+		return gamebsp.PointInSubsector(xx, yy);
+	}
 	do
 	{
 		side = R_PointOnSide(xx, yy, node);
@@ -2005,6 +2418,9 @@ subsector_t *FLevelLocals::PointInRenderSubsector (fixed_t x, fixed_t y)
 	if (nodes.Size() == 0)
 		return &subsectors[0];
 	
+	if (renderbsp.Nodes.Size() > 0)
+		return renderbsp.PointInSubsector(x, y);
+
 	node = HeadNode();
 	
 	do
@@ -2017,3 +2433,33 @@ subsector_t *FLevelLocals::PointInRenderSubsector (fixed_t x, fixed_t y)
 	return (subsector_t *)((uint8_t *)node - 1);
 }
 
+//==========================================================================
+//
+// Batch versions of PointInSector and PointInRenderSubsector.
+//
+//==========================================================================
+
+void FLevelLocals::PointInSectors(const DVector2 *pos, sector_t **result, unsigned count)
+{
+	static thread_local TArray<subsector_t *> ssecs;
+
+	if (gamebsp.Nodes.Size() == 0 || HeadGamenode() == nullptr)
+	{
+		for (unsigned i = 0; i < count; i++) result[i] = PointInSector(pos[i]);
+		return;
+	}
+	ssecs.Resize(count);
+	gamebsp.PointInSubsectors(pos, ssecs.Data(), count);
+	for (unsigned i = 0; i < count; i++) result[i] = ssecs[i]->sector;
+}
+
+void FLevelLocals::PointInRenderSubsectors(const DVector2 *pos, subsector_t **result, unsigned count)
+{
+	if (renderbsp.Nodes.Size() == 0)
+	{
+		for (unsigned i = 0; i < count; i++) result[i] = PointInRenderSubsector(pos[i]);
+		return;
+	}
+	renderbsp.PointInSubsectors(pos, result, count);
+}
+
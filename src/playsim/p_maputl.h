@@ -9,6 +9,7 @@
 
 extern int validcount;
 struct FBlockNode;
+struct FBlockThings;
 
 struct divline_t
 {
@@ -285,7 +286,9 @@ class FBlockThingsIterator
 
 	int curx, cury;
 
-	FBlockNode *block;
+	FBlockThings *things;
+	int thingindex;
+	unsigned generation;
 
 	int Buckets[32];
 
@@ -361,17 +364,23 @@ public:
 class FPathTraverse
 {
 protected:
-	static TArray<intercept_t> intercepts;
+	// Each thread gets its own intercept stack. Nested traversals push their
+	// intercepts on top of the ones of the traversal that started them.
+	static thread_local TArray<intercept_t> intercepts;
 
 	FLevelLocals *Level;
 	divline_t trace;
 	double Startfrac;
 	unsigned int intercept_index;
 	unsigned int intercept_count;
+	unsigned int intercept_end;		// end of this traversal's intercepts, which are sorted by frac
+	unsigned int intercept_pos;		// first intercept in the sorted range not returned yet
 	unsigned int count;
 
 	virtual void AddLineIntercepts(int bx, int by);
+	void AddBatchedLineIntercepts(int bx, int by);
 	virtual void AddThingIntercepts(int bx, int by, FBlockThingsIterator &it, bool compatible);
+	void SortIntercepts();
 	FPathTraverse(FLevelLocals *l) 
 	{
 		Level = l;
@@ -1287,7 +1287,7 @@ DEFINE_ACTION_FUNCTION(AActor, Grind)
 
 bool AActor::CallGrind(bool items)
 {
-	IFVIRTUAL(AActor, Grind)
+	IFOVERRIDENVIRTUAL(AActor, Grind)
 	{
 		VMValue params[] = { (DObject*)this, items };
 		int retv;
@@ -3154,7 +3154,7 @@ DEFINE_ACTION_FUNCTION(AActor, Slam)
 
 bool AActor::CallSlam(AActor *thing)
 {
-	IFVIRTUAL(AActor, Slam)
+	IFOVERRIDENVIRTUAL(AActor, Slam)
 	{
 		VMValue params[2] = { (DObject*)this, thing };
 		VMReturn ret;
@@ -3247,7 +3247,7 @@ int AActor::AbsorbDamage(int damage, FName dmgtype)
 void AActor::AlterWeaponSprite(visstyle_t *vis)
 {
 	int changed = 0;
-	TArray<AActor *> items;
+	TSmallArray<AActor *, 32> items;
 	// This needs to go backwards through the items but the list has no backlinks.
 	for (AActor *item = Inventory; item != nullptr; item = item->Inventory)
 	{
@@ -3496,6 +3496,61 @@ DEFINE_ACTION_FUNCTION(AActor, CheckPortalTransition)
 	return 0;
 }
 
+//==========================================================================
+//
+// AActor :: CanSleep
+//
+// Checks whether everything between the inventory effects and the state
+// countdown in Tick would leave this actor unchanged. This is the case for
+// things lying still on a flat floor outside of water, portals and scrollers,
+// like most corpses and decorations. Since it is re-evaluated every tic,
+// anything that pushes, damages or alters the actor through a script wakes
+// it up again on its next tic without needing any explicit notification.
+//
+//==========================================================================
+
+// This selects a playsim path, so all nodes and demos must agree on it.
+CVAR(Bool, think_sleep, true, CVAR_ARCHIVE | CVAR_SERVERINFO)
+
+bool AActor::CanSleep()
+{
+	if (!Vel.isZero() || Z() != floorz || player != nullptr || Inventory != nullptr)
+		return false;
+
+	if ((flags & (MF_MISSILE | MF_SKULLFLY | MF_STEALTH | MF_UNMORPHED)) ||
+		(flags2 & (MF2_BLASTED | MF2_WINDTHRUST)) ||
+		(flags4 & MF4_VFRICTION) ||
+		(flags6 & MF6_TOUCHY) ||
+		(flags7 & MF7_HANDLENODELAY) ||
+		(flags8 & MF8_INSCROLLSEC) ||
+		effects != 0 || PoisonDurationReceived != 0 ||
+		waterlevel != 0 || boomwaterlevel != 0 ||
+		Level->BotInfo.botnum != 0)
+		return false;
+
+	// Crash() must have nothing left to do.
+	if (!(flags6 & MF6_DONTCORPSE) && ((flags & MF_CORPSE) || (flags6 & MF6_KILLED)) &&
+		!(flags3 & MF3_CRASHED) && !(flags & MF_ICECORPSE))
+		return false;
+
+	// No render sector list update pending.
+	if (Pos() != OldRenderPos && !(flags & MF_NOSECTOR))
+		return false;
+
+	if (Sector == nullptr || (Sector->MoreFlags & SECMF_UNDERWATER) || Sector->GetHeightSec() != nullptr ||
+		Sector->e->XFloor.ffloors.Size() > 0 ||
+		!Sector->PortalBlocksMovement(sector_t::ceiling) || !Sector->PortalBlocksMovement(sector_t::floor))
+		return false;
+
+	// Solid things can slide down steep slopes.
+	if ((flags & MF_SOLID) && !(flags & (MF_NOCLIP | MF_NOGRAVITY | MF_NOBLOCKMAP)))
+	{
+		if (floorsector == nullptr || floorsector->floorplane.isSlope() || floorsector->e->XFloor.ffloors.Size() > 0)
+			return false;
+	}
+	return true;
+}
+
 //
 // P_MobjThinker
 //
@@ -3558,6 +3613,24 @@ void AActor::Tick ()
 		}
 		flags8 &= ~MF8_INSCROLLSEC;
 	}
+	else if (think_sleep && CanSleep())
+	{
+		// Only do what the movement code would do for an actor at rest.
+		if (isFrozen())
+		{
+			if (flags6 & MF6_BOSSCUBE)
+			{
+				special2++;
+			}
+			return;
+		}
+		BlockingMobj = nullptr;
+		Blocking3DFloor = nullptr;
+		BlockingFloor = nullptr;
+		BlockingCeiling = nullptr;
+		flags4 &= ~MF4_SCROLLMOVE;
+		Level->Thinkers.SleepingCount++;
+	}
 	else
 	{
 
@@ -4690,7 +4763,7 @@ DEFINE_ACTION_FUNCTION(AActor, BeginPlay)
 
 void AActor::CallBeginPlay()
 {
-	IFVIRTUAL(AActor, BeginPlay)
+	IFOVERRIDENVIRTUAL(AActor, BeginPlay)
 	{
 		// Without the type cast this picks the 'void *' assignment...
 		VMValue params[1] = { (DObject*)this };
@@ -4761,7 +4834,7 @@ DEFINE_ACTION_FUNCTION(AActor, Activate)
 
 void AActor::CallActivate(AActor *activator)
 {
-	IFVIRTUAL(AActor, Activate)
+	IFOVERRIDENVIRTUAL(AActor, Activate)
 	{
 		// Without the type cast this picks the 'void *' assignment...
 		VMValue params[2] = { (DObject*)this, (DObject*)activator };
@@ -4807,7 +4880,7 @@ DEFINE_ACTION_FUNCTION(AActor, Deactivate)
 
 void AActor::CallDeactivate(AActor *activator)
 {
-	IFVIRTUAL(AActor, Deactivate)
+	IFOVERRIDENVIRTUAL(AActor, Deactivate)
 	{
 		// Without the type cast this picks the 'void *' assignment...
 		VMValue params[2] = { (DObject*)this, (DObject*)activator };
@@ -7022,7 +7095,7 @@ DEFINE_ACTION_FUNCTION(AActor, TakeSpecialDamage)
 
 int AActor::CallTakeSpecialDamage(AActor *inflictor, AActor *source, int damage, FName damagetype)
 {
-	IFVIRTUAL(AActor, TakeSpecialDamage)
+	IFOVERRIDENVIRTUAL(AActor, TakeSpecialDamage)
 	{
 		VMValue params[5] = { (DObject*)this, inflictor, source, damage, damagetype.GetIndex() };
 		VMReturn ret;
@@ -27,15 +27,97 @@
 #include "g_levellocals.h"
 #include "p_maputl.h"
 #include "actor.h"
+#include "stats.h"
 
 //=============================================================================
 // phares 3/21/98
 //
 // Maintain a freelist of msecnode_t's to reduce memory allocs and frees.
+//
+// The nodes are allocated in fixed size chunks which are never moved, so
+// each node has a stable index. Freed nodes are reused in LIFO order to
+// keep the working set small, and once a level has been cleared out the
+// freelist gets rebuilt in index order so that a new level starts with
+// nodes that are adjacent in memory.
 //=============================================================================
 
-msecnode_t *headsecnode = nullptr;
-FMemArena secnodearena;
+class FSecnodePool
+{
+	enum
+	{
+		CHUNK_SHIFT = 9,
+		CHUNK_SIZE = 1 << CHUNK_SHIFT,
+	};
+
+	TArray<msecnode_t *> Chunks;
+	msecnode_t *FreeList = nullptr;
+	unsigned Allocated = 0;		// number of nodes that were ever handed out from the chunks
+
+public:
+	unsigned Live = 0;
+	unsigned Peak = 0;
+
+	~FSecnodePool()
+	{
+		for (auto chunk : Chunks) delete[] chunk;
+	}
+
+	msecnode_t *Get()
+	{
+		msecnode_t *node;
+
+		if (FreeList != nullptr)
+		{
+			node = FreeList;
+			FreeList = node->m_snext;
+		}
+		else
+		{
+			if ((Allocated >> CHUNK_SHIFT) >= Chunks.Size())
+			{
+				Chunks.Push(new msecnode_t[CHUNK_SIZE]);
+			}
+			node = &Chunks[Allocated >> CHUNK_SHIFT][Allocated & (CHUNK_SIZE - 1)];
+			node->m_index = Allocated++;
+		}
+		if (++Live > Peak) Peak = Live;
+		return node;
+	}
+
+	void Put(msecnode_t *node)
+	{
+		node->m_snext = FreeList;
+		FreeList = node;
+		Live--;
+	}
+
+	msecnode_t *GetNode(unsigned index) const
+	{
+		return index < Allocated ? &Chunks[index >> CHUNK_SHIFT][index & (CHUNK_SIZE - 1)] : nullptr;
+	}
+
+	unsigned Size() const
+	{
+		return Allocated;
+	}
+
+	void Reset()
+	{
+		// Nodes that are still in use cannot be touched.
+		if (Live > 0) return;
+		FreeList = nullptr;
+		for (unsigned i = Allocated; i-- > 0; )
+		{
+			auto node = GetNode(i);
+			node->m_snext = FreeList;
+			FreeList = node;
+		}
+		Peak = 0;
+	}
+};
+
+static FSecnodePool SecnodePool;
+FMemArena secnodearena(10*1024, "SectorNodes");
 
 //=============================================================================
 //
@@ -48,18 +130,7 @@ FMemArena secnodearena;
 
 msecnode_t *P_GetSecnode()
 {
-	msecnode_t *node;
-
-	if (headsecnode)
-	{
-		node = headsecnode;
-		headsecnode = headsecnode->m_snext;
-	}
-	else
-	{
-		node = (msecnode_t *)secnodearena.Alloc(sizeof(*node));
-	}
-	return node;
+	return SecnodePool.Get();
 }
 
 //=============================================================================
@@ -72,8 +143,27 @@ msecnode_t *P_GetSecnode()
 
 void P_PutSecnode(msecnode_t *node)
 {
-	node->m_snext = headsecnode;
-	headsecnode = node;
+	SecnodePool.Put(node);
+}
+
+//=============================================================================
+//
+// P_ResetSecnodes
+//
+// Called when a level gets cleared.
+//
+//=============================================================================
+
+void P_ResetSecnodes()
+{
+	SecnodePool.Reset();
+}
+
+ADD_STAT(secnodes)
+{
+	FString out;
+	out.Format("Sector nodes: %u live, %u peak, %u allocated", SecnodePool.Live, SecnodePool.Peak, SecnodePool.Size());
+	return out;
 }
 
 //=============================================================================
@@ -480,3 +570,102 @@ void FBlockNode::Release()
 	NextBlock = FreeBlocks;
 	FreeBlocks = this;
 }
+
+//===========================================================================
+//
+// FBlockmap :: LinkThing
+//
+// Adds a freshly linked block node to its block's packed thing list.
+//
+//===========================================================================
+
+void FBlockmap::LinkThing(FBlockNode *node)
+{
+	auto &things = blockthings[node->BlockIndex];
+	node->PackedIndex = things.Actors.Push(node->Me);
+	things.Nodes.Push(node);
+	things.Spanning.Push(0);
+}
+
+//===========================================================================
+//
+// FBlockmap :: UnlinkThing
+//
+// Only clears the entry so that running iterators are not disturbed.
+//
+//===========================================================================
+
+void FBlockmap::UnlinkThing(FBlockNode *node)
+{
+	auto &things = blockthings[node->BlockIndex];
+	things.Actors[node->PackedIndex] = nullptr;
+	clearedthings++;
+	if (!things.Dirty)
+	{
+		things.Dirty = true;
+		dirtyblocks.Push(node->BlockIndex);
+	}
+}
+
+//===========================================================================
+//
+// FBlockmap :: RestoreThing
+//
+// Puts a node back that was removed with UnlinkThing, for player
+// prediction which needs to restore the original order.
+//
+//===========================================================================
+
+void FBlockmap::RestoreThing(FBlockNode *node)
+{
+	blockthings[node->BlockIndex].Actors[node->PackedIndex] = node->Me;
+	clearedthings--;
+}
+
+//===========================================================================
+//
+// FBlockmap :: MarkSpanning
+//
+//===========================================================================
+
+void FBlockmap::MarkSpanning(FBlockNode *node)
+{
+	blockthings[node->BlockIndex].Spanning[node->PackedIndex] = 1;
+}
+
+//===========================================================================
+//
+// FBlockmap :: CompactThings
+//
+// Removes the cleared entries. This may not be called while any
+// FBlockThingsIterator is active, except for ones that are kept across
+// tics. Those clamp their position when they see the new generation.
+//
+//===========================================================================
+
+void FBlockmap::CompactThings()
+{
+	for (auto index : dirtyblocks)
+	{
+		auto &things = blockthings[index];
+		unsigned count = 0;
+		for (unsigned i = 0; i < things.Actors.Size(); i++)
+		{
+			if (things.Actors[i] != nullptr)
+			{
+				things.Actors[count] = things.Actors[i];
+				things.Nodes[count] = things.Nodes[i];
+				things.Spanning[count] = things.Spanning[i];
+				things.Nodes[count]->PackedIndex = count;
+				count++;
+			}
+		}
+		things.Actors.Resize(count);
+		things.Nodes.Resize(count);
+		things.Spanning.Resize(count);
+		things.Generation++;
+		things.Dirty = false;
+	}
+	dirtyblocks.Clear();
+	clearedthings = 0;
+}
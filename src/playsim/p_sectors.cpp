@@ -1117,6 +1117,7 @@ double GetFriction(const sector_t *self, int plane, double *pMoveFac)
 		 {
 			 line->flags &= ~(ML_BLOCKING | ML_BLOCKEVERYTHING);
 			 line->special = 0;
+			 P_InvalidateSightCache();
 			 line->sidedef[0]->SetTexture(side_t::mid, FNullTextureID());
 			 line->sidedef[1]->SetTexture(side_t::mid, FNullTextureID());
 		 }
@@ -33,6 +33,7 @@
 #include "b_bot.h"
 #include "p_spec.h"
 #include "vm.h"
+#include "parallel_for.h"
 
 #include "g_levellocals.h"
 #include "actorinlines.h"
@@ -51,9 +52,9 @@ This uses specialized forms of the maputils routines for optimized performance
 */
 
 // Performance meters
-static int sightcounts[6];
 static cycle_t SightCycles;
 static cycle_t MaxSightCycles;
+static cycle_t SightPlanCycles;
 
 enum
 {
@@ -87,12 +88,52 @@ struct SightTask
 };
 
 
-static TArray<intercept_t> intercepts (128);
-static TArray<SightTask> portals(32);
+//==========================================================================
+//
+// Per-thread working storage for sight checks.
+//
+// The main thread uses the validcount fields in the map data for
+// deduplicating lines. Worker threads cannot do that without racing
+// each other, so they get private stamp arrays instead.
+//
+//==========================================================================
+
+struct FSightContext
+{
+	TArray<intercept_t> intercepts;
+	TArray<SightTask> portals;
+	TArray<int> LineStamps;
+	TArray<int> PolyStamps;
+	FLevelLocals *Level = nullptr;
+	int Stamp = 0;
+	int counts[6] = {};
+
+	void InitForWorker(FLevelLocals *l)
+	{
+		if (Level != l || LineStamps.Size() != l->lines.Size() || PolyStamps.Size() != l->Polyobjects.Size())
+		{
+			Level = l;
+			LineStamps.Resize(l->lines.Size());
+			PolyStamps.Resize(l->Polyobjects.Size());
+			memset(LineStamps.Data(), 0, LineStamps.Size() * sizeof(int));
+			memset(PolyStamps.Data(), 0, PolyStamps.Size() * sizeof(int));
+			Stamp = 0;
+		}
+	}
+
+	bool IsWorker() const
+	{
+		return Level != nullptr;
+	}
+};
+
+static FSightContext MainSight;
+static thread_local FSightContext WorkerSight;
 
 class SightCheck
 {
 	FLevelLocals *Level;
+	FSightContext *ctx;
 	DVector3 sightstart;
 	DVector2 sightend;
 	double Startfrac;
@@ -116,10 +157,35 @@ class SightCheck
 	bool P_SightTraverseIntercepts ();
 	bool LineBlocksSight(line_t *ld);
 
+	void NewStamp()
+	{
+		if (ctx->IsWorker()) ctx->Stamp++;
+		else validcount++;
+	}
+
+	bool MarkLine(line_t *ld)
+	{
+		int &stamp = ctx->IsWorker() ? ctx->LineStamps[ld->Index()] : ld->validcount;
+		int cur = ctx->IsWorker() ? ctx->Stamp : validcount;
+		if (stamp == cur) return false;
+		stamp = cur;
+		return true;
+	}
+
+	bool MarkPolyobj(FPolyObj *po)
+	{
+		int &stamp = ctx->IsWorker() ? ctx->PolyStamps[unsigned(po - &Level->Polyobjects[0])] : po->validcount;
+		int cur = ctx->IsWorker() ? ctx->Stamp : validcount;
+		if (stamp == cur) return false;
+		stamp = cur;
+		return true;
+	}
+
 public:
-	SightCheck(FLevelLocals *l)
+	SightCheck(FLevelLocals *l, FSightContext *c)
 	{
 		Level = l;
+		ctx = c;
 	}
 
 	bool P_SightPathTraverse ();
@@ -279,16 +345,16 @@ bool SightCheck::PTR_SightTraverse (intercept_t *in)
 
 		if (portaldir != sector_t::floor && (open.portalflags & SO_TOPBACK) && !(open.portalflags & SO_TOPFRONT))
 		{
-			portals.Push({ in->frac, topslope, bottomslope, sector_t::ceiling, backsec->GetOppositePortalGroup(sector_t::ceiling) });
+			ctx->portals.Push({ in->frac, topslope, bottomslope, sector_t::ceiling, backsec->GetOppositePortalGroup(sector_t::ceiling) });
 		}
 		if (portaldir != sector_t::ceiling && (open.portalflags & SO_BOTTOMBACK) && !(open.portalflags & SO_BOTTOMFRONT))
 		{
-			portals.Push({ in->frac, topslope, bottomslope, sector_t::floor, backsec->GetOppositePortalGroup(sector_t::floor) });
+			ctx->portals.Push({ in->frac, topslope, bottomslope, sector_t::floor, backsec->GetOppositePortalGroup(sector_t::floor) });
 		}
 	}
 	if (lport != nullptr && lport->mDestination != nullptr)
 	{
-		portals.Push({ in->frac, topslope, bottomslope, portaldir, lport->mDestination->frontsector->PortalGroup });
+		ctx->portals.Push({ in->frac, topslope, bottomslope, portaldir, lport->mDestination->frontsector->PortalGroup });
 		return false;
 	}
 
@@ -434,11 +500,10 @@ bool SightCheck::P_SightCheckLine (line_t *ld)
 {
 	divline_t dl;
 
-	if (ld->validcount == validcount)
+	if (!MarkLine(ld))
 	{
 		return true;
 	}
-	ld->validcount = validcount;
 	if (P_PointOnDivlineSide (ld->v1->fPos(), &Trace) ==
 		P_PointOnDivlineSide (ld->v2->fPos(), &Trace))
 	{
@@ -456,12 +521,12 @@ bool SightCheck::P_SightCheckLine (line_t *ld)
 		if (LineBlocksSight(ld)) return false;
 	}
 
-	sightcounts[3]++;
+	ctx->counts[3]++;
 	// store the line for later intersection testing
 	intercept_t newintercept;
 	newintercept.isaline = true;
 	newintercept.d.line = ld;
-	intercepts.Push (newintercept);
+	ctx->intercepts.Push (newintercept);
 
 	return true;
 }
@@ -495,9 +560,8 @@ int SightCheck::P_SightBlockLinesIterator (int x, int y)
 	{
 		if (polyLink->polyobj)
 		{ // only check non-empty links
-			if (polyLink->polyobj->validcount != validcount)
+			if (MarkPolyobj(polyLink->polyobj))
 			{
-				polyLink->polyobj->validcount = validcount;
 				for (i = 0; i < polyLink->polyobj->Linedefs.Size(); i++)
 				{
 					if (!P_SightCheckLine(polyLink->polyobj->Linedefs[i]))
@@ -540,13 +604,13 @@ bool SightCheck::P_SightTraverseIntercepts ()
 	unsigned scanpos;
 	divline_t dl;
 
-	count = intercepts.Size ();
+	count = ctx->intercepts.Size ();
 //
 // calculate intercept distance
 //
-	for (scanpos = 0; scanpos < intercepts.Size (); scanpos++)
+	for (scanpos = 0; scanpos < ctx->intercepts.Size (); scanpos++)
 	{
-		scan = &intercepts[scanpos];
+		scan = &ctx->intercepts[scanpos];
 		P_MakeDivline (scan->d.line, &dl);
 		scan->frac = P_InterceptVector (&Trace, &dl);
 		if (scan->frac < Startfrac)
@@ -565,9 +629,9 @@ bool SightCheck::P_SightTraverseIntercepts ()
 	while (count--)
 	{
 		dist = INT_MAX;
-		for (scanpos = 0; scanpos < intercepts.Size (); scanpos++)
+		for (scanpos = 0; scanpos < ctx->intercepts.Size (); scanpos++)
 		{
-			scan = &intercepts[scanpos];
+			scan = &ctx->intercepts[scanpos];
 			if (scan->frac < dist)
 			{
 				dist = scan->frac;
@@ -627,8 +691,8 @@ bool SightCheck::P_SightPathTraverse ()
 	int mapx, mapy, mapxstep, mapystep;
 	int count;
 
-	validcount++;
-	intercepts.Clear ();
+	NewStamp();
+	ctx->intercepts.Clear ();
 	x1 = sightstart.X + Startfrac * Trace.dx;
 	y1 = sightstart.Y + Startfrac * Trace.dy;
 	x2 = sightend.X;
@@ -660,11 +724,11 @@ bool SightCheck::P_SightPathTraverse ()
 	// We also must check if the starting sector contains  portals, and start sight checks in those as well.
 	if (portaldir != sector_t::floor && checkceiling && !lastsector->PortalBlocksSight(sector_t::ceiling))
 	{
-		portals.Push({ 0, topslope, bottomslope, sector_t::ceiling, lastsector->GetOppositePortalGroup(sector_t::ceiling) });
+		ctx->portals.Push({ 0, topslope, bottomslope, sector_t::ceiling, lastsector->GetOppositePortalGroup(sector_t::ceiling) });
 	}
 	if (portaldir != sector_t::ceiling && checkfloor && !lastsector->PortalBlocksSight(sector_t::floor))
 	{
-		portals.Push({ 0, topslope, bottomslope, sector_t::floor, lastsector->GetOppositePortalGroup(sector_t::floor) });
+		ctx->portals.Push({ 0, topslope, bottomslope, sector_t::floor, lastsector->GetOppositePortalGroup(sector_t::floor) });
 	}
 
 	x1 -= Level->blockmap.bmaporgx;
@@ -760,7 +824,7 @@ bool SightCheck::P_SightPathTraverse ()
 		itres = P_SightBlockLinesIterator(mapx, mapy);
 		if (itres == 0)
 		{
-			sightcounts[1]++;
+			ctx->counts[1]++;
 			return false;	// early out
 		}
 
@@ -771,7 +835,7 @@ bool SightCheck::P_SightPathTraverse ()
 		switch (((xs_FloorToInt(yintercept) == mapy) << 1) | (xs_FloorToInt(xintercept) == mapx))
 		{
 		case 0:		// neither xintercept nor yintercept match!
-sightcounts[5]++;
+ctx->counts[5]++;
 			// Continuing won't make things any better, so we might as well stop right here
 			count = 1000;
 			break;
@@ -791,7 +855,7 @@ sightcounts[5]++;
 			break;
 
 		case 3:		// xintercept and yintercept both match
-			sightcounts[4]++;
+			ctx->counts[4]++;
 			// The trace is exiting a block through its corner. Not only does the block
 			// being entered need to be checked (which will happen when this loop
 			// continues), but the other two blocks adjacent to the corner also need to
@@ -799,7 +863,7 @@ sightcounts[5]++;
 			if (!P_SightBlockLinesIterator (mapx + mapxstep, mapy) ||
 				!P_SightBlockLinesIterator (mapx, mapy + mapystep))
 			{
-sightcounts[1]++;
+ctx->counts[1]++;
 				return false;
 			}
 			xintercept += xstep;
@@ -818,7 +882,7 @@ sightcounts[1]++;
 //
 // couldn't early out, so go through the sorted list
 //
-sightcounts[2]++;
+ctx->counts[2]++;
 
 	bool traverseres = P_SightTraverseIntercepts ( );
 	if (itres == -1) return false;	// if the iterator had an early out there was no line of sight. The traverser was only called to collect more portals.
@@ -826,6 +890,229 @@ sightcounts[2]++;
 	return traverseres;
 }
 
+//==========================================================================
+//
+// P_SightTraverseLOS
+//
+// The actual line of sight trace from the eyes of t1 to any part of t2.
+// This only reads map data, so it can be run on a worker thread as long
+// as a private context is passed.
+//
+//==========================================================================
+
+static bool P_SightTraverseLOS(AActor *t1, AActor *t2, int flags, FSightContext *ctx)
+{
+	bool res;
+
+	if (ctx->IsWorker()) ctx->Stamp++;
+	else validcount++;
+	ctx->portals.Clear();
+
+	sector_t *sec;
+	double lookheight = t1->Z() + t1->Height*0.75;
+	t1->GetPortalTransition(lookheight, &sec);
+
+	double bottomslope = t2->Z() - lookheight;
+	double topslope = bottomslope + t2->Height;
+	SightTask task = { 0, topslope, bottomslope, -1, sec->PortalGroup };
+
+
+	SightCheck s(t1->Level, ctx);
+	s.init(t1, t2, sec, &task, flags);
+	res = s.P_SightPathTraverse ();
+	if (!res)
+	{
+		double dist = t1->Distance2D(t2);
+		for (unsigned i = 0; i < ctx->portals.Size(); i++)
+		{
+			ctx->portals[i].Frac += 1 / dist;
+			s.init(t1, t2, NULL, &ctx->portals[i], flags);
+			if (s.P_SightPathTraverse())
+			{
+				res = true;
+				break;
+			}
+		}
+	}
+	return res;
+}
+
+//==========================================================================
+//
+// Sight cache
+//
+// Many action functions check sight for the same pair of actors several
+// times per tic, so the trace results get memorized for the current tic.
+// An entry is only used if nothing the trace depends upon has changed,
+// i.e. both actors are still at the same spot and no sector plane,
+// polyobject, portal or line property the trace looks at was altered
+// since. Every engine-side write to those invalidates the cache, but
+// ZScript can modify a line's flags, special and args directly without
+// the engine noticing, so the cache is opt-in and should only be enabled
+// for content that doesn't do that.
+//
+// With think_multithreaded enabled the thinker loop also fills the cache
+// in advance by tracing the sight lines of all monsters to their current
+// targets in parallel.
+//
+//==========================================================================
+
+CVAR(Bool, sv_sightcache, false, CVAR_SERVERINFO)
+
+struct FSightKey
+{
+	AActor *looker;
+	AActor *target;
+	int flags;
+};
+
+template<> struct THashTraits<FSightKey>
+{
+	hash_t Hash(const FSightKey &key)
+	{
+		return (hash_t)((((intptr_t)key.looker) >> 4) ^ (((intptr_t)key.target) >> 2) ^ key.flags);
+	}
+	int Compare(const FSightKey &left, const FSightKey &right) 
+	{ 
+		return left.looker != right.looker || left.target != right.target || left.flags != right.flags; 
+	}
+};
+
+struct FSightMemo
+{
+	sector_t *lookersector, *targetsector;
+	DVector3 lookerpos, targetpos;
+	double lookerheight, targetheight;
+	int generation;
+	int tic;
+	bool result;
+
+	void Setup(AActor *t1, AActor *t2, int gen)
+	{
+		lookersector = t1->Sector;
+		targetsector = t2->Sector;
+		lookerpos = t1->Pos();
+		targetpos = t2->Pos();
+		lookerheight = t1->Height;
+		targetheight = t2->Height;
+		generation = gen;
+		tic = gametic;
+	}
+
+	bool Matches(AActor *t1, AActor *t2, int gen) const
+	{
+		return gen == generation && tic == gametic && t1->Sector == lookersector && t2->Sector == targetsector &&
+			t1->Pos() == lookerpos && t2->Pos() == targetpos && t1->Height == lookerheight && t2->Height == targetheight;
+	}
+};
+
+static TMap<FSightKey, FSightMemo> SightCache;
+static int SightGeneration;
+static int sightcache[3];	// hits, misses, planned
+
+// Flags that are evaluated before the trace and do not affect its outcome.
+enum { SF_NOTRACEFLAGS = SF_IGNOREVISIBILITY };
+
+//==========================================================================
+//
+// Any change to the map geometry invalidates the cached sight checks.
+//
+//==========================================================================
+
+void P_InvalidateSightCache()
+{
+	SightGeneration++;
+}
+
+//==========================================================================
+//
+// P_CachedSightTraverse
+//
+//==========================================================================
+
+static bool P_CachedSightTraverse(AActor *t1, AActor *t2, int flags)
+{
+	FSightKey key = { t1, t2, flags & ~SF_NOTRACEFLAGS };
+	auto memo = SightCache.CheckKey(key);
+	if (memo != nullptr && memo->Matches(t1, t2, SightGeneration))
+	{
+		sightcache[0]++;
+		return memo->result;
+	}
+	sightcache[1]++;
+	bool res = P_SightTraverseLOS(t1, t2, key.flags, &MainSight);
+	auto &entry = SightCache[key];
+	entry.Setup(t1, t2, SightGeneration);
+	entry.result = res;
+	return res;
+}
+
+//==========================================================================
+//
+// P_PlanSightChecks
+//
+// Parallel read-only phase before the thinkers get ticked.
+//
+//==========================================================================
+
+struct FSightPlan
+{
+	AActor *looker;
+	AActor *target;
+	bool result[2];	// for flags 0 and SF_SEEPASTBLOCKEVERYTHING
+};
+
+void P_PlanSightChecks(FLevelLocals *Level)
+{
+	static TArray<FSightPlan> plans;
+
+	SightPlanCycles.Clock();
+	plans.Clear();
+
+	auto it = Level->GetThinkerIterator<AActor>();
+	AActor *ac;
+	while ((ac = it.Next()))
+	{
+		AActor *targ = ac->target;
+		if (targ == nullptr || !(ac->flags3 & MF3_ISMONSTER) || (ac->ObjectFlags & OF_EuthanizeMe) || ac->health <= 0)
+			continue;
+		if (targ->Level != Level || !Level->CheckReject(ac->Sector, targ->Sector))
+			continue;
+
+		plans.Push({ ac, targ });
+	}
+
+	int count = plans.Size();
+	if (count > 0)
+	{
+		const int slice = 64;
+		parallel_for(0, count, slice, [=](int start)
+		{
+			WorkerSight.InitForWorker(Level);
+			int end = MIN(start + slice, count);
+			for (int i = start; i < end; i++)
+			{
+				auto &plan = plans[i];
+				plan.result[0] = P_SightTraverseLOS(plan.looker, plan.target, 0, &WorkerSight);
+				plan.result[1] = P_SightTraverseLOS(plan.looker, plan.target, SF_SEEPASTBLOCKEVERYTHING, &WorkerSight);
+			}
+		});
+
+		for (auto &plan : plans)
+		{
+			for (int j = 0; j < 2; j++)
+			{
+				FSightKey key = { plan.looker, plan.target, j == 0 ? 0 : SF_SEEPASTBLOCKEVERYTHING };
+				auto &entry = SightCache[key];
+				entry.Setup(plan.looker, plan.target, SightGeneration);
+				entry.result = plan.result[j];
+			}
+		}
+	}
+	sightcache[2] += count;
+	SightPlanCycles.Unclock();
+}
+
 /*
 =====================
 =
@@ -857,7 +1144,7 @@ int P_CheckSight (AActor *t1, AActor *t2, int flags)
 	//
 	if (!t1->Level->CheckReject(s1, s2))
 	{
-sightcounts[0]++;
+MainSight.counts[0]++;
 		res = false;			// can't possibly be connected
 		goto done;
 	}
@@ -899,36 +1186,13 @@ sightcounts[0]++;
 
 	// An unobstructed LOS is possible.
 	// Now look from eyes of t1 to any part of t2.
-
-	validcount++;
-	portals.Clear();
+	if (sv_sightcache)
 	{
-		sector_t *sec;
-		double lookheight = t1->Z() + t1->Height*0.75;
-		t1->GetPortalTransition(lookheight, &sec);
-
-		double bottomslope = t2->Z() - lookheight;
-		double topslope = bottomslope + t2->Height;
-		SightTask task = { 0, topslope, bottomslope, -1, sec->PortalGroup };
-
-
-		SightCheck s(t1->Level);
-		s.init(t1, t2, sec, &task, flags);
-		res = s.P_SightPathTraverse ();
-		if (!res)
-		{
-			double dist = t1->Distance2D(t2);
-			for (unsigned i = 0; i < portals.Size(); i++)
-			{
-				portals[i].Frac += 1 / dist;
-				s.init(t1, t2, NULL, &portals[i], flags);
-				if (s.P_SightPathTraverse())
-				{
-					res = true;
-					break;
-				}
-			}
-		}
+		res = P_CachedSightTraverse(t1, t2, flags);
+	}
+	else
+	{
+		res = P_SightTraverseLOS(t1, t2, flags, &MainSight);
 	}
 
 done:
@@ -941,7 +1205,13 @@ ADD_STAT (sight)
 	FString out;
 	out.Format ("%04.1f ms (%04.1f max), %5d %2d%4d%4d%4d%4d\n",
 		SightCycles.TimeMS(), MaxSightCycles.TimeMS(),
-		sightcounts[3], sightcounts[0], sightcounts[1], sightcounts[2], sightcounts[4], sightcounts[5]);
+		MainSight.counts[3], MainSight.counts[0], MainSight.counts[1], MainSight.counts[2], MainSight.counts[4], MainSight.counts[5]);
+	out.AppendFormat("cache: %d hits, %d misses", sightcache[0], sightcache[1]);
+	if (sightcache[2] > 0)
+	{
+		out.AppendFormat(", %d planned in %04.1f ms", sightcache[2], SightPlanCycles.TimeMS());
+	}
+	out += '\n';
 	return out;
 }
 
@@ -956,5 +1226,8 @@ void P_ResetSightCounters (bool full)
 		MaxSightCycles = SightCycles;
 	}
 	SightCycles.Reset();
-	memset (sightcounts, 0, sizeof(sightcounts));
+	SightPlanCycles.Reset();
+	memset (MainSight.counts, 0, sizeof(MainSight.counts));
+	memset (sightcache, 0, sizeof(sightcache));
+	SightCache.Clear();
 }
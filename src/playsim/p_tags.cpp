@@ -34,6 +34,7 @@
 */
 
 
+#include <algorithm>
 #include "p_tags.h"
 #include "c_dispatch.h"
 #include "g_levellocals.h"
@@ -190,6 +191,42 @@ void FTagManager::HashTags()
 		}
 	}
 
+	BuildFlatIndex(allTags, TagTargets, TagRanges);
+	BuildFlatIndex(allIDs, IDTargets, IDRanges);
+}
+
+//-----------------------------------------------------------------------------
+//
+// Groups the valid entries by tag. Within a tag they stay in array
+// order, which is the order the hash chains return them in.
+//
+//-----------------------------------------------------------------------------
+
+void FTagManager::BuildFlatIndex(const TArray<FTagItem> &items, TArray<int> &targets, TMap<int, FTagRange> &ranges)
+{
+	TArray<int> order;
+
+	for (unsigned i = 0; i < items.Size(); i++)
+	{
+		if (items[i].target >= 0) order.Push(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return items[a].tag < items[b].tag; });
+
+	targets.Resize(order.Size());
+	ranges.Clear();
+	for (unsigned i = 0; i < order.Size(); i++)
+	{
+		auto &item = items[order[i]];
+		targets[i] = item.target;
+		if (i == 0 || items[order[i - 1]].tag != item.tag)
+		{
+			ranges[item.tag] = { (int)i, (int)i + 1 };
+		}
+		else
+		{
+			ranges[item.tag].last = i + 1;
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -333,10 +370,8 @@ int FSectorTagIterator::Next()
 	}
 	else if (searchtag != 0)
 	{
-		while (start >= 0 && tagManager.allTags[start].tag != searchtag) start = tagManager.allTags[start].nexttag;
-		if (start == -1) return -1;
-		ret = tagManager.allTags[start].target;
-		start = tagManager.allTags[start].nexttag;
+		if (start >= end) return -1;
+		ret = tagManager.TagTargets[start++];
 	}
 	else
 	{
@@ -378,10 +413,7 @@ int FSectorTagIterator::NextCompat(bool compat, int start)
 
 int FLineIdIterator::Next()
 {
-	while (start >= 0 && tagManager.allIDs[start].tag != searchtag) start = tagManager.allIDs[start].nexttag;
-	if (start == -1) return -1;
-	int ret = tagManager.allIDs[start].target;
-	start = tagManager.allIDs[start].nexttag;
-	return ret;
+	if (start >= end) return -1;
+	return tagManager.IDTargets[start++];
 }
 
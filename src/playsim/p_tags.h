@@ -11,6 +11,13 @@ struct FTagItem
 	int nexttag;	// for hashing
 };
 
+// A tag's run of targets in FTagManager's flat index.
+struct FTagRange
+{
+	int first;
+	int last;
+};
+
 class FSectorTagIterator;
 class FLineIdIterator;
 struct FLevelLocals;
@@ -37,6 +44,14 @@ class FTagManager
 	int TagHashFirst[TAG_HASH_SIZE];
 	int IDHashFirst[TAG_HASH_SIZE];
 
+	// Every tag's targets stored contiguously, in the same order as the
+	// hash chains, so that the iterators do not have to skip over other
+	// tags that share a hash slot. Built by HashTags.
+	TArray<int> TagTargets;
+	TArray<int> IDTargets;
+	TMap<int, FTagRange> TagRanges;
+	TMap<int, FTagRange> IDRanges;
+
 	bool SectorHasTags(int sect) const
 	{
 		return sect >= 0 && sect < (int)startForSector.Size() && startForSector[sect] >= 0;
@@ -57,6 +72,10 @@ class FTagManager
 		startForLine.Clear();
 		memset(TagHashFirst, -1, sizeof(TagHashFirst));
 		memset(IDHashFirst, -1, sizeof(IDHashFirst));
+		TagTargets.Clear();
+		IDTargets.Clear();
+		TagRanges.Clear();
+		IDRanges.Clear();
 	}
 
 	bool SectorHasTags(const sector_t *sector) const;
@@ -70,6 +89,7 @@ class FTagManager
 	bool LineHasID(const line_t *line, int id) const;
 
 	void HashTags();
+	static void BuildFlatIndex(const TArray<FTagItem> &items, TArray<int> &targets, TMap<int, FTagRange> &ranges);
 public:	// The ones below are called by functions that cannot be declared as friend.
 	void AddSectorTag(int sector, int tag);
 	void AddLineID(int line, int tag);
@@ -85,6 +105,7 @@ class FSectorTagIterator
 protected:
 	int searchtag;
 	int start;
+	int end;		// end of the tag's range in TagTargets
 	FTagManager &tagManager;
 
 	FSectorTagIterator(FTagManager &tm) : tagManager(tm)
@@ -92,10 +113,22 @@ protected:
 		// For DSectorTagIterator
 	}
 
-	void Init(int tag)
+	void InitRange(int tag)
 	{
 		searchtag = tag;
-		start = tag == 0 ? 0 : tagManager.TagHashFirst[((unsigned int)tag) % FTagManager::TAG_HASH_SIZE];
+		auto range = tagManager.TagRanges.CheckKey(tag);
+		start = range ? range->first : 0;
+		end = range ? range->last : 0;
+	}
+
+	void Init(int tag)
+	{
+		if (tag == 0)
+		{
+			searchtag = 0;
+			start = 0;
+		}
+		else InitRange(tag);
 	}
 
 	void Init(int tag, line_t *line)
@@ -105,11 +138,7 @@ protected:
 			searchtag = INT_MIN;
 			start = (line == NULL || line->backsector == NULL) ? -1 : line->backsector->Index();
 		}
-		else
-		{
-			searchtag = tag;
-			start = tagManager.TagHashFirst[((unsigned int)tag) % FTagManager::TAG_HASH_SIZE];
-		}
+		else InitRange(tag);
 	}
 
 	FSectorTagIterator(FTagManager &tm, int tag) : tagManager(tm)
@@ -133,12 +162,15 @@ class FLineIdIterator
 protected:
 	int searchtag;
 	int start;
+	int end;
 	FTagManager &tagManager;
 
 	FLineIdIterator(FTagManager &tm, int id) : tagManager(tm)
 	{
 		searchtag = id;
-		start = tagManager.IDHashFirst[((unsigned int)id) % FTagManager::TAG_HASH_SIZE];
+		auto range = tagManager.IDRanges.CheckKey(id);
+		start = range ? range->first : 0;
+		end = range ? range->last : 0;
 	}
 
 public:
@@ -1445,6 +1445,7 @@ void P_PredictPlayer (player_t *player)
 			block->NextActor->PrevActor = block->PrevActor;
 		}
 		*(block->PrevActor) = block->NextActor;
+		act->Level->blockmap.UnlinkThing(block);
 		block = block->NextBlock;
 	}
 	act->BlockNode = NULL;
@@ -1588,9 +1589,17 @@ void P_UnPredictPlayer ()
 			{
 				block->NextActor->PrevActor = &block->NextActor;
 			}
+			act->Level->blockmap.RestoreThing(block);
 			block = block->NextBlock;
 		}
 
+		// While the game is paused the level tick does not compact the blockmap,
+		// but prediction keeps relinking the player.
+		if (act->Level->blockmap.clearedthings > FBlockmap::MAXCLEAREDTHINGS)
+		{
+			act->Level->blockmap.CompactThings();
+		}
+
 		actInvSel = InvSel;
 		player->inventorytics = inventorytics;
 	}
@@ -39,6 +39,7 @@
 #include "g_levellocals.h"
 #include "actorinlines.h"
 #include "v_text.h"
+#include "stats.h"
 
 // TYPES -------------------------------------------------------------------
 
@@ -130,6 +131,9 @@ static void ReleaseAllPolyNodes();
 
 static FPolyNode *FreePolyNodes;
 
+static cycle_t PolyMoveCycles;
+static int PolyMoveCount, PolyCheckCount;
+
 // CODE --------------------------------------------------------------------
 
 
@@ -850,6 +854,76 @@ void FPolyObj::CalcCenter()
 	CenterSpot.pos = c / Vertices.Size();
 }
 
+//==========================================================================
+//
+// PolyMoveClock
+//
+// Times a single move or rotate attempt for the polyobjs stat.
+//
+//==========================================================================
+
+struct PolyMoveClock
+{
+	PolyMoveClock() { PolyMoveCount++; PolyMoveCycles.Clock(); }
+	~PolyMoveClock() { PolyMoveCycles.Unclock(); }
+};
+
+ADD_STAT(polyobjs)
+{
+	FString out;
+	out.Format("%d moves (%d checked) %04.2f ms", PolyMoveCount, PolyCheckCount, PolyMoveCycles.TimeMS());
+	PolyMoveCycles.Reset();
+	PolyMoveCount = PolyCheckCount = 0;
+	return out;
+}
+
+//==========================================================================
+//
+// AnyMobjsNearLines
+//
+// Broadphase for the blocking checks: CheckMobjBlocking only ever looks
+// at actors linked into the blocks its line's bbox touches, so if the
+// blocks under all of the polyobject's lines are empty, none of the
+// per-line checks can find anything and they can be skipped entirely.
+//
+//==========================================================================
+
+bool FPolyObj::AnyMobjsNearLines() const
+{
+	if (Linedefs.Size() == 0) return false;
+
+	double box[4] = { Linedefs[0]->bbox[BOXTOP], Linedefs[0]->bbox[BOXBOTTOM], Linedefs[0]->bbox[BOXLEFT], Linedefs[0]->bbox[BOXRIGHT] };
+	for (unsigned i = 1; i < Linedefs.Size(); i++)
+	{
+		const double *lbox = Linedefs[i]->bbox;
+		if (lbox[BOXTOP] > box[BOXTOP]) box[BOXTOP] = lbox[BOXTOP];
+		if (lbox[BOXBOTTOM] < box[BOXBOTTOM]) box[BOXBOTTOM] = lbox[BOXBOTTOM];
+		if (lbox[BOXLEFT] < box[BOXLEFT]) box[BOXLEFT] = lbox[BOXLEFT];
+		if (lbox[BOXRIGHT] > box[BOXRIGHT]) box[BOXRIGHT] = lbox[BOXRIGHT];
+	}
+
+	auto &blockmap = Level->blockmap;
+	int bmapwidth = blockmap.bmapwidth;
+	int bmapheight = blockmap.bmapheight;
+	int top = clamp(blockmap.GetBlockY(box[BOXTOP]), 0, bmapheight - 1);
+	int bottom = clamp(blockmap.GetBlockY(box[BOXBOTTOM]), 0, bmapheight - 1);
+	int left = clamp(blockmap.GetBlockX(box[BOXLEFT]), 0, bmapwidth - 1);
+	int right = clamp(blockmap.GetBlockX(box[BOXRIGHT]), 0, bmapwidth - 1);
+
+	for (int j = bottom * bmapwidth; j <= top * bmapwidth; j += bmapwidth)
+	{
+		for (int i = left; i <= right; i++)
+		{
+			if (blockmap.blocklinks[j + i] != nullptr)
+			{
+				PolyCheckCount++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 //==========================================================================
 //
 // PO_MovePolyobj
@@ -859,10 +933,11 @@ void FPolyObj::CalcCenter()
 bool FPolyObj::MovePolyobj (const DVector2 &pos, bool force)
 {
 	FBoundingBox oldbounds = Bounds;
+	PolyMoveClock clock;
 	UnLinkPolyobj ();
 	DoMovePolyobj (pos);
 
-	if (!force)
+	if (!force && AnyMobjsNearLines())
 	{
 		bool blocked = false;
 
@@ -938,6 +1013,7 @@ bool FPolyObj::RotatePolyobj (DAngle angle, bool fromsave)
 	DAngle an;
 	bool blocked;
 	FBoundingBox oldbounds = Bounds;
+	PolyMoveClock clock;
 
 	an = Angle + angle;
 
@@ -955,7 +1031,7 @@ bool FPolyObj::RotatePolyobj (DAngle angle, bool fromsave)
 	UpdateBBox();
 
 	// If we are loading a savegame we do not really want to damage actors and be blocked by them. This can also cause crashes when trying to damage incompletely deserialized player pawns.
-	if (!fromsave)
+	if (!fromsave && AnyMobjsNearLines())
 	{
 		for (unsigned i = 0; i < Sidedefs.Size(); i++)
 		{
@@ -994,6 +1070,8 @@ void FPolyObj::UnLinkPolyobj ()
 	int i, j;
 	int index;
 
+	Level->blockmap.polylinks++;
+
 	// remove the polyobj from each blockmap section
 	for(j = bbox[BOXBOTTOM]; j <= bbox[BOXTOP]; j++)
 	{
@@ -1163,6 +1241,9 @@ void FPolyObj::LinkPolyobj ()
 	int bmapwidth = Level->blockmap.bmapwidth;
 	int bmapheight = Level->blockmap.bmapheight;
 
+	P_InvalidateSightCache();
+	Level->blockmap.polylinks++;
+
 	// calculate the polyobj bbox
 	Bounds.ClearBox();
 	for(unsigned i = 0; i < Sidedefs.Size(); i++)
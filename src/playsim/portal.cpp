@@ -358,6 +358,7 @@ bool FLevelLocals::ChangePortalLine(line_t *line, int destid)
 		port->mFlags = port->mDefFlags;
 	}
 	SetPortalRotation(port);
+	P_InvalidateSightCache();
 	return true;
 }
 
@@ -976,6 +977,7 @@ void FLevelLocals::CreateLinkedPortals()
 	{
 		// todo: disable all portals whose offsets do not match the associated groups
 	}
+	BuildGroupPortalLinks();
 
 	// reject would just get in the way when checking sight through portals.
 	if (Displacements.size > 1)
@@ -1042,6 +1044,36 @@ void FLevelLocals::CreateLinkedPortals()
 }
 
 
+//============================================================================
+//
+// For each portal group, collect the linked line portals whose origin
+// group has a displacement from it, in the same order as linkedPortals.
+// CollectConnectedGroups only ever considers those, so this lets it skip
+// the rest of the list without changing which portals it finds.
+//
+//============================================================================
+
+void FLevelLocals::BuildGroupPortalLinks()
+{
+	int numgroups = Displacements.size;
+
+	groupLinkedPortals.Clear();
+	groupLinkedPortalStart.Resize(numgroups + 1);
+	for (int group = 0; group < numgroups; group++)
+	{
+		groupLinkedPortalStart[group] = groupLinkedPortals.Size();
+		for (auto port : linkedPortals)
+		{
+			int othergroup = port->mOrigin->frontsector->PortalGroup;
+			if (Displacements(group, othergroup).isSet)
+			{
+				groupLinkedPortals.Push(port);
+			}
+		}
+	}
+	groupLinkedPortalStart[numgroups] = groupLinkedPortals.Size();
+}
+
 //============================================================================
 //
 // Collect all portal groups this actor would occupy at the given position
@@ -1070,17 +1102,19 @@ bool FLevelLocals::CollectConnectedGroups(int startgroup, const DVector3 &positi
 		processMask.setBit(thisgroup);
 		//out.Add(thisgroup);
 
-		for (unsigned i = 0; i < linkedPortals.Size(); i++)
+		// only walk the portals that are connected to this group at all.
+		unsigned first = groupLinkedPortalStart[thisgroup];
+		unsigned last = groupLinkedPortalStart[thisgroup + 1];
+		for (unsigned i = first; i < last; i++)
 		{
-			line_t *ld = linkedPortals[i]->mOrigin;
+			line_t *ld = groupLinkedPortals[i]->mOrigin;
 			int othergroup = ld->frontsector->PortalGroup;
 			FDisplacement &disp = Displacements(thisgroup, othergroup);
-			if (!disp.isSet) continue;	// no connection.
 
 			FBoundingBox box(position.X + disp.pos.X, position.Y + disp.pos.Y, checkradius);
 
-			if (!box.inRange(ld) || box.BoxOnLineSide(linkedPortals[i]->mOrigin) != -1) continue;	// not touched
-			foundPortals.Push(linkedPortals[i]);
+			if (!box.inRange(ld) || box.BoxOnLineSide(ld) != -1) continue;	// not touched
+			foundPortals.Push(groupLinkedPortals[i]);
 		}
 		bool foundone = true;
 		while (foundone)
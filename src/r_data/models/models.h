@@ -382,6 +382,7 @@ struct FIndexInit
 };
 
 typedef TMap<FModelVertex, unsigned int, FVoxelVertexHash, FIndexInit> FVoxelMap;
+struct FVoxelFace;
 
 
 class FVoxelModel : public FModel
@@ -394,7 +395,8 @@ protected:
 	TArray<FModelVertex> mVertices;
 	TArray<unsigned int> mIndices;
 	
-	void MakeSlabPolys(int x, int y, kvxslab_t *voxptr, FVoxelMap &check);
+	void MakeSlabPolys(int x, int y, kvxslab_t *voxptr, TArray<FVoxelFace> *faces);
+	void MergeFaces(int dir, TArray<FVoxelFace> &faces, int udim, int vdim, FVoxelMap &check);
 	void AddFace(int x1, int y1, int z1, int x2, int y2, int z2, int x3, int y3, int z3, int x4, int y4, int z4, uint8_t color, FVoxelMap &check);
 	unsigned int AddVertex(FModelVertex &vert, FVoxelMap &check);
 
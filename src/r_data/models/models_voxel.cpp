@@ -237,11 +237,30 @@ void FVoxelModel::AddFace(int x1, int y1, int z1, int x2, int y2, int z2, int x3
 
 //===========================================================================
 //
-// 
+// Collects the visible faces of one slab, grouped by the direction they face.
+// The slab's culling bits say which sides are exposed. Top and bottom only
+// exist at the slab's ends.
 //
 //===========================================================================
 
-void FVoxelModel::MakeSlabPolys(int x, int y, kvxslab_t *voxptr, FVoxelMap &check)
+struct FVoxelFace
+{
+	uint16_t slice, u, v;
+	uint8_t color;
+};
+
+enum
+{
+	VFACE_LEFT,		// -x
+	VFACE_RIGHT,	// +x
+	VFACE_FRONT,	// -y
+	VFACE_BACK,		// +y
+	VFACE_TOP,		// -z
+	VFACE_BOTTOM,	// +z
+	VFACE_COUNT
+};
+
+void FVoxelModel::MakeSlabPolys(int x, int y, kvxslab_t *voxptr, TArray<FVoxelFace> *faces)
 {
 	const uint8_t *col = voxptr->col;
 	int zleng = voxptr->zleng;
@@ -250,37 +269,90 @@ void FVoxelModel::MakeSlabPolys(int x, int y, kvxslab_t *voxptr, FVoxelMap &chec
 
 	if (cull & 16)
 	{
-		AddFace(x, y, ztop, x+1, y, ztop, x, y+1, ztop, x+1, y+1, ztop, *col, check);
+		faces[VFACE_TOP].Push({ (uint16_t)ztop, (uint16_t)x, (uint16_t)y, col[0] });
 	}
-	int z = ztop;
-	while (z < ztop+zleng)
+	for (int i = 0; i < zleng; i++)
+	{
+		uint16_t z = uint16_t(ztop + i);
+		if (cull & 1) faces[VFACE_LEFT].Push({ (uint16_t)x, (uint16_t)y, z, col[i] });
+		if (cull & 2) faces[VFACE_RIGHT].Push({ (uint16_t)x, (uint16_t)y, z, col[i] });
+		if (cull & 4) faces[VFACE_FRONT].Push({ (uint16_t)y, (uint16_t)x, z, col[i] });
+		if (cull & 8) faces[VFACE_BACK].Push({ (uint16_t)y, (uint16_t)x, z, col[i] });
+	}
+	if (cull & 32)
 	{
-		int c = 0;
-		while (z+c < ztop+zleng && col[c] == col[0]) c++;
+		faces[VFACE_BOTTOM].Push({ uint16_t(ztop + zleng - 1), (uint16_t)x, (uint16_t)y, col[zleng - 1] });
+	}
+}
 
-		if (cull & 1)
-		{
-			AddFace(x, y, z, x, y+1, z, x, y, z+c, x, y+1, z+c, *col, check);
-		}
-		if (cull & 2)
+//===========================================================================
+//
+// Greedy meshing: merges same colored faces in one plane into rectangles.
+// Faces are visited in row order so each rectangle starts at its first
+// corner and grows along u, then along v as long as whole rows match.
+//
+//===========================================================================
+
+void FVoxelModel::MergeFaces(int dir, TArray<FVoxelFace> &faces, int udim, int vdim, FVoxelMap &check)
+{
+	if (faces.Size() == 0) return;
+
+	std::sort(faces.begin(), faces.end(), [](const FVoxelFace &a, const FVoxelFace &b)
+	{
+		if (a.slice != b.slice) return a.slice < b.slice;
+		if (a.v != b.v) return a.v < b.v;
+		return a.u < b.u;
+	});
+
+	// 0 is an empty cell, everything else is color + 1.
+	TArray<uint16_t> grid(udim * vdim, true);
+	memset(grid.Data(), 0, grid.Size() * sizeof(uint16_t));
+
+	unsigned first = 0;
+	while (first < faces.Size())
+	{
+		int s = faces[first].slice;
+		unsigned last = first;
+		for (; last < faces.Size() && faces[last].slice == s; last++)
 		{
-			AddFace(x+1, y+1, z, x+1, y, z, x+1, y+1, z+c, x+1, y, z+c, *col, check);
+			grid[faces[last].v * udim + faces[last].u] = faces[last].color + 1;
 		}
-		if (cull & 4)
+
+		for (unsigned i = first; i < last; i++)
 		{
-			AddFace(x+1, y, z, x, y, z, x+1, y, z+c, x, y, z+c, *col, check);
+			int u0 = faces[i].u, v0 = faces[i].v;
+			uint16_t c = grid[v0 * udim + u0];
+			if (c == 0) continue;	// already part of an earlier rectangle
+
+			int u1 = u0 + 1;
+			while (u1 < udim && grid[v0 * udim + u1] == c) u1++;
+
+			int v1 = v0 + 1;
+			for (; v1 < vdim; v1++)
+			{
+				int u;
+				for (u = u0; u < u1 && grid[v1 * udim + u] == c; u++);
+				if (u < u1) break;
+			}
+
+			for (int v = v0; v < v1; v++)
+			{
+				memset(&grid[v * udim + u0], 0, (u1 - u0) * sizeof(uint16_t));
+			}
+
+			uint8_t color = uint8_t(c - 1);
+			int p = s + 1;
+			switch (dir)
+			{
+			case VFACE_LEFT:	AddFace(s, u0, v0, s, u1, v0, s, u0, v1, s, u1, v1, color, check); break;
+			case VFACE_RIGHT:	AddFace(p, u1, v0, p, u0, v0, p, u1, v1, p, u0, v1, color, check); break;
+			case VFACE_FRONT:	AddFace(u1, s, v0, u0, s, v0, u1, s, v1, u0, s, v1, color, check); break;
+			case VFACE_BACK:	AddFace(u0, p, v0, u1, p, v0, u0, p, v1, u1, p, v1, color, check); break;
+			case VFACE_TOP:		AddFace(u0, v0, s, u1, v0, s, u0, v1, s, u1, v1, s, color, check); break;
+			case VFACE_BOTTOM:	AddFace(u1, v0, p, u0, v0, p, u1, v1, p, u0, v1, p, color, check); break;
+			}
 		}
-		if (cull & 8)
-		{
-			AddFace(x, y+1, z, x+1, y+1, z, x, y+1, z+c, x+1, y+1, z+c, *col, check);
-		}	
-		z+=c;
-		col+=c;
-	}
-	if (cull & 32)
-	{
-		int z = ztop+zleng-1;
-		AddFace(x+1, y, z+1, x, y, z+1, x+1, y+1, z+1, x, y+1, z+1, voxptr->col[zleng-1], check);
+		first = last;
 	}
 }
 
@@ -293,6 +365,7 @@ void FVoxelModel::MakeSlabPolys(int x, int y, kvxslab_t *voxptr, FVoxelMap &chec
 void FVoxelModel::Initialize()
 {
 	FVoxelMap check;
+	TArray<FVoxelFace> faces[VFACE_COUNT];
 	FVoxelMipLevel *mip = &mVoxel->Mips[0];
 	for (int x = 0; x < mip->SizeX; x++)
 	{
@@ -304,10 +377,16 @@ void FVoxelModel::Initialize()
 			kvxslab_t *voxend = (kvxslab_t *)(slabxoffs + xyoffs[y+1]);
 			for (; voxptr < voxend; voxptr = (kvxslab_t *)((uint8_t *)voxptr + voxptr->zleng + 3))
 			{
-				MakeSlabPolys(x, y, voxptr, check);
+				MakeSlabPolys(x, y, voxptr, faces);
 			}
 		}
 	}
+	MergeFaces(VFACE_LEFT, faces[VFACE_LEFT], mip->SizeY, mip->SizeZ, check);
+	MergeFaces(VFACE_RIGHT, faces[VFACE_RIGHT], mip->SizeY, mip->SizeZ, check);
+	MergeFaces(VFACE_FRONT, faces[VFACE_FRONT], mip->SizeX, mip->SizeZ, check);
+	MergeFaces(VFACE_BACK, faces[VFACE_BACK], mip->SizeX, mip->SizeZ, check);
+	MergeFaces(VFACE_TOP, faces[VFACE_TOP], mip->SizeX, mip->SizeY, check);
+	MergeFaces(VFACE_BOTTOM, faces[VFACE_BOTTOM], mip->SizeX, mip->SizeY, check);
 }
 
 //===========================================================================
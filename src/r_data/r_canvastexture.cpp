@@ -38,6 +38,14 @@
 #include "r_canvastexture.h"
 #include "g_levellocals.h"
 #include "serializer.h"
+#include "c_cvars.h"
+
+// Nonzero values spread camera updates over this many frames. Each camera
+// gets its own slot so that not all of them are rendered in the same frame.
+CUSTOM_CVAR(Int, r_cameratexture_interval, 1, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 1) self = 1;
+}
 
 //==========================================================================
 //
@@ -112,15 +120,28 @@ void SetCameraToTexture(AActor *viewpoint, const FString &texturename, double fo
 // FCanvasTextureInfo :: UpdateAll
 //
 // Updates all canvas textures that were visible in the last frame.
+// With r_cameratexture_interval above 1 each camera only gets its turn
+// every that many frames, but one that has never been rendered since
+// being assigned is always done right away.
 //
 //==========================================================================
 
 void FCanvasTextureInfo::UpdateAll(std::function<void(AActor *, FCanvasTexture *, double fov)> callback)
 {
-	for (auto &probe : List)
+	static unsigned framecount;
+	unsigned interval = (unsigned)*r_cameratexture_interval;
+	unsigned slot = framecount++;
+
+	for (unsigned i = 0; i < List.Size(); i++)
 	{
+		auto &probe = List[i];
 		if (probe.Viewpoint != nullptr && probe.Texture->bNeedsUpdate)
 		{
+			if (interval > 1 && !probe.Texture->bFirstUpdate && (slot + i) % interval != 0)
+			{
+				// Stays flagged, so it'll be picked up on its next turn if still in view.
+				continue;
+			}
 			callback(probe.Viewpoint, probe.Texture, probe.FOV);
 		}
 	}
@@ -55,6 +55,7 @@ class DSectorPlaneInterpolation : public DInterpolation
 	double oldheight, oldtexz;
 	double bakheight, baktexz;
 	bool ceiling;
+	bool moved = false;		// only valid between Interpolate and Restore
 	TArray<DInterpolation *> attached;
 
 
@@ -140,6 +141,7 @@ class DPolyobjInterpolation : public DInterpolation
 	TArray<double> oldverts, bakverts;
 	double oldcx, oldcy;
 	double bakcx, bakcy;
+	bool moved = false;		// only valid between Interpolate and Restore
 
 public:
 
@@ -457,6 +459,7 @@ void DSectorPlaneInterpolation::UpdateInterpolation()
 
 void DSectorPlaneInterpolation::Restore()
 {
+	if (!moved) return;
 	if (!ceiling)
 	{
 		sector->floorplane.setD(bakheight);
@@ -496,13 +499,16 @@ void DSectorPlaneInterpolation::Interpolate(double smoothratio)
 	bakheight = pplane->fD();
 	baktexz = sector->GetPlaneTexZ(pos);
 
+	moved = oldheight != bakheight || oldtexz != baktexz;
 	if (refcount == 0 && oldheight == bakheight)
 	{
 		UnlinkFromMap();
 		Destroy();
 	}
-	else
+	else if (moved)
 	{
+		// A plane whose mover is waiting keeps its interpolation but needs
+		// neither the 3D floor nor the portal recalculation until it moves again.
 		pplane->setD(oldheight + (bakheight - oldheight) * smoothratio);
 		sector->SetPlaneTexZ(pos, oldtexz + (baktexz - oldtexz) * smoothratio, true);
 		P_RecalculateAttached3DFloors(sector);
@@ -810,6 +816,7 @@ void DPolyobjInterpolation::UpdateInterpolation()
 
 void DPolyobjInterpolation::Restore()
 {
+	if (!moved) return;
 	for(unsigned int i = 0; i < poly->Vertices.Size(); i++)
 	{
 		poly->Vertices[i]->set(bakverts[i*2  ], bakverts[i*2+1]);
@@ -841,15 +848,18 @@ void DPolyobjInterpolation::Interpolate(double smoothratio)
 				oldverts[i * 2 + 1] + (bakverts[i * 2 + 1] - oldverts[i * 2 + 1]) * smoothratio);
 		}
 	}
+	bakcx = poly->CenterSpot.pos.X;
+	bakcy = poly->CenterSpot.pos.Y;
+	moved = changed || bakcx != oldcx || bakcy != oldcy;
 	if (refcount == 0 && !changed)
 	{
 		UnlinkFromMap();
 		Destroy();
 	}
-	else
+	else if (moved)
 	{
-		bakcx = poly->CenterSpot.pos.X;
-		bakcy = poly->CenterSpot.pos.Y;
+		// Clearing the subsector links forces the polyobject to be split
+		// again for rendering, so don't do it for one that isn't moving.
 		poly->CenterSpot.pos.X = bakcx + (bakcx - oldcx) * smoothratio;
 		poly->CenterSpot.pos.Y = bakcy + (bakcy - oldcy) * smoothratio;
 
@@ -331,19 +331,43 @@ public:
 			}
 		}
 
+		// Sort the segs by start position so that finding the successor of a seg
+		// does not need to go through the entire list. Segs with the same start
+		// stay in their original order, which keeps the picks below the same
+		// as a linear search through the list.
+		TArray<unsigned> bystart(outersegs.Size(), true);
+		TArray<bool> used(outersegs.Size(), true);
+		for (unsigned i = 0; i < outersegs.Size(); i++)
+		{
+			bystart[i] = i;
+			used[i] = false;
+		}
+		auto startless = [&](unsigned a, unsigned b)
+		{
+			auto pa = outersegs[a]->v1->fPos();
+			auto pb = outersegs[b]->v1->fPos();
+			if (pa.X != pb.X) return pa.X < pb.X;
+			if (pa.Y != pb.Y) return pa.Y < pb.Y;
+			return a < b;
+		};
+		std::sort(bystart.begin(), bystart.end(), startless);
+
 		// Loop until all segs have been used.
 		seg_t *seg = nullptr;
 		unsigned startindex = 0;
-		while (outersegs.Size() > 0)
+		unsigned remaining = outersegs.Size();
+		unsigned firstfree = 0;
+		while (remaining > 0)
 		{
 			if (seg == nullptr)
 			{
-				for (unsigned i = 0; i < outersegs.Size(); i++)
+				while (used[firstfree]) firstfree++;
+				for (unsigned i = firstfree; i < outersegs.Size(); i++)
 				{
-					if (outersegs[i]->sidedef != nullptr && outersegs[i]->sidedef->V1() == outersegs[i]->v1)
+					if (!used[i] && outersegs[i]->sidedef != nullptr && outersegs[i]->sidedef->V1() == outersegs[i]->v1)
 					{
 						seg = outersegs[i];
-						outersegs.Delete(i);
+						used[i] = true;
 						break;
 					}
 				}
@@ -351,47 +375,60 @@ public:
 				{
 					// There's only minisegs left. Most likely this is just node garbage.
 					// Todo: Need to check.
-					seg = outersegs[0];
-					outersegs.Delete(0);
+					seg = outersegs[firstfree];
+					used[firstfree] = true;
 				}
+				remaining--;
 				startindex = loopedsegs.Push(seg);
 			}
 
 			// Find the next seg in the loop.
 
 			auto segangle = VecToAngle(seg->v2->fPos() - seg->v1->fPos());
+			auto segend = seg->v2->fPos();
+
+			// Locate the first seg starting at this seg's end.
+			unsigned lo = 0, hi = bystart.Size();
+			while (lo < hi)
+			{
+				unsigned mid = (lo + hi) / 2;
+				auto pos = outersegs[bystart[mid]]->v1->fPos();
+				if (pos.X < segend.X || (pos.X == segend.X && pos.Y < segend.Y)) lo = mid + 1;
+				else hi = mid;
+			}
 
 			seg_t *pick = nullptr;
 			int pickindex = -1;
-			for (unsigned i = 0; i < outersegs.Size(); i++)
+			for (unsigned j = lo; j < bystart.Size() && outersegs[bystart[j]]->v1->fPos() == segend; j++)
 			{
+				unsigned i = bystart[j];
+				if (used[i]) continue;
 				auto secondseg = outersegs[i];
-				if (secondseg->v1->fPos() == seg->v2->fPos())
+
+				// This should never choose a miniseg over a real sidedef. 
+				if (pick == nullptr || (pick->sidedef == nullptr && secondseg->sidedef != nullptr))
 				{
-					// This should never choose a miniseg over a real sidedef. 
-					if (pick == nullptr || (pick->sidedef == nullptr && secondseg->sidedef != nullptr))
+					pick = secondseg;
+					pickindex = i;
+				}
+				else if (pick->sidedef == nullptr || secondseg->sidedef != nullptr)
+				{
+					// If there's more than one pick the one with the smallest angle.
+					auto pickangle = deltaangle(segangle, VecToAngle(pick->v2->fPos() - pick->v1->fPos()));
+					auto secondangle = deltaangle(segangle, VecToAngle(secondseg->v2->fPos() - secondseg->v1->fPos()));
+
+					if (secondangle < pickangle)
 					{
 						pick = secondseg;
 						pickindex = i;
 					}
-					else if (pick->sidedef == nullptr || secondseg->sidedef != nullptr)
-					{
-						// If there's more than one pick the one with the smallest angle.
-						auto pickangle = deltaangle(segangle, VecToAngle(pick->v2->fPos() - pick->v1->fPos()));
-						auto secondangle = deltaangle(segangle, VecToAngle(secondseg->v2->fPos() - secondseg->v1->fPos()));
-
-						if (secondangle < pickangle)
-						{
-							pick = secondseg;
-							pickindex = i;
-						}
-					}
 				}
 			}
 			if (pick)
 			{
 				loopedsegs.Push(pick);
-				outersegs.Delete(pickindex);
+				used[pickindex] = true;
+				remaining--;
 				seg = pick;
 			}
 			else
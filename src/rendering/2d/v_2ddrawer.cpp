@@ -32,6 +32,7 @@
 #include "v_video.h"
 #include "g_levellocals.h"
 #include "vm.h"
+#include "stats.h"
 
 EXTERN_CVAR(Float, transsouls)
 
@@ -179,9 +180,11 @@ DEFINE_ACTION_FUNCTION_NATIVE(DShape2D, PushTriangle, Shape2D_PushTriangle)
 
 int F2DDrawer::AddCommand(const RenderCommand *data) 
 {
+	mStats.Commands++;
 	if (mData.Size() > 0 && data->isCompatible(mData.Last()))
 	{
 		// Merge with the last command.
+		mStats.Merged++;
 		mData.Last().mIndexCount += data->mIndexCount;
 		mData.Last().mVertCount += data->mVertCount;
 		return mData.Size();
@@ -789,8 +792,28 @@ void F2DDrawer::AddPixel(int x1, int y1, int palcolor, uint32_t color)
 
 void F2DDrawer::Clear()
 {
+	mStats.Vertices += mVertices.Size();
+	mStats.Indices += mIndices.Size();
 	mVertices.Clear();
 	mIndices.Clear();
 	mData.Clear();
 	mIsFirstPass = true;
 }
+
+//==========================================================================
+//
+// Per frame 2D drawer counts
+//
+//==========================================================================
+
+ADD_STAT(twod)
+{
+	static F2DDrawer::Stats last;
+	auto &now = screen->Get2DStats();
+	FString out;
+	out.Format("2D: %u commands, %u submitted (%u merged), %u vertices, %u indices",
+		(now.Commands - last.Commands) - (now.Merged - last.Merged), now.Commands - last.Commands, now.Merged - last.Merged,
+		now.Vertices - last.Vertices, now.Indices - last.Indices);
+	last = now;
+	return out;
+}
@@ -171,6 +171,16 @@ public:
 	void Clear();
 
 	bool mIsFirstPass = true;
+
+	// Running totals for the 'twod' stat, which reports the difference per frame.
+	struct Stats
+	{
+		unsigned Commands;		// AddCommand calls
+		unsigned Merged;		// of those, how many got merged into the previous command
+		unsigned Vertices;
+		unsigned Indices;
+	};
+	Stats mStats = {};
 };
 
 
@@ -204,7 +204,7 @@ void FGLRenderer::UpdateShadowMap()
 		mShadowMapShader->Uniforms.SetData();
 		static_cast<GLDataBuffer*>(mShadowMapShader->Uniforms.GetBuffer())->BindBase();
 
-		glViewport(0, 0, gl_shadowmap_quality, 1024);
+		glViewport(0, 0, gl_shadowmap_quality, screen->mShadowMap.LightRows());
 		RenderScreenQuad();
 
 		const auto &viewport = screen->mScreenViewport;
@@ -281,7 +281,9 @@ sector_t *FGLRenderer::RenderView(player_t* player)
 			fovratio = ratio;
 		}
 
+		FGLDebug::PushGroup("scene");
 		retsec = RenderViewpoint(r_viewpoint, player->camera, NULL, r_viewpoint.FieldOfView.Degrees, ratio, fovratio, true, true);
+		FGLDebug::PopGroup();
 	}
 	All.Unclock();
 	return retsec;
@@ -52,7 +52,15 @@ namespace OpenGLRenderer
 
 namespace
 {
-	std::vector<std::pair<FString, GLuint>> timeElapsedQueries;
+	// Timestamps instead of GL_TIME_ELAPSED, because elapsed time queries cannot be nested.
+	struct TimestampQuery
+	{
+		FString name;
+		GLuint start;
+		GLuint end;
+	};
+	std::vector<TimestampQuery> timeElapsedQueries;
+	std::vector<size_t> groupStack;
 }
 
 //-----------------------------------------------------------------------------
@@ -66,15 +74,21 @@ void FGLDebug::Update()
 	gpuStatOutput = "";
 	for (auto &query : timeElapsedQueries)
 	{
-		GLuint timeElapsed = 0;
-		glGetQueryObjectuiv(query.second, GL_QUERY_RESULT, &timeElapsed);
-		glDeleteQueries(1, &query.second);
+		GLuint64 start = 0, end = 0;
+		glGetQueryObjectui64v(query.start, GL_QUERY_RESULT, &start);
+		glDeleteQueries(1, &query.start);
+		if (query.end != 0)
+		{
+			glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+			glDeleteQueries(1, &query.end);
 
-		FString out;
-		out.Format("%s=%04.2f ms\n", query.first.GetChars(), timeElapsed / 1000000.0f);
-		gpuStatOutput += out;
+			FString out;
+			out.Format("%s=%04.2f ms\n", query.name.GetChars(), (end > start ? end - start : 0) / 1000000.0f);
+			gpuStatOutput += out;
+		}
 	}
 	timeElapsedQueries.clear();
+	groupStack.clear();
 
 	gpuStatActive = keepGpuStatActive;
 	keepGpuStatActive = false;
@@ -128,8 +142,9 @@ void FGLDebug::PushGroup(const FString &name)
 	{
 		GLuint queryHandle = 0;
 		glGenQueries(1, &queryHandle);
-		glBeginQuery(GL_TIME_ELAPSED, queryHandle);
-		timeElapsedQueries.push_back({ name, queryHandle });
+		glQueryCounter(queryHandle, GL_TIMESTAMP);
+		groupStack.push_back(timeElapsedQueries.size());
+		timeElapsedQueries.push_back({ name, queryHandle, 0 });
 	}
 }
 
@@ -140,9 +155,12 @@ void FGLDebug::PopGroup()
 		glPopDebugGroup();
 	}
 
-	if (gpuStatActive)
+	if (gpuStatActive && !groupStack.empty())
 	{
-		glEndQuery(GL_TIME_ELAPSED);
+		auto &query = timeElapsedQueries[groupStack.back()];
+		groupStack.pop_back();
+		glGenQueries(1, &query.end);
+		glQueryCounter(query.end, GL_TIMESTAMP);
 	}
 }
 
@@ -453,7 +453,9 @@ void OpenGLFrameBuffer::Draw2D()
 	if (GLRenderer != nullptr)
 	{
 		GLRenderer->mBuffers->BindCurrentFB();
+		FGLDebug::PushGroup("2D");
 		::Draw2D(&m2DDrawer, gl_RenderState);
+		FGLDebug::PopGroup();
 	}
 }
 
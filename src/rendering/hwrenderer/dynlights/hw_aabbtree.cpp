@@ -76,6 +76,24 @@ LevelAABBTree::LevelAABBTree(FLevelLocals *lev)
 		treeline.dx = (float)line.v2->fX() - treeline.x;
 		treeline.dy = (float)line.v2->fY() - treeline.y;
 	}
+
+	// Link every node to its parent and every line to its leaf so that Update can refit bottom-up.
+	parentNodes.Resize(nodes.Size());
+	leafForLine.Resize(treelines.Size());
+	for (auto &p : parentNodes) p = -1;
+	for (auto &l : leafForLine) l = -1;
+	for (unsigned int i = 0; i < nodes.Size(); i++)
+	{
+		if (nodes[i].line_index == -1)
+		{
+			parentNodes[nodes[i].left_node] = i;
+			parentNodes[nodes[i].right_node] = i;
+		}
+		else
+		{
+			leafForLine[nodes[i].line_index] = i;
+		}
+	}
 }
 
 bool LevelAABBTree::GenerateTree(const FVector2 *centroids, bool dynamicsubtree)
@@ -115,7 +133,9 @@ bool LevelAABBTree::GenerateTree(const FVector2 *centroids, bool dynamicsubtree)
 
 bool LevelAABBTree::Update()
 {
-	bool modified = false;
+	dirtyNodesStart = dirtyLinesStart = INT_MAX;
+	dirtyNodesEnd = dirtyLinesEnd = 0;
+
 	for (unsigned int i = dynamicStartLine; i < mapLines.Size(); i++)
 	{
 		const auto &line = Level->lines[mapLines[i]];
@@ -128,64 +148,45 @@ bool LevelAABBTree::Update()
 
 		if (memcmp(&treelines[i], &treeline, sizeof(AABBTreeLine)))
 		{
-			TArray<int> path = FindNodePath(i, nodes.Size() - 1);
-			if (path.Size())
+			int nodeIndex = leafForLine[i];
+			if (nodeIndex >= 0)
 			{
 				float x1 = (float)line.v1->fX();
 				float y1 = (float)line.v1->fY();
 				float x2 = (float)line.v2->fX();
 				float y2 = (float)line.v2->fY();
 
-				int nodeIndex = path[0];
 				nodes[nodeIndex].aabb_left = MIN(x1, x2);
 				nodes[nodeIndex].aabb_right = MAX(x1, x2);
 				nodes[nodeIndex].aabb_top = MIN(y1, y2);
 				nodes[nodeIndex].aabb_bottom = MAX(y1, y2);
+				MarkDirtyNode(nodeIndex);
 
-				for (unsigned int j = 1; j < path.Size(); j++)
+				for (int j = parentNodes[nodeIndex]; j >= 0; j = parentNodes[j])
 				{
-					auto &cur = nodes[path[j]];
+					auto &cur = nodes[j];
 					const auto &left = nodes[cur.left_node];
 					const auto &right = nodes[cur.right_node];
 					cur.aabb_left = MIN(left.aabb_left, right.aabb_left);
 					cur.aabb_top = MIN(left.aabb_top, right.aabb_top);
 					cur.aabb_right = MAX(left.aabb_right, right.aabb_right);
 					cur.aabb_bottom = MAX(left.aabb_bottom, right.aabb_bottom);
+					MarkDirtyNode(j);
 				}
 
 				treelines[i] = treeline;
-				modified = true;
+				dirtyLinesStart = MIN(dirtyLinesStart, (int)i);
+				dirtyLinesEnd = MAX(dirtyLinesEnd, (int)i + 1);
 			}
 		}
 	}
-	return modified;
+	return dirtyNodesEnd > 0;
 }
 
-TArray<int> LevelAABBTree::FindNodePath(unsigned int line, unsigned int node)
+void LevelAABBTree::MarkDirtyNode(int node)
 {
-	const AABBTreeNode &n = nodes[node];
-
-	if (n.aabb_left > treelines[line].x || n.aabb_right < treelines[line].x ||
-		n.aabb_top > treelines[line].y || n.aabb_bottom < treelines[line].y)
-	{
-		return {};
-	}
-
-	TArray<int> path;
-	if (n.line_index == -1)
-	{
-		path = FindNodePath(line, n.left_node);
-		if (path.Size() == 0)
-			path = FindNodePath(line, n.right_node);
-
-		if (path.Size())
-			path.Push(node);
-	}
-	else if (n.line_index == (int)line)
-	{
-		path.Push(node);
-	}
-	return path;
+	dirtyNodesStart = MIN(dirtyNodesStart, node);
+	dirtyNodesEnd = MAX(dirtyNodesEnd, node + 1);
 }
 
 double LevelAABBTree::RayTest(const DVector3 &ray_start, const DVector3 &ray_end)
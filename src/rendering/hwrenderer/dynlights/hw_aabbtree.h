@@ -55,12 +55,13 @@ public:
 	size_t LinesSize() const { return treelines.Size() * sizeof(AABBTreeLine); }
 	unsigned int NodesCount() const { return nodes.Size(); }
 
-	const void *DynamicNodes() const { return nodes.Data() + dynamicStartNode; }
-	const void *DynamicLines() const { return treelines.Data() + dynamicStartLine; }
-	size_t DynamicNodesSize() const { return (nodes.Size() - dynamicStartNode) * sizeof(AABBTreeNode); }
-	size_t DynamicLinesSize() const { return (treelines.Size() - dynamicStartLine) * sizeof(AABBTreeLine); }
-	size_t DynamicNodesOffset() const { return dynamicStartNode * sizeof(AABBTreeNode); }
-	size_t DynamicLinesOffset() const { return dynamicStartLine * sizeof(AABBTreeLine); }
+	// Ranges changed by the last Update call. Only valid if it returned true.
+	const void *DirtyNodes() const { return nodes.Data() + dirtyNodesStart; }
+	const void *DirtyLines() const { return treelines.Data() + dirtyLinesStart; }
+	size_t DirtyNodesSize() const { return (dirtyNodesEnd - dirtyNodesStart) * sizeof(AABBTreeNode); }
+	size_t DirtyLinesSize() const { return (dirtyLinesEnd - dirtyLinesStart) * sizeof(AABBTreeLine); }
+	size_t DirtyNodesOffset() const { return dirtyNodesStart * sizeof(AABBTreeNode); }
+	size_t DirtyLinesOffset() const { return dirtyLinesStart * sizeof(AABBTreeLine); }
 
 private:
 	bool GenerateTree(const FVector2 *centroids, bool dynamicsubtree);
@@ -74,7 +75,7 @@ private:
 	// Generate a tree node and its children recursively
 	int GenerateTreeNode(int *treelines, int num_lines, const FVector2 *centroids, int *work_buffer);
 
-	TArray<int> FindNodePath(unsigned int line, unsigned int node);
+	void MarkDirtyNode(int node);
 
 	// Nodes in the AABB tree. Last node is the root node.
 	TArray<AABBTreeNode> nodes;
@@ -82,9 +83,16 @@ private:
 	// Line segments for the leaf nodes in the tree.
 	TArray<AABBTreeLine> treelines;
 
+	// Parent of each node (-1 for the root) and leaf node of each line.
+	TArray<int> parentNodes;
+	TArray<int> leafForLine;
+
 	int dynamicStartNode = 0;
 	int dynamicStartLine = 0;
 
+	int dirtyNodesStart = 0, dirtyNodesEnd = 0;
+	int dirtyLinesStart = 0, dirtyLinesEnd = 0;
+
 	TArray<int> mapLines;
 	FLevelLocals *Level;
 };
@@ -28,6 +28,7 @@
 #include "stats.h"
 #include "g_levellocals.h"
 #include "v_video.h"
+#include "r_utility.h"
 
 /*
 	The 1D shadow maps are stored in a 1024x1024 texture as float depth values (R32F).
@@ -115,28 +116,41 @@ void IShadowMap::CollectLights()
 	int lightindex = 0;
 	auto Level = &level;
 
-	// Todo: this should go through the blockmap in a spiral pattern around the player so that closer lights are preferred.
+	mCandidates.Clear();
 	for (auto light = Level->lights; light; light = light->next)
 	{
 		LightsProcessed++;
-		if (light->shadowmapped && light->IsActive() && lightindex < 1024 * 4)
+		light->mShadowmapIndex = 1024;
+		if (light->shadowmapped && light->IsActive())
 		{
-			LightsShadowmapped++;
+			mCandidates.Push(light);
+		}
+	}
+
+	// If there are more lights than rows in the shadow map, prefer the ones closest to the camera.
+	if (mCandidates.Size() > 1024)
+	{
+		DVector2 viewpos = r_viewpoint.Pos.XY();
+		std::nth_element(mCandidates.begin(), mCandidates.begin() + 1024, mCandidates.end(), [&](FDynamicLight *a, FDynamicLight *b)
+		{
+			return (a->Pos.XY() - viewpos).LengthSquared() < (b->Pos.XY() - viewpos).LengthSquared();
+		});
+		mCandidates.Clamp(1024);
+	}
 
-			light->mShadowmapIndex = lightindex >> 2;
+	for (auto light : mCandidates)
+	{
+		LightsShadowmapped++;
 
-			mLights[lightindex] = (float)light->X();
-			mLights[lightindex+1] = (float)light->Y();
-			mLights[lightindex+2] = (float)light->Z();
-			mLights[lightindex+3] = light->GetRadius();
-			lightindex += 4;
-		}
-        else
-        {
-            light->mShadowmapIndex = 1024;
-        }
+		light->mShadowmapIndex = lightindex >> 2;
 
+		mLights[lightindex] = (float)light->X();
+		mLights[lightindex+1] = (float)light->Y();
+		mLights[lightindex+2] = (float)light->Z();
+		mLights[lightindex+3] = light->GetRadius();
+		lightindex += 4;
 	}
+	mLightRows = MAX(lightindex >> 2, 1);
 
 	for (; lightindex < 1024 * 4; lightindex++)
 	{
@@ -206,8 +220,8 @@ void IShadowMap::UploadAABBTree()
 	}
 	else if (mAABBTree->Update())
 	{
-		mNodesBuffer->SetSubData(mAABBTree->DynamicNodesOffset(), mAABBTree->DynamicNodesSize(), mAABBTree->DynamicNodes());
-		mLinesBuffer->SetSubData(mAABBTree->DynamicLinesOffset(), mAABBTree->DynamicLinesSize(), mAABBTree->DynamicLines());
+		mNodesBuffer->SetSubData(mAABBTree->DirtyNodesOffset(), mAABBTree->DirtyNodesSize(), mAABBTree->DirtyNodes());
+		mLinesBuffer->SetSubData(mAABBTree->DirtyLinesOffset(), mAABBTree->DirtyLinesSize(), mAABBTree->DirtyLines());
 	}
 }
 
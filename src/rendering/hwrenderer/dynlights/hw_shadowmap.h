@@ -40,6 +40,12 @@ public:
 		return mAABBTree->NodesCount();
 	}
 
+	// Number of shadow map rows in use. Rows past this are never sampled and need no update.
+	int LightRows() const
+	{
+		return mLightRows;
+	}
+
 protected:
 	void CollectLights();
 	bool ValidateAABBTree(FLevelLocals *lev);
@@ -52,6 +58,8 @@ protected:
 
 	// Working buffer for creating the list of lights. Stored here to avoid allocating memory each frame
 	TArray<float> mLights;
+	TArray<FDynamicLight *> mCandidates;
+	int mLightRows = 1024;
 
 	// Used to detect when a level change requires the AABB tree to be regenerated
 	level_info_t *mLastLevel = nullptr;
@@ -670,11 +670,12 @@ void PPAmbientOcclusion::CreateShaders()
 
 void PPAmbientOcclusion::UpdateTextures(int width, int height)
 {
-	if ((width <= 0 || height <= 0) || (width == LastWidth && height == LastHeight))
+	int downsample = gl_ssao_downsample;
+	if ((width <= 0 || height <= 0) || (width == LastWidth && height == LastHeight && downsample == LastDownsample))
 		return;
 
-	AmbientWidth = (width + 1) / 2;
-	AmbientHeight = (height + 1) / 2;
+	AmbientWidth = (width + downsample - 1) / downsample;
+	AmbientHeight = (height + downsample - 1) / downsample;
 
 	LinearDepthTexture = { AmbientWidth, AmbientHeight, PixelFormat::R32f };
 	Ambient0 = { AmbientWidth, AmbientHeight, PixelFormat::Rg16f };
@@ -682,6 +683,7 @@ void PPAmbientOcclusion::UpdateTextures(int width, int height)
 
 	LastWidth = width;
 	LastHeight = height;
+	LastDownsample = downsample;
 }
 
 void PPAmbientOcclusion::Render(PPRenderState *renderstate, float m5, int sceneWidth, int sceneHeight)
@@ -852,7 +854,7 @@ void PPShadowMap::Update(PPRenderState *renderstate)
 	renderstate->Clear();
 	renderstate->Shader = &ShadowMap;
 	renderstate->Uniforms.Set(uniforms);
-	renderstate->Viewport = { 0, 0, gl_shadowmap_quality, 1024 };
+	renderstate->Viewport = { 0, 0, gl_shadowmap_quality, screen->mShadowMap.LightRows() };
 	renderstate->SetShadowMapBuffers(true);
 	renderstate->SetOutputShadowMap();
 	renderstate->SetNoBlend();
@@ -697,6 +697,7 @@ private:
 	int LastQuality = -1;
 	int LastWidth = 0;
 	int LastHeight = 0;
+	int LastDownsample = 0;
 
 	PPShader LinearDepth;
 	PPShader LinearDepthMS;
@@ -90,6 +90,13 @@ CUSTOM_CVAR(Float, gl_ssao_exponent, 1.8f, 0)
 	if (self < 0.1f) self = 0.1f;
 }
 
+// Divisor for the resolution the occlusion gets calculated at.
+CUSTOM_CVAR(Int, gl_ssao_downsample, 2, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 1) self = 1;
+	else if (self > 4) self = 4;
+}
+
 CUSTOM_CVAR(Float, gl_paltonemap_powtable, 2.0f, CVAR_ARCHIVE | CVAR_NOINITCALL)
 {
 	screen->UpdatePalette();
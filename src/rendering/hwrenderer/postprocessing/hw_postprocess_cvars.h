@@ -44,6 +44,7 @@ EXTERN_CVAR(Float, gl_ssao_bias)
 EXTERN_CVAR(Float, gl_ssao_radius)
 EXTERN_CVAR(Float, gl_ssao_blur)
 EXTERN_CVAR(Float, gl_ssao_exponent)
+EXTERN_CVAR(Int, gl_ssao_downsample)
 EXTERN_CVAR(Float, gl_paltonemap_powtable)
 EXTERN_CVAR(Bool, gl_paltonemap_reverselookup)
 EXTERN_CVAR(Float, gl_menu_blur)
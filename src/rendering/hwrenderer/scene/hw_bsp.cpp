@@ -33,12 +33,16 @@
 #include "po_man.h"
 #include "m_fixed.h"
 #include "ctpl.h"
+#include "d_player.h"
+#include "actorinlines.h"
+#include "r_data/models/models.h"
 #include "hwrenderer/scene/hw_fakeflat.h"
 #include "hwrenderer/scene/hw_clipper.h"
 #include "hwrenderer/scene/hw_drawstructs.h"
 #include "hwrenderer/scene/hw_drawinfo.h"
 #include "hwrenderer/scene/hw_portal.h"
 #include "hwrenderer/utility/hw_clock.h"
+#include "hwrenderer/utility/hw_cvars.h"
 #include "hwrenderer/data/flatvertices.h"
 
 #ifdef ARCH_IA32
@@ -46,6 +50,7 @@
 #endif // ARCH_IA32
 
 CVAR(Bool, gl_multithread, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CVAR(Bool, gl_cullsprites, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 
 thread_local bool isWorkerThread;
 ctpl::thread_pool renderPool(1);
@@ -66,6 +71,7 @@ struct RenderJob
 	int type;
 	subsector_t *sub;
 	seg_t *seg;
+	AActor **culled;	// for sprite jobs, see CullThings
 };
 
 
@@ -75,11 +81,11 @@ class RenderJobQueue
 	std::atomic<int> readindex{};
 	std::atomic<int> writeindex{};
 public:
-	void AddJob(int type, subsector_t *sub, seg_t *seg = nullptr)
+	void AddJob(int type, subsector_t *sub, seg_t *seg = nullptr, AActor **culled = nullptr)
 	{
 		// This does not check for array overflows. The pool should be large enough that it never hits the limit.
 
-		pool[writeindex] = { type, sub, seg };
+		pool[writeindex] = { type, sub, seg, culled };
 		writeindex++;	// update index only after the value has been written.
 	}
 
@@ -98,6 +104,49 @@ public:
 
 static RenderJobQueue jobQueue;	// One static queue is sufficient here. This code will never be called recursively.
 
+//==========================================================================
+//
+// Null terminated lists of the things CullThings found hidden, handed to
+// the sprite jobs. The worker reads them while the main thread adds more,
+// so a list may never move once it is made. They are kept in blocks that
+// only ever get new lists appended within their capacity and are emptied
+// for each new scene.
+//
+//==========================================================================
+
+class FCulledThingsPool
+{
+	enum { BLOCKSIZE = 4096 };
+
+	TArray<TArray<AActor *>> Blocks;
+	unsigned Current = 0;
+
+public:
+	void Clear()
+	{
+		for (auto &block : Blocks) block.Clear();
+		Current = 0;
+	}
+
+	AActor **Add(const TArray<AActor *> &things)
+	{
+		unsigned needed = things.Size() + 1;
+		while (Current < Blocks.Size() && Blocks[Current].Max() - Blocks[Current].Size() < needed) Current++;
+		if (Current == Blocks.Size())
+		{
+			Blocks.Push(TArray<AActor *>(MAX<unsigned>(needed, BLOCKSIZE)));
+		}
+		auto &block = Blocks[Current];
+		unsigned start = block.Size();
+		for (auto thing : things) block.Push(thing);
+		block.Push(nullptr);
+		return &block[start];
+	}
+};
+
+static FCulledThingsPool culledThings;
+static TArray<AActor *> culledScratch;
+
 void HWDrawInfo::WorkerThread()
 {
 	sector_t *front, *back;
@@ -173,7 +222,7 @@ void HWDrawInfo::WorkerThread()
 		case RenderJob::SpriteJob:
 			SetupSprite.Clock();
 			front = hw_FakeFlat(job->sub->sector, in_area, false);
-			RenderThings(job->sub, front);
+			RenderThings(job->sub, front, job->culled);
 			SetupSprite.Unclock();
 			break;
 
@@ -502,21 +551,127 @@ void HWDrawInfo::AddSpecialPortalLines(subsector_t * sub, sector_t * sector, lin
 }
 
 
+//==========================================================================
+//
+// Gets the radius around the actor's origin that its sprite can cover in
+// any billboard mode. Returns a negative value if this cannot be known
+// in advance, which is the case for models and voxels.
+//
+//==========================================================================
+
+static double SpriteCullRadius(AActor *thing, const FRenderViewpoint &vp)
+{
+	int spritenum = thing->sprite;
+	DVector2 sprscale = thing->Scale;
+	if (thing->player != nullptr)
+	{
+		P_CheckPlayerSprite(thing, spritenum, sprscale);
+	}
+
+	FTexture *tex;
+	if (thing->picnum.isValid())
+	{
+		tex = TexMan.GetTexture(thing->picnum, true);
+	}
+	else
+	{
+		if (FindModelFrame(thing->GetClass(), spritenum, thing->frame, !!(thing->flags & MF_DROPPED))) return -1;
+
+		bool mirror;
+		DAngle ang = (thing->InterpolatedPosition(vp.TicFrac) - vp.Pos).Angle();
+		DAngle sprangle = thing->GetSpriteAngle(ang, vp.TicFrac);
+		FTextureID patch = sprites[spritenum].GetSpriteFrame(thing->frame, -1, sprangle, &mirror, !!(thing->renderflags & RF_SPRITEFLIP));
+		tex = patch.isValid() ? TexMan.GetTexture(patch) : nullptr;
+	}
+	if (tex == nullptr) return 0;
+
+	// Same rectangle as FMaterial::SetSpriteRect, before any trimming.
+	double sx = fabs(sprscale.X), sy = fabs(sprscale.Y);
+	double left = -tex->GetSpriteLeftOffsetHW() * sx;
+	double top = -tex->GetSpriteTopOffsetHW() * sy;
+	double width = tex->GetSpriteWidthHW() * sx;
+	double height = tex->GetSpriteHeightHW() * sy;
+
+	bool tilted = !(thing->renderflags & RF_FORCEYBILLBOARD) && (gl_billboard_mode == 1 || (thing->renderflags & RF_FORCEXYBILLBOARD));
+	if (!tilted && !gl_billboard_faces_camera && !(thing->renderflags & RF_ROLLSPRITE))
+	{
+		// An upright sprite only extends sideways from the origin, in either direction if mirrored.
+		return MAX(fabs(left), fabs(left + width));
+	}
+
+	// Rolling and pitching rotate the sprite around its center or origin, so the distance of the
+	// center from the origin plus half the diagonal covers all cases. Sprite clipping may move it
+	// up by no more than its height before that.
+	DVector2 center(left + width / 2, top + height / 2);
+	return center.Length() + DVector2(width, height).Length() / 2 + height;
+}
+
+//==========================================================================
+//
+// CullThings
+//
+// Things get processed with the first subsector of their sector, which
+// may be well before the view reaches the part of the sector they stand
+// in. Anything whose sprite is entirely covered by the solid walls
+// already in the clipper is hidden and gets skipped by RenderThings.
+// This runs on the main thread because the clipper gets modified while
+// the worker processes its queue. The things' validcount belongs to the
+// thread rendering them, so the result is passed on as a list instead,
+// sorted so that RenderThings can look things up quickly.
+//
+//==========================================================================
+
+AActor **HWDrawInfo::CullThings(sector_t * sec)
+{
+	// Inside portals the clipper may get ranges removed again later.
+	if (!gl_cullsprites || mCurrentPortal != nullptr) return nullptr;
+
+	const auto &vp = Viewpoint;
+	culledScratch.Clear();
+	for (auto p = sec->touching_renderthings; p != nullptr; p = p->m_snext)
+	{
+		auto thing = p->m_thing;
+		if (thing->renderflags & (RF_WALLSPRITE | RF_FLATSPRITE)) continue;
+
+		double r = SpriteCullRadius(thing, vp);
+		if (r < 0) continue;
+
+		DVector3 pos = thing->InterpolatedPosition(vp.TicFrac);
+		float box[4];
+		box[BOXTOP] = float(pos.Y + r);
+		box[BOXBOTTOM] = float(pos.Y - r);
+		box[BOXLEFT] = float(pos.X - r);
+		box[BOXRIGHT] = float(pos.X + r);
+		if (!mClipper->CheckBox(box))
+		{
+			culledScratch.Push(thing);
+			culled_sprites++;
+		}
+	}
+	if (culledScratch.Size() == 0) return nullptr;
+	std::sort(culledScratch.begin(), culledScratch.end());
+	return culledThings.Add(culledScratch);
+}
+
 //==========================================================================
 //
 // R_RenderThings
 //
 //==========================================================================
 
-void HWDrawInfo::RenderThings(subsector_t * sub, sector_t * sector)
+void HWDrawInfo::RenderThings(subsector_t * sub, sector_t * sector, AActor **culled)
 {
 	sector_t * sec=sub->sector;
+	AActor **culledend = culled;
+	if (culled != nullptr) while (*culledend != nullptr) culledend++;
+
 	// Handle all things in sector.
     const auto &vp = Viewpoint;
 	for (auto p = sec->touching_renderthings; p != nullptr; p = p->m_snext)
 	{
 		auto thing = p->m_thing;
 		if (thing->validcount == validcount) continue;
+		if (culled != culledend && std::binary_search(culled, culledend, thing)) continue;
 		thing->validcount = validcount;
 
 		FIntCVar *cvar = thing->GetInfo()->distancecheck;
@@ -559,7 +714,7 @@ void HWDrawInfo::RenderThings(subsector_t * sub, sector_t * sector)
 void HWDrawInfo::RenderParticles(subsector_t *sub, sector_t *front)
 {
 	SetupSprite.Clock();
-	for (int i = Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = Level->Particles[i].snext)
+	for (uint32_t i = Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = Level->Particles[i].snext)
 	{
 		if (mClipPortal)
 		{
@@ -659,14 +814,15 @@ void HWDrawInfo::DoSubsector(subsector_t * sub)
 
 		if (gl_render_things && (sector->touching_renderthings || sector->sectorportal_thinglist))
 		{
+			auto culled = CullThings(sector);
 			if (multithread)
 			{
-				jobQueue.AddJob(RenderJob::SpriteJob, sub, nullptr);
+				jobQueue.AddJob(RenderJob::SpriteJob, sub, nullptr, culled);
 			}
 			else
 			{
 				SetupSprite.Clock();
-				RenderThings(sub, fakesector);
+				RenderThings(sub, fakesector, culled);
 				SetupSprite.Unclock();
 			}
 		}
@@ -805,6 +961,7 @@ void HWDrawInfo::RenderBSP(void *node, bool drawpsprites)
 	viewy = FLOAT2FIXED(Viewpoint.Pos.Y);
 
 	validcount++;	// used for processing sidedefs only once by the renderer.
+	culledThings.Clear();
 
 	multithread = gl_multithread;
 	if (multithread)
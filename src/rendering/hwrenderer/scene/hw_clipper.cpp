@@ -95,9 +95,45 @@ void Clipper::Clear()
 	
 	cliphead = NULL;
 	silhouette = NULL;
+	memset(coarse, 0, sizeof(coarse));
 	starttime++;
 }
 
+//-----------------------------------------------------------------------------
+//
+// Coarse occupancy map
+//
+//-----------------------------------------------------------------------------
+
+void Clipper::MarkCoarse(angle_t start, angle_t end)
+{
+	unsigned first = start >> COARSE_SHIFT;
+	unsigned last = end >> COARSE_SHIFT;
+
+	for (unsigned w = first >> 6; w <= last >> 6; w++)
+	{
+		uint64_t mask = ~0ull;
+		if (w == first >> 6) mask &= ~0ull << (first & 63);
+		if (w == last >> 6) mask &= ~0ull >> (63 - (last & 63));
+		coarse[w] |= mask;
+	}
+}
+
+bool Clipper::IsCoarseCovered(angle_t start, angle_t end) const
+{
+	unsigned first = start >> COARSE_SHIFT;
+	unsigned last = end >> COARSE_SHIFT;
+
+	for (unsigned w = first >> 6; w <= last >> 6; w++)
+	{
+		uint64_t mask = ~0ull;
+		if (w == first >> 6) mask &= ~0ull << (first & 63);
+		if (w == last >> 6) mask &= ~0ull >> (63 - (last & 63));
+		if ((coarse[w] & mask) != mask) return false;
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //
 // SetSilhouette
@@ -132,6 +168,9 @@ bool Clipper::IsRangeVisible(angle_t startAngle, angle_t endAngle)
 	ci = cliphead;
 	
 	if (endAngle==0 && ci && ci->start==0) return false;
+
+	// A slice no range has ever touched means no single range can contain this one.
+	if (!IsCoarseCovered(startAngle, endAngle)) return true;
 	
 	while (ci != NULL && ci->start < endAngle)
 	{
@@ -155,6 +194,8 @@ void Clipper::AddClipRange(angle_t start, angle_t end)
 {
 	ClipNode *node, *temp, *prevNode;
 
+	MarkCoarse(start, end);
+
 	if (cliphead)
 	{
 		//check to see if range contains any old ranges
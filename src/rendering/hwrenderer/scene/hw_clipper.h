@@ -32,6 +32,16 @@ class Clipper
     const FRenderViewpoint *viewpoint = nullptr;
 	bool blocked = false;
 
+	// Coarse map of the angle space, one bit per 1/256th. A bit is set once any
+	// clip range has touched that slice, so a range that reaches into a clear
+	// slice cannot be covered and the list walk can be skipped. Removing ranges
+	// never clears bits, which only makes the test fall back to the list.
+	enum { COARSE_SHIFT = 24, COARSE_WORDS = 4 };
+	uint64_t coarse[COARSE_WORDS] = {};
+
+	void MarkCoarse(angle_t startangle, angle_t endangle);
+	bool IsCoarseCovered(angle_t startangle, angle_t endangle) const;
+
 	static angle_t AngleToPseudo(angle_t ang);
 	bool IsRangeVisible(angle_t startangle, angle_t endangle);
 	void RemoveRange(ClipNode * cn);
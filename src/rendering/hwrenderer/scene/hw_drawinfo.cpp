@@ -43,6 +43,7 @@
 #include "hwrenderer/dynlights/hw_lightbuffer.h"
 #include "hwrenderer/utility/hw_vrmodes.h"
 #include "hw_clipper.h"
+#include "stats.h"
 
 EXTERN_CVAR(Float, r_visibility)
 CVAR(Bool, gl_bandedswlight, false, CVAR_ARCHIVE)
@@ -424,6 +425,7 @@ HWDecal *HWDrawInfo::AddDecal(bool onmirror)
 
 void HWDrawInfo::CreateScene(bool drawpsprites)
 {
+	FTraceZone zone("HWDrawInfo::CreateScene");
 	const auto &vp = Viewpoint;
 	angle_t a1 = FrustumAngle();
 	mClipper->SafeAddClipRangeRealAngles(vp.Angles.Yaw.BAMs() + a1, vp.Angles.Yaw.BAMs() - a1);
@@ -464,6 +466,7 @@ void HWDrawInfo::CreateScene(bool drawpsprites)
 
 void HWDrawInfo::RenderScene(FRenderState &state)
 {
+	FTraceZone zone("HWDrawInfo::RenderScene");
 	const auto &vp = Viewpoint;
 	RenderAll.Clock();
 
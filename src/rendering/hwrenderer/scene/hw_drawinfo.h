@@ -201,7 +201,8 @@ private:
 	void AddLines(subsector_t * sub, sector_t * sector);
 	void AddSpecialPortalLines(subsector_t * sub, sector_t * sector, line_t *line);
 	public:
-	void RenderThings(subsector_t * sub, sector_t * sector);
+	AActor **CullThings(sector_t * sec);
+	void RenderThings(subsector_t * sub, sector_t * sector, AActor **culled = nullptr);
 	void RenderParticles(subsector_t *sub, sector_t *front);
 	void DoSubsector(subsector_t * sub);
 	int SetupLightsForOtherPlane(subsector_t * sub, FDynLightData &lightdata, const secplane_t *plane);
@@ -38,7 +38,9 @@
 #include "hw_drawinfo.h"
 #include "hw_fakeflat.h"
 
-FMemArena RenderDataAllocator(1024*1024);	// Use large blocks to reduce allocation time.
+CVAR(Bool, gl_sort_balanced, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+FMemArena RenderDataAllocator(1024*1024, "RenderData");	// Use large blocks to reduce allocation time.
 
 void ResetRenderDataAllocator()
 {
@@ -193,10 +195,31 @@ void HWDrawList::MakeSortList()
 //==========================================================================
 SortNode * HWDrawList::FindSortPlane(SortNode * head)
 {
-	while (head->next && drawitems[head->itemindex].rendertype!=DrawType_FLAT) 
-		head=head->next;
-	if (drawitems[head->itemindex].rendertype==DrawType_FLAT) return head;
-	return NULL;
+	if (!gl_sort_balanced)
+	{
+		while (head->next && drawitems[head->itemindex].rendertype!=DrawType_FLAT) 
+			head=head->next;
+		if (drawitems[head->itemindex].rendertype==DrawType_FLAT) return head;
+		return NULL;
+	}
+
+	// Split at the plane of median height. Taking the first one makes each plane
+	// a level of its own so that every sprite gets checked against all of them.
+	static TArray<SortNode*> planes;
+
+	planes.Clear();
+	for (SortNode *node = head; node; node = node->next)
+	{
+		if (drawitems[node->itemindex].rendertype == DrawType_FLAT) planes.Push(node);
+	}
+	if (planes.Size() == 0) return NULL;
+
+	auto median = planes.begin() + planes.Size() / 2;
+	std::nth_element(planes.begin(), median, planes.end(), [=](SortNode *a, SortNode *b)
+	{
+		return flats[drawitems[a->itemindex].index]->z < flats[drawitems[b->itemindex].index]->z;
+	});
+	return *median;
 }
 
 
@@ -704,8 +727,10 @@ void HWDrawList::Sort(HWDrawInfo *di)
 {
 	reverseSort = !!(di->Level->i_compatflags & COMPATF_SPRITESORT);
     SortZ = di->Viewpoint.Pos.Z;
+	SortTranslucent.Clock();
 	MakeSortList();
 	sorted = DoSort(di, SortNodes[SortNodeStart]);
+	SortTranslucent.Unclock();
 }
 
 //==========================================================================
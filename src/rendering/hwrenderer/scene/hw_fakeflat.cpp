@@ -190,7 +190,7 @@ area_t hw_CheckViewArea(vertex_t *v1, vertex_t *v2, sector_t *frontsector, secto
 // 
 //
 //==========================================================================
-static FMemArena FakeSectorAllocator(20 * sizeof(sector_t));
+static FMemArena FakeSectorAllocator(20 * sizeof(sector_t), "FakeSectors");
 
 static sector_t *allocateSector(sector_t *sec)
 {
@@ -164,7 +164,23 @@ bool FPortalSceneState::RenderFirstSkyPortal(int recursion, HWDrawInfo *outer_di
 
 void FPortalSceneState::RenderPortal(HWPortal *p, FRenderState &state, bool usestencil, HWDrawInfo *outer_di)
 {
-	if (gl_portals) outer_di->RenderPortal(p, state, usestencil);
+	if (gl_portals)
+	{
+		Clocker c(PortalTypeTime(p->GetName()));
+		if (gl_portalinfo)
+		{
+			cycle_t time;
+			time.Reset();
+			time.Clock();
+			outer_di->RenderPortal(p, state, usestencil);
+			time.Unclock();
+			Printf("%s%s took %2.3f ms\n", indent.GetChars(), p->GetName(), time.TimeMS());
+		}
+		else
+		{
+			outer_di->RenderPortal(p, state, usestencil);
+		}
+	}
 }
 
 
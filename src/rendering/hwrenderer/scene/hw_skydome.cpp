@@ -177,6 +177,40 @@ void FSkyVertexBuffer::CreateSkyHemisphere(int hemi)
 	}
 }
 
+//-----------------------------------------------------------------------------
+//
+// Copies a hemisphere's rows into one strip, with two degenerate vertices
+// between rows, so that the dome can be drawn with a single call per half.
+// Each row has an even vertex count so the winding stays the same.
+//
+//-----------------------------------------------------------------------------
+
+void FSkyVertexBuffer::CreateDomeStrip(int hemi)
+{
+	int first = hemi == SKYHEMI_UPPER ? 1 : mRows + 2;
+
+	mDomeStart[hemi - 1] = mVertices.Size();
+	for (int r = first; r < first + mRows; r++)
+	{
+		unsigned start = mPrimStart[r];
+		unsigned end = mPrimStart[r + 1];
+
+		if (r > first)
+		{
+			FSkyVertex last = mVertices[start - 1];
+			FSkyVertex next = mVertices[start];
+			mVertices.Push(last);
+			mVertices.Push(next);
+		}
+		for (unsigned i = start; i < end; i++)
+		{
+			FSkyVertex vert = mVertices[i];
+			mVertices.Push(vert);
+		}
+	}
+	mDomeCount[hemi - 1] = mVertices.Size() - mDomeStart[hemi - 1];
+}
+
 //-----------------------------------------------------------------------------
 //
 //
@@ -274,6 +308,9 @@ void FSkyVertexBuffer::CreateDome()
 	ptr[35].SetXYZ(-128.f, 128.f, -128.f, 1, 1);
 	ptr[36].SetXYZ(128.f, 128.f, 128.f, 0, 0);
 	ptr[37].SetXYZ(-128.f, 128.f, 128.f, 1, 0);
+
+	CreateDomeStrip(SKYHEMI_UPPER);
+	CreateDomeStrip(SKYHEMI_LOWER);
 }
 
 //-----------------------------------------------------------------------------
@@ -62,8 +62,13 @@ public:
 	int mFaceStart[7];
 	int mSideStart;
 
+	// all rows of one hemisphere joined into a single strip
+	int mDomeStart[2];
+	int mDomeCount[2];
+
 	void SkyVertex(int r, int c, bool yflip);
 	void CreateSkyHemisphere(int hemi);
+	void CreateDomeStrip(int hemi);
 	void CreateDome();
 
 public:
@@ -77,11 +77,8 @@ void HWSkyPortal::RenderDome(HWDrawInfo *di, FRenderState &state, FMaterial * te
 		state.EnableTexture(true);
 	}
 	state.SetObjectColor(0xffffffff);
-	for (int i = 1; i <= vertexBuffer->mRows; i++)
-	{
-		RenderRow(di, state, DT_TriangleStrip, i, i == 1);
-		RenderRow(di, state, DT_TriangleStrip, rc + i, false);
-	}
+	state.Draw(DT_TriangleStrip, vertexBuffer->mDomeStart[0], vertexBuffer->mDomeCount[0]);
+	state.Draw(DT_TriangleStrip, vertexBuffer->mDomeStart[1], vertexBuffer->mDomeCount[1]);
 
 	state.EnableTextureMatrix(false);
 	state.EnableModelMatrix(false);
@@ -65,6 +65,12 @@ const float LARGE_VALUE = 1e19f;
 EXTERN_CVAR(Bool, r_debug_disable_vis_filter)
 EXTERN_CVAR(Float, transsouls)
 
+// Models farther away than this get drawn as their sprite. 0 disables the fallback.
+CUSTOM_CVAR(Float, gl_model_maxdistance, 0.f, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 0.f) self = 0.f;
+}
+
 
 //==========================================================================
 //
@@ -210,6 +216,8 @@ void HWSprite::DrawSprite(HWDrawInfo *di, FRenderState &state, bool translucent)
 
 	secplane_t bottomp = { { 0, 0, -1. }, bottomclip, 1. };
 	secplane_t topp = { { 0, 0, -1. }, topclip, 1. };
+	// the glow check of each light slice needs the same position.
+	DVector3 glowpos = actor != nullptr && lightlist ? actor->InterpolatedPosition(vp.TicFrac) : DVector3(0, 0, 0);
 	for (unsigned i = 0; i < iter; i++)
 	{
 		if (lightlist)
@@ -219,7 +227,7 @@ void HWSprite::DrawSprite(HWDrawInfo *di, FRenderState &state, bool translucent)
 			secplane_t *lowplane = i == (*lightlist).Size() - 1 ? &bottomp : &(*lightlist)[i + 1].plane;
 
 			int thislight = (*lightlist)[i].caster != nullptr ? hw_ClampLight(*(*lightlist)[i].p_lightlevel) : lightlevel;
-			int thisll = actor == nullptr ? thislight : (uint8_t)actor->Sector->CheckSpriteGlow(thislight, actor->InterpolatedPosition(vp.TicFrac));
+			int thisll = actor == nullptr ? thislight : (uint8_t)actor->Sector->CheckSpriteGlow(thislight, glowpos);
 
 			FColormap thiscm;
 			thiscm.CopyFog(Colormap);
@@ -782,6 +790,10 @@ void HWSprite::Process(HWDrawInfo *di, AActor* thing, sector_t * sector, area_t
 	}
 
 	modelframe = isPicnumOverride ? nullptr : FindModelFrame(thing->GetClass(), spritenum, thing->frame, !!(thing->flags & MF_DROPPED));
+	if (modelframe && gl_model_maxdistance > 0 && (thingpos - vp.Pos).LengthSquared() > gl_model_maxdistance * gl_model_maxdistance)
+	{
+		modelframe = nullptr;
+	}
 	if (!modelframe)
 	{
 		bool mirror;
@@ -36,7 +36,15 @@
 #include "image.h"
 #include "v_video.h"
 #include "v_font.h"
+#include "templates.h"
+#include <thread>
+#include <atomic>
+#include <vector>
 
+CVAR(Bool, gl_precache_multithread, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+EXTERN_CVAR(Bool, gl_texture_usehires)
+EXTERN_CVAR(Int, gl_texture_hqresizemode)
+EXTERN_CVAR(Int, gl_texture_hqresizemult)
 
 //==========================================================================
 //
@@ -65,6 +73,196 @@ static void PrecacheSprite(FTexture *tex, SpriteHits &hits)
 	if (gltex) gltex->PrecacheList(hits);
 }
 
+//==========================================================================
+//
+// Precaching a single texture index
+//
+//==========================================================================
+
+static void PrecacheIndex(int i, uint8_t *texhitlist, SpriteHits **spritehitlist)
+{
+	FTexture *tex = TexMan.ByIndex(i);
+	if (tex != nullptr)
+	{
+		PrecacheTexture(tex, texhitlist[i]);
+		if (spritehitlist[i] != nullptr && (*spritehitlist[i]).CountUsed() > 0)
+		{
+			PrecacheSprite(tex, *spritehitlist[i]);
+		}
+	}
+}
+
+//==========================================================================
+//
+// FPrecachePipeline
+//
+// Creates the untranslated texture buffers ahead of the upload when
+// upscaling is on. Decoding goes through the lump cache and the image
+// sources so it has to stay on this thread, but the upscaler and the edge
+// processing only work on the buffer, so that part gets done by worker
+// threads while the next batch is being decoded. The finished buffers are
+// handed to the textures and picked up by CreateTexBuffer when the
+// backend creates the hardware texture.
+//
+// Both buffers of a texture are kept in the same job because ProcessData
+// updates the texture's mask info.
+//
+//==========================================================================
+
+struct FPrecacheJob
+{
+	FTexture *tex;
+	int count;
+	int flags[2];
+	bool process[2];
+	bool hasAlpha[2];
+	FTextureBuffer buffer[2];
+};
+
+class FPrecachePipeline
+{
+	std::vector<std::thread> Workers;
+	std::vector<FPrecacheJob> *Jobs = nullptr;
+	std::atomic<unsigned> NextJob;
+	unsigned NumThreads;
+
+	void WorkerProc()
+	{
+		for (unsigned i = NextJob++; i < Jobs->size(); i = NextJob++)
+		{
+			auto &job = (*Jobs)[i];
+			for (int j = 0; j < job.count; j++)
+			{
+				if (job.process[j]) job.tex->PostProcessTexBuffer(job.buffer[j], job.hasAlpha[j], false);
+			}
+		}
+	}
+
+public:
+	enum { BATCH_SIZE = 32 };
+
+	FPrecachePipeline(unsigned numthreads) : NumThreads(numthreads) {}
+	~FPrecachePipeline() { Wait(); }
+
+	static void AddBuffer(FPrecacheJob &job, FTexture *tex, bool expand)
+	{
+		FMaterial *mat = FMaterial::ValidateTexture(tex, expand);
+		if (mat == nullptr || mat->tex != tex || tex->isSWCanvas() || tex->isHardwareCanvas()) return;
+		if (tex->SystemTextures.GetHardwareTexture(0, mat->isExpanded()) != nullptr) return;
+
+		// Same flags as PrecacheMaterial passes to the base layer.
+		int flags = mat->isExpanded() ? CTF_Expand : (gl_texture_usehires && !tex->isScaled()) ? CTF_CheckHires : 0;
+		flags |= CTF_ProcessData;
+		for (int j = 0; j < job.count; j++)
+		{
+			if (job.flags[j] == flags) return;
+		}
+		int j = job.count++;
+		job.flags[j] = flags;
+		job.process[j] = tex->DecodeTexBuffer(job.buffer[j], 0, flags, job.hasAlpha[j]);
+	}
+
+	static void Decode(std::vector<FPrecacheJob> &jobs, int i, uint8_t *texhitlist, SpriteHits **spritehitlist)
+	{
+		FTexture *tex = TexMan.ByIndex(i);
+		if (tex == nullptr || tex->GetImage() == nullptr) return;
+
+		jobs.emplace_back();
+		auto &job = jobs.back();
+		job.tex = tex;
+		job.count = 0;
+		if (texhitlist[i] & (FTextureManager::HIT_Wall | FTextureManager::HIT_Flat | FTextureManager::HIT_Sky))
+		{
+			AddBuffer(job, tex, false);
+		}
+		if (spritehitlist[i] != nullptr && (*spritehitlist[i]).CheckKey(0))
+		{
+			AddBuffer(job, tex, true);
+		}
+		if (job.count == 0) jobs.pop_back();
+	}
+
+	void Start(std::vector<FPrecacheJob> &jobs)
+	{
+		Jobs = &jobs;
+		NextJob = 0;
+		unsigned count = MIN<unsigned>(NumThreads, (unsigned)jobs.size());
+		for (unsigned i = 0; i < count; i++)
+		{
+			Workers.emplace_back([=]() { WorkerProc(); });
+		}
+	}
+
+	void Wait()
+	{
+		for (auto &thread : Workers) thread.join();
+		Workers.clear();
+	}
+
+	static void Finish(std::vector<FPrecacheJob> &jobs)
+	{
+		for (auto &job : jobs)
+		{
+			for (int j = 0; j < job.count; j++)
+			{
+				job.tex->SetPreparedTexBuffer(job.flags[j], std::move(job.buffer[j]));
+			}
+		}
+	}
+
+	static void Discard(std::vector<FPrecacheJob> &jobs)
+	{
+		// Anything the backend did not ask for, e.g. because the texture already existed.
+		for (auto &job : jobs) job.tex->DiscardPreparedTexBuffers();
+		jobs.clear();
+	}
+};
+
+//==========================================================================
+//
+// PrecacheTexturesThreaded
+//
+//==========================================================================
+
+static bool PrecacheTexturesThreaded(const TArray<int> &order, uint8_t *texhitlist, SpriteHits **spritehitlist)
+{
+	unsigned hwthreads = std::thread::hardware_concurrency();
+	if (!gl_precache_multithread || gl_texture_hqresizemode <= 0 || gl_texture_hqresizemult < 2 || hwthreads < 2)
+	{
+		return false;
+	}
+
+	FPrecachePipeline pipeline(clamp<unsigned>(hwthreads - 1, 1, 8));
+	std::vector<FPrecacheJob> running, decoded;
+	unsigned runstart = 0, runend = 0;
+
+	for (unsigned start = 0; ; start += FPrecachePipeline::BATCH_SIZE)
+	{
+		unsigned end = MIN<unsigned>(start + FPrecachePipeline::BATCH_SIZE, order.Size());
+
+		// Decode the next batch while the workers are busy with the current one.
+		for (unsigned i = start; i < end; i++)
+		{
+			FPrecachePipeline::Decode(decoded, order[i], texhitlist, spritehitlist);
+		}
+
+		pipeline.Wait();
+		FPrecachePipeline::Finish(running);
+		for (unsigned i = runstart; i < runend; i++)
+		{
+			PrecacheIndex(order[i], texhitlist, spritehitlist);
+		}
+		FPrecachePipeline::Discard(running);
+
+		if (start >= end) break;
+		std::swap(running, decoded);
+		pipeline.Start(running);
+		runstart = start;
+		runend = end;
+	}
+	return true;
+}
+
 //==========================================================================
 //
 // DFrameBuffer :: Precache
@@ -223,6 +421,7 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 	if (gl_precache)
 	{
 		FImageSource::BeginPrecaching();
+		TArray<int> lumps;
 
 		// cache all used textures
 		for (int i = cnt - 1; i >= 0; i--)
@@ -235,6 +434,7 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 					if (tex->GetImage() && tex->SystemTextures.GetHardwareTexture(0, false) == nullptr)
 					{
 						FImageSource::RegisterForPrecache(tex->GetImage());
+						lumps.Push(tex->GetImage()->LumpNum());
 					}
 				}
 
@@ -242,21 +442,24 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 				if (spritehitlist[i] != nullptr && (*spritehitlist[i]).CheckKey(0))
 				{
 					FImageSource::RegisterForPrecache(tex->GetImage());
+					lumps.Push(tex->GetImage()->LumpNum());
 				}
 			}
 		}
+		// Let the image data get read in while the textures are being created.
+		Wads.PrefetchLumps(lumps);
 
 		// cache all used textures
+		TArray<int> order;
 		for (int i = cnt - 1; i >= 0; i--)
 		{
-			FTexture *tex = TexMan.ByIndex(i);
-			if (tex != nullptr)
+			if (TexMan.ByIndex(i) != nullptr) order.Push(i);
+		}
+		if (!PrecacheTexturesThreaded(order, texhitlist, spritehitlist))
+		{
+			for (int i : order)
 			{
-				PrecacheTexture(tex, texhitlist[i]);
-				if (spritehitlist[i] != nullptr && (*spritehitlist[i]).CountUsed() > 0)
-				{
-					PrecacheSprite(tex, *spritehitlist[i]);
-				}
+				PrecacheIndex(i, texhitlist, spritehitlist);
 			}
 		}
 
@@ -52,9 +52,22 @@ glcycle_t Dirty;
 glcycle_t drawcalls;
 glcycle_t twoD, Flush3D;
 glcycle_t MTWait, WTTotal;
+glcycle_t SortTranslucent;
 int vertexcount, flatvertices, flatprimitives;
 
+// Time spent per portal type. Nested portals are included in their parent's time.
+struct FPortalTypeTime
+{
+	const char *Name;
+	glcycle_t Time;
+	int Count;
+};
+enum { MAX_PORTAL_TYPES = 8 };
+static FPortalTypeTime PortalTypeTimes[MAX_PORTAL_TYPES];
+static int numportaltypes;
+
 int rendered_lines,rendered_flats,rendered_sprites,render_vertexsplit,render_texsplit,rendered_decals, rendered_portals, rendered_commandbuffers;
+int culled_sprites;
 int iter_dlightf, iter_dlight, draw_dlight, draw_dlightf;
 
 void ResetProfilingData()
@@ -76,9 +89,39 @@ void ResetProfilingData()
 	drawcalls.Reset();
 	MTWait.Reset();
 	WTTotal.Reset();
+	SortTranslucent.Reset();
+	for (int i = 0; i < numportaltypes; i++)
+	{
+		PortalTypeTimes[i].Time.Reset();
+		PortalTypeTimes[i].Count = 0;
+	}
 
 	flatvertices=flatprimitives=vertexcount=0;
-	render_texsplit=render_vertexsplit=rendered_lines=rendered_flats=rendered_sprites=rendered_decals=rendered_portals = 0;
+	render_texsplit=render_vertexsplit=rendered_lines=rendered_flats=rendered_sprites=rendered_decals=rendered_portals=culled_sprites = 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+// The names are the portals' GetName strings which are all literals,
+// so comparing the pointers is enough.
+//
+//-----------------------------------------------------------------------------
+
+glcycle_t &PortalTypeTime(const char *name)
+{
+	int i;
+	for (i = 0; i < numportaltypes; i++)
+	{
+		if (PortalTypeTimes[i].Name == name) break;
+	}
+	if (i == numportaltypes)
+	{
+		// Should never happen, but lump anything beyond the table into the last entry.
+		if (numportaltypes == MAX_PORTAL_TYPES) i = MAX_PORTAL_TYPES - 1;
+		else PortalTypeTimes[numportaltypes++].Name = name;
+	}
+	PortalTypeTimes[i].Count++;
+	return PortalTypeTimes[i].Time;
 }
 
 //-----------------------------------------------------------------------------
@@ -96,25 +139,34 @@ static void AppendRenderTimes(FString &str)
 	str.AppendFormat("BSP = %2.3f, Clip=%2.3f\n"
 		"W: Render=%2.3f, Setup=%2.3f\n"
 		"F: Render=%2.3f, Setup=%2.3f\n"
-		"S: Render=%2.3f, Setup=%2.3f\n"
+		"S: Render=%2.3f, Setup=%2.3f, Translucent sort=%2.3f\n"
 		"2D: %2.3f Finish3D: %2.3f\n"
 		"Main thread total=%2.3f, Main thread waiting=%2.3f Worker thread total=%2.3f, Worker thread waiting=%2.3f\n"
 		"All=%2.3f, Render=%2.3f, Setup=%2.3f, Portal=%2.3f, Drawcalls=%2.3f, Postprocess=%2.3f, Finish=%2.3f\n",
 		bsp, clipwall,
 		RenderWall.TimeMS(), setupwall, 
 		RenderFlat.TimeMS(), SetupFlat.TimeMS(),
-		RenderSprite.TimeMS(), SetupSprite.TimeMS(), 
+		RenderSprite.TimeMS(), SetupSprite.TimeMS(), SortTranslucent.TimeMS(),
 		twoD.TimeMS(), Flush3D.TimeMS() - twoD.TimeMS(),
 		MTWait.TimeMS() + Bsp.TimeMS(), MTWait.TimeMS(), WTTotal.TimeMS(), WTTotal.TimeMS() - setupwall - SetupFlat.TimeMS() - SetupSprite.TimeMS(),
 		All.TimeMS() + Finish.TimeMS(), RenderAll.TimeMS(),	ProcessAll.TimeMS(), PortalAll.TimeMS(), drawcalls.TimeMS(), PostProcess.TimeMS(), Finish.TimeMS());
+
+	bool first = true;
+	for (int i = 0; i < numportaltypes; i++)
+	{
+		if (PortalTypeTimes[i].Count == 0) continue;
+		str.AppendFormat("%s%s=%2.3f (%d)", first ? "Portals: " : ", ", PortalTypeTimes[i].Name, PortalTypeTimes[i].Time.TimeMS(), PortalTypeTimes[i].Count);
+		first = false;
+	}
+	if (!first) str += "\n";
 }
 
 static void AppendRenderStats(FString &out)
 {
 	out.AppendFormat("Walls: %d (%d splits, %d t-splits, %d vertices)\n"
 		"Flats: %d (%d primitives, %d vertices)\n"
-		"Sprites: %d, Decals=%d, Portals: %d, Command buffers: %d\n",
-		rendered_lines, render_vertexsplit, render_texsplit, vertexcount, rendered_flats, flatprimitives, flatvertices, rendered_sprites,rendered_decals, rendered_portals, rendered_commandbuffers );
+		"Sprites: %d (%d occluded), Decals=%d, Portals: %d, Command buffers: %d\n",
+		rendered_lines, render_vertexsplit, render_texsplit, vertexcount, rendered_flats, flatprimitives, flatvertices, rendered_sprites, culled_sprites, rendered_decals, rendered_portals, rendered_commandbuffers );
 }
 
 static void AppendLightStats(FString &out)
@@ -14,10 +14,14 @@ extern glcycle_t RenderAll;
 extern glcycle_t Dirty;
 extern glcycle_t drawcalls, twoD, Flush3D;
 extern glcycle_t MTWait, WTTotal;
+extern glcycle_t SortTranslucent;
+
+glcycle_t &PortalTypeTime(const char *name);
 
 extern int iter_dlightf, iter_dlight, draw_dlight, draw_dlightf;
 extern int rendered_lines,rendered_flats,rendered_sprites,rendered_decals,render_vertexsplit,render_texsplit;
 extern int rendered_portals;
+extern int culled_sprites;
 
 extern int vertexcount, flatvertices, flatprimitives;
 
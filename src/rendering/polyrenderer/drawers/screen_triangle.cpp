@@ -1655,6 +1655,12 @@ void ScreenTriangle::Draw(const TriDrawTriangleArgs* args, PolyTriangleThreadDat
 	midY = MIN(midY, clipbottom);
 	bottomY = MIN(bottomY, clipbottom);
 
+	if (topY >= bottomY)
+		return;
+
+	// Every thread sees every triangle, but small ones often cover none of this thread's lines.
+	// Skip those before doing any of the per-triangle setup.
+	topY += thread->skipped_by_thread(topY);
 	if (topY >= bottomY)
 		return;
 
@@ -1668,7 +1674,6 @@ void ScreenTriangle::Draw(const TriDrawTriangleArgs* args, PolyTriangleThreadDat
 	if (thread->StencilTest) opt |= SWTRI_StencilTest;
 	testfunc = ScreenTriangle::TestSpanOpts[opt];
 
-	topY += thread->skipped_by_thread(topY);
 	int num_cores = thread->num_cores;
 
 	// Find start/end X positions for each line covered by the triangle:
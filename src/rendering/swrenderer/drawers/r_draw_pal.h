@@ -35,7 +35,12 @@ namespace swrenderer
 		void SetTextureVPos(fixed_t pos) { dc_texturefrac = pos; }
 		void SetTextureVStep(fixed_t step) { dc_iscale = step; }
 
-		void SetLight(float light, int shade) { mLight = light; mShade = shade; }
+		// Resolved once per column since a wrapping column is drawn in several pieces
+		void SetLight(float light, int shade)
+		{
+			mColormapOffset = GETPALOOKUP(light, shade) << COLORMAPSHIFT;
+			mLightScale = LIGHTSCALE(light, shade);
+		}
 
 		uint8_t* Dest() const { return dc_dest; }
 		int DestY() const { return dc_dest_y; }
@@ -73,7 +78,7 @@ namespace swrenderer
 				if (viewport->RenderTarget->IsBgra())
 					return basecolormap->Maps;
 				else
-					return basecolormap->Maps + (GETPALOOKUP(mLight, mShade) << COLORMAPSHIFT);
+					return basecolormap->Maps + mColormapOffset;
 			}
 			else
 			{
@@ -84,7 +89,7 @@ namespace swrenderer
 		uint8_t* TranslationMap() const { return wallargs->TranslationMap(); }
 
 		ShadeConstants ColormapConstants() const { return wallargs->ColormapConstants(); }
-		fixed_t Light() const { return LIGHTSCALE(mLight, mShade); }
+		fixed_t Light() const { return mLightScale; }
 
 		FLightNode* LightList() const { return wallargs->lightlist; }
 
@@ -103,8 +108,8 @@ namespace swrenderer
 		const uint8_t* dc_source2 = nullptr;
 		int dc_wall_fracbits = 0;
 
-		float mLight = 0.0f;
-		int mShade = 0;
+		int mColormapOffset = 0;
+		fixed_t mLightScale = 0;
 	};
 
 	class DrawWallCommand : public DrawerCommand
@@ -334,6 +334,7 @@ namespace swrenderer
 	{
 		if (Thread->MainThread)
 			PlaneCycles.Clock();
+		Thread->PhaseCycles[PhasePlanes].Clock();
 
 		VisiblePlane *pl;
 		int i;
@@ -356,6 +357,7 @@ namespace swrenderer
 			}
 		}
 
+		Thread->PhaseCycles[PhasePlanes].Unclock();
 		if (Thread->MainThread)
 			PlaneCycles.Unclock();
 
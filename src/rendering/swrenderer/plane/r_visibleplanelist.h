@@ -56,9 +56,11 @@ namespace swrenderer
 		VisiblePlaneList();
 		VisiblePlane *Add(unsigned hash);
 
-		enum { MAXVISPLANES = 128 }; // must be a power of 2
+		enum { MAXVISPLANES = 512 }; // must be a power of 2
 		VisiblePlane *visplanes[MAXVISPLANES + 1];
 
-		static unsigned CalcHash(int picnum, int lightlevel, const secplane_t &height) { return (unsigned)((picnum) * 3 + (lightlevel)+(FLOAT2FIXED((height).fD())) * 7) & (MAXVISPLANES - 1); }
+		// Uses the whole map units of the plane's height. Its fixed point value has all
+		// low bits clear for the usual integer heights, so it did not spread the planes at all.
+		static unsigned CalcHash(int picnum, int lightlevel, const secplane_t &height) { return (unsigned)((picnum) * 3 + (lightlevel) + (FLOAT2FIXED((height).fD()) >> FRACBITS) * 7) & (MAXVISPLANES - 1); }
 	};
 }
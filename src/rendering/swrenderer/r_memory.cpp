@@ -37,15 +37,30 @@
 #include "po_man.h"
 #include "r_data/colormaps.h"
 #include "r_memory.h"
+#include "stats.h"
 #include <stdlib.h>
 
+static TArray<RenderMemory *> AllRenderMemory;
+
+RenderMemory::RenderMemory()
+{
+	AllRenderMemory.Push(this);
+}
+
+RenderMemory::~RenderMemory()
+{
+	AllRenderMemory.Delete(AllRenderMemory.Find(this));
+}
+
 void *RenderMemory::AllocBytes(int size)
 {
 	size = (size + 15) / 16 * 16; // 16-byte align
 		
-	if (UsedBlocks.empty() || UsedBlocks.back()->Position + size > BlockSize)
+	if (UsedBlocks.empty() || UsedBlocks.back()->Position + size > UsedBlocks.back()->Size)
 	{
-		if (!FreeBlocks.empty())
+		// Blocks are kept once allocated, so after the first few frames this only
+		// happens when a frame needs more than any frame before it did.
+		if (!FreeBlocks.empty() && FreeBlocks.back()->Size >= (uint32_t)size)
 		{
 			auto block = std::move(FreeBlocks.back());
 			block->Position = 0;
@@ -54,19 +69,27 @@ void *RenderMemory::AllocBytes(int size)
 		}
 		else
 		{
-			UsedBlocks.push_back(std::unique_ptr<MemoryBlock>(new MemoryBlock()));
+			UsedBlocks.push_back(std::unique_ptr<MemoryBlock>(new MemoryBlock(MAX((uint32_t)BlockSize, (uint32_t)size))));
+			FrameNewBlocks++;
 		}
 	}
 		
 	auto &block = UsedBlocks.back();
 	void *data = block->Data + block->Position;
 	block->Position += size;
+	FrameBytes += size;
 
 	return data;
 }
 	
 void RenderMemory::Clear()
 {
+	LastBytes = FrameBytes;
+	PeakBytes = MAX(PeakBytes, FrameBytes);
+	LastNewBlocks = FrameNewBlocks;
+	FrameBytes = 0;
+	FrameNewBlocks = 0;
+
 	while (!UsedBlocks.empty())
 	{
 		auto block = std::move(UsedBlocks.back());
@@ -75,6 +98,18 @@ void RenderMemory::Clear()
 	}
 }
 
+ADD_STAT(rendermemory)
+{
+	FString out;
+	for (unsigned i = 0; i < AllRenderMemory.Size(); i++)
+	{
+		auto mem = AllRenderMemory[i];
+		out.AppendFormat("arena %u: %uK used, peak %uK, %u blocks, %d new\n", i,
+			(unsigned)(mem->LastFrameBytes() / 1024), (unsigned)(mem->PeakFrameBytes() / 1024), (unsigned)mem->BlockCount(), mem->LastFrameNewBlocks());
+	}
+	return out;
+}
+
 static void* Aligned_Alloc(size_t alignment, size_t size)
 {
 	void* ptr;
@@ -105,7 +140,7 @@ static void Aligned_Free(void* ptr)
 	}
 }
 
-RenderMemory::MemoryBlock::MemoryBlock() : Data(static_cast<uint8_t*>(Aligned_Alloc(16, BlockSize))), Position(0)
+RenderMemory::MemoryBlock::MemoryBlock(uint32_t size) : Data(static_cast<uint8_t*>(Aligned_Alloc(16, size))), Position(0), Size(size)
 {
 }
 
@@ -7,7 +7,16 @@
 class RenderMemory
 {
 public:
+	RenderMemory();
+	~RenderMemory();
+
 	void Clear();
+
+	// Usage of the last cleared frame
+	size_t LastFrameBytes() const { return LastBytes; }
+	size_t PeakFrameBytes() const { return PeakBytes; }
+	int LastFrameNewBlocks() const { return LastNewBlocks; }
+	size_t BlockCount() const { return UsedBlocks.size() + FreeBlocks.size(); }
 		
 	template<typename T>
 	T *AllocMemory(int size = 1)
@@ -29,7 +38,7 @@ private:
 		
 	struct MemoryBlock
 	{
-		MemoryBlock();
+		MemoryBlock(uint32_t size);
 		~MemoryBlock();
 			
 		MemoryBlock(const MemoryBlock &) = delete;
@@ -37,7 +46,14 @@ private:
 			
 		uint8_t *Data;
 		uint32_t Position;
+		uint32_t Size;
 	};
 	std::vector<std::unique_ptr<MemoryBlock>> UsedBlocks;
 	std::vector<std::unique_ptr<MemoryBlock>> FreeBlocks;
+
+	size_t FrameBytes = 0;
+	int FrameNewBlocks = 0;
+	size_t LastBytes = 0;
+	size_t PeakBytes = 0;
+	int LastNewBlocks = 0;
 };
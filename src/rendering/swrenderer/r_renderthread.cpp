@@ -104,6 +104,8 @@ namespace swrenderer
 
 		std::unique_lock<std::mutex> lock(loadmutex);
 
+		texture->MarkUsed();
+
 		const FSoftwareTextureSpan *spans;
 		if (Viewport->RenderTarget->IsBgra())
 		{
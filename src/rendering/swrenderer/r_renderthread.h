@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <thread>
+#include "stats.h"
 
 class DrawerCommandQueue;
 typedef std::shared_ptr<DrawerCommandQueue> DrawerCommandQueuePtr;
@@ -52,6 +53,20 @@ namespace swrenderer
 	class SWTruecolorDrawers;
 	class SWPalDrawers;
 
+	// Timed parts of a scene slice, see stat swphases. BSP includes the segs, 3D floors and portals include the work nested in them.
+	enum RenderPhase
+	{
+		PhaseBSP,
+		PhaseSegs,
+		PhasePlanes,
+		PhaseSprites,
+		PhaseTranslucent,
+		Phase3DFloors,
+		PhasePortals,
+		PhaseDrawerFlush,
+		NumRenderPhases
+	};
+
 	class RenderThread
 	{
 	public:
@@ -62,6 +77,8 @@ namespace swrenderer
 		int X1 = 0;
 		int X2 = MAXWIDTH;
 		bool MainThread = false;
+		double SliceTime = 0.0;	// milliseconds spent in the last scene slice
+		cycle_t PhaseCycles[NumRenderPhases];
 
 		std::unique_ptr<RenderMemory> FrameMemory;
 		std::unique_ptr<RenderOpaquePass> OpaquePass;
@@ -463,7 +463,9 @@ namespace swrenderer
 		{
 			if ((line->sidedef) && !(line->sidedef->Flags & WALLF_POLYOBJ))
 			{
+				Thread->PhaseCycles[PhaseSegs].Clock();
 				renderline.Render(line, InSubsector, frontsector, nullptr, floorplane, ceilingplane, opaque3dfloor);
+				Thread->PhaseCycles[PhaseSegs].Unclock();
 			}
 			line++;
 		}
@@ -616,7 +618,7 @@ namespace swrenderer
 		if ((unsigned int)(sub->Index()) < Level->subsectors.Size())
 		{ // Only do it for the main BSP.
 			int lightlevel = (floorlightlevel + ceilinglightlevel) / 2;
-			for (int i = frontsector->Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = frontsector->Level->Particles[i].snext)
+			for (uint32_t i = frontsector->Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = frontsector->Level->Particles[i].snext)
 			{
 				RenderParticle::Project(Thread, &frontsector->Level->Particles[i], sub->sector, lightlevel, FakeSide, foggy);
 			}
@@ -638,7 +640,9 @@ namespace swrenderer
 			else if (!outersubsector || line->sidedef == nullptr || !(line->sidedef->Flags & WALLF_POLYOBJ))
 			{
 				Add3DFloorLine(line, frontsector);
+				Thread->PhaseCycles[PhaseSegs].Clock();
 				renderline.Render(line, InSubsector, frontsector, nullptr, floorplane, ceilingplane, Fake3DOpaque::Normal); // now real
+				Thread->PhaseCycles[PhaseSegs].Unclock();
 			}
 			line++;
 		}
@@ -669,7 +673,9 @@ namespace swrenderer
 					clip3d->fakeFloor->validcount = validcount;
 					clip3d->NewClip();
 				}
+				Thread->PhaseCycles[PhaseSegs].Clock();
 				renderline.Render(line, InSubsector, frontsector, &tempsec, nullptr, nullptr, opaque3dfloor); // fake
+				Thread->PhaseCycles[PhaseSegs].Unclock();
 			}
 			clip3d->fakeFloor = nullptr;
 		}
@@ -823,6 +829,7 @@ namespace swrenderer
 	{
 		if (Thread->MainThread)
 			WallCycles.Clock();
+		Thread->PhaseCycles[PhaseBSP].Clock();
 
 		for (uint32_t sub : PvsSubsectors)
 			SubsectorDepths[sub] = 0xffffffff;
@@ -835,6 +842,7 @@ namespace swrenderer
 		InSubsector = nullptr;
 		RenderBSPNode(Level->HeadNode());	// The head node is the last node output.
 
+		Thread->PhaseCycles[PhaseBSP].Unclock();
 		if (Thread->MainThread)
 			WallCycles.Unclock();
 	}
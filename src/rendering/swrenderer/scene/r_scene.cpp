@@ -74,6 +74,12 @@ bool r_modelscene = false;
 namespace swrenderer
 {
 	cycle_t WallCycles, PlaneCycles, MaskedCycles, DrawerWaitCycles;
+	static FString SceneThreadStats;
+	static FString ScenePhaseStats;
+
+	enum { PhaseHistorySize = 64 };
+	static double PhaseHistory[NumRenderPhases][PhaseHistorySize];
+	static int PhaseHistoryPos, PhaseHistoryCount;
 	
 	RenderScene::RenderScene()
 	{
@@ -146,6 +152,9 @@ namespace swrenderer
 		DrawerWaitCycles.Clock();
 		DrawerThreads::WaitForWorkers();
 		DrawerWaitCycles.Unclock();
+
+		// All drawers have finished, so no pixel data is referenced anymore
+		FSoftwareTexture::EvictCache();
 	}
 
 	void RenderScene::RenderActorView(AActor *actor, bool renderPlayerSprites, bool dontmaplines)
@@ -221,14 +230,16 @@ namespace swrenderer
 			StartThreads(numThreads);
 		}
 
+		UpdateSliceBounds(numThreads);
+
 		// Setup threads:
 		std::unique_lock<std::mutex> start_lock(start_mutex);
 		for (int i = 0; i < numThreads; i++)
 		{
 			*Threads[i]->Viewport = *MainThread()->Viewport;
 			*Threads[i]->Light = *MainThread()->Light;
-			Threads[i]->X1 = viewwidth * i / numThreads;
-			Threads[i]->X2 = viewwidth * (i + 1) / numThreads;
+			Threads[i]->X1 = SliceBounds[i];
+			Threads[i]->X2 = SliceBounds[i + 1];
 		}
 		run_id++;
 		start_lock.unlock();
@@ -260,13 +271,121 @@ namespace swrenderer
 			finished_threads = 0;
 		}
 
+		SliceTimes.resize(numThreads);
+		SceneThreadStats = "";
+		for (int i = 0; i < numThreads; i++)
+		{
+			SliceTimes[i] = Threads[i]->SliceTime;
+			SceneThreadStats.AppendFormat("thread %d: columns %d-%d %04.1f ms\n", i, SliceBounds[i], SliceBounds[i + 1], SliceTimes[i]);
+		}
+		UpdatePhaseStats(numThreads);
+
 		// Change main thread back to covering the whole screen for player sprites
 		MainThread()->X1 = 0;
 		MainThread()->X2 = viewwidth;
 	}
 
+	//==========================================================================
+	//
+	// Splits the view into one column range per thread. With timings from
+	// the previous frame at the same layout the split points are moved so
+	// that every thread gets about the same share of the measured cost,
+	// assuming it is spread evenly inside each of the old slices. Moving
+	// only halfway there each frame keeps the slices from oscillating.
+	//
+	//==========================================================================
+
+	void RenderScene::UpdateSliceBounds(int numThreads)
+	{
+		const int minwidth = 16;
+
+		bool usable = SliceBounds.size() == (size_t)numThreads + 1 && SliceTimes.size() == (size_t)numThreads && SliceBounds.back() == viewwidth && viewwidth >= minwidth * numThreads;
+		double total = 0.0;
+		if (usable)
+		{
+			for (double t : SliceTimes)
+				total += t;
+		}
+
+		if (!usable || total <= 0.0)
+		{
+			SliceBounds.resize(numThreads + 1);
+			for (int i = 0; i <= numThreads; i++)
+				SliceBounds[i] = viewwidth * i / numThreads;
+			return;
+		}
+
+		std::vector<int> bounds(numThreads + 1);
+		bounds[0] = 0;
+		bounds[numThreads] = viewwidth;
+
+		double acc = 0.0;
+		int slice = 0;
+		for (int k = 1; k < numThreads; k++)
+		{
+			double target = total * k / numThreads;
+			while (slice < numThreads - 1 && acc + SliceTimes[slice] < target)
+			{
+				acc += SliceTimes[slice];
+				slice++;
+			}
+			double frac = SliceTimes[slice] > 0.0 ? clamp((target - acc) / SliceTimes[slice], 0.0, 1.0) : 0.5;
+			int x = SliceBounds[slice] + (int)(frac * (SliceBounds[slice + 1] - SliceBounds[slice]));
+			x = (x + SliceBounds[k]) / 2;
+			bounds[k] = clamp(x, bounds[k - 1] + minwidth, viewwidth - (numThreads - k) * minwidth);
+		}
+		SliceBounds.swap(bounds);
+	}
+
+	//==========================================================================
+	//
+	// Collects the per thread phase timings of the last slice pass and keeps
+	// their sums for the last PhaseHistorySize passes.
+	//
+	//==========================================================================
+
+	void RenderScene::UpdatePhaseStats(int numThreads)
+	{
+		static const char *names[NumRenderPhases] = { "bsp", "segs", "planes", "sprites", "translucent", "3dfloors", "portals", "flush" };
+
+		ScenePhaseStats = "phase      ";
+		for (int i = 0; i < numThreads; i++)
+			ScenePhaseStats.AppendFormat("  thread %-2d", i);
+		ScenePhaseStats += "    average       peak\n";
+
+		for (int phase = 0; phase < NumRenderPhases; phase++)
+		{
+			ScenePhaseStats.AppendFormat("%-11s", names[phase]);
+			double total = 0.0;
+			for (int i = 0; i < numThreads; i++)
+			{
+				double ms = Threads[i]->PhaseCycles[phase].TimeMS();
+				total += ms;
+				ScenePhaseStats.AppendFormat("  %6.2f ms", ms);
+			}
+			PhaseHistory[phase][PhaseHistoryPos] = total;
+
+			double sum = 0.0, peak = 0.0;
+			int count = MIN(PhaseHistoryCount + 1, (int)PhaseHistorySize);
+			for (int i = 0; i < count; i++)
+			{
+				sum += PhaseHistory[phase][i];
+				peak = MAX(peak, PhaseHistory[phase][i]);
+			}
+			ScenePhaseStats.AppendFormat("  %6.2f ms  %6.2f ms\n", sum / count, peak);
+		}
+
+		PhaseHistoryPos = (PhaseHistoryPos + 1) % PhaseHistorySize;
+		PhaseHistoryCount = MIN(PhaseHistoryCount + 1, (int)PhaseHistorySize);
+	}
+
 	void RenderScene::RenderThreadSlice(RenderThread *thread)
 	{
+		auto starttime = std::chrono::steady_clock::now();
+
+		for (auto &cycles : thread->PhaseCycles)
+			cycles.Reset();
+
 		thread->DrawQueue->Clear();
 		thread->FrameMemory->Clear();
 		thread->Clip3D->Cleanup();
@@ -300,13 +419,19 @@ namespace swrenderer
 		{
 			thread->PlaneList->Render();
 
+			thread->PhaseCycles[PhasePortals].Clock();
 			thread->Portal->RenderPlanePortals();
 			thread->Portal->RenderLinePortals();
+			thread->PhaseCycles[PhasePortals].Unclock();
 
 			thread->TranslucentPass->Render();
 		}
 
+		thread->PhaseCycles[PhaseDrawerFlush].Clock();
 		DrawerThreads::Execute(thread->DrawQueue);
+		thread->PhaseCycles[PhaseDrawerFlush].Unclock();
+
+		thread->SliceTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - starttime).count();
 	}
 
 	void RenderScene::StartThreads(size_t numThreads)
@@ -441,6 +566,16 @@ namespace swrenderer
 		return out;
 	}
 
+	ADD_STAT(scenethreads)
+	{
+		return SceneThreadStats;
+	}
+
+	ADD_STAT(swphases)
+	{
+		return ScenePhaseStats;
+	}
+
 	static double bestwallcycles = HUGE_VAL;
 
 	ADD_STAT(wallcycles)
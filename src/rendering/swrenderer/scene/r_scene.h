@@ -61,6 +61,8 @@ namespace swrenderer
 		void RenderActorView(AActor *actor,bool renderplayersprite, bool dontmaplines);
 		void RenderThreadSlices();
 		void RenderThreadSlice(RenderThread *thread);
+		void UpdateSliceBounds(int numThreads);
+		void UpdatePhaseStats(int numThreads);
 		void RenderPSprites();
 
 		void StartThreads(size_t numThreads);
@@ -78,5 +80,9 @@ namespace swrenderer
 		std::mutex end_mutex;
 		std::condition_variable end_condition;
 		size_t finished_threads = 0;
+
+		// Slice layout and per-thread timings of the last frame, used to balance the next one.
+		std::vector<int> SliceBounds;
+		std::vector<double> SliceTimes;
 	};
 }
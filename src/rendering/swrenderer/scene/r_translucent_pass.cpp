@@ -136,6 +136,7 @@ namespace swrenderer
 		RenderPortal *renderportal = Thread->Portal.get();
 		DrawSegmentList *drawseglist = Thread->DrawSegments.get();
 
+		Thread->PhaseCycles[PhaseSprites].Clock();
 		auto &sortedSprites = Thread->SpriteList->SortedSprites;
 		for (int i = sortedSprites.Size(); i > 0; i--)
 		{
@@ -146,8 +147,10 @@ namespace swrenderer
 				sprite->Render(Thread, clip3DFloor);
 			}
 		}
+		Thread->PhaseCycles[PhaseSprites].Unclock();
 
 		// render any remaining masked mid textures
+		Thread->PhaseCycles[PhaseTranslucent].Clock();
 
 		for (unsigned int index = 0; index != drawseglist->SegmentsCount(); index++)
 		{
@@ -166,6 +169,7 @@ namespace swrenderer
 					ds->drawsegclip.SetRangeUndrawn(ds->x1, ds->x2);
 			}
 		}
+		Thread->PhaseCycles[PhaseTranslucent].Unclock();
 	}
 
 	void RenderTranslucentPass::Render()
@@ -185,6 +189,7 @@ namespace swrenderer
 		}
 		else
 		{ // kg3D - correct sorting
+			Thread->PhaseCycles[Phase3DFloors].Clock();
 			// ceilings
 			for (HeightLevel *hl = clip3d->height_cur; hl != nullptr && hl->height >= Thread->Viewport->viewpoint.Pos.Z; hl = hl->prev)
 			{
@@ -223,6 +228,7 @@ namespace swrenderer
 				DrawMaskedSingle(true, clip3DFloor);
 			}
 			clip3d->DeleteHeights();
+			Thread->PhaseCycles[Phase3DFloors].Unclock();
 		}
 
 		if (Thread->MainThread)
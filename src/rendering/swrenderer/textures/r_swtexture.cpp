@@ -38,9 +38,20 @@
 #include "bitmap.h"
 #include "m_alloc.h"
 #include "imagehelpers.h"
+#include "c_cvars.h"
+#include "stats.h"
 
 EXTERN_CVAR(Bool, gl_texture_usehires)
 
+CUSTOM_CVAR(Int, r_swtexturebudget, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 0) self = 0;
+}
+
+TArray<FSoftwareTexture *> FSoftwareTexture::CachedTextures;
+int FSoftwareTexture::CacheFrame;
+static size_t CacheEvictions;
+
 
 FSoftwareTexture *FTexture::GetSoftwareTexture()
 {
@@ -145,6 +156,7 @@ const uint8_t *FSoftwareTexture::GetPixels(int style)
 				}
 			}
 		}
+		AddToCache();
 	}
 	return Pixels.Data();
 }
@@ -178,10 +190,81 @@ const uint32_t *FSoftwareTexture::GetPixelsBgra()
 			}
 			GenerateBgraMipmaps();
 		}
+		AddToCache();
 	}
 	return PixelsBgra.Data();
 }
 
+//==========================================================================
+//
+// Pixel data cache
+//
+//==========================================================================
+
+void FSoftwareTexture::AddToCache()
+{
+	MarkUsed();
+	if (mEvictable && !mCached)
+	{
+		CachedTextures.Push(this);
+		mCached = true;
+	}
+}
+
+void FSoftwareTexture::RemoveFromCache()
+{
+	if (mCached)
+	{
+		CachedTextures.Delete(CachedTextures.Find(this));
+		mCached = false;
+	}
+}
+
+void FSoftwareTexture::EvictCache()
+{
+	size_t budget = size_t(r_swtexturebudget) << 20;
+	int frame = CacheFrame++;
+	if (budget == 0) return;
+
+	size_t total = 0;
+	for (auto tex : CachedTextures) total += tex->CachedSize();
+	if (total <= budget) return;
+
+	// Oldest first. Anything used by the frame just drawn stays, even if that leaves the cache over budget.
+	std::sort(CachedTextures.begin(), CachedTextures.end(), [](FSoftwareTexture *a, FSoftwareTexture *b) { return a->mLastUsedFrame < b->mLastUsedFrame; });
+
+	unsigned count = 0;
+	while (count < CachedTextures.Size() && total > budget && CachedTextures[count]->mLastUsedFrame < frame)
+	{
+		auto tex = CachedTextures[count++];
+		total -= tex->CachedSize();
+		tex->mCached = false;
+		tex->Unload();
+		CacheEvictions++;
+	}
+	CachedTextures.Delete(0, count);
+}
+
+FString FSoftwareTexture::GetCacheStats()
+{
+	size_t total = 0;
+	unsigned loaded = 0;
+	for (auto tex : CachedTextures)
+	{
+		size_t size = tex->CachedSize();
+		total += size;
+		if (size > 0) loaded++;
+	}
+	FString out;
+	out.Format("%u textures, %.1f MB, budget %d MB, %zu evicted", loaded, total / (1024.0 * 1024.0), *r_swtexturebudget, CacheEvictions);
+	return out;
+}
+
+ADD_STAT(swtextures)
+{
+	return FSoftwareTexture::GetCacheStats();
+}
+
 //==========================================================================
 //
 //
@@ -26,6 +26,18 @@ protected:
 	int mPhysicalScale;
 	int mBufferFlags;
 
+	// Budgeted cache of converted pixel data. Unloaded data gets recreated on the next GetPixels call.
+	bool mEvictable = true;
+	bool mCached = false;
+	int mLastUsedFrame = 0;
+
+	static TArray<FSoftwareTexture *> CachedTextures;
+	static int CacheFrame;
+
+	void AddToCache();
+	void RemoveFromCache();
+	size_t CachedSize() const { return Pixels.Size() + PixelsBgra.Size() * sizeof(uint32_t); }
+
 	void FreeAllSpans();
 	template<class T> FSoftwareTextureSpan **CreateSpans(const T *pixels);
 	void FreeSpans(FSoftwareTextureSpan **spans);
@@ -36,6 +48,7 @@ public:
 	
 	virtual ~FSoftwareTexture()
 	{
+		RemoveFromCache();
 		FreeAllSpans();
 	}
 
@@ -95,6 +108,14 @@ public:
 	int GetPhysicalWidth() { return mPhysicalWidth; }
 	int GetPhysicalHeight() { return mPhysicalHeight; }
 	int GetPhysicalScale() const { return mPhysicalScale; }
+
+	// Marks the pixel data as used by the frame currently being rendered
+	void MarkUsed() { mLastUsedFrame = CacheFrame; }
+
+	// Unloads the least recently used pixel data when over r_swtexturebudget. Must only be
+	// called when no drawer commands referencing texture pixels are pending.
+	static void EvictCache();
+	static FString GetCacheStats();
 	
 	virtual void Unload()
 	{
@@ -182,7 +203,7 @@ class FSWCanvasTexture : public FSoftwareTexture
 
 public:
 
-	FSWCanvasTexture(FTexture *source) : FSoftwareTexture(source) {}
+	FSWCanvasTexture(FTexture *source) : FSoftwareTexture(source) { mEvictable = false; }
 	~FSWCanvasTexture();
 
 	// Returns the whole texture, stored in column-major order
@@ -49,6 +49,7 @@ FWarpTexture::FWarpTexture (FTexture *source, int warptype)
 	if (warptype == 2) SetupMultipliers(256, 128); 
 	SetupMultipliers(128, 128); // [mxd]
 	bWarped = warptype;
+	mEvictable = false;
 }
 
 bool FWarpTexture::CheckModified (int style)
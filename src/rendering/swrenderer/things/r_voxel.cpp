@@ -397,6 +397,22 @@ namespace swrenderer
 			outblocks = thread->FrameMemory->AllocMemory<VoxelBlock>(maxoutblocks);
 		int nextoutblock = 0;
 
+		// Running count of the columns not yet closed by the clip arrays. Any slab column
+		// whose screen range has none of them open can be skipped without walking its slabs.
+		int *opencolumns = nullptr;
+		if ((flags & DVF_FIND_X1X2) == 0)
+		{
+			int width = MAX(this->x2 - this->x1, 0);
+			opencolumns = thread->FrameMemory->AllocMemory<int>(width + 1) - this->x1;
+			opencolumns[this->x1] = 0;
+			for (x = this->x1; x < this->x1 + width; x++)
+			{
+				opencolumns[x + 1] = opencolumns[x] + (daumost[x] < dadmost[x] ? 1 : 0);
+			}
+			if (opencolumns[this->x1 + width] == 0)
+				return;
+		}
+
 		for (cnt = 0; cnt < 8; cnt++)
 		{
 			switch (cnt)
@@ -492,6 +508,8 @@ namespace swrenderer
 						continue;
 					}
 
+					if (opencolumns[rx] == opencolumns[lx]) continue;
+
 					fixed_t l1 = xs_RoundToInt(centerxwidebig_f / (ny - yoff));
 					fixed_t l2 = xs_RoundToInt(centerxwidebig_f / (ny + yoff));
 					for (; voxptr < voxend; voxptr = (kvxslab_t *)((uint8_t *)voxptr + voxptr->zleng + 3))
@@ -500,6 +500,7 @@ public:
 
 	virtual void Draw2D() {}
 	void Clear2D() { m2DDrawer.Clear(); }
+	const F2DDrawer::Stats &Get2DStats() const { return m2DDrawer.mStats; }
 
 	// Dim part of the canvas
 	void Dim(PalEntry color, float amount, int x1, int y1, int w, int h, FRenderStyle *style = nullptr);
@@ -9,6 +9,9 @@
 #include "hwrenderer/data/flatvertices.h"
 #include "hwrenderer/scene/hw_viewpointuniforms.h"
 #include "rendering/2d/v_2ddrawer.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "m_misc.h"
 
 VkRenderPassManager::VkRenderPassManager()
 {
@@ -16,6 +19,7 @@ VkRenderPassManager::VkRenderPassManager()
 
 VkRenderPassManager::~VkRenderPassManager()
 {
+	SaveUsedPipelines();
 	DynamicSet.reset(); // Needed since it must come before destruction of DynamicDescriptorPool
 }
 
@@ -24,6 +28,167 @@ void VkRenderPassManager::Init()
 	CreateDynamicSetLayout();
 	CreateDescriptorPool();
 	CreateDynamicSet();
+	LoadUsedPipelines();
+}
+
+static const char *PipelineLogMagic = "ZVP2";
+
+static FString CreatePipelineLogName(bool create)
+{
+	FString path = M_GetCachePath(create);
+	if (create) CreatePath(path);
+	path << "/vkpipelines.bin";
+	return path;
+}
+
+// Custom shaders are numbered in the order they get defined, which depends on the loaded mods.
+static FString GetUserShaderName(int effectState)
+{
+	if (effectState < FIRST_USER_SHADER || effectState - FIRST_USER_SHADER >= (int)usershaders.Size())
+		return "";
+	auto &desc = usershaders[effectState - FIRST_USER_SHADER];
+	FString name;
+	name.Format("%s:%d:%s", desc.shader.GetChars(), (int)desc.shaderType, desc.defines.GetChars());
+	return name;
+}
+
+static int FindUserShader(const FString &name)
+{
+	for (unsigned i = 0; i < usershaders.Size(); i++)
+	{
+		if (GetUserShaderName(FIRST_USER_SHADER + i) == name)
+			return FIRST_USER_SHADER + i;
+	}
+	return -1;
+}
+
+void VkRenderPassManager::AddUsedPipeline(const VkRenderPassKey &passKey, const VkPipelineKey &key)
+{
+	UsedPipelines[passKey].insert(key);
+}
+
+void VkRenderPassManager::LoadUsedPipelines()
+{
+	FileReader fr;
+	if (!fr.OpenFile(CreatePipelineLogName(false)))
+		return;
+
+	// The keys are stored as they are in memory, so the file is only usable if both had the same layout when it was written.
+	char magic[4];
+	if (fr.Read(magic, 4) != 4 || memcmp(magic, PipelineLogMagic, 4) != 0)
+		return;
+	if (fr.ReadUInt32() != sizeof(VkRenderPassKey) || fr.ReadUInt32() != sizeof(VkPipelineKey) || fr.ReadUInt32() != sizeof(FVertexBufferAttribute))
+		return;
+
+	uint32_t count = fr.ReadUInt32();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// The vertex format and custom shader are stored by what they are instead of by their
+		// index, since those get assigned in the order they are first needed in a session.
+		VkRenderPassKey passKey;
+		VkLoggedPipeline logged;
+		if (fr.Read(&passKey, sizeof(VkRenderPassKey)) != sizeof(VkRenderPassKey) || fr.Read(&logged.Key, sizeof(VkPipelineKey)) != sizeof(VkPipelineKey))
+			break;
+
+		logged.NumBindingPoints = fr.ReadInt32();
+		logged.Stride = fr.ReadUInt32();
+		uint32_t numAttrs = fr.ReadUInt32();
+		if (numAttrs > VATTR_MAX)
+			break;
+		logged.Attrs.resize(numAttrs);
+		if (numAttrs > 0 && fr.Read(logged.Attrs.data(), numAttrs * sizeof(FVertexBufferAttribute)) != (FileReader::Size)(numAttrs * sizeof(FVertexBufferAttribute)))
+			break;
+
+		uint32_t nameLength = fr.ReadUInt32();
+		if (nameLength > 1024)
+			break;
+		TArray<char> name(nameLength + 1, true);
+		if (fr.Read(name.Data(), nameLength) != nameLength)
+			break;
+		name[nameLength] = 0;
+		logged.UserShader = name.Data();
+
+		LoggedPipelines[passKey].push_back(std::move(logged));
+	}
+}
+
+void VkRenderPassManager::SaveUsedPipelines()
+{
+	// Only what this session needed gets written, so the file does not keep
+	// growing and combinations that are no longer used drop out of it.
+	uint32_t count = 0;
+	for (auto &it : UsedPipelines)
+		count += (uint32_t)it.second.size();
+	if (count == 0)
+		return;
+
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(CreatePipelineLogName(true)));
+	if (fw)
+	{
+		uint32_t passKeySize = sizeof(VkRenderPassKey);
+		uint32_t keySize = sizeof(VkPipelineKey);
+		uint32_t attrSize = sizeof(FVertexBufferAttribute);
+		fw->Write(PipelineLogMagic, 4);
+		fw->Write(&passKeySize, sizeof(uint32_t));
+		fw->Write(&keySize, sizeof(uint32_t));
+		fw->Write(&attrSize, sizeof(uint32_t));
+		fw->Write(&count, sizeof(uint32_t));
+		for (auto &it : UsedPipelines)
+		{
+			for (auto &key : it.second)
+			{
+				const VkVertexFormat &format = VertexFormats[key.VertexFormat];
+				FString userShader = key.SpecialEffect == EFF_NONE ? GetUserShaderName(key.EffectState) : "";
+				int32_t numBindingPoints = format.NumBindingPoints;
+				uint32_t stride = (uint32_t)format.Stride;
+				uint32_t numAttrs = (uint32_t)format.Attrs.size();
+				uint32_t nameLength = (uint32_t)userShader.Len();
+
+				fw->Write(&it.first, sizeof(VkRenderPassKey));
+				fw->Write(&key, sizeof(VkPipelineKey));
+				fw->Write(&numBindingPoints, sizeof(int32_t));
+				fw->Write(&stride, sizeof(uint32_t));
+				fw->Write(&numAttrs, sizeof(uint32_t));
+				fw->Write(format.Attrs.data(), numAttrs * sizeof(FVertexBufferAttribute));
+				fw->Write(&nameLength, sizeof(uint32_t));
+				fw->Write(userShader.GetChars(), nameLength);
+			}
+		}
+	}
+}
+
+bool VkRenderPassManager::ResolveLoggedPipeline(const VkLoggedPipeline &logged, VkPipelineKey &key)
+{
+	key = logged.Key;
+	key.VertexFormat = GetVertexFormat(logged.NumBindingPoints, (int)logged.Attrs.size(), logged.Stride, logged.Attrs.data());
+	if (key.SpecialEffect == EFF_NONE && logged.UserShader.IsNotEmpty())
+	{
+		key.EffectState = FindUserShader(logged.UserShader);
+		if (key.EffectState < 0)
+			return false;
+	}
+	else if (key.SpecialEffect == EFF_NONE && key.EffectState >= FIRST_USER_SHADER)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool VkRenderPassManager::IsUsablePipelineKey(const VkPipelineKey &key, const VkRenderPassKey &passKey)
+{
+	// Keys from an earlier session may refer to shaders or vertex formats that do not exist (yet) in this one.
+	if (key.VertexFormat < 0 || (size_t)key.VertexFormat >= VertexFormats.size())
+		return false;
+	if (key.DrawType < 0 || key.DrawType > 4 || key.DepthFunc < 0 || key.DepthFunc > 2 || key.StencilPassOp < 0 || key.StencilPassOp > 2)
+		return false;
+	if (key.NumTextureLayers < 0 || key.NumTextureLayers > 16)
+		return false;
+
+	auto shaders = GetVulkanFrameBuffer()->GetShaderManager();
+	EPassType passType = passKey.DrawBuffers > 1 ? GBUFFER_PASS : NORMAL_PASS;
+	if (key.SpecialEffect != EFF_NONE)
+		return shaders->GetEffect(key.SpecialEffect, passType) != nullptr;
+	return key.EffectState >= 0 && shaders->Get(key.EffectState, key.AlphaTest, passType) != nullptr;
 }
 
 void VkRenderPassManager::RenderBuffersReset()
@@ -51,7 +216,22 @@ VkRenderPassSetup *VkRenderPassManager::GetRenderPass(const VkRenderPassKey &key
 {
 	auto &item = RenderPassSetup[key];
 	if (!item)
+	{
 		item.reset(new VkRenderPassSetup(key));
+
+		// Creating everything this pass needed last time right away keeps the pipeline
+		// compiles from being spread over the frames where each one is first used.
+		auto logged = LoggedPipelines.find(key);
+		if (logged != LoggedPipelines.end())
+		{
+			for (auto &entry : logged->second)
+			{
+				VkPipelineKey pipelineKey;
+				if (ResolveLoggedPipeline(entry, pipelineKey) && IsUsablePipelineKey(pipelineKey, key))
+					item->PrecreatePipeline(pipelineKey);
+			}
+		}
+	}
 	return item.get();
 }
 
@@ -273,10 +453,27 @@ VulkanPipeline *VkRenderPassSetup::GetPipeline(const VkPipelineKey &key)
 {
 	auto &item = Pipelines[key];
 	if (!item)
+	{
 		item = CreatePipeline(key);
+		GetVulkanFrameBuffer()->GetRenderPassManager()->AddUsedPipeline(PassKey, key);
+	}
+	else if (!Precreated.empty() && Precreated.erase(key))
+	{
+		GetVulkanFrameBuffer()->GetRenderPassManager()->AddUsedPipeline(PassKey, key);
+	}
 	return item.get();
 }
 
+void VkRenderPassSetup::PrecreatePipeline(const VkPipelineKey &key)
+{
+	auto &item = Pipelines[key];
+	if (!item)
+	{
+		item = CreatePipeline(key);
+		Precreated.insert(key);
+	}
+}
+
 std::unique_ptr<VulkanPipeline> VkRenderPassSetup::CreatePipeline(const VkPipelineKey &key)
 {
 	auto fb = GetVulkanFrameBuffer();
@@ -7,6 +7,7 @@
 #include "hwrenderer/scene/hw_renderstate.h"
 #include <string.h>
 #include <map>
+#include <set>
 
 class VKDataBuffer;
 
@@ -55,10 +56,12 @@ public:
 
 	VulkanRenderPass *GetRenderPass(int clearTargets);
 	VulkanPipeline *GetPipeline(const VkPipelineKey &key);
+	void PrecreatePipeline(const VkPipelineKey &key);
 
 	VkRenderPassKey PassKey;
 	std::unique_ptr<VulkanRenderPass> RenderPasses[8];
 	std::map<VkPipelineKey, std::unique_ptr<VulkanPipeline>> Pipelines;
+	std::set<VkPipelineKey> Precreated;	// created from the log but not requested yet
 
 private:
 	std::unique_ptr<VulkanRenderPass> CreateRenderPass(int clearTargets);
@@ -74,6 +77,17 @@ public:
 	int UseVertexData;
 };
 
+// A pipeline from an earlier session, with the parts of its key that are only valid within a session stored by value.
+class VkLoggedPipeline
+{
+public:
+	VkPipelineKey Key;
+	int NumBindingPoints;
+	size_t Stride;
+	std::vector<FVertexBufferAttribute> Attrs;
+	FString UserShader;
+};
+
 class VkRenderPassManager
 {
 public:
@@ -93,6 +107,8 @@ public:
 	std::unique_ptr<VulkanDescriptorSet> AllocateTextureDescriptorSet(int numLayers);
 	VulkanPipelineLayout* GetPipelineLayout(int numLayers);
 
+	void AddUsedPipeline(const VkRenderPassKey &passKey, const VkPipelineKey &key);
+
 	std::unique_ptr<VulkanDescriptorSetLayout> DynamicSetLayout;
 	std::map<VkRenderPassKey, std::unique_ptr<VkRenderPassSetup>> RenderPassSetup;
 
@@ -102,9 +118,18 @@ private:
 	void CreateDynamicSetLayout();
 	void CreateDescriptorPool();
 	void CreateDynamicSet();
+	void LoadUsedPipelines();
+	void SaveUsedPipelines();
+	bool IsUsablePipelineKey(const VkPipelineKey &key, const VkRenderPassKey &passKey);
+	bool ResolveLoggedPipeline(const VkLoggedPipeline &logged, VkPipelineKey &key);
 
 	VulkanDescriptorSetLayout *GetTextureSetLayout(int numLayers);
 
+	// The combinations the last session needed. New render pass setups create their share of these up front.
+	std::map<VkRenderPassKey, std::vector<VkLoggedPipeline>> LoggedPipelines;
+	// The combinations this session needed, which replace the log on shutdown.
+	std::map<VkRenderPassKey, std::set<VkPipelineKey>> UsedPipelines;
+
 	int TextureDescriptorSetsLeft = 0;
 	int TextureDescriptorsLeft = 0;
 	std::vector<std::unique_ptr<VulkanDescriptorPool>> TextureDescriptorPools;
@@ -455,6 +455,8 @@ void VkRenderState::BeginFrame()
 {
 	mMaterial.Reset();
 	mApplyCount = 0;
+	mMatrixBufferWriter.Reset();
+	mStreamBufferWriter.Reset();
 }
 
 void VkRenderState::EndRenderPass()
@@ -3,17 +3,24 @@
 #include "vulkan/system/vk_framebuffer.h"
 #include "vulkan/system/vk_builders.h"
 #include "vulkan/renderer/vk_streambuffer.h"
+#include "stats.h"
+#include "templates.h"
 
-VkStreamBuffer::VkStreamBuffer(size_t structSize, size_t count)
+static TArray<VkStreamBuffer*> AllStreamBuffers;
+
+VkStreamBuffer::VkStreamBuffer(const char *name, size_t structSize, size_t count) : mName(name)
 {
+	AllStreamBuffers.Push(this);
 	mBlockSize = static_cast<uint32_t>((structSize + screen->uniformblockalignment - 1) / screen->uniformblockalignment * screen->uniformblockalignment);
 
 	UniformBuffer = (VKDataBuffer*)GetVulkanFrameBuffer()->CreateDataBuffer(-1, false, false);
 	UniformBuffer->SetData(mBlockSize * count, nullptr, false);
+	mMaxSize = (size_t)mBlockSize * count * 8;
 }
 
 VkStreamBuffer::~VkStreamBuffer()
 {
+	AllStreamBuffers.Delete(AllStreamBuffers.Find(this));
 	delete UniformBuffer;
 }
 
@@ -22,12 +29,50 @@ uint32_t VkStreamBuffer::NextStreamDataBlock()
 	mStreamDataOffset += mBlockSize;
 	if (mStreamDataOffset + (size_t)mBlockSize >= UniformBuffer->Size())
 	{
+		mFrameUsed += mStreamDataOffset;
+		mFrameFlushes++;
 		mStreamDataOffset = 0;
 		return 0xffffffff;
 	}
 	return mStreamDataOffset;
 }
 
+void VkStreamBuffer::BeginFrame()
+{
+	mLastFrameUsed = mFrameUsed;
+	mLastFrameFlushes = mFrameFlushes;
+	mPeakUsed = MAX(mPeakUsed, mFrameUsed);
+	mFrameUsed = 0;
+	mFrameFlushes = 0;
+
+	// Running out forces a submit and a wait for the GPU in the middle of the frame.
+	// If that happened, make room for the whole frame so it only costs once.
+	if (mLastFrameFlushes > 0 && UniformBuffer->Size() < mMaxSize)
+	{
+		size_t newSize = UniformBuffer->Size();
+		while (newSize < mLastFrameUsed + mBlockSize * 2 && newSize < mMaxSize)
+			newSize *= 2;
+		UniformBuffer->SetData(MIN(newSize, mMaxSize), nullptr, false);
+		mStreamDataOffset = 0;
+	}
+}
+
+FString VkStreamBuffer::GetStats() const
+{
+	FString out;
+	out.Format("%s: %uK of %uK used, peak %uK, %d flushes\n", mName,
+		(unsigned)(mLastFrameUsed / 1024), (unsigned)(UniformBuffer->Size() / 1024), (unsigned)(mPeakUsed / 1024), mLastFrameFlushes);
+	return out;
+}
+
+ADD_STAT(vkstreambuffers)
+{
+	FString out;
+	for (auto buffer : AllStreamBuffers)
+		out += buffer->GetStats();
+	return out;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 VkStreamBufferWriter::VkStreamBufferWriter()
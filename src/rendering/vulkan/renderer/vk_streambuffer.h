@@ -44,15 +44,28 @@ private:
 class VkStreamBuffer
 {
 public:
-	VkStreamBuffer(size_t structSize, size_t count);
+	VkStreamBuffer(const char *name, size_t structSize, size_t count);
 	~VkStreamBuffer();
 
 	uint32_t NextStreamDataBlock();
-	void Reset() { mStreamDataOffset = 0; }
+	void Reset() { mFrameUsed += mStreamDataOffset; mStreamDataOffset = 0; }
+
+	// Must only be called while the GPU is not using the buffer.
+	// Grows it if the last frame did not fit and updates the statistics.
+	void BeginFrame();
+	FString GetStats() const;
 
 	VKDataBuffer* UniformBuffer = nullptr;
 
 private:
+	const char *mName;
 	uint32_t mBlockSize = 0;
 	uint32_t mStreamDataOffset = 0;
+	size_t mMaxSize = 0;
+
+	size_t mFrameUsed = 0;
+	int mFrameFlushes = 0;
+	size_t mLastFrameUsed = 0;
+	int mLastFrameFlushes = 0;
+	size_t mPeakUsed = 0;
 };
@@ -51,10 +51,14 @@ VkShaderManager::VkShaderManager(VulkanDevice *device) : device(device)
 			mEffectShaders[j].push_back(std::move(prog));
 		}
 	}
+
+	ShaderBuilder::SaveCache();
 }
 
 VkShaderManager::~VkShaderManager()
 {
+	// Picks up the postprocess shaders, which only get compiled once they are first used.
+	ShaderBuilder::SaveCache();
 	ShFinalize();
 }
 
@@ -2,6 +2,10 @@
 #include "vk_builders.h"
 #include "doomerrors.h"
 #include "r_data/renderstyle.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "m_misc.h"
+#include "md5.h"
 #include <ShaderLang.h>
 #include <GlslangToSpv.h>
 
@@ -112,6 +116,114 @@ static const TBuiltInResource DefaultTBuiltInResource = {
 	}
 };
 
+// Compiled SPIR-V is independent of the device, so it only has to be keyed by the
+// stage and the complete source, which already contains all the defines.
+// Bump the magic whenever the compiler settings below change.
+static const char *SpirvCacheMagic = "ZVS1";
+static TMap<FString, TArray<uint32_t>> SpirvCache;
+static bool SpirvCacheLoaded;
+static bool SpirvCacheDirty;
+
+static FString CreateSpirvCacheName(bool create)
+{
+	FString path = M_GetCachePath(create);
+	if (create) CreatePath(path);
+	path << "/vkshadercache.zdsc";
+	return path;
+}
+
+static FString CalcSpirvChecksum(int stage, const FString &code)
+{
+	uint8_t digest[16];
+	MD5Context md5;
+	md5.Update((const uint8_t *)&stage, sizeof(int));
+	md5.Update((const uint8_t *)code.GetChars(), (unsigned int)code.Len());
+	md5.Final(digest);
+
+	char hexdigest[33];
+	for (int i = 0; i < 16; i++)
+	{
+		int v = digest[i] >> 4;
+		hexdigest[i * 2] = v < 10 ? ('0' + v) : ('a' + v - 10);
+		v = digest[i] & 15;
+		hexdigest[i * 2 + 1] = v < 10 ? ('0' + v) : ('a' + v - 10);
+	}
+	hexdigest[32] = 0;
+	return hexdigest;
+}
+
+static void LoadSpirvCache()
+{
+	if (SpirvCacheLoaded)
+		return;
+	SpirvCacheLoaded = true;
+
+	try
+	{
+		FileReader fr;
+		if (!fr.OpenFile(CreateSpirvCacheName(false)))
+			return;
+
+		char magic[4];
+		if (fr.Read(magic, 4) != 4 || memcmp(magic, SpirvCacheMagic, 4) != 0)
+			I_Error("Not a shader cache file");
+
+		uint32_t count = fr.ReadUInt32();
+		if (count > 4096)
+			I_Error("Too many shaders cached");
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			char hexdigest[33];
+			if (fr.Read(hexdigest, 32) != 32)
+				I_Error("Read error");
+			hexdigest[32] = 0;
+
+			uint32_t size = fr.ReadUInt32();
+			if (size > 1024 * 1024)
+				I_Error("Shader too big, probably file corruption");
+
+			// Earlier versions could save an empty entry for a shader that failed to compile.
+			if (size == 0)
+				continue;
+
+			auto &spirv = SpirvCache[hexdigest];
+			spirv.Resize(size);
+			if (fr.Read(spirv.Data(), size * sizeof(uint32_t)) != size * sizeof(uint32_t))
+				I_Error("Read error");
+		}
+	}
+	catch (...)
+	{
+		SpirvCache.Clear();
+	}
+}
+
+void ShaderBuilder::SaveCache()
+{
+	if (!SpirvCacheDirty)
+		return;
+	SpirvCacheDirty = false;
+
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(CreateSpirvCacheName(true)));
+	if (fw)
+	{
+		uint32_t count = SpirvCache.CountUsed();
+		fw->Write(SpirvCacheMagic, 4);
+		fw->Write(&count, sizeof(uint32_t));
+
+		TMap<FString, TArray<uint32_t>>::Iterator it(SpirvCache);
+		TMap<FString, TArray<uint32_t>>::Pair *pair;
+		while (it.NextPair(pair))
+		{
+			uint32_t size = pair->Value.Size();
+			fw->Write(pair->Key.GetChars(), 32);
+			fw->Write(&size, sizeof(uint32_t));
+			fw->Write(pair->Value.Data(), size * sizeof(uint32_t));
+		}
+	}
+}
+
 ShaderBuilder::ShaderBuilder()
 {
 }
@@ -129,6 +241,38 @@ void ShaderBuilder::setFragmentShader(const FString &c)
 }
 
 std::unique_ptr<VulkanShader> ShaderBuilder::create(const char *shadername, VulkanDevice *device)
+{
+	LoadSpirvCache();
+
+	FString checksum = CalcSpirvChecksum(stage, code);
+	TArray<uint32_t> *cached = SpirvCache.CheckKey(checksum);
+	if (cached == nullptr)
+	{
+		// Only add it once it compiled, or a failed shader would end up in the cache file.
+		TArray<uint32_t> spirv = compile(shadername);
+		cached = &SpirvCache[checksum];
+		*cached = std::move(spirv);
+		SpirvCacheDirty = true;
+	}
+
+	VkShaderModuleCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	createInfo.codeSize = cached->Size() * sizeof(uint32_t);
+	createInfo.pCode = cached->Data();
+
+	VkShaderModule shaderModule;
+	VkResult result = vkCreateShaderModule(device->device, &createInfo, nullptr, &shaderModule);
+	if (result != VK_SUCCESS)
+	{
+		FString msg;
+		msg.Format("Could not create vulkan shader module for '%s': %s", shadername, VkResultToString(result).GetChars());
+		VulkanError(msg.GetChars());
+	}
+
+	return std::make_unique<VulkanShader>(device, shaderModule);
+}
+
+TArray<uint32_t> ShaderBuilder::compile(const char *shadername)
 {
 	EShLanguage stage = (EShLanguage)this->stage;
 	const char *sources[] = { code.GetChars() };
@@ -169,21 +313,10 @@ std::unique_ptr<VulkanShader> ShaderBuilder::create(const char *shadername, Vulk
 	spv::SpvBuildLogger logger;
 	glslang::GlslangToSpv(*intermediate, spirv, &logger, &spvOptions);
 
-	VkShaderModuleCreateInfo createInfo = {};
-	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	createInfo.codeSize = spirv.size() * sizeof(unsigned int);
-	createInfo.pCode = spirv.data();
-
-	VkShaderModule shaderModule;
-	VkResult result = vkCreateShaderModule(device->device, &createInfo, nullptr, &shaderModule);
-	if (result != VK_SUCCESS)
-	{
-		FString msg;
-		msg.Format("Could not create vulkan shader module for '%s': %s", shadername, VkResultToString(result).GetChars());
-		VulkanError(msg.GetChars());
-	}
-
-	return std::make_unique<VulkanShader>(device, shaderModule);
+	TArray<uint32_t> result;
+	result.Resize((unsigned)spirv.size());
+	memcpy(result.Data(), spirv.data(), spirv.size() * sizeof(uint32_t));
+	return result;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -113,7 +113,12 @@ public:
 
 	std::unique_ptr<VulkanShader> create(const char *shadername, VulkanDevice *device);
 
+	// Writes out the SPIR-V of all shaders compiled so far, if anything new was added.
+	static void SaveCache();
+
 private:
+	TArray<uint32_t> compile(const char *shadername);
+
 	FString code;
 	int stage;
 };
@@ -617,7 +622,7 @@ inline void ComputePipelineBuilder::setComputeShader(VulkanShader *shader)
 inline std::unique_ptr<VulkanPipeline> ComputePipelineBuilder::create(VulkanDevice *device)
 {
 	VkPipeline pipeline;
-	vkCreateComputePipelines(device->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+	vkCreateComputePipelines(device->device, device->pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
 	return std::make_unique<VulkanPipeline>(device, pipeline);
 }
 
@@ -1033,7 +1038,7 @@ inline void GraphicsPipelineBuilder::addDynamicState(VkDynamicState state)
 inline std::unique_ptr<VulkanPipeline> GraphicsPipelineBuilder::create(VulkanDevice *device)
 {
 	VkPipeline pipeline = 0;
-	VkResult result = vkCreateGraphicsPipelines(device->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+	VkResult result = vkCreateGraphicsPipelines(device->device, device->pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
 	CheckVulkanError(result, "Could not create graphics pipeline");
 	return std::make_unique<VulkanPipeline>(device, pipeline);
 }
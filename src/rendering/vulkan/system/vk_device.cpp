@@ -42,6 +42,9 @@
 #include "i_system.h"
 #include "version.h"
 #include "doomerrors.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "m_misc.h"
 #include "gamedata/fonts/v_text.h"
 
 bool I_GetVulkanPlatformExtensions(unsigned int *count, const char **names);
@@ -84,6 +87,7 @@ VulkanDevice::VulkanDevice()
 		SelectFeatures();
 		CreateDevice();
 		CreateAllocator();
+		CreatePipelineCache();
 	}
 	catch (...)
 	{
@@ -226,6 +230,80 @@ void VulkanDevice::CreateAllocator()
 		VulkanError("Unable to create allocator");
 }
 
+static FString CreatePipelineCacheName(bool create)
+{
+	FString path = M_GetCachePath(create);
+	if (create) CreatePath(path);
+	path << "/vkpipelinecache.bin";
+	return path;
+}
+
+void VulkanDevice::CreatePipelineCache()
+{
+	std::vector<uint8_t> data;
+
+	FileReader fr;
+	if (fr.OpenFile(CreatePipelineCacheName(false)))
+	{
+		// Only hand over data that was written for this exact device and driver.
+		// The driver is required to check this too, but not all of them do so reliably.
+		auto size = fr.GetLength();
+		if (size > 16 + VK_UUID_SIZE && size < 64 * 1024 * 1024)
+		{
+			data.resize(size);
+			if (fr.Read(data.data(), size) != size)
+			{
+				data.clear();
+			}
+			else
+			{
+				uint32_t header[4];
+				memcpy(header, data.data(), sizeof(header));
+				if (header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+					header[2] != PhysicalDevice.Properties.vendorID ||
+					header[3] != PhysicalDevice.Properties.deviceID ||
+					memcmp(data.data() + 16, PhysicalDevice.Properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+				{
+					data.clear();
+				}
+			}
+		}
+	}
+
+	VkPipelineCacheCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = data.size();
+	createInfo.pInitialData = data.empty() ? nullptr : data.data();
+	if (vkCreatePipelineCache(device, &createInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+	{
+		// Not having a cache only costs time, so try again without the stored data before giving up on it.
+		createInfo.initialDataSize = 0;
+		createInfo.pInitialData = nullptr;
+		if (vkCreatePipelineCache(device, &createInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+			pipelineCache = VK_NULL_HANDLE;
+	}
+}
+
+void VulkanDevice::SavePipelineCache()
+{
+	if (!pipelineCache)
+		return;
+
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+		return;
+
+	std::vector<uint8_t> data(size);
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) != VK_SUCCESS)
+		return;
+
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(CreatePipelineCacheName(true)));
+	if (fw)
+	{
+		fw->Write(data.data(), size);
+	}
+}
+
 void VulkanDevice::CreateDevice()
 {
 	float queuePriority = 1.0f;
@@ -501,6 +579,13 @@ void VulkanDevice::ReleaseResources()
 	if (device)
 		vkDeviceWaitIdle(device);
 
+	if (pipelineCache)
+	{
+		SavePipelineCache();
+		vkDestroyPipelineCache(device, pipelineCache, nullptr);
+	}
+	pipelineCache = VK_NULL_HANDLE;
+
 	if (allocator)
 		vmaDestroyAllocator(allocator);
 
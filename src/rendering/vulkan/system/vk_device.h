@@ -71,6 +71,7 @@ public:
 	VkSurfaceKHR surface = VK_NULL_HANDLE;
 	VkDevice device = VK_NULL_HANDLE;
 	VmaAllocator allocator = VK_NULL_HANDLE;
+	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
 
 	VkQueue graphicsQueue = VK_NULL_HANDLE;
 	VkQueue presentQueue = VK_NULL_HANDLE;
@@ -86,6 +87,8 @@ private:
 	void SelectFeatures();
 	void CreateDevice();
 	void CreateAllocator();
+	void CreatePipelineCache();
+	void SavePipelineCache();
 	void ReleaseResources();
 
 	bool SupportsDeviceExtension(const char *ext) const;
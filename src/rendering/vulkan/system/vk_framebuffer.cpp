@@ -162,8 +162,8 @@ void VulkanFrameBuffer::InitializeState()
 	CreateFanToTrisIndexBuffer();
 
 	// To do: move this to HW renderer interface maybe?
-	MatrixBuffer = new VkStreamBuffer(sizeof(MatricesUBO), 50000);
-	StreamBuffer = new VkStreamBuffer(sizeof(StreamUBO), 300);
+	MatrixBuffer = new VkStreamBuffer("Matrices", sizeof(MatricesUBO), 50000);
+	StreamBuffer = new VkStreamBuffer("Stream data", sizeof(StreamUBO), 300);
 
 	mShaderManager.reset(new VkShaderManager(device));
 	mSamplerManager.reset(new VkSamplerManager(device));
@@ -430,7 +430,9 @@ sector_t *VulkanFrameBuffer::RenderView(player_t *player)
 
 		mPostprocess->ImageTransitionScene(true); // This is the only line that differs compared to FGLRenderer::RenderView
 
+		PushGroup("scene");
 		retsec = RenderViewpoint(r_viewpoint, player->camera, NULL, r_viewpoint.FieldOfView.Degrees, ratio, fovratio, true, true);
+		PopGroup();
 	}
 	All.Unclock();
 	return retsec;
@@ -831,7 +833,14 @@ void VulkanFrameBuffer::BeginFrame()
 	SetViewportRects(nullptr);
 	mScreenBuffers->BeginFrame(screen->mScreenViewport.width, screen->mScreenViewport.height, screen->mSceneViewport.width, screen->mSceneViewport.height);
 	mSaveBuffers->BeginFrame(SAVEPICWIDTH, SAVEPICHEIGHT, SAVEPICWIDTH, SAVEPICHEIGHT);
+
+	// The stream buffers may get replaced here, so nothing in flight may still use them
+	// and the render state's writers must start over. UpdateDynamicSet binds the new ones.
+	mRenderState->EndRenderPass();
+	WaitForCommands(false);
 	mRenderState->BeginFrame();
+	MatrixBuffer->BeginFrame();
+	StreamBuffer->BeginFrame();
 	mRenderPassManager->UpdateDynamicSet();
 
 	if (mNextTimestampQuery > 0)
@@ -903,7 +912,9 @@ void VulkanFrameBuffer::UpdateGpuStats()
 
 void VulkanFrameBuffer::Draw2D()
 {
+	PushGroup("2D");
 	::Draw2D(&m2DDrawer, *mRenderState);
+	PopGroup();
 }
 
 VulkanCommandBuffer *VulkanFrameBuffer::GetTransferCommands()
@@ -9,6 +9,9 @@
 
 CVAR(Bool, vk_hdr, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
 
+// Present mode preferred while vsync is off: 0 = mailbox (no tearing), 1 = immediate (lowest latency, tears)
+CVAR(Int, vk_presentmode, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
+
 void I_GetVulkanDrawableSize(int *width, int *height);
 
 VulkanSwapChain::VulkanSwapChain(VulkanDevice *device) : device(device)
@@ -23,13 +26,14 @@ VulkanSwapChain::~VulkanSwapChain()
 uint32_t VulkanSwapChain::AcquireImage(int width, int height, VulkanSemaphore *semaphore, VulkanFence *fence)
 {
 	auto vsync = static_cast<VulkanFrameBuffer*>(screen)->cur_vsync;
-	if (lastSwapWidth != width || lastSwapHeight != height || lastVsync != vsync || lastHdr != vk_hdr || !swapChain)
+	if (lastSwapWidth != width || lastSwapHeight != height || lastVsync != vsync || lastHdr != vk_hdr || lastPresentMode != vk_presentmode || !swapChain)
 	{
 		Recreate();
 		lastSwapWidth = width;
 		lastSwapHeight = height;
 		lastVsync = vsync;
 		lastHdr = vk_hdr;
+		lastPresentMode = vk_presentmode;
 	}
 
 	uint32_t imageIndex;
@@ -284,7 +288,9 @@ void VulkanSwapChain::SelectPresentMode()
 	{
 		bool supportsMailbox = std::find(presentModes.begin(), presentModes.end(), VK_PRESENT_MODE_MAILBOX_KHR) != presentModes.end();
 		bool supportsImmediate = std::find(presentModes.begin(), presentModes.end(), VK_PRESENT_MODE_IMMEDIATE_KHR) != presentModes.end();
-		if (supportsMailbox)
+		if (vk_presentmode == 1 && supportsImmediate)
+			swapChainPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+		else if (supportsMailbox)
 			swapChainPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
 		else if (supportsImmediate)
 			swapChainPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
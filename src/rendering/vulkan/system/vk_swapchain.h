@@ -47,6 +47,7 @@ private:
 	int lastSwapHeight = 0;
 	bool lastVsync = false;
 	bool lastHdr = false;
+	int lastPresentMode = 0;
 
 	VulkanSwapChain(const VulkanSwapChain &) = delete;
 	VulkanSwapChain &operator=(const VulkanSwapChain &) = delete;
@@ -52,7 +52,7 @@
 #include "utf8.h"
 
 extern FRandom pr_exrandom;
-FMemArena FxAlloc(65536);
+FMemArena FxAlloc(65536, "FxAlloc");
 
 struct FLOP
 {
@@ -9170,6 +9170,38 @@ FxExpression *FxVMFunctionCall::Resolve(FCompileContext& ctx)
 	return this;
 }
 
+//==========================================================================
+//
+// Checks whether a native virtual function is not overridden by any class.
+// All classes exist and have their virtual tables set up by the time code
+// gets emitted so such a call always ends up in the same function. Calling
+// it directly lets the JIT use the native's direct call entry point instead
+// of loading it from the vtable and going through the VM call thunk.
+// Natives check for a null self themselves so this does not lose the
+// null pointer check the vtable lookup performs.
+//
+//==========================================================================
+
+int VirtualCallSites, DevirtualizedCallSites;
+
+static bool IsNeverOverridden(PFunction *func, VMFunction *vmfunc)
+{
+	if (!(vmfunc->VarFlags & VARF_Native)) return false;
+
+	auto owner = PType::toClass(func->OwningClass);
+	if (owner == nullptr) return false;
+
+	unsigned index = vmfunc->VirtualIndex;
+	for (auto cls : PClass::AllClasses)
+	{
+		if (cls->Virtuals.Size() > index && cls->Virtuals[index] != vmfunc && cls->IsDescendantOf(owner->Descriptor))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 //==========================================================================
 //
 //
@@ -9270,6 +9302,15 @@ ExpEmit FxVMFunctionCall::Emit(VMFunctionBuilder *build)
 	ArgList.DeleteAndClear();
 	ArgList.ShrinkToFit();
 
+	if (!staticcall)
+	{
+		VirtualCallSites++;
+		if (IsNeverOverridden(Function, vmfunc))
+		{
+			DevirtualizedCallSites++;
+			staticcall = true;
+		}
+	}
 	if (!staticcall) emitters.SetVirtualReg(selfemit.RegNum);
 	int resultcount = vmfunc->Proto->ReturnTypes.Size() == 0 ? 0 : MAX(AssignCount, 1);
 
@@ -807,6 +807,8 @@ VMFunction *FFunctionBuildList::AddFunction(PNamespace *gnspc, const VersionInfo
 }
 
 
+extern int VirtualCallSites, DevirtualizedCallSites;
+
 void FFunctionBuildList::Build()
 {
 	int codesize = 0;
@@ -929,6 +931,9 @@ void FFunctionBuildList::Build()
 	VMFunction::CreateRegUseInfo();
 	FScriptPosition::StrictErrors = false;
 
+	DPrintf(DMSG_NOTIFY, "%d of %d virtual call sites resolved to direct calls\n", DevirtualizedCallSites, VirtualCallSites);
+	VirtualCallSites = DevirtualizedCallSites = 0;
+
 	if (FScriptPosition::ErrorCounter == 0 && Args->CheckParm("-dumpjit")) DumpJit();
 	mItems.Clear();
 	mItems.ShrinkToFit();
@@ -237,23 +237,38 @@ INTBOOL CheckActorFlag(AActor *owner, FFlagDef *fd)
 
 INTBOOL CheckActorFlag(AActor *owner, const char *flagname, bool printerror)
 {
-	const char *dot = strchr (flagname, '.');
-	FFlagDef *fd;
-	const PClass *cls = owner->GetClass();
+	// Scripts usually check the same few flags on the same few classes over and
+	// over, so the result of the name lookup is remembered for each class.
+	PClassActor *cls = owner->GetClass();
+	FName flag(flagname);
+	FCachedFlag *cached = cls->ActorInfo()->FlagCache.CheckKey(flag);
 
-	if (dot != NULL)
+	if (cached == nullptr)
 	{
-		FString part1(flagname, dot-flagname);
-		fd = FindFlag (cls, part1, dot+1);
-	}
-	else
-	{
-		fd = FindFlag (cls, flagname, NULL);
+		const char *dot = strchr (flagname, '.');
+		FFlagDef *fd;
+
+		if (dot != NULL)
+		{
+			FString part1(flagname, dot-flagname);
+			fd = FindFlag (cls, part1, dot+1);
+		}
+		else
+		{
+			fd = FindFlag (cls, flagname, NULL);
+		}
+
+		cached = &cls->ActorInfo()->FlagCache.Insert(flag, { 0, 0, 0, false });
+		if (fd != NULL)
+		{
+			*cached = { fd->flagbit, fd->structoffset, fd->fieldsize, true };
+		}
 	}
 
-	if (fd != NULL)
+	if (cached->found)
 	{
-		return CheckActorFlag(owner, fd);
+		FFlagDef fd = { cached->flagbit, "", cached->structoffset, cached->fieldsize, 0 };
+		return CheckActorFlag(owner, &fd);
 	}
 	else
 	{
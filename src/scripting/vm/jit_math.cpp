@@ -945,6 +945,19 @@ void JitCompiler::EmitFLOP()
 			cc.movsd(regF[A], regF[B]);
 		cc.xorpd(regF[A], maskXmm);
 	}
+	else if (C == FLOP_ABS)
+	{
+		auto mask = cc.newInt64Const(asmjit::kConstScopeLocal, 0x7fffffffffffffffll);
+		auto maskXmm = newTempXmmSd();
+		cc.movsd(maskXmm, mask);
+		if (A != B)
+			cc.movsd(regF[A], regF[B]);
+		cc.andpd(regF[A], maskXmm);
+	}
+	else if (C == FLOP_SQRT)
+	{
+		CallSqrt(regF[A], regF[B]);
+	}
 	else
 	{
 		auto v = newTempXmmSd();
@@ -1513,11 +1526,9 @@ void JitCompiler::EmitEQA_K()
 	});
 }
 
+// Square roots are correctly rounded under IEEE 754, so the SSE2 instruction
+// produces exactly what g_sqrt does without the overhead of a call.
 void JitCompiler::CallSqrt(const asmjit::X86Xmm &a, const asmjit::X86Xmm &b)
 {
-	auto result = newResultXmmSd();
-	auto call = CreateCall<double, double>(g_sqrt);
-	call->setRet(0, result);
-	call->setArg(0, b);
-	cc.movsd(a, result);
+	cc.sqrtsd(a, b);
 }
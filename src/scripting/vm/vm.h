@@ -395,6 +395,12 @@ struct VMValue
 	}
 };
 
+// Script profiler (vmprofiler.cpp)
+extern bool VMProfiling;
+void VMProfileEnter(uintptr_t key, FString (*describe)(uintptr_t key));
+void VMProfileLeave();
+void VMProfileReset();
+
 class VMFunction
 {
 public:
@@ -410,7 +416,14 @@ public:
 	class PPrototype *Proto;
 	TArray<uint32_t> ArgFlags;		// Should be the same length as Proto->ArgumentTypes
 
-	int(*ScriptCall)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret) = nullptr;
+	typedef int(*ScriptCallType)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+	ScriptCallType ScriptCall = nullptr;
+	ScriptCallType ProfiledCall = nullptr;	// the real entry point while the script profiler has ScriptCall wrapped
+
+	// Anything that replaces the entry point after the first call must go through these
+	// so that it doesn't accidentally unhook the profiler.
+	ScriptCallType RealScriptCall() const { return ProfiledCall != nullptr ? ProfiledCall : ScriptCall; }
+	void SetScriptCall(ScriptCallType call) { (ProfiledCall != nullptr ? ProfiledCall : ScriptCall) = call; }
 
 	VMFunction(FName name = NAME_None) : ImplicitArgs(0), Name(name), Proto(NULL)
 	{
@@ -432,6 +445,7 @@ public:
 			f->~VMFunction();
 		}
 		AllFunctions.Clear();
+		VMProfileReset();
 		// also release any JIT data
 		JitRelease();
 	}
@@ -776,6 +790,21 @@ unsigned GetVirtualIndex(PClass *cls, const char *funcname);
 
 #define IFVIRTUAL(cls, funcname) IFVIRTUALPTR(this, cls, funcname)
 
+// Like IFVIRTUALPTR but only enters the block if the function got overridden
+// below 'cls'. Use this where 'cls' declares it as a native virtual and the
+// else branch calls the same native function, to avoid going through the VM.
+#define IFOVERRIDENVIRTUALPTR(self, cls, funcname) \
+	static unsigned VIndex = ~0u; \
+	if (VIndex == ~0u) { \
+		VIndex = GetVirtualIndex(RUNTIME_CLASS(cls), #funcname); \
+		assert(VIndex != ~0u); \
+	} \
+	auto clss = self->GetClass(); \
+	VMFunction *func = clss->Virtuals.Size() > VIndex? clss->Virtuals[VIndex] : nullptr;  \
+	if (func != nullptr && func != RUNTIME_CLASS(cls)->Virtuals[VIndex])
+
+#define IFOVERRIDENVIRTUAL(cls, funcname) IFOVERRIDENVIRTUALPTR(this, cls, funcname)
+
 #define IFVIRTUALPTRNAME(self, cls, funcname) \
 	static unsigned VIndex = ~0u; \
 	if (VIndex == ~0u) { \
@@ -50,8 +50,12 @@ CUSTOM_CVAR(Bool, vm_jit, true, CVAR_NOINITCALL)
 	Printf("You must restart " GAMENAME " for this change to take effect.\n");
 	Printf("This cvar is currently not saved. You must specify it on the command line.");
 }
+// Functions get interpreted for this many calls before being JIT compiled, so that
+// code that only runs once or twice, like most setup code, does not pay for compiling.
+CVAR(Int, vm_jit_threshold, 2, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 #else
 CVAR(Bool, vm_jit, false, CVAR_NOINITCALL|CVAR_NOSET)
+CVAR(Int, vm_jit_threshold, 0, CVAR_NOINITCALL|CVAR_NOSET)
 FString JitCaptureStackTrace(int framesToSkip, bool includeNativeFrames) { return FString(); }
 void JitRelease() {}
 #endif
@@ -130,11 +134,16 @@ VMScriptFunction::VMScriptFunction(FName name)
 	NumKonstA = 0;
 	MaxParam = 0;
 	NumArgs = 0;
+	InterpretedCalls = 0;
 	ScriptCall = &VMScriptFunction::FirstScriptCall;
 }
 
 VMScriptFunction::~VMScriptFunction()
 {
+	for (auto buffer : ArrayBuffers)
+	{
+		if (buffer != nullptr) M_Free(buffer);
+	}
 	if (Code != NULL)
 	{
 		if (KonstS != NULL)
@@ -222,13 +231,36 @@ void VMScriptFunction::Alloc(int numops, int numkonstd, int numkonstf, int numko
 	NumKonstA = numkonsta;
 }
 
+//==========================================================================
+//
+// Local dynamic arrays of plain values keep their storage from one call to
+// the next. The array is still handed out empty with no reported capacity
+// so everything the script can see is the same as with a fresh array, but
+// the first Push reallocates the kept buffer instead of allocating a new
+// one, which avoids a malloc/free pair per call for functions that
+// build temporary lists every tic.
+//
+//==========================================================================
+
+static bool CanKeepArrayBuffer(const PType *type)
+{
+	return type->isDynArray() && static_cast<const PDynArray*>(type)->ElementType->GetRegType() != REGT_STRING;
+}
+
 void VMScriptFunction::InitExtra(void *addr)
 {
 	char *caddr = (char*)addr;
 
-	for (auto tao : SpecialInits)
+	for (unsigned i = 0; i < SpecialInits.Size(); i++)
 	{
+		auto &tao = SpecialInits[i];
 		tao.first->InitializeValue(caddr + tao.second, nullptr);
+		if (i < ArrayBuffers.Size() && ArrayBuffers[i] != nullptr)
+		{
+			// Most stays 0 so the first growth goes through M_Realloc on the kept block.
+			((FArray*)(caddr + tao.second))->Array = ArrayBuffers[i];
+			ArrayBuffers[i] = nullptr;
+		}
 	}
 }
 
@@ -236,8 +268,25 @@ void VMScriptFunction::DestroyExtra(void *addr)
 {
 	char *caddr = (char*)addr;
 
-	for (auto tao : SpecialInits)
+	for (unsigned i = 0; i < SpecialInits.Size(); i++)
 	{
+		auto &tao = SpecialInits[i];
+		FArray *aray = (FArray*)(caddr + tao.second);
+		if (CanKeepArrayBuffer(tao.first) && aray->Array != nullptr)
+		{
+			if (ArrayBuffers.Size() == 0)
+			{
+				ArrayBuffers.Resize(SpecialInits.Size());
+				for (auto &buffer : ArrayBuffers) buffer = nullptr;
+			}
+			if (ArrayBuffers[i] == nullptr)
+			{
+				ArrayBuffers[i] = aray->Array;
+				aray->Array = nullptr;
+				aray->Count = aray->Most = 0;
+				continue;
+			}
+		}
 		tao.first->DestroyValue(caddr + tao.second);
 	}
 }
@@ -278,22 +327,49 @@ static bool CanJit(VMScriptFunction *func)
 	return false;
 }
 
+void VMScriptFunction::CompileOrInterpret(VMScriptFunction *func)
+{
+#ifdef HAVE_VM_JIT
+	if (vm_jit && CanJit(func))
+	{
+		auto code = JitCompile(func);
+		func->SetScriptCall(code ? code : VMExec);
+	}
+	else
+#endif // HAVE_VM_JIT
+	{
+		func->SetScriptCall(VMExec);
+	}
+}
+
 int VMScriptFunction::FirstScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret)
 {
 #ifdef HAVE_VM_JIT
-	if (vm_jit && CanJit(static_cast<VMScriptFunction*>(func)))
+	// Callers always go through ScriptCall, so the function can be switched over to
+	// native code later without anything else needing to know.
+	if (vm_jit && vm_jit_threshold > 0)
 	{
-		func->ScriptCall = JitCompile(static_cast<VMScriptFunction*>(func));
-		if (!func->ScriptCall)
-			func->ScriptCall = VMExec;
+		func->SetScriptCall(&VMScriptFunction::CountedScriptCall);
 	}
 	else
 #endif // HAVE_VM_JIT
 	{
-		func->ScriptCall = VMExec;
+		CompileOrInterpret(static_cast<VMScriptFunction*>(func));
+	}
+
+	return func->RealScriptCall()(func, params, numparams, ret, numret);
+}
+
+int VMScriptFunction::CountedScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret)
+{
+	auto sfunc = static_cast<VMScriptFunction*>(func);
+	if (sfunc->InterpretedCalls++ < vm_jit_threshold)
+	{
+		return VMExec(func, params, numparams, ret, numret);
 	}
 
-	return func->ScriptCall(func, params, numparams, ret, numret);
+	CompileOrInterpret(sfunc);
+	return func->RealScriptCall()(func, params, numparams, ret, numret);
 }
 
 int VMNativeFunction::NativeScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *returns, int numret)
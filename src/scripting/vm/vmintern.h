@@ -471,7 +471,9 @@ public:
 	VM_UHALF NumKonstA;
 	VM_UHALF MaxParam;		// Maximum number of parameters this function has on the stack at once
 	VM_UBYTE NumArgs;		// Number of arguments this function takes
+	int InterpretedCalls;	// Number of calls run through the interpreter while waiting to be JIT compiled
 	TArray<FTypeAndOffset> SpecialInits;	// list of all contents on the extra stack which require construction and destruction
+	TArray<void *> ArrayBuffers;	// storage of local dynamic arrays kept from the last call, indexed like SpecialInits
 
 	void InitExtra(void *addr);
 	void DestroyExtra(void *addr);
@@ -480,4 +482,6 @@ public:
 
 private:
 	static int FirstScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+	static int CountedScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+	static void CompileOrInterpret(VMScriptFunction *func);
 };
@@ -0,0 +1,348 @@
+/*
+** vmprofiler.cpp
+** Call tree profiler for ZScript and ACS
+**
+** While running, every VM function's entry point is wrapped so that each
+** call is timed and attributed to its place in the call tree. ACS scripts
+** report themselves through VMProfileEnter/VMProfileLeave. The result can
+** be written out as folded stacks for use with flame graph tools.
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#include "dobject.h"
+#include "vmintern.h"
+#include "stats.h"
+#include "c_dispatch.h"
+#include "files.h"
+#include "v_text.h"
+#include "templates.h"
+
+bool VMProfiling;
+
+struct FProfileNode
+{
+	uintptr_t Key;
+	int Parent;
+	FString Name;
+	TArray<int> Children;
+	unsigned Calls;
+	cycle_t Time;
+};
+
+enum
+{
+	MAX_PROFILE_DEPTH = 256,	// anything deeper is charged to the node at this depth
+};
+
+static TArray<FProfileNode> ProfileNodes;
+static TArray<int> ProfileStack;
+
+//==========================================================================
+//
+// ProfileClear
+//
+//==========================================================================
+
+static void ProfileClear()
+{
+	ProfileNodes.Resize(1);
+	auto &root = ProfileNodes[0];
+	root.Key = 0;
+	root.Parent = -1;
+	root.Name = "root";
+	root.Children.Clear();
+	root.Calls = 0;
+	root.Time.Reset();
+	ProfileStack.Clear();
+	ProfileStack.Push(0);
+}
+
+//==========================================================================
+//
+// VMProfileEnter
+//
+// Descends into the child of the current node identified by key.
+// Function nodes use the VMFunction pointer, anything else has to
+// use an odd value so that the two can never collide. describe is
+// only called the first time a node is seen at a given spot of
+// the tree, nullptr means key is a VMFunction.
+//
+//==========================================================================
+
+void VMProfileEnter(uintptr_t key, FString (*describe)(uintptr_t key))
+{
+	if (!VMProfiling) return;
+
+	int parent = ProfileStack.Last();
+	if (parent < 0 || ProfileStack.Size() >= MAX_PROFILE_DEPTH)
+	{
+		ProfileStack.Push(-1);
+		return;
+	}
+
+	int node = -1;
+	for (int child : ProfileNodes[parent].Children)
+	{
+		if (ProfileNodes[child].Key == key)
+		{
+			node = child;
+			break;
+		}
+	}
+	if (node < 0)
+	{
+		node = ProfileNodes.Reserve(1);
+		auto &n = ProfileNodes[node];
+		n.Key = key;
+		n.Parent = parent;
+		n.Name = describe != nullptr ? describe(key) : reinterpret_cast<VMFunction *>(key)->PrintableName;
+		n.Children.Clear();
+		n.Calls = 0;
+		n.Time.Reset();
+		ProfileNodes[parent].Children.Push(node);
+	}
+	ProfileNodes[node].Calls++;
+	ProfileNodes[node].Time.Clock();
+	ProfileStack.Push(node);
+}
+
+//==========================================================================
+//
+// VMProfileLeave
+//
+//==========================================================================
+
+void VMProfileLeave()
+{
+	// The root never gets popped, which also keeps this safe if profiling
+	// got stopped and restarted while something was still on the stack.
+	if (ProfileStack.Size() <= 1) return;
+
+	int node = ProfileStack.Last();
+	ProfileStack.Pop();
+	if (node > 0) ProfileNodes[node].Time.Unclock();
+}
+
+//==========================================================================
+//
+// ProfiledScriptCall
+//
+// Stands in for the real entry point of every function while profiling.
+//
+//==========================================================================
+
+static int ProfiledScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret)
+{
+	auto call = func->ProfiledCall;
+	int result;
+
+	VMProfileEnter(reinterpret_cast<uintptr_t>(func), nullptr);
+	try
+	{
+		result = call(func, params, numparams, ret, numret);
+	}
+	catch (...)
+	{
+		VMProfileLeave();
+		throw;
+	}
+	VMProfileLeave();
+	return result;
+}
+
+//==========================================================================
+//
+// Installing and removing the wrapper
+//
+//==========================================================================
+
+static void ProfileStart()
+{
+	if (VMProfiling) return;
+
+	ProfileClear();
+	for (auto func : VMFunction::AllFunctions)
+	{
+		if (func->ScriptCall != nullptr && func->ProfiledCall == nullptr)
+		{
+			func->ProfiledCall = func->ScriptCall;
+			func->ScriptCall = ProfiledScriptCall;
+		}
+	}
+	VMProfiling = true;
+}
+
+static void ProfileStop()
+{
+	if (!VMProfiling) return;
+
+	for (auto func : VMFunction::AllFunctions)
+	{
+		if (func->ProfiledCall != nullptr)
+		{
+			func->ScriptCall = func->ProfiledCall;
+			func->ProfiledCall = nullptr;
+		}
+	}
+	VMProfiling = false;
+}
+
+//==========================================================================
+//
+// VMProfileReset
+//
+// Called when all functions get deleted. The nodes only keep copies of
+// the names so the collected data can still be dumped afterward.
+//
+//==========================================================================
+
+void VMProfileReset()
+{
+	VMProfiling = false;
+	ProfileStack.Resize(ProfileNodes.Size() > 0 ? 1 : 0);
+}
+
+//==========================================================================
+//
+// Reporting
+//
+//==========================================================================
+
+static double ProfileSelfTime(int node)
+{
+	double time = ProfileNodes[node].Time.TimeMS();
+	for (int child : ProfileNodes[node].Children)
+	{
+		time -= ProfileNodes[child].Time.TimeMS();
+	}
+	return MAX(time, 0.);
+}
+
+static FString ProfilePath(int node)
+{
+	FString path = ProfileNodes[node].Name;
+	for (node = ProfileNodes[node].Parent; node > 0; node = ProfileNodes[node].Parent)
+	{
+		path = ProfileNodes[node].Name + ";" + path;
+	}
+	return path;
+}
+
+static bool ProfileDump(const char *filename)
+{
+	FileWriter *fw = FileWriter::Open(filename);
+	if (fw == nullptr)
+	{
+		return false;
+	}
+	for (unsigned i = 1; i < ProfileNodes.Size(); i++)
+	{
+		// Folded stacks format, one line per call path with its self time in microseconds.
+		int64_t usec = int64_t(ProfileSelfTime(i) * 1000);
+		if (usec > 0)
+		{
+			// Flame graph tools use spaces and semicolons as separators.
+			FString path = ProfilePath(i);
+			path.ReplaceChars(' ', '_');
+			fw->Printf("%s %lld\n", path.GetChars(), (long long)usec);
+		}
+	}
+	delete fw;
+	return true;
+}
+
+static void ProfileList(unsigned count)
+{
+	TArray<int> sorted;
+	TArray<double> self;
+	self.Resize(ProfileNodes.Size());
+	for (unsigned i = 1; i < ProfileNodes.Size(); i++)
+	{
+		self[i] = ProfileSelfTime(i);
+		sorted.Push(i);
+	}
+	std::sort(sorted.begin(), sorted.end(), [&](int a, int b) { return self[a] > self[b]; });
+
+	Printf("%10s %10s %10s  %s\n", "self ms", "total ms", "calls", "function");
+	for (unsigned i = 0; i < sorted.Size() && i < count; i++)
+	{
+		auto &n = ProfileNodes[sorted[i]];
+		Printf("%10.3f %10.3f %10u  %s\n", self[sorted[i]], n.Time.TimeMS(), n.Calls, ProfilePath(sorted[i]).GetChars());
+	}
+}
+
+//==========================================================================
+//
+// CCMD vmprofile
+//
+//==========================================================================
+
+CCMD(vmprofile)
+{
+	if (argv.argc() >= 2)
+	{
+		if (stricmp(argv[1], "start") == 0)
+		{
+			ProfileStart();
+			Printf("Script profiling started\n");
+			return;
+		}
+		else if (stricmp(argv[1], "stop") == 0)
+		{
+			ProfileStop();
+			Printf("Script profiling stopped\n");
+			return;
+		}
+		else if (stricmp(argv[1], "list") == 0)
+		{
+			ProfileList(argv.argc() >= 3 ? (unsigned)strtoul(argv[2], nullptr, 10) : 20);
+			return;
+		}
+		else if (stricmp(argv[1], "dump") == 0)
+		{
+			const char *filename = argv.argc() >= 3 ? argv[2] : "vmprofile.folded";
+			if (VMProfiling)
+			{
+				Printf(TEXTCOLOR_ORANGE "Stop profiling before dumping the results.\n");
+			}
+			else if (!ProfileDump(filename))
+			{
+				Printf(TEXTCOLOR_RED "Unable to write %s\n", filename);
+			}
+			else
+			{
+				Printf("Profile written to %s\n", filename);
+			}
+			return;
+		}
+	}
+	Printf("Usage: vmprofile <start|stop|list [count]|dump [filename]>\n");
+}
@@ -1115,6 +1115,30 @@ DEFINE_ACTION_FUNCTION_NATIVE(AActor, LineAttack, ZS_LineAttack)
 	return numret;
 }
 
+static void BeginHitscanBatch(AActor *self)
+{
+	self->Level->blockmap.BeginLineBatch();
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(AActor, BeginHitscanBatch, BeginHitscanBatch)
+{
+	PARAM_SELF_PROLOGUE(AActor);
+	BeginHitscanBatch(self);
+	return 0;
+}
+
+static void EndHitscanBatch(AActor *self)
+{
+	self->Level->blockmap.EndLineBatch();
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(AActor, EndHitscanBatch, EndHitscanBatch)
+{
+	PARAM_SELF_PROLOGUE(AActor);
+	EndHitscanBatch(self);
+	return 0;
+}
+
 static int LineTrace(AActor *self, double angle, double distance, double pitch, int flags, double offsetz, double offsetforward, double offsetside, FLineTraceData *data)
 {
 	return P_LineTrace(self,angle,distance,pitch,flags,offsetz,offsetforward,offsetside,data);
@@ -60,6 +60,7 @@
 #include "cmdlib.h"
 #include "g_levellocals.h"
 #include "utf8.h"
+#include "c_cvars.h"
 
 bool save_full = false;	// for testing. Should be removed afterward.
 
@@ -295,6 +296,7 @@ struct FReader
 {
 	TArray<FJSONObject> mObjects;
 	rapidjson::Document mDoc;
+	TArray<char> mBuffer;		// the parsed text when the document was parsed in place
 	TArray<DObject *> mDObjects;
 	rapidjson::Value *mKeyValue = nullptr;
 	bool mObjectsRead = false;
@@ -305,6 +307,15 @@ struct FReader
 		mObjects.Push(FJSONObject(&mDoc));
 	}
 
+	// Takes over a null-terminated buffer and parses it in place, so that
+	// strings in the document point into it instead of being copied.
+	FReader(TArray<char> &buffer)
+	{
+		mBuffer.Swap(buffer);
+		mDoc.ParseInsitu(mBuffer.Data());
+		mObjects.Push(FJSONObject(&mDoc));
+	}
+
 	rapidjson::Value *FindKey(const char *key)
 	{
 		FJSONObject &obj = mObjects.Last();
@@ -378,16 +389,17 @@ bool FSerializer::OpenReader(FCompressedBuffer *input)
 	if (w != nullptr || r != nullptr) return false;
 
 	mErrors = 0;
+	TArray<char> unpacked(input->mSize + 1, true);
 	if (input->mMethod == METHOD_STORED)
 	{
-		r = new FReader((char*)input->mBuffer, input->mSize);
+		memcpy(unpacked.Data(), input->mBuffer, input->mSize);
 	}
 	else
 	{
-		TArray<char> unpacked(input->mSize);
 		input->Decompress(unpacked.Data());
-		r = new FReader(unpacked.Data(), input->mSize);
 	}
+	unpacked[input->mSize] = 0;
+	r = new FReader(unpacked);
 	return true;
 }
 
@@ -1035,26 +1047,49 @@ const char *FSerializer::GetOutput(unsigned *len)
 
 //==========================================================================
 //
-//
+// Savegames and hub snapshots are compressed on the spot, so this
+// directly affects how long saving and leaving a hub level stall the game.
+// The JSON text barely gets any smaller above zlib's default level.
 //
 //==========================================================================
 
+CUSTOM_CVAR(Int, save_compression, 6, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 1) self = 1;
+	else if (self > 9) self = 9;
+}
+
 FCompressedBuffer FSerializer::GetCompressedOutput()
 {
 	if (isReading()) return{ 0,0,0,0,0,nullptr };
-	FCompressedBuffer buff;
 	WriteObjects();
 	EndObject();
-	buff.mSize = (unsigned)w->mOutString.GetSize();
+	return CompressSerializerOutput(w->mOutString.GetString(), (unsigned)w->mOutString.GetSize(), save_compression);
+}
+
+//==========================================================================
+//
+// CompressSerializerOutput
+//
+// This does not touch any global state, so it can also be used off the
+// main thread with a copy of GetOutput's text. The caller passes in the
+// compression level, normally save_compression read on the main thread.
+//
+//==========================================================================
+
+FCompressedBuffer CompressSerializerOutput(const char *text, unsigned size, int level)
+{
+	FCompressedBuffer buff;
+	buff.mSize = size;
 	buff.mZipFlags = 0;
-	buff.mCRC32 = crc32(0, (const Bytef*)w->mOutString.GetString(), buff.mSize);
+	buff.mCRC32 = crc32(0, (const Bytef*)text, buff.mSize);
 
 	uint8_t *compressbuf = new uint8_t[buff.mSize+1];
 
 	z_stream stream;
 	int err;
 
-	stream.next_in = (Bytef *)w->mOutString.GetString();
+	stream.next_in = (Bytef *)text;
 	stream.avail_in = buff.mSize;
 	stream.next_out = (Bytef*)compressbuf;
 	stream.avail_out = buff.mSize;
@@ -1063,7 +1098,7 @@ FCompressedBuffer FSerializer::GetCompressedOutput()
 	stream.opaque = (voidpf)0;
 
 	// create output in zip-compatible form as required by FCompressedBuffer
-	err = deflateInit2(&stream, 8, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY);
+	err = deflateInit2(&stream, level, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY);
 	if (err != Z_OK)
 	{
 		goto error;
@@ -1088,7 +1123,9 @@ FCompressedBuffer FSerializer::GetCompressedOutput()
 	}
 
 error:
-	memcpy(compressbuf, w->mOutString.GetString(), buff.mSize + 1);
+	memcpy(compressbuf, text, buff.mSize);
+	compressbuf[buff.mSize] = 0;
+	buff.mBuffer = (char *)compressbuf;
 	buff.mCompressedSize = buff.mSize;
 	buff.mMethod = METHOD_STORED;
 	return buff;
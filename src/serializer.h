@@ -185,6 +185,8 @@ public:
 	int mErrors = 0;
 };
 
+FCompressedBuffer CompressSerializerOutput(const char *text, unsigned size, int level);
+
 FSerializer &Serialize(FSerializer &arc, const char *key, bool &value, bool *defval);
 FSerializer &Serialize(FSerializer &arc, const char *key, int64_t &value, int64_t *defval);
 FSerializer &Serialize(FSerializer &arc, const char *key, uint64_t &value, uint64_t *defval);
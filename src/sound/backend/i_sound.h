@@ -110,9 +110,13 @@ public:
 	std::pair<SoundHandle,bool> LoadSoundVoc(uint8_t *sfxdata, int length, bool monoize=false);
 	virtual std::pair<SoundHandle,bool> LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1, bool monoize = false) = 0;
 	virtual std::pair<SoundHandle, bool> LoadSoundBuffered(FSoundLoadBuffer *buffer, bool monoize);
+	// Decodes a compressed sound into buffer for a later LoadSoundBuffered call. This does not touch the device,
+	// so it may be called from any thread. Returns false if the sound has to go through LoadSound instead.
+	virtual bool DecodeSound(uint8_t *sfxdata, int length, FSoundLoadBuffer *buffer) { return false; }
 	virtual void UnloadSound (SoundHandle sfx) = 0;	// unloads a sound from memory
 	virtual unsigned int GetMSLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
 	virtual unsigned int GetSampleLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
+	virtual unsigned int GetSoundBytes(SoundHandle sfx) { return 0; }	// Gets the memory used by a loaded sound
 	virtual float GetOutputRate() = 0;
 
 	// Streaming sounds.
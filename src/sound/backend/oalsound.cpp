@@ -34,6 +34,7 @@
 
 #include <functional>
 #include <chrono>
+#include <mutex>
 
 #include "c_cvars.h"
 #include "templates.h"
@@ -45,6 +46,7 @@
 #include "m_fixed.h"
 #include "zmusic/sounddecoder.h"
 #include "filereadermusicinterface.h"
+#include "stats.h"
 
 
 const char *GetSampleTypeName(SampleType type);
@@ -172,6 +174,13 @@ class OpenALSoundStream : public SoundStream
 	ALsizei SampleRate;
 	ALenum Format;
 	ALsizei FrameSize;
+	int BufferMS;	// play time of one buffer
+
+	// Statistics, guarded by StreamLock like Process itself
+	unsigned Underruns;
+	unsigned Fills;
+	double FillMS;
+	double PeakFillMS;
 
 	static const int BufferCount = 4;
 	ALuint Buffers[BufferCount];
@@ -224,7 +233,7 @@ class OpenALSoundStream : public SoundStream
 
 public:
 	OpenALSoundStream(OpenALSoundRenderer *renderer)
-	  : Renderer(renderer), Source(0), Playing(false), Looping(false), Volume(1.0f)
+	  : Renderer(renderer), BufferMS(100), Underruns(0), Fills(0), FillMS(0), PeakFillMS(0), Source(0), Playing(false), Looping(false), Volume(1.0f)
 	{
 		memset(Buffers, 0, sizeof(Buffers));
 		Renderer->AddStream(this);
@@ -335,6 +344,8 @@ public:
 		ALenum err;
 
 		std::unique_lock<std::mutex> lock(Renderer->StreamLock);
+		unsigned underruns = Underruns;
+		double fillms = Fills > 0 ? FillMS / Fills : 0., peakfillms = PeakFillMS;
 		alGetSourcef(Source, AL_GAIN, &volume);
 		alGetSourcei(Source, AL_SAMPLE_OFFSET, &offset);
 		alGetSourcei(Source, AL_BUFFERS_PROCESSED, &processed);
@@ -360,6 +371,8 @@ public:
 		stats.AppendFormat(", %uHz", SampleRate);
 		if(!Playing)
 			stats += " XX";
+		stats.AppendFormat("\n%d/%d buffers queued, %u underruns, fill %.2f ms avg, %.2f ms peak, %d ms per buffer",
+			queued - processed, BufferCount, underruns, fillms, peakfillms, BufferMS);
 		return stats;
 	}
 
@@ -387,7 +400,16 @@ public:
 			alSourceUnqueueBuffers(Source, 1, &bufid);
 			processed--;
 
-			if(Callback(this, &Data[0], Data.Size(), UserData))
+			cycle_t fill;
+			fill.Reset();
+			fill.Clock();
+			bool filled = Callback(this, &Data[0], Data.Size(), UserData);
+			fill.Unclock();
+			Fills++;
+			FillMS += fill.TimeMS();
+			PeakFillMS = MAX(PeakFillMS, fill.TimeMS());
+
+			if(filled)
 			{
 				alBufferData(bufid, Format, &Data[0], Data.Size(), SampleRate);
 				alSourceQueueBuffers(Source, 1, &bufid);
@@ -405,6 +427,7 @@ public:
 			ok = (getALError() == AL_NO_ERROR) && (queued > 0);
 			if(ok)
 			{
+				Underruns++;
 				alSourcePlay(Source);
 				ok = (getALError()==AL_NO_ERROR);
 			}
@@ -414,6 +437,11 @@ public:
 		return ok;
 	}
 
+	int GetBufferMS() const
+	{
+		return BufferMS;
+	}
+
 	bool Init(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
 	{
 		if(!SetupSource())
@@ -468,6 +496,7 @@ public:
 		buffbytes += FrameSize-1;
 		buffbytes -= buffbytes%FrameSize;
 		Data.Resize(buffbytes);
+		BufferMS = int(int64_t(buffbytes / FrameSize) * 1000 / samplerate);
 
 		return true;
 	}
@@ -888,10 +917,17 @@ void OpenALSoundRenderer::BackgroundProc()
 		}
 		else
 		{
-			// Else, process all active streams and sleep for 100ms
+			// Else, process all active streams and sleep until the stream with
+			// the shortest buffers is halfway through one. A fixed interval
+			// longer than the whole queue would let small-buffered streams
+			// underrun no matter how fast they can be refilled.
+			int waitms = 100;
 			for(size_t i = 0;i < Streams.Size();i++)
+			{
 				Streams[i]->Process();
-			StreamWake.wait_for(lock, std::chrono::milliseconds(100));
+				waitms = MIN(waitms, Streams[i]->GetBufferMS() / 2);
+			}
+			StreamWake.wait_for(lock, std::chrono::milliseconds(MAX(waitms, 5)));
 		}
 	}
 }
@@ -963,6 +999,22 @@ unsigned int OpenALSoundRenderer::GetMSLength(SoundHandle sfx)
 	return 0;
 }
 
+unsigned int OpenALSoundRenderer::GetSoundBytes(SoundHandle sfx)
+{
+	if(sfx.data)
+	{
+		ALuint buffer = GET_PTRID(sfx.data);
+		if(alIsBuffer(buffer))
+		{
+			ALint size;
+			alGetBufferi(buffer, AL_SIZE, &size);
+			if(getALError() == AL_NO_ERROR)
+				return (unsigned int)size;
+		}
+	}
+	return 0;
+}
+
 unsigned int OpenALSoundRenderer::GetSampleLength(SoundHandle sfx)
 {
 	if(sfx.data)
@@ -1200,6 +1252,66 @@ std::pair<SoundHandle,bool> OpenALSoundRenderer::LoadSound(uint8_t *sfxdata, int
 	return std::make_pair(retval, AL.SOFT_source_spatialize || chans == ChannelConfig_Mono || monoize);
 }
 
+//==========================================================================
+//
+// Same decoding as LoadSound without monoizing, minus the buffer creation.
+// The decoder libraries get loaded and initialized when the first decoder
+// is created, so that part is serialized. The actual decoding is not.
+//
+//==========================================================================
+
+bool OpenALSoundRenderer::DecodeSound(uint8_t *sfxdata, int length, FSoundLoadBuffer *pBuffer)
+{
+	static std::mutex decodermutex;
+	uint32_t loop_start = 0, loop_end = ~0u;
+	bool startass = false, endass = false;
+	ChannelConfig chans;
+	SampleType type;
+	int srate;
+
+	auto mreader = new MusicIO::MemoryReader(sfxdata, length);
+	FindLoopTags(mreader, &loop_start, &startass, &loop_end, &endass);
+	mreader->seek(0, SEEK_SET);
+
+	std::unique_ptr<SoundDecoder> decoder;
+	{
+		std::lock_guard<std::mutex> lock(decodermutex);
+		decoder.reset(SoundDecoder::CreateDecoder(mreader));
+		if (!decoder)
+		{
+			delete mreader;
+			return false;
+		}
+		decoder->getInfo(&srate, &chans, &type);
+	}
+
+	// Anything LoadSoundBuffered cannot take is left to LoadSound, which also reports it.
+	if ((chans != ChannelConfig_Mono && chans != ChannelConfig_Stereo) || (type != SampleType_UInt8 && type != SampleType_Int16))
+	{
+		return false;
+	}
+	int samplesize = (chans == ChannelConfig_Stereo ? 2 : 1) * (type == SampleType_Int16 ? 2 : 1);
+
+	pBuffer->mBuffer = decoder->readAll();
+	if (pBuffer->mBuffer.size() == 0)
+	{
+		return false;
+	}
+
+	if (!startass) loop_start = Scale(loop_start, srate, 1000);
+	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
+	const uint32_t samples = (uint32_t)pBuffer->mBuffer.size() / samplesize;
+	if (loop_start > samples) loop_start = 0;
+	if (loop_end > samples) loop_end = samples;
+
+	pBuffer->loop_start = loop_start;
+	pBuffer->loop_end = loop_end;
+	pBuffer->chans = chans;
+	pBuffer->type = type;
+	pBuffer->srate = srate;
+	return true;
+}
+
 std::pair<SoundHandle, bool> OpenALSoundRenderer::LoadSoundBuffered(FSoundLoadBuffer *pBuffer, bool monoize)
 {
 	SoundHandle retval = { NULL };
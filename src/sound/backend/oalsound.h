@@ -127,10 +127,12 @@ public:
 	virtual void SetMusicVolume(float volume);
 	virtual std::pair<SoundHandle, bool> LoadSound(uint8_t *sfxdata, int length, bool monoize, FSoundLoadBuffer *buffer);
 	virtual std::pair<SoundHandle,bool> LoadSoundBuffered(FSoundLoadBuffer *buffer,  bool monoize);
+	virtual bool DecodeSound(uint8_t *sfxdata, int length, FSoundLoadBuffer *buffer);
 	virtual std::pair<SoundHandle,bool> LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1, bool monoize = false);
 	virtual void UnloadSound(SoundHandle sfx);
 	virtual unsigned int GetMSLength(SoundHandle sfx);
 	virtual unsigned int GetSampleLength(SoundHandle sfx);
+	virtual unsigned int GetSoundBytes(SoundHandle sfx);
 	virtual float GetOutputRate();
 
 	// Streaming sounds.
@@ -200,6 +200,14 @@ CUSTOM_CVAR(Int, fluid_chorus_type, 0/*FLUID_CHORUS_DEFAULT_TYPE*/, CVAR_ARCHIVE
 	FORWARD_CVAR(fluid_chorus_type);
 }
 
+// Loads the soundfont's samples only when a preset gets selected. This makes starting a song with a
+// large soundfont much faster, but a program change in the middle of a song then loads samples on
+// the streaming thread, which can make the music stutter.
+CUSTOM_CVAR(Bool, fluid_dynamic_samples, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_VIRTUAL)
+{
+	FORWARD_BOOL_CVAR(fluid_dynamic_samples);
+}
+
 
 //==========================================================================
 //
@@ -65,6 +65,9 @@
 #include "vm.h"
 #include "g_game.h"
 #include "s_music.h"
+#include "files.h"
+#include "i_time.h"
+#include "stats.h"
 
 // PUBLIC DATA DEFINITIONS -------------------------------------------------
 
@@ -75,6 +78,34 @@ CUSTOM_CVAR(Int, snd_channels, 128, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// number
 	if (self < 64) self = 64;
 }
 CVAR(Bool, snd_waterreverb, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CUSTOM_CVAR(Int, snd_cachebudget, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// in MB, 0 means unlimited
+{
+	if (self < 0) self = 0;
+	else if (soundEngine) soundEngine->SetCacheBudget(size_t(self) << 20);
+}
+
+// Writes the sound engine's timings of every frame to this file, as CSV.
+static FileWriter *TimingLog;
+CUSTOM_CVAR(String, snd_timinglog, "", 0)
+{
+	if (TimingLog != nullptr)
+	{
+		delete TimingLog;
+		TimingLog = nullptr;
+	}
+	if (*self != 0)
+	{
+		TimingLog = FileWriter::Open(self);
+		if (TimingLog == nullptr)
+		{
+			Printf(TEXTCOLOR_RED "Unable to write %s\n", *self);
+		}
+		else
+		{
+			TimingLog->Printf("msecs,update ms,starts,start ms,dmx ms,raw ms,voc ms,decode ms,upload ms\n");
+		}
+	}
+}
 
 
 static FString LastLocalSndInfo;
@@ -87,6 +118,7 @@ class DoomSoundEngine : public SoundEngine
 	void CalcPosVel(int type, const void* source, const float pt[3], int channum, int chanflags, FVector3* pos, FVector3* vel) override;
 	bool ValidatePosVel(int sourcetype, const void* source, const FVector3& pos, const FVector3& vel);
 	TArray<uint8_t> ReadSound(int lumpnum);
+	void PrefetchSounds(const TArray<int> &lumps) override;
 	int PickReplacement(int refid);
 
 public:
@@ -109,6 +141,7 @@ void S_Init()
 	if (!soundEngine)
 	{
 		soundEngine = new DoomSoundEngine;
+		soundEngine->SetCacheBudget(size_t(*snd_cachebudget) << 20);
 	}
 
 	I_InitSound();
@@ -617,6 +650,7 @@ static void S_SetListener(AActor *listenactor)
 
 void S_UpdateSounds (AActor *listenactor)
 {
+	FTraceZone zone("S_UpdateSounds");
 	// should never happen
 	S_SetListener(listenactor);
 	
@@ -626,6 +660,18 @@ void S_UpdateSounds (AActor *listenactor)
 	}
 
 	soundEngine->UpdateSounds(primaryLevel->time);
+
+	if (TimingLog != nullptr)
+	{
+		// These are the timings of the frame UpdateSounds just finished collecting.
+		TimingLog->Printf("%llu", (unsigned long long)I_msTime());
+		for (int i = 0; i < NUM_SOUNDTIMINGS; i++)
+		{
+			if (i == STIME_Start) TimingLog->Printf(",%d", soundEngine->GetLastCount(STIME_Start));
+			TimingLog->Printf(",%.3f", soundEngine->GetLastTime(ESoundTiming(i)));
+		}
+		TimingLog->Printf("\n");
+	}
 }
 
 //==========================================================================
@@ -718,6 +764,7 @@ void S_SerializeSounds(FSerializer &arc)
 			}
 			arc.EndArray();
 		}
+		soundEngine->RecountChannels();
 		// The two tic delay is to make sure any screenwipes have finished.
 		// This needs to be two because the game is run for one tic before
 		// the wipe so that it can produce a screen to wipe to. So if we
@@ -1027,6 +1074,11 @@ TArray<uint8_t> DoomSoundEngine::ReadSound(int lumpnum)
 	return wlump.Read();
 }
 
+void DoomSoundEngine::PrefetchSounds(const TArray<int> &lumps)
+{
+	Wads.PrefetchLumps(lumps);
+}
+
 //==========================================================================
 //
 // S_PickReplacement
@@ -1397,3 +1449,13 @@ ADD_STAT (sound)
 {
 	return GSnd->GatherStats ();
 }
+
+ADD_STAT (sounds)
+{
+	return soundEngine ? soundEngine->GetCacheStats() : FString();
+}
+
+ADD_STAT (soundtimes)
+{
+	return soundEngine ? soundEngine->GetTimingStats() : FString();
+}
@@ -446,6 +446,11 @@ ReverbContainer *DefaultEnvironments[26] =
 
 ReverbContainer *Environments = &Off;
 
+// Lookup table for S_FindEnvironment. Gets rebuilt on the next lookup
+// whenever the environment list changes.
+static TMap<int, ReverbContainer *> EnvironmentIndex;
+static bool EnvironmentIndexValid;
+
 ReverbContainer *S_FindEnvironment (const char *name)
 {
 	ReverbContainer *probe = Environments;
@@ -466,13 +471,17 @@ ReverbContainer *S_FindEnvironment (const char *name)
 
 ReverbContainer *S_FindEnvironment (int id)
 {
-	ReverbContainer *probe = Environments;
-
-	while (probe != NULL && probe->ID < id)
+	if (!EnvironmentIndexValid)
 	{
-		probe = probe->Next;
+		EnvironmentIndex.Clear();
+		for (ReverbContainer *probe = Environments; probe != NULL; probe = probe->Next)
+		{
+			EnvironmentIndex[probe->ID] = probe;
+		}
+		EnvironmentIndexValid = true;
 	}
-	return (probe && probe->ID == id ? probe : NULL);
+	ReverbContainer **probe = EnvironmentIndex.CheckKey(id);
+	return probe != NULL ? *probe : NULL;
 }
 
 void S_AddEnvironment (ReverbContainer *settings)
@@ -480,6 +489,7 @@ void S_AddEnvironment (ReverbContainer *settings)
 	ReverbContainer *probe = Environments;
 	ReverbContainer **ptr = &Environments;
 
+	EnvironmentIndexValid = false;
 	while (probe != NULL && probe->ID < settings->ID)
 	{
 		ptr = &probe->Next;
@@ -627,5 +637,6 @@ void S_UnloadReverbDef ()
 		probe = next;
 	}
 	Environments = &Off;
+	EnvironmentIndexValid = false;
 }
 
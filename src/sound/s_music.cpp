@@ -87,6 +87,7 @@
 #include "s_music.h"
 #include "filereadermusicinterface.h"
 #include "zmusic/zmusic.h"
+#include "stats.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -164,6 +165,11 @@ void S_StopStream()
 	}
 }
 
+ADD_STAT(musicstream)
+{
+	return musicStream ? musicStream->GetStats() : FString("No music stream");
+}
+
 
 //==========================================================================
 //
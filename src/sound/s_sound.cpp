@@ -35,6 +35,10 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 #ifdef _WIN32
 #include <io.h>
 #endif
@@ -66,6 +70,7 @@ void SoundEngine::Init(TArray<uint8_t> &curve)
 		ReturnChannel(Channels);
 	}
 	S_SoundCurve = std::move(curve);
+	for (auto &cycles : TimingCycles) cycles.Reset();
 }
 
 //==========================================================================
@@ -130,6 +135,18 @@ void SoundEngine::CacheMarkedSounds()
 		MarkUsed(chan->SoundID);
 	}
 
+	// Get the data of everything that still needs to be loaded on its way first.
+	TArray<int> lumps;
+	for (unsigned i = 1; i < S_sfx.Size(); ++i)
+	{
+		if (S_sfx[i].bUsed && !S_sfx[i].data.isValid() && S_sfx[i].link == sfxinfo_t::NO_LINK && S_sfx[i].lumpnum >= 0)
+		{
+			lumps.Push(S_sfx[i].lumpnum);
+		}
+	}
+	PrefetchSounds(lumps);
+	DecodeMarkedSounds();
+
 	for (unsigned i = 1; i < S_sfx.Size(); ++i)
 	{
 		if (S_sfx[i].bUsed)
@@ -146,6 +163,89 @@ void SoundEngine::CacheMarkedSounds()
 	}
 }
 
+//==========================================================================
+//
+// DecodeMarkedSounds
+//
+// Decodes the compressed sounds CacheMarkedSounds is about to load on
+// worker threads, then creates their buffers on this thread. VOC, raw and
+// DMX sounds, and anything the renderer refuses to decode this way, are
+// left to the regular CacheSound path. Batching keeps the memory held by
+// decoded data in check.
+//
+//==========================================================================
+
+void SoundEngine::DecodeMarkedSounds()
+{
+	struct PendingSound
+	{
+		sfxinfo_t *sfx;
+		TArray<uint8_t> data;
+		FSoundLoadBuffer buffer;
+		bool decoded;
+	};
+
+	const unsigned batchsize = 64;
+	unsigned numthreads = std::min(std::thread::hardware_concurrency(), 8u);
+	if (GSnd == nullptr || GSnd->IsNull() || numthreads < 2) return;
+
+	TMap<int, bool> queuedlumps;
+	std::vector<PendingSound> pending;
+	unsigned next = 1;
+	while (next < S_sfx.Size())
+	{
+		pending.clear();
+		for (; next < S_sfx.Size() && pending.size() < batchsize; next++)
+		{
+			sfxinfo_t *sfx = &S_sfx[next];
+			if (!sfx->bUsed || sfx->bPlayerReserve) continue;
+			while (!sfx->bRandomHeader && sfx->link != sfxinfo_t::NO_LINK)
+			{
+				sfx = &S_sfx[sfx->link];
+			}
+			if (sfx->bRandomHeader || sfx->bLoadRAW || sfx->data.isValid() || sfx->lumpnum < 0 || queuedlumps.CheckKey(sfx->lumpnum)) continue;
+			queuedlumps[sfx->lumpnum] = true;
+
+			auto data = ReadSound(sfx->lumpnum);
+			int size = data.Size();
+			if (size <= 8 || strncmp((const char *)data.Data(), "Creative Voice File", 19) == 0) continue;
+			int32_t dmxlen = LittleLong(((int32_t *)data.Data())[1]);
+			if (data[0] == 3 && data[1] == 0 && dmxlen <= size - 8) continue;
+
+			pending.push_back({ sfx, std::move(data), {}, false });
+		}
+		if (pending.size() == 0) continue;
+
+		std::atomic<unsigned> nextdecode(0);
+		auto decode = [&]()
+		{
+			for (unsigned i = nextdecode++; i < pending.size(); i = nextdecode++)
+			{
+				pending[i].decoded = GSnd->DecodeSound(pending[i].data.Data(), pending[i].data.Size(), &pending[i].buffer);
+			}
+		};
+		std::vector<std::thread> threads;
+		for (unsigned i = 1; i < std::min<size_t>(numthreads, pending.size()); i++)
+		{
+			threads.push_back(std::thread(decode));
+		}
+		decode();
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		for (auto &p : pending)
+		{
+			if (p.decoded)
+			{
+				LoadSound(p.sfx, &p.buffer);
+				LoadSound3D(p.sfx, &p.buffer);
+			}
+		}
+	}
+}
+
 //==========================================================================
 //
 // S_CacheSound
@@ -194,6 +294,152 @@ void SoundEngine::UnloadSound (sfxinfo_t *sfx)
 		GSnd->UnloadSound(sfx->data);
 	sfx->data.Clear();
 	sfx->data3d.Clear();
+	UpdateResidentBytes(sfx);
+}
+
+//==========================================================================
+//
+// UpdateResidentBytes
+//
+//==========================================================================
+
+void SoundEngine::UpdateResidentBytes(sfxinfo_t *sfx)
+{
+	unsigned int bytes = 0;
+	if (sfx->data.isValid())
+		bytes += GSnd->GetSoundBytes(sfx->data);
+	if (sfx->data3d.isValid() && sfx->data3d != sfx->data)
+		bytes += GSnd->GetSoundBytes(sfx->data3d);
+	ResidentBytes = ResidentBytes - sfx->ResidentBytes + bytes;
+	sfx->ResidentBytes = bytes;
+}
+
+//==========================================================================
+//
+// EvictSounds
+//
+// Unloads the least recently used sounds until the loaded ones fit into
+// the cache budget again. Anything a channel still refers to, including
+// evicted looping channels that may get restarted later, is kept.
+//
+//==========================================================================
+
+void SoundEngine::EvictSounds()
+{
+	TArray<bool> playing;
+	playing.Resize(S_sfx.Size());
+	memset(playing.Data(), 0, playing.Size() * sizeof(bool));
+	for (FSoundChan* chan = Channels; chan != nullptr; chan = chan->NextChan)
+	{
+		for (unsigned int id : { (unsigned int)chan->SoundID, (unsigned int)chan->OrgID })
+		{
+			while (id < S_sfx.Size() && !playing[id])
+			{
+				playing[id] = true;
+				if (S_sfx[id].bRandomHeader || S_sfx[id].link == sfxinfo_t::NO_LINK) break;
+				id = S_sfx[id].link;
+			}
+		}
+	}
+
+	TArray<sfxinfo_t*> candidates;
+	for (unsigned i = 1; i < S_sfx.Size(); ++i)
+	{
+		if (S_sfx[i].ResidentBytes > 0 && !playing[i])
+		{
+			candidates.Push(&S_sfx[i]);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](sfxinfo_t *a, sfxinfo_t *b) { return a->LastUsed < b->LastUsed; });
+
+	for (unsigned i = 0; i < candidates.Size() && ResidentBytes > CacheBudget; ++i)
+	{
+		UnloadSound(candidates[i]);
+		CacheEvictions++;
+	}
+}
+
+//==========================================================================
+//
+// GetCacheStats
+//
+//==========================================================================
+
+FString SoundEngine::GetCacheStats()
+{
+	unsigned int count = 0;
+	for (unsigned i = 1; i < S_sfx.Size(); ++i)
+	{
+		if (S_sfx[i].ResidentBytes > 0) count++;
+	}
+	FString out;
+	out.Format("%u sounds loaded, %.1f MB", count, ResidentBytes / (1024. * 1024.));
+	if (CacheBudget > 0) out.AppendFormat(", budget %.1f MB", CacheBudget / (1024. * 1024.));
+	out.AppendFormat(", %u evicted", CacheEvictions);
+	return out;
+}
+
+//==========================================================================
+//
+// SoundTimer
+//
+// Times one call for the sound timing stats.
+//
+//==========================================================================
+
+struct SoundTimer
+{
+	cycle_t &Cycles;
+	SoundTimer(cycle_t &cycles, int &count) : Cycles(cycles) { count++; Cycles.Clock(); }
+	~SoundTimer() { Cycles.Unclock(); }
+};
+
+//==========================================================================
+//
+// EndTimingFrame
+//
+// Called once per UpdateSounds to move the timings collected since the
+// last call into the history.
+//
+//==========================================================================
+
+void SoundEngine::EndTimingFrame()
+{
+	for (int i = 0; i < NUM_SOUNDTIMINGS; i++)
+	{
+		LastTimes[i] = TimingCycles[i].TimeMS();
+		LastCounts[i] = TimingCounts[i];
+		TimingHistory[i][TimingHistoryPos] = LastTimes[i];
+		TimingCycles[i].Reset();
+		TimingCounts[i] = 0;
+	}
+	TimingHistoryPos = (TimingHistoryPos + 1) % TimingHistorySize;
+	TimingHistoryCount = std::min(TimingHistoryCount + 1, (int)TimingHistorySize);
+}
+
+//==========================================================================
+//
+// GetTimingStats
+//
+//==========================================================================
+
+FString SoundEngine::GetTimingStats()
+{
+	static const char *names[NUM_SOUNDTIMINGS] = { "update", "start", "dmx", "raw", "voc", "decode", "upload" };
+
+	FString out = "timing       last   calls    average       peak\n";
+	for (int i = 0; i < NUM_SOUNDTIMINGS; i++)
+	{
+		double sum = 0, peak = 0;
+		for (int j = 0; j < TimingHistoryCount; j++)
+		{
+			sum += TimingHistory[i][j];
+			peak = std::max(peak, TimingHistory[i][j]);
+		}
+		out.AppendFormat("%-8s %6.2f ms  %6d  %6.2f ms  %6.2f ms\n", names[i], LastTimes[i], LastCounts[i],
+			TimingHistoryCount > 0 ? sum / TimingHistoryCount : 0., peak);
+	}
+	return out;
 }
 
 //==========================================================================
@@ -233,11 +479,61 @@ FSoundChan *SoundEngine::GetChannel(void *syschan)
 
 void SoundEngine::ReturnChannel(FSoundChan *chan)
 {
+	CountChannel(chan, -1);
 	UnlinkChannel(chan);
 	memset(chan, 0, sizeof(*chan));
 	LinkChannel(chan, &FreeChannels);
 }
 
+//==========================================================================
+//
+// S_CountChannel
+//
+// Keeps the per-sound channel counts used by CheckSingular and
+// CheckSoundLimit in sync. Must be called once a channel's sound IDs
+// are set and again right before it is returned to the free pool.
+//
+//==========================================================================
+
+void SoundEngine::CountChannel(FSoundChan *chan, int delta)
+{
+	auto count = [=](TArray<int> &counts, int id)
+	{
+		if (id <= 0) return;
+		if ((unsigned)id >= counts.Size())
+		{
+			if (delta < 0) return;
+			unsigned oldsize = counts.Size();
+			counts.Resize(std::max<unsigned>(id + 1, S_sfx.Size()));
+			for (unsigned i = oldsize; i < counts.Size(); i++) counts[i] = 0;
+		}
+		counts[id] += delta;
+	};
+	count(ChannelsBySound, chan->SoundID);
+	count(ChannelsByOrgSound, chan->OrgID);
+}
+
+//==========================================================================
+//
+// S_RecountChannels
+//
+// Rebuilds the per-sound channel counts from scratch, for code that fills
+// in channels directly, like restoring them from a savegame.
+//
+//==========================================================================
+
+void SoundEngine::RecountChannels()
+{
+	ChannelsBySound.Resize(S_sfx.Size());
+	ChannelsByOrgSound.Resize(S_sfx.Size());
+	for (auto &c : ChannelsBySound) c = 0;
+	for (auto &c : ChannelsByOrgSound) c = 0;
+	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+	{
+		CountChannel(chan, 1);
+	}
+}
+
 //==========================================================================
 //
 // S_UnlinkChannel
@@ -371,6 +667,8 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 	if (sound_id <= 0 || volume <= 0 || nosfx || nosound )
 		return NULL;
 
+	SoundTimer timer(TimingCycles[STIME_Start], TimingCounts[STIME_Start]);
+
 	// prevent crashes.
 	if (type == SOURCE_Unattached && pt == nullptr) type = SOURCE_None;
 
@@ -597,6 +895,7 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 	{
 		chan->SoundID = sound_id;
 		chan->OrgID = FSoundID(org_id);
+		CountChannel(chan, 1);
 		chan->EntChannel = channel;
 		chan->Volume = float(volume);
 		chan->ChanFlags |= chanflags;
@@ -678,6 +977,7 @@ void SoundEngine::RestartChannel(FSoundChan *chan)
 
         LoadSound3D(sfx, &SoundBuffer);
 		chan->ChanFlags &= ~(CHAN_EVICTED|CHAN_ABSTIME);
+		chan->ParamsSent = false;	// this gets a new source
         ochan = (FSoundChan*)GSnd->StartSound3D(sfx->data3d, &listener, chan->Volume, &chan->Rolloff, chan->DistanceScale, chan->Pitch,
             chan->Priority, pos, vel, chan->EntChannel, startflags, chan);
 	}
@@ -726,12 +1026,26 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 				// This is necessary to avoid using the rolloff settings of the linked sound if its
 				// settings are different.
 				if (sfx->Rolloff.MinDistance == 0) sfx->Rolloff = S_Rolloff;
+				S_sfx[i].LastUsed = ++LoadCounter;
 				return &S_sfx[i];
 			}
 		}
 
 		//DPrintf(DMSG_NOTIFY, "Loading sound \"%s\" (%td)\n", sfx->name.GetChars(), sfx - &S_sfx[0]);
 
+		// Already decoded by DecodeMarkedSounds.
+		if (pBuffer != nullptr && pBuffer->mBuffer.size() > 0)
+		{
+			SoundTimer timer(TimingCycles[STIME_LoadUpload], TimingCounts[STIME_LoadUpload]);
+			auto snd = GSnd->LoadSoundBuffered(pBuffer, false);
+			sfx->data = snd.first;
+			if (snd.second)
+				sfx->data3d = sfx->data;
+			if (sfx->data.isValid())
+				break;
+			pBuffer->mBuffer.clear();
+		}
+
 		auto sfxdata = ReadSound(sfx->lumpnum);
 		int size = sfxdata.Size();
 		if (size > 8)
@@ -742,16 +1056,19 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 			// If the sound is voc, use the custom loader.
 			if (strncmp ((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0)
 			{
+				SoundTimer timer(TimingCycles[STIME_LoadVOC], TimingCounts[STIME_LoadVOC]);
 				snd = GSnd->LoadSoundVoc(sfxdata.Data(), size);
 			}
 			// If the sound is raw, just load it as such.
 			else if (sfx->bLoadRAW)
 			{
+				SoundTimer timer(TimingCycles[STIME_LoadRaw], TimingCounts[STIME_LoadRaw]);
 				snd = GSnd->LoadSoundRaw(sfxdata.Data(), size, sfx->RawRate, 1, 8, sfx->LoopStart);
 			}
 			// Otherwise, try the sound as DMX format.
 			else if (((uint8_t *)sfxdata.Data())[0] == 3 && ((uint8_t *)sfxdata.Data())[1] == 0 && dmxlen <= size - 8)
 			{
+				SoundTimer timer(TimingCycles[STIME_LoadDMX], TimingCounts[STIME_LoadDMX]);
 				int frequency = LittleShort(((uint16_t *)sfxdata.Data())[1]);
 				if (frequency == 0) frequency = 11025;
 				snd = GSnd->LoadSoundRaw(sfxdata.Data()+8, dmxlen, frequency, 1, 8, sfx->LoopStart);
@@ -759,6 +1076,7 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 			// If that fails, let the sound system try and figure it out.
 			else
 			{
+				SoundTimer timer(TimingCycles[STIME_LoadDecoded], TimingCounts[STIME_LoadDecoded]);
 				snd = GSnd->LoadSound(sfxdata.Data(), size, false, pBuffer);
 			}
 
@@ -777,6 +1095,8 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 		}
 		break;
 	}
+	UpdateResidentBytes(sfx);
+	sfx->LastUsed = ++LoadCounter;
 	return sfx;
 }
 
@@ -793,6 +1113,7 @@ void SoundEngine::LoadSound3D(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 
 	if (pBuffer->mBuffer.size() > 0)
 	{
+		SoundTimer timer(TimingCycles[STIME_LoadUpload], TimingCounts[STIME_LoadUpload]);
 		snd = GSnd->LoadSoundBuffered(pBuffer, true);
 	}
 	else
@@ -805,16 +1126,19 @@ void SoundEngine::LoadSound3D(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 		// If the sound is voc, use the custom loader.
 		if (strncmp((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0)
 		{
+			SoundTimer timer(TimingCycles[STIME_LoadVOC], TimingCounts[STIME_LoadVOC]);
 			snd = GSnd->LoadSoundVoc(sfxdata.Data(), size, true);
 		}
 		// If the sound is raw, just load it as such.
 		else if (sfx->bLoadRAW)
 		{
+			SoundTimer timer(TimingCycles[STIME_LoadRaw], TimingCounts[STIME_LoadRaw]);
 			snd = GSnd->LoadSoundRaw(sfxdata.Data(), size, sfx->RawRate, 1, 8, sfx->LoopStart, true);
 		}
 		// Otherwise, try the sound as DMX format.
 		else if (((uint8_t *)sfxdata.Data())[0] == 3 && ((uint8_t *)sfxdata.Data())[1] == 0 && dmxlen <= size - 8)
 		{
+			SoundTimer timer(TimingCycles[STIME_LoadDMX], TimingCounts[STIME_LoadDMX]);
 			int frequency = LittleShort(((uint16_t *)sfxdata.Data())[1]);
 			if (frequency == 0) frequency = 11025;
 			snd = GSnd->LoadSoundRaw(sfxdata.Data() + 8, dmxlen, frequency, 1, 8, sfx->LoopStart, -1, true);
@@ -822,11 +1146,13 @@ void SoundEngine::LoadSound3D(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 		// If that fails, let the sound system try and figure it out.
 		else
 		{
+			SoundTimer timer(TimingCycles[STIME_LoadDecoded], TimingCounts[STIME_LoadDecoded]);
 			snd = GSnd->LoadSound(sfxdata.Data(), size, true, pBuffer);
 		}
 	}
 
 	sfx->data3d = snd.first;
+	UpdateResidentBytes(sfx);
 }
 
 //==========================================================================
@@ -839,14 +1165,7 @@ void SoundEngine::LoadSound3D(sfxinfo_t *sfx, FSoundLoadBuffer *pBuffer)
 
 bool SoundEngine::CheckSingular(int sound_id)
 {
-	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
-	{
-		if (chan->OrgID == sound_id)
-		{
-			return true;
-		}
-	}
-	return false;
+	return (unsigned)sound_id < ChannelsByOrgSound.Size() && ChannelsByOrgSound[sound_id] > 0;
 }
 
 //==========================================================================
@@ -871,6 +1190,13 @@ bool SoundEngine::CheckSoundLimit(sfxinfo_t *sfx, const FVector3 &pos, int near_
 {
 	FSoundChan *chan;
 	int count;
+
+	// There cannot be enough copies nearby if there aren't enough playing at all.
+	unsigned sound_id = unsigned(sfx - &S_sfx[0]);
+	if (sound_id >= ChannelsBySound.Size() || ChannelsBySound[sound_id] < near_limit)
+	{
+		return false;
+	}
 	
 	for (chan = Channels, count = 0; chan != NULL && count < near_limit; chan = chan->NextChan)
 	{
@@ -1229,15 +1555,33 @@ void SoundEngine::UpdateSounds(int time)
 {
 	FVector3 pos, vel;
 
+	EndTimingFrame();
+	SoundTimer timer(TimingCycles[STIME_Update], TimingCounts[STIME_Update]);
+
+	// The backend's source parameters only depend on the source's and the
+	// listener's position, so stationary sources need no update until the
+	// listener moves.
+	bool listenermoved = listener.position != LastListenerPos;
+	LastListenerPos = listener.position;
+
 	for (FSoundChan* chan = Channels; chan != NULL; chan = chan->NextChan)
 	{
 		if ((chan->ChanFlags & (CHAN_EVICTED | CHAN_IS3D)) == CHAN_IS3D)
 		{
 			CalcPosVel(chan, &pos, &vel);
 
+			if (!listenermoved && chan->ParamsSent && pos == chan->LastPos && vel == chan->LastVel)
+			{
+				chan->ChanFlags &= ~CHAN_JUSTSTARTED;
+				continue;
+			}
+
 			if (ValidatePosVel(chan, pos, vel))
 			{
 				GSnd->UpdateSoundParams3D(&listener, chan, !!(chan->ChanFlags & CHAN_AREA), pos, vel);
+				chan->ParamsSent = true;
+				chan->LastPos = pos;
+				chan->LastVel = vel;
 			}
 		}
 		chan->ChanFlags &= ~CHAN_JUSTSTARTED;
@@ -1246,6 +1590,11 @@ void SoundEngine::UpdateSounds(int time)
 	GSnd->UpdateListener(&listener);
 	GSnd->UpdateSounds();
 
+	if (CacheBudget > 0 && ResidentBytes > CacheBudget)
+	{
+		EvictSounds();
+	}
+
 	if (time >= RestartEvictionsAt)
 	{
 		RestartEvictionsAt = 0;
@@ -1497,6 +1846,8 @@ int SoundEngine::AddSoundLump(const char* logicalname, int lump, int CurrentPitc
 
 	newsfx.data.Clear();
 	newsfx.data3d.Clear();
+	newsfx.ResidentBytes = 0;
+	newsfx.LastUsed = 0;
 	newsfx.name = logicalname;
 	newsfx.lumpnum = lump;
 	newsfx.next = 0;
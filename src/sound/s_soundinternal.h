@@ -1,6 +1,7 @@
 #pragma once
 
 #include "i_sound.h"
+#include "stats.h"
 
 struct FRandomSoundList
 {
@@ -48,6 +49,9 @@ struct sfxinfo_t
 
 	int			LoopStart;				// -1 means no specific loop defined
 
+	unsigned int ResidentBytes;			// Memory used by data and data3d
+	int			LastUsed;				// Load counter value of the last LoadSound call, for evicting the least recently used sounds
+
 	unsigned int link;
 	enum { NO_LINK = 0xffffffff };
 
@@ -144,6 +148,9 @@ struct FSoundChan : public FISoundChannel
 	int16_t		NearLimit;
 	uint8_t		SourceType;
 	float		LimitRange;
+	bool		ParamsSent;	// LastPos and LastVel have been passed to the sound backend.
+	FVector3	LastPos;
+	FVector3	LastVel;
 	union
 	{
 		const void *Source;
@@ -226,12 +233,26 @@ ReverbContainer *S_FindEnvironment (const char *name);
 ReverbContainer *S_FindEnvironment (int id);
 void S_AddEnvironment (ReverbContainer *settings);
 	
+// What the sound engine's timings are collected for.
+enum ESoundTiming
+{
+	STIME_Update,		// UpdateSounds
+	STIME_Start,		// StartSound, including loading the sound
+	STIME_LoadDMX,		// loading sounds by format
+	STIME_LoadRaw,
+	STIME_LoadVOC,
+	STIME_LoadDecoded,
+	STIME_LoadUpload,	// uploading sounds decoded at level load
+	NUM_SOUNDTIMINGS
+};
+
 class SoundEngine
 {
 protected:
 	bool SoundPaused = false;		// whether sound is paused
 	int RestartEvictionsAt = 0;	// do not restart evicted channels before this time
 	SoundListener listener{};
+	FVector3 LastListenerPos = {};	// listener position at the last UpdateSounds
 
 	FSoundChan* Channels = nullptr;
 	FSoundChan* FreeChannels = nullptr;
@@ -243,11 +264,30 @@ protected:
 	TMap<int, int> ResIdMap;
 	TArray<FRandomSoundList> S_rnd;
 
+	size_t ResidentBytes = 0;		// Memory used by all loaded sounds
+	size_t CacheBudget = 0;			// 0 means unlimited
+	unsigned int CacheEvictions = 0;
+	int LoadCounter = 0;
+
+	// Timings of the current frame, and of the last ones for the stats.
+	enum { TimingHistorySize = 64 };
+	cycle_t TimingCycles[NUM_SOUNDTIMINGS];
+	int TimingCounts[NUM_SOUNDTIMINGS] = {};
+	double LastTimes[NUM_SOUNDTIMINGS] = {};
+	int LastCounts[NUM_SOUNDTIMINGS] = {};
+	double TimingHistory[NUM_SOUNDTIMINGS][TimingHistorySize] = {};
+	int TimingHistoryPos = 0, TimingHistoryCount = 0;
+
+	// Number of channels in the Channels list per sound, indexed by sound ID.
+	TArray<int> ChannelsBySound;
+	TArray<int> ChannelsByOrgSound;
+
 private:
 	void LoadSound3D(sfxinfo_t* sfx, FSoundLoadBuffer* pBuffer);
 	void LinkChannel(FSoundChan* chan, FSoundChan** head);
 	void UnlinkChannel(FSoundChan* chan);
 	void ReturnChannel(FSoundChan* chan);
+	void CountChannel(FSoundChan* chan, int delta);
 	void RestartChannel(FSoundChan* chan);
 	void RestoreEvictedChannel(FSoundChan* chan);
 
@@ -262,7 +302,11 @@ private:
 	// Checks if a copy of this sound is already playing.
 	bool CheckSingular(int sound_id);
 	bool CheckSoundLimit(sfxinfo_t* sfx, const FVector3& pos, int near_limit, float limit_range, int sourcetype, const void* actor, int channel);
+	void UpdateResidentBytes(sfxinfo_t* sfx);
+	void EndTimingFrame();
+	void EvictSounds();
 	virtual TArray<uint8_t> ReadSound(int lumpnum) = 0;
+	virtual void PrefetchSounds(const TArray<int> &lumps) {}
 
 public:
 	virtual ~SoundEngine() = default;
@@ -284,6 +328,7 @@ public:
 	void SetPitch(FSoundChan* chan, float dpitch);
 
 	FSoundChan* GetChannel(void* syschan);
+	void RecountChannels();
 	void RestoreEvictedChannels();
 	void CalcPosVel(FSoundChan* chan, FVector3* pos, FVector3* vel);
 
@@ -294,6 +339,13 @@ public:
 
 	void UpdateSounds(int time);
 
+	// Sounds beyond this many bytes get unloaded, least recently used first, unless they are playing.
+	void SetCacheBudget(size_t bytes) { CacheBudget = bytes; }
+	FString GetCacheStats();
+	FString GetTimingStats();
+	double GetLastTime(ESoundTiming timing) const { return LastTimes[timing]; }
+	int GetLastCount(ESoundTiming timing) const { return LastCounts[timing]; }
+
 	FSoundChan* StartSound(int sourcetype, const void* source,
 		const FVector3* pt, int channel, FSoundID sound_id, float volume, float attenuation, FRolloffInfo* rolloff = nullptr, float spitch = 0.0f);
 
@@ -312,6 +364,7 @@ public:
 	void Reset();
 	void MarkUsed(int num);
 	void CacheMarkedSounds();
+	void DecodeMarkedSounds();
 	TArray<FSoundChan*> AllActiveChannels();
 
 	void MarkAllUnused()
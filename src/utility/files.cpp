@@ -33,6 +33,16 @@
 **
 */
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "files.h"
 #include "templates.h"
 
@@ -348,6 +358,77 @@ public:
 
 
 
+//==========================================================================
+//
+// MappedFileReader
+//
+// reads data from a file that has been mapped into memory. Since this
+// exposes its buffer, archives opened through it can hand out pointers
+// into the mapping for their uncompressed lumps instead of copying them.
+//
+//==========================================================================
+
+class MappedFileReader : public MemoryReader
+{
+#ifdef _WIN32
+	HANDLE hFile = INVALID_HANDLE_VALUE;
+	HANDLE hMapping = nullptr;
+#endif
+
+public:
+	~MappedFileReader()
+	{
+#ifdef _WIN32
+		if (bufptr != nullptr) UnmapViewOfFile(bufptr);
+		if (hMapping != nullptr) CloseHandle(hMapping);
+		if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+#else
+		if (bufptr != nullptr) munmap(const_cast<char *>(bufptr), Length);
+#endif
+	}
+
+	bool Open(const char *filename)
+	{
+#ifdef _WIN32
+		hFile = CreateFileW(WideString(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(hFile, &size) || !CanMap(size.QuadPart)) return false;
+		hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (hMapping == nullptr) return false;
+		bufptr = (const char *)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (bufptr == nullptr) return false;
+#else
+		int fd = open(filename, O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || !CanMap(info.st_size))
+		{
+			close(fd);
+			return false;
+		}
+		void *mem = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);	// the mapping stays valid without the descriptor
+		if (mem == MAP_FAILED) return false;
+		bufptr = (const char *)mem;
+#endif
+		FilePos = 0;
+		return true;
+	}
+
+private:
+	bool CanMap(int64_t size)
+	{
+		// Empty files cannot be mapped, and on 32 bit systems large files would eat
+		// up too much of the address space, so those stay with regular file access.
+		if (size <= 0 || size > (sizeof(void *) >= 8 ? 0x7fffffff : 0x10000000)) return false;
+		Length = (long)size;
+		return true;
+	}
+};
+
 //==========================================================================
 //
 // FileReader
@@ -369,6 +450,19 @@ bool FileReader::OpenFile(const char *filename, FileReader::Size start, FileRead
 	return true;
 }
 
+bool FileReader::OpenFileMapped(const char *filename)
+{
+	auto reader = new MappedFileReader;
+	if (!reader->Open(filename))
+	{
+		delete reader;
+		return OpenFile(filename);
+	}
+	Close();
+	mReader = reader;
+	return true;
+}
+
 bool FileReader::OpenFilePart(FileReader &parent, FileReader::Size start, FileReader::Size length)
 {
 	auto reader = new FileReaderRedirect(parent, (long)start, (long)length);
@@ -172,6 +172,7 @@ public:
 	}
 
 	bool OpenFile(const char *filename, Size start = 0, Size length = -1);
+	bool OpenFileMapped(const char *filename);	// maps the entire file into memory if possible, otherwise same as OpenFile
 	bool OpenFilePart(FileReader &parent, Size start, Size length);
 	bool OpenMemory(const void *mem, Size length);	// read directly from the buffer
 	bool OpenMemoryArray(const void *mem, Size length);	// read from a copy of the buffer.
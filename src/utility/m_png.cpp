@@ -36,9 +36,15 @@
 
 #include <stdlib.h>
 #include <zlib.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 #ifdef _MSC_VER
 #include <malloc.h>		// for alloca()
 #endif
+#ifndef NO_SSE
+#include <emmintrin.h>
+#endif
 
 #include "m_crc32.h"
 #include "m_swap.h"
@@ -52,11 +58,6 @@
 // size of the compression buffer it allocates on the stack.
 #define PNG_WRITE_SIZE	32768
 
-// Set this to 1 to use a simple heuristic to select the filter to apply
-// for each row of RGB image saves. As it turns out, it seems no filtering
-// is the best for Doom screenshots, no matter what the heuristic might
-// determine, so that's why this is 0 here.
-#define USE_FILTER_HEURISTIC 0
 
 // TYPES -------------------------------------------------------------------
 
@@ -108,6 +109,7 @@ CUSTOM_CVAR(Int, png_level, 5, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 		self = 9;
 }
 CVAR(Float, png_gamma, 0.f, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR(Bool, png_filter, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// pick a PNG row filter per row of true color images
 
 // PRIVATE DATA DEFINITIONS ------------------------------------------------
 
@@ -755,14 +757,14 @@ uint32_t CalcSum(Byte *row, int len)
 //    outputs. (Consider the output bytes as signed differences for this
 //    test.)
 //
+// For paletted software renders no filtering tends to give the smallest
+// files, which is why this is off unless png_filter is set. Hardware
+// rendered true color screenshots usually compress better with it.
+//
 //==========================================================================
 
-#if USE_FILTER_HEURISTIC
 static int SelectFilter(Byte **row, Byte *prior, int width)
 {
-	// As it turns out, it seems no filtering is the best for Doom screenshots,
-	// no matter what the heuristic might determine.
-	return 0;
 	uint32_t sum;
 	uint32_t bestsum;
 	int bestfilter;
@@ -827,7 +829,7 @@ static int SelectFilter(Byte **row, Byte *prior, int width)
 	for (x = 4; x <= width; ++x)
 	{
 		row[3][x] = row[0][x] - (row[0][x - 3] + prior[x - 1]) / 2;
-		sum += (char)row[3][x];
+		sum += abs((char)row[3][x]);
 		if (sum >= bestsum)
 		{ // This isn't going to be any better.
 			break;
@@ -865,7 +867,7 @@ static int SelectFilter(Byte **row, Byte *prior, int width)
 		{
 			row[4][x] = row[0][x] - c;
 		}
-		sum += (char)row[4][x];
+		sum += abs((char)row[4][x]);
 		if (sum >= bestsum)
 		{ // This isn't going to be any better.
 			break;
@@ -878,49 +880,124 @@ static int SelectFilter(Byte **row, Byte *prior, int width)
 
 	return bestfilter;
 }
-#else
-#define SelectFilter(x,y,z)		0
-#endif
 
 //==========================================================================
 //
-// M_SaveBitmap
+// DeflateStrip
 //
-// Given a bitmap, creates one or more IDAT chunks in the given file.
-// Returns true on success.
+// Compresses one piece of an image as raw deflate data that can be
+// concatenated with the pieces following it. Everything but the last
+// piece ends on a byte boundary without ending the stream.
 //
 //==========================================================================
 
-bool M_SaveBitmap(const uint8_t *from, ESSType color_type, int width, int height, int pitch, FileWriter *file)
+struct FDeflateStrip
 {
-	TArray<Byte> temprow_storage;
+	const Byte *In;
+	size_t InSize;
+	bool Last;
+	int Level;
+	std::vector<Byte> Out;
+	uLong Adler;
+	bool Ok;
+};
 
-#if USE_FILTER_HEURISTIC
-	static const unsigned temprow_count = 5;
+static void DeflateStrip(FDeflateStrip *strip)
+{
+	z_stream stream;
 
-	TArray<Byte> prior_storage(width * 3, true);
-	Byte *prior = &prior_storage[0];
-#else
-	static const unsigned temprow_count = 1;
-#endif
+	strip->Adler = adler32(adler32(0, Z_NULL, 0), strip->In, (uInt)strip->InSize);
+	strip->Ok = false;
 
-	const unsigned temprow_size = 1 + width * 3;
-	temprow_storage.Resize(temprow_size * temprow_count);
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	if (deflateInit2(&stream, strip->Level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		return;
+	}
+	// The sync flush adds an empty stored block on top of what deflateBound accounts for.
+	strip->Out.resize(deflateBound(&stream, (uLong)strip->InSize) + 16);
+	stream.next_in = (Bytef *)strip->In;
+	stream.avail_in = (uInt)strip->InSize;
+	stream.next_out = strip->Out.data();
+	stream.avail_out = (uInt)strip->Out.size();
+
+	int err = deflate(&stream, strip->Last ? Z_FINISH : Z_SYNC_FLUSH);
+	strip->Ok = strip->Last ? err == Z_STREAM_END : (err == Z_OK && stream.avail_out > 0);
+	strip->Out.resize(stream.total_out);
+	deflateEnd(&stream);
+}
 
-	Byte* temprow[temprow_count];
+//==========================================================================
+//
+// WriteImageData
+//
+// Compresses filtered image data into a series of IDAT chunks. Large
+// images are split into strips that get deflated in parallel and then
+// joined into one zlib stream, the way pigz does it. Each strip starts
+// without a dictionary, which costs a little compression.
+//
+//==========================================================================
 
-	for (unsigned i = 0; i < temprow_count; ++i)
+static bool WriteImageData(FileWriter *file, const Byte *data, size_t size)
+{
+	const size_t minstrip = 256 * 1024;
+	unsigned numstrips = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), size / minstrip);
+
+	if (numstrips > 1)
 	{
-		temprow[i] = &temprow_storage[temprow_size * i];
+		std::vector<FDeflateStrip> strips(numstrips);
+		std::vector<std::thread> threads;
+		size_t stripsize = size / numstrips;
+
+		for (unsigned i = 0; i < numstrips; i++)
+		{
+			strips[i].In = data + i * stripsize;
+			strips[i].InSize = i == numstrips - 1 ? size - i * stripsize : stripsize;
+			strips[i].Last = i == numstrips - 1;
+			strips[i].Level = png_level;
+		}
+		for (unsigned i = 1; i < numstrips; i++)
+		{
+			threads.emplace_back(DeflateStrip, &strips[i]);
+		}
+		DeflateStrip(&strips[0]);
+		for (auto &t : threads)
+		{
+			t.join();
+		}
+
+		std::vector<Byte> zdata = { 0x78, 0x9c };	// zlib header: deflate, 32k window
+		uLong adler = strips[0].Adler;
+		for (unsigned i = 0; i < numstrips; i++)
+		{
+			if (!strips[i].Ok)
+			{
+				return false;
+			}
+			if (i > 0) adler = adler32_combine(adler, strips[i].Adler, (z_off_t)strips[i].InSize);
+			zdata.insert(zdata.end(), strips[i].Out.begin(), strips[i].Out.end());
+		}
+		uint32_t badler = BigLong((uint32_t)adler);
+		zdata.insert(zdata.end(), (Byte *)&badler, (Byte *)&badler + 4);
+
+		for (size_t pos = 0; pos < zdata.size(); pos += PNG_WRITE_SIZE)
+		{
+			if (!WriteIDAT(file, &zdata[pos], (int)std::min<size_t>(PNG_WRITE_SIZE, zdata.size() - pos)))
+			{
+				return false;
+			}
+		}
+		return true;
 	}
 
 	Byte buffer[PNG_WRITE_SIZE];
 	z_stream stream;
 	int err;
-	int y;
 
-	stream.next_in = Z_NULL;
-	stream.avail_in = 0;
+	stream.next_in = (Bytef *)data;
+	stream.avail_in = (uInt)size;
 	stream.zalloc = Z_NULL;
 	stream.zfree = Z_NULL;
 	err = deflateInit (&stream, png_level);
@@ -930,40 +1007,71 @@ bool M_SaveBitmap(const uint8_t *from, ESSType color_type, int width, int height
 		return false;
 	}
 
-	y = height;
-	stream.next_out = buffer;
-	stream.avail_out = sizeof(buffer);
+	do
+	{
+		stream.next_out = buffer;
+		stream.avail_out = sizeof(buffer);
+		err = deflate (&stream, Z_FINISH);
+		if (err != Z_OK && err != Z_STREAM_END)
+		{
+			break;
+		}
+		if (sizeof(buffer) - stream.avail_out > 0 && !WriteIDAT (file, buffer, int(sizeof(buffer) - stream.avail_out)))
+		{
+			deflateEnd (&stream);
+			return false;
+		}
+	} while (err == Z_OK);
+
+	deflateEnd (&stream);
+	return err == Z_STREAM_END;
+}
 
-	temprow[0][0] = 0;
-#if USE_FILTER_HEURISTIC
-	temprow[1][0] = 1;
-	temprow[2][0] = 2;
-	temprow[3][0] = 3;
-	temprow[4][0] = 4;
+//==========================================================================
+//
+// M_SaveBitmap
+//
+// Given a bitmap, creates one or more IDAT chunks in the given file.
+// Returns true on success.
+//
+//==========================================================================
 
-	// Fill the prior row with 0 for RGB images. Paletted is always filter 0,
-	// so it doesn't need this.
-	if (color_type != SS_PAL)
+bool M_SaveBitmap(const uint8_t *from, ESSType color_type, int width, int height, int pitch, FileWriter *file)
+{
+	static const unsigned temprow_count = 5;
+	const unsigned temprow_size = 1 + width * 3;
+	const unsigned outrow_size = color_type == SS_PAL ? 1 + width : temprow_size;
+	const bool filter = png_filter && color_type != SS_PAL;
+
+	TArray<Byte> temprow_storage(temprow_size * temprow_count, true);
+	TArray<Byte> prior_storage(width * 3, true);
+	TArray<Byte> image(outrow_size * height, true);
+	Byte *prior = &prior_storage[0];
+	Byte* temprow[temprow_count];
+
+	for (unsigned i = 0; i < temprow_count; ++i)
 	{
-		memset(prior, 0, width * 3);
+		temprow[i] = &temprow_storage[temprow_size * i];
+		temprow[i][0] = i;
 	}
-#endif
 
-	while (y-- > 0 && err == Z_OK)
+	// Fill the prior row with 0 for RGB images. Paletted is always filter 0,
+	// so it doesn't need this.
+	memset(prior, 0, width * 3);
+
+	for (int y = 0; y < height; y++, from += pitch)
 	{
+		Byte *row = temprow[0];
+
 		switch (color_type)
 		{
 		case SS_PAL:
-			memcpy(&temprow[0][1], from, width);
 			// always use filter type 0 for paletted images
-			stream.next_in = temprow[0];
-			stream.avail_in = width + 1;
+			memcpy(&temprow[0][1], from, width);
 			break;
 
 		case SS_RGB:
 			memcpy(&temprow[0][1], from, width*3);
-			stream.next_in = temprow[SelectFilter(temprow, prior, width)];
-			stream.avail_in = width * 3 + 1;
 			break;
 
 		case SS_BGRA:
@@ -973,69 +1081,18 @@ bool M_SaveBitmap(const uint8_t *from, ESSType color_type, int width, int height
 				temprow[0][x*3 + 2] = from[x*4 + 1];
 				temprow[0][x*3 + 3] = from[x*4];
 			}
-			stream.next_in = temprow[SelectFilter(temprow, prior, width)];
-			stream.avail_in = width * 3 + 1;
 			break;
 		}
-#if USE_FILTER_HEURISTIC
-		if (color_type != SS_PAL)
+		if (filter)
 		{
+			row = temprow[SelectFilter(temprow, prior, width)];
 			// Save this row for filter calculations on the next row.
-			memcpy (prior, &temprow[0][1], stream.avail_in - 1);
-		}
-#endif
-
-		from += pitch;
-
-		err = deflate (&stream, (y == 0) ? Z_FINISH : 0);
-		if (err != Z_OK)
-		{
-			break;
-		}
-		while (stream.avail_out == 0)
-		{
-			if (!WriteIDAT (file, buffer, sizeof(buffer)))
-			{
-				return false;
-			}
-			stream.next_out = buffer;
-			stream.avail_out = sizeof(buffer);
-			if (stream.avail_in != 0)
-			{
-				err = deflate (&stream, (y == 0) ? Z_FINISH : 0);
-				if (err != Z_OK)
-				{
-					break;
-				}
-			}
-		}
-	}
-
-	while (err == Z_OK)
-	{
-		err = deflate (&stream, Z_FINISH);
-		if (err != Z_OK)
-		{
-			break;
-		}
-		if (stream.avail_out == 0)
-		{
-			if (!WriteIDAT (file, buffer, sizeof(buffer)))
-			{
-				return false;
-			}
-			stream.next_out = buffer;
-			stream.avail_out = sizeof(buffer);
+			memcpy (prior, &temprow[0][1], width * 3);
 		}
+		memcpy(&image[outrow_size * y], row, outrow_size);
 	}
 
-	deflateEnd (&stream);
-
-	if (err != Z_STREAM_END)
-	{
-		return false;
-	}
-	return WriteIDAT (file, buffer, sizeof(buffer)-stream.avail_out);
+	return WriteImageData(file, image.Data(), image.Size());
 }
 
 //==========================================================================
@@ -1064,6 +1121,62 @@ static bool WriteIDAT (FileWriter *file, const uint8_t *data, int len)
 	return true;
 }
 
+//==========================================================================
+//
+// UnfilterPaethSSE2
+//
+// Paeth unfiltering for 3 and 4 byte pixels, one whole pixel at a time.
+// The predictor is computed in 16 bit lanes. For the first pixel a and c
+// are 0, which makes the predictor pick b, the same as the scalar path.
+//
+//==========================================================================
+
+#ifndef NO_SSE
+static inline __m128i LoadPixel(const uint8_t *p, int bpp)
+{
+	uint32_t v = 0;
+	memcpy(&v, p, bpp);
+	return _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), _mm_setzero_si128());
+}
+
+static inline __m128i Abs16(__m128i v)
+{
+	return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+}
+
+static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void UnfilterPaethSSE2(int width, uint8_t *dest, const uint8_t *row, const uint8_t *prev, int bpp)
+{
+	__m128i a = _mm_setzero_si128();
+	__m128i c = _mm_setzero_si128();
+
+	for (int x = 0; x < width; x += bpp)
+	{
+		__m128i b = LoadPixel(prev + x, bpp);
+		__m128i d = LoadPixel(row + x, bpp);
+
+		__m128i pa = _mm_sub_epi16(b, c);
+		__m128i pb = _mm_sub_epi16(a, c);
+		__m128i pc = Abs16(_mm_add_epi16(pa, pb));
+		pa = Abs16(pa);
+		pb = Abs16(pb);
+
+		__m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+		__m128i nearest = Select(_mm_cmpeq_epi16(smallest, pa), a, Select(_mm_cmpeq_epi16(smallest, pb), b, c));
+
+		// The sum only needs to wrap around in 8 bits.
+		a = _mm_and_si128(_mm_add_epi16(nearest, d), _mm_set1_epi16(0xff));
+		uint32_t v = _mm_cvtsi128_si32(_mm_packus_epi16(a, a));
+		memcpy(dest + x, &v, bpp);
+		c = b;
+	}
+}
+#endif
+
 //==========================================================================
 //
 // UnfilterRow
@@ -1118,6 +1231,13 @@ void UnfilterRow (int width, uint8_t *dest, uint8_t *row, uint8_t *prev, int bpp
 		break;
 
 	case 4:		// Paeth
+#ifndef NO_SSE
+		if (bpp == 3 || bpp == 4)
+		{
+			UnfilterPaethSSE2(width, dest, row, prev, bpp);
+			break;
+		}
+#endif
 		x = bpp;
 		do
 		{
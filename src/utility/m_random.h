@@ -90,6 +90,7 @@ public:
 
 	// SFMT interface
 	unsigned int GenRand32();
+	void GenRand32(uint32_t *out, int count);
 	uint64_t GenRand64();
 	void FillArray32(uint32_t *array, int size);
 	void FillArray64(uint64_t *array, int size);
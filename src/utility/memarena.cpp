@@ -41,6 +41,8 @@
 #include "memarena.h"
 #include "c_dispatch.h"
 
+FMemArena *FMemArena::FirstArena;
+
 struct FMemArena::Block
 {
 	Block *NextBlock;
@@ -71,11 +73,18 @@ static inline void *RoundPointer(void *ptr)
 //
 //==========================================================================
 
-FMemArena::FMemArena(size_t blocksize)
+FMemArena::FMemArena(size_t blocksize, const char *name)
 {
 	TopBlock = NULL;
 	FreeBlocks = NULL;
 	BlockSize = blocksize;
+	Name = name;
+	NextArena = NULL;
+	if (name != NULL)
+	{
+		NextArena = FirstArena;
+		FirstArena = this;
+	}
 }
 
 //==========================================================================
@@ -87,6 +96,17 @@ FMemArena::FMemArena(size_t blocksize)
 FMemArena::~FMemArena()
 {
 	FreeAllBlocks();
+	if (Name != NULL)
+	{
+		for (FMemArena **prev = &FirstArena; *prev != NULL; prev = &(*prev)->NextArena)
+		{
+			if (*prev == this)
+			{
+				*prev = NextArena;
+				break;
+			}
+		}
+	}
 }
 
 //==========================================================================
@@ -116,6 +136,26 @@ void *FMemArena::Alloc(size_t size)
 	return iAlloc((size + 15) & ~15);
 }
 
+//==========================================================================
+//
+// FMemArena :: Alloc with alignment
+//
+// Regular allocations are already 16 byte aligned. For anything larger
+// enough extra space is taken to move the result up to the boundary.
+//
+//==========================================================================
+
+void *FMemArena::Alloc(size_t size, size_t align)
+{
+	assert((align & (align - 1)) == 0);
+	if (align <= 16)
+	{
+		return Alloc(size);
+	}
+	char *mem = (char *)Alloc(size + align - 16);
+	return (void *)(((size_t)mem + align - 1) & ~(align - 1));
+}
+
 //==========================================================================
 //
 // FMemArena :: FreeAll
@@ -158,16 +198,52 @@ void FMemArena::FreeAllBlocks()
 //
 //==========================================================================
 
-void FMemArena::DumpInfo()
+void FMemArena::GetUsage(size_t &allocated, size_t &used, size_t &freeblocks) const
 {
-	size_t allocated = 0;
-	size_t used = 0;
+	allocated = used = freeblocks = 0;
 	for (auto block = TopBlock; block != NULL; block = block->NextBlock)
 	{
-		allocated += BlockSize;
-		used += BlockSize - ((char*)block->Limit - (char*)block->Avail);
+		// Oversized allocations get blocks larger than BlockSize.
+		allocated += (char*)block->Limit - (char*)block;
+		used += (char*)block->Avail - (char*)block;
 	}
-	Printf("%zu bytes allocated, %zu bytes in use\n", allocated, used);
+	for (auto block = FreeBlocks; block != NULL; block = block->NextBlock)
+	{
+		freeblocks += (char*)block->Limit - (char*)block;
+	}
+}
+
+void FMemArena::DumpInfo()
+{
+	size_t allocated, used, freeblocks;
+	GetUsage(allocated, used, freeblocks);
+	Printf("%zu bytes allocated, %zu bytes in use, %zu bytes in free blocks\n", allocated, used, freeblocks);
+}
+
+//==========================================================================
+//
+// FMemArena :: DumpAllArenas
+//
+// Prints the memory use of every named arena.
+//
+//==========================================================================
+
+void FMemArena::DumpAllArenas()
+{
+	size_t total = 0;
+	for (auto arena = FirstArena; arena != NULL; arena = arena->NextArena)
+	{
+		size_t allocated, used, freeblocks;
+		arena->GetUsage(allocated, used, freeblocks);
+		Printf("%-16s %10zu allocated %10zu used %10zu free\n", arena->Name, allocated, used, freeblocks);
+		total += allocated + freeblocks;
+	}
+	Printf("%zu bytes total\n", total);
+}
+
+CCMD(arenas)
+{
+	FMemArena::DumpAllArenas();
 }
 
 //==========================================================================
@@ -182,7 +258,7 @@ void FMemArena::DumpData(FILE *f)
 {
 	for (auto block = TopBlock; block != NULL; block = block->NextBlock)
 	{
-		auto used = BlockSize - ((char*)block->Limit - (char*)block->Avail);
+		auto used = (char*)block->Avail - (char*)block;
 		fwrite(block, 1, used, f);
 	}
 }
@@ -36,19 +36,24 @@
 
 #include "zstring.h"
 
-// A general purpose arena.
+// A general purpose arena. Arenas that are given a name are listed with
+// their memory use by the 'arenas' console command.
 class FMemArena
 {
 public:
-	FMemArena(size_t blocksize = 10*1024);
+	FMemArena(size_t blocksize = 10*1024, const char *name = nullptr);
 	~FMemArena();
 
 	void *Alloc(size_t size);
+	void *Alloc(size_t size, size_t align);
 	void FreeAll();
 	void FreeAllBlocks();
+	void GetUsage(size_t &allocated, size_t &used, size_t &freeblocks) const;
 	void DumpInfo();
 	void DumpData(FILE *f);
 
+	static void DumpAllArenas();
+
 protected:
 	struct Block;
 
@@ -59,6 +64,10 @@ protected:
 	Block *TopBlock;
 	Block *FreeBlocks;
 	size_t BlockSize;
+	const char *Name;
+	FMemArena *NextArena;
+
+	static FMemArena *FirstArena;
 };
 
 // An arena specializing in storage of FStrings. It knows how to free them,
@@ -36,6 +36,7 @@
 #include "name.h"
 #include "c_dispatch.h"
 #include "c_console.h"
+#include "stats.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -101,17 +102,17 @@ int FName::NameManager::FindName (const char *text, bool noCreate)
 	}
 
 	unsigned int hash = MakeKey (text);
-	unsigned int bucket = hash % HASH_SIZE;
-	int scanner = Buckets[bucket];
+	unsigned int slot = hash & SlotMask;
+	int scanner;
 
 	// See if the name already exists.
-	while (scanner >= 0)
+	while ((scanner = Slots[slot]) >= 0)
 	{
 		if (NameArray[scanner].Hash == hash && stricmp (NameArray[scanner].Text, text) == 0)
 		{
 			return scanner;
 		}
-		scanner = NameArray[scanner].NextHash;
+		slot = (slot + 1) & SlotMask;
 	}
 
 	// If we get here, then the name does not exist.
@@ -120,7 +121,7 @@ int FName::NameManager::FindName (const char *text, bool noCreate)
 		return 0;
 	}
 
-	return AddName (text, hash, bucket);
+	return AddName (text, hash, slot);
 }
 
 //==========================================================================
@@ -143,11 +144,11 @@ int FName::NameManager::FindName (const char *text, size_t textLen, bool noCreat
 	}
 
 	unsigned int hash = MakeKey (text, textLen);
-	unsigned int bucket = hash % HASH_SIZE;
-	int scanner = Buckets[bucket];
+	unsigned int slot = hash & SlotMask;
+	int scanner;
 
 	// See if the name already exists.
-	while (scanner >= 0)
+	while ((scanner = Slots[slot]) >= 0)
 	{
 		if (NameArray[scanner].Hash == hash &&
 			strnicmp (NameArray[scanner].Text, text, textLen) == 0 &&
@@ -155,7 +156,7 @@ int FName::NameManager::FindName (const char *text, size_t textLen, bool noCreat
 		{
 			return scanner;
 		}
-		scanner = NameArray[scanner].NextHash;
+		slot = (slot + 1) & SlotMask;
 	}
 
 	// If we get here, then the name does not exist.
@@ -164,7 +165,7 @@ int FName::NameManager::FindName (const char *text, size_t textLen, bool noCreat
 		return 0;
 	}
 
-	return AddName (text, hash, bucket);
+	return AddName (text, hash, slot);
 }
 
 //==========================================================================
@@ -178,7 +179,9 @@ int FName::NameManager::FindName (const char *text, size_t textLen, bool noCreat
 void FName::NameManager::InitBuckets ()
 {
 	Inited = true;
-	memset (Buckets, -1, sizeof(Buckets));
+	SlotMask = MIN_SLOTS - 1;
+	Slots = (int *)M_Malloc (MIN_SLOTS * sizeof(int));
+	memset (Slots, -1, MIN_SLOTS * sizeof(int));
 
 	// Register built-in names. 'None' must be name 0.
 	for (size_t i = 0; i < countof(PredefinedNames); ++i)
@@ -196,7 +199,7 @@ void FName::NameManager::InitBuckets ()
 //
 //==========================================================================
 
-int FName::NameManager::AddName (const char *text, unsigned int hash, unsigned int bucket)
+int FName::NameManager::AddName (const char *text, unsigned int hash, unsigned int slot)
 {
 	char *textstore;
 	NameBlock *block = Blocks;
@@ -226,12 +229,47 @@ int FName::NameManager::AddName (const char *text, unsigned int hash, unsigned i
 
 	NameArray[NumNames].Text = textstore;
 	NameArray[NumNames].Hash = hash;
-	NameArray[NumNames].NextHash = Buckets[bucket];
-	Buckets[bucket] = NumNames;
+	Slots[slot] = NumNames;
 
+	if (unsigned(NumNames + 1) * 2 > SlotMask)
+	{
+		GrowSlots ();
+	}
 	return NumNames++;
 }
 
+//==========================================================================
+//
+// FName :: NameManager :: GrowSlots
+//
+// Doubles the size of the hash table. Names store their full hash so
+// nothing needs to be rehashed from the text.
+//
+//==========================================================================
+
+void FName::NameManager::GrowSlots ()
+{
+	unsigned int newmask = SlotMask * 2 + 1;
+	int *newslots = (int *)M_Malloc ((newmask + 1) * sizeof(int));
+	memset (newslots, -1, (newmask + 1) * sizeof(int));
+
+	for (unsigned int i = 0; i <= SlotMask; ++i)
+	{
+		if (Slots[i] >= 0)
+		{
+			unsigned int slot = NameArray[Slots[i]].Hash & newmask;
+			while (newslots[slot] >= 0)
+			{
+				slot = (slot + 1) & newmask;
+			}
+			newslots[slot] = Slots[i];
+		}
+	}
+	M_Free (Slots);
+	Slots = newslots;
+	SlotMask = newmask;
+}
+
 //==========================================================================
 //
 // FName :: NameManager :: AddBlock
@@ -283,6 +321,44 @@ FName::NameManager::~NameManager()
 		M_Free (NameArray);
 		NameArray = NULL;
 	}
+	if (Slots != NULL)
+	{
+		M_Free (Slots);
+		Slots = NULL;
+	}
 	NumNames = MaxNames = 0;
-	memset (Buckets, -1, sizeof(Buckets));
+	SlotMask = 0;
+	Inited = false;
+}
+
+//==========================================================================
+//
+// FName :: GetHashStats
+//
+//==========================================================================
+
+FString FName::GetHashStats ()
+{
+	const NameManager &nm = NameData;
+	unsigned int maxprobe = 0, totalprobe = 0, used = 0;
+
+	for (unsigned int i = 0; nm.Slots != NULL && i <= nm.SlotMask; ++i)
+	{
+		if (nm.Slots[i] >= 0)
+		{
+			unsigned int probe = (i - nm.NameArray[nm.Slots[i]].Hash) & nm.SlotMask;
+			totalprobe += probe;
+			if (probe > maxprobe) maxprobe = probe;
+			used++;
+		}
+	}
+	FString out;
+	out.Format("%d names, %u slots, avg probe %.2f, max probe %u",
+		nm.NumNames, nm.Slots != NULL ? nm.SlotMask + 1 : 0, used > 0 ? double(totalprobe) / used : 0., maxprobe);
+	return out;
+}
+
+ADD_STAT(names)
+{
+	return FName::GetHashStats ();
 }
@@ -68,6 +68,9 @@ public:
 
 	int SetName (const char *text, bool noCreate=false) { return Index = NameData.FindName (text, noCreate); }
 
+	// Summary of the name table's size and probe lengths for the stat display.
+	static FString GetHashStats ();
+
 	bool IsValidName() const { return (unsigned)Index < (unsigned)NameData.NumNames; }
 
 	// Note that the comparison operators compare the names' indices, not
@@ -93,7 +96,6 @@ protected:
 	{
 		char *Text;
 		unsigned int Hash;
-		int NextHash;
 	};
 
 	struct NameManager
@@ -103,19 +105,25 @@ protected:
 		// means this struct must only exist in the program's BSS section.
 		~NameManager();
 
-		enum { HASH_SIZE = 1024 };
+		enum { MIN_SLOTS = 4096 };
 		struct NameBlock;
 
 		NameBlock *Blocks;
 		NameEntry *NameArray;
 		int NumNames, MaxNames;
-		int Buckets[HASH_SIZE];
+
+		// Open addressed hash table of indices into NameArray, -1 for an
+		// empty slot. The size is always a power of 2 and it gets doubled
+		// before it becomes half full.
+		int *Slots;
+		unsigned int SlotMask;
 
 		int FindName (const char *text, bool noCreate);
 		int FindName (const char *text, size_t textlen, bool noCreate);
-		int AddName (const char *text, unsigned int hash, unsigned int bucket);
+		int AddName (const char *text, unsigned int hash, unsigned int slot);
 		NameBlock *AddBlock (size_t len);
 		void InitBuckets ();
+		void GrowSlots ();
 		static bool Inited;
 	};
 
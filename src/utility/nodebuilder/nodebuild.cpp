@@ -40,6 +40,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <thread>
 
 #include "doomdata.h"
 #include "nodebuild.h"
@@ -48,6 +49,11 @@ const int MaxSegs = 64;
 const int SplitCost = 8;
 const int AAPreference = 16;
 
+// Splitter selection is spread across threads when there are at least
+// this many seg classifications to do.
+const uint64_t ParallelSplitterWork = 1 << 20;
+const unsigned int MaxSplitterThreads = 8;
+
 #if 0
 #define D(x) x
 #else
@@ -445,6 +451,7 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 	uint32_t bestseg;
 	uint32_t seg;
 	bool nosplitters = false;
+	unsigned int numsegs = 0;
 
 	bestvalue = 0;
 	bestseg = UINT_MAX;
@@ -456,6 +463,9 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 
 	D(Printf (PRINT_LOG, "Processing set %d\n", set));
 
+	// Which segs get tried as splitters does not depend on the scores
+	// of the ones before them, so collect them all first.
+	SplitterCandidates.Clear();
 	while (seg != UINT_MAX)
 	{
 		FPrivSeg *pseg = &Segs[seg];
@@ -473,28 +483,36 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 				}
 
 				stepleft = step;
-				SetNodeFromSeg (node, pseg);
-
-				int value = Heuristic (node, set, nosplit);
-
-				D(Printf (PRINT_LOG, "Seg %5d, ld %d (%5d,%5d)-(%5d,%5d) scores %d\n", seg, Segs[seg].linedef, node.x>>16, node.y>>16,
-					(node.x+node.dx)>>16, (node.y+node.dy)>>16, value));
-
-				if (value > bestvalue)
-				{
-					bestvalue = value;
-					bestseg = seg;
-				}
-				else if (value < 0)
-				{
-					nosplitters = true;
-				}
+				SplitterCandidates.Push (seg);
 			}
 		}
 
+		numsegs++;
 		seg = pseg->next;
 	}
 
+	ScoreSplitters (set, nosplit, numsegs);
+
+	for (unsigned int i = 0; i < SplitterCandidates.Size(); ++i)
+	{
+		int value = SplitterScores[i];
+
+		seg = SplitterCandidates[i];
+		D(SetNodeFromSeg (node, &Segs[seg]));
+		D(Printf (PRINT_LOG, "Seg %5d, ld %d (%5d,%5d)-(%5d,%5d) scores %d\n", seg, Segs[seg].linedef, node.x>>16, node.y>>16,
+			(node.x+node.dx)>>16, (node.y+node.dy)>>16, value));
+
+		if (value > bestvalue)
+		{
+			bestvalue = value;
+			bestseg = seg;
+		}
+		else if (value < 0)
+		{
+			nosplitters = true;
+		}
+	}
+
 	if (bestseg == UINT_MAX)
 	{ // No lines split any others into two sets, so this is a convex region.
 	D(Printf (PRINT_LOG, "set %d, step %d, nosplit %d has no good splitter (%d)\n", set, step, nosplit, nosplitters));
@@ -508,13 +526,74 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 	return 1;
 }
 
+// Fills SplitterScores with the Heuristic value of every seg in
+// SplitterCandidates. Nothing is modified while scoring, so for big sets
+// the candidates are split into even ranges for a few threads, each with
+// its own scratch lists. The scores are the same as in a serial run.
+// Heuristic adds at most one entry per seg in the set to each scratch list,
+// so they are all sized up front. Growing them on the threads would go
+// through M_Realloc, whose bookkeeping is not thread safe.
+
+void FNodeBuilder::ScoreSplitters (uint32_t set, bool nosplit, unsigned int numsegs)
+{
+	unsigned int count = SplitterCandidates.Size();
+	unsigned int numthreads = 1;
+
+	SplitterScores.Resize (count);
+
+	if (uint64_t(count) * numsegs >= ParallelSplitterWork)
+	{
+		numthreads = MAX (1u, MIN (std::thread::hardware_concurrency(), MaxSplitterThreads));
+		numthreads = MIN (numthreads, count);
+	}
+
+	auto score = [this, set, nosplit](unsigned int first, unsigned int last, TArray<int> *touched, TArray<int> *colinear)
+	{
+		node_t node;
+
+		for (unsigned int i = first; i < last; ++i)
+		{
+			SetNodeFromSeg (node, &Segs[SplitterCandidates[i]]);
+			SplitterScores[i] = Heuristic (node, set, nosplit, *touched, *colinear);
+		}
+	};
+
+	if (numthreads <= 1)
+	{
+		score (0, count, &Touched, &Colinear);
+		return;
+	}
+
+	std::thread threads[MaxSplitterThreads];
+	TArray<int> scratch[MaxSplitterThreads][2];
+	unsigned int per = (count + numthreads - 1) / numthreads;
+
+	Touched.Grow (numsegs);
+	Colinear.Grow (numsegs);
+	for (unsigned int t = 1; t < numthreads; ++t)
+	{
+		scratch[t][0].Grow (numsegs);
+		scratch[t][1].Grow (numsegs);
+	}
+
+	for (unsigned int t = 1; t < numthreads; ++t)
+	{
+		threads[t] = std::thread (score, MIN (count, t * per), MIN (count, (t + 1) * per), &scratch[t][0], &scratch[t][1]);
+	}
+	score (0, per, &Touched, &Colinear);
+	for (unsigned int t = 1; t < numthreads; ++t)
+	{
+		threads[t].join ();
+	}
+}
+
 // Given a splitter (node), returns a score based on how "good" the resulting
 // split in a set of segs is. Higher scores are better. -1 means this splitter
 // splits something it shouldn't and will only be returned if honorNoSplit is
 // true. A score of 0 means that the splitter does not split any of the segs
 // in the set.
 
-int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
+int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit, TArray<int> &touched, TArray<int> &colinear)
 {
 	// Set the initial score above 0 so that near vertex anti-weighting is less likely to produce a negative score.
 	int score = 1000000;
@@ -529,8 +608,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 	unsigned int max, m2, p, q;
 	double frac;
 
-	Touched.Clear ();
-	Colinear.Clear ();
+	touched.Clear ();
+	colinear.Clear ();
 
 	while (i != UINT_MAX)
 	{
@@ -556,32 +635,32 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 			{
 				if ((sidev[0] | sidev[1]) != 0)
 				{
-					max = Touched.Size();
+					max = touched.Size();
 					for (p = 0; p < max; ++p)
 					{
-						if (Touched[p] == test->loopnum)
+						if (touched[p] == test->loopnum)
 						{
 							break;
 						}
 					}
 					if (p == max)
 					{
-						Touched.Push (test->loopnum);
+						touched.Push (test->loopnum);
 					}
 				}
 				else
 				{
-					max = Colinear.Size();
+					max = colinear.Size();
 					for (p = 0; p < max; ++p)
 					{
-						if (Colinear[p] == test->loopnum)
+						if (colinear[p] == test->loopnum)
 						{
 							break;
 						}
 					}
 					if (p == max)
 					{
-						Colinear.Push (test->loopnum);
+						colinear.Push (test->loopnum);
 					}
 				}
 			}
@@ -698,8 +777,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 	// seg of that sector must be crossing the container's corner and does not
 	// actually split the container.
 
-	max = Touched.Size ();
-	m2 = Colinear.Size ();
+	max = touched.Size ();
+	m2 = colinear.Size ();
 
 	// If honorNoSplit is false, then both these lists will be empty.
 
@@ -712,10 +791,10 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 
 	for (p = 0; p < max; ++p)
 	{
-		int look = Touched[p];
+		int look = touched[p];
 		for (q = 0; q < m2; ++q)
 		{
-			if (look == Colinear[q])
+			if (look == colinear[q])
 			{
 				break;
 			}
@@ -267,6 +267,8 @@ private:
 
 	TArray<int> Touched;	// Loops a splitter touches on a vertex
 	TArray<int> Colinear;	// Loops with edges colinear to a splitter
+	TArray<uint32_t> SplitterCandidates;	// Segs SelectSplitter is trying
+	TArray<int> SplitterScores;				// and the scores they got
 	FEventTree Events;		// Vertices intersected by the current splitter
 
 	TArray<FSplitSharer> SplitSharers;	// Segs colinear with the current splitter
@@ -297,7 +299,12 @@ private:
 	bool ShoveSegBehind (uint32_t set, node_t &node, uint32_t seg, uint32_t mate);	int SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg, int step, bool nosplit);
 	void SplitSegs (uint32_t set, node_t &node, uint32_t splitseg, uint32_t &outset0, uint32_t &outset1, unsigned int &count0, unsigned int &count1);
 	uint32_t SplitSeg (uint32_t segnum, int splitvert, int v1InFront);
-	int Heuristic (node_t &node, uint32_t set, bool honorNoSplit);
+	void ScoreSplitters (uint32_t set, bool nosplit, unsigned int numsegs);
+	int Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
+	{
+		return Heuristic (node, set, honorNoSplit, Touched, Colinear);
+	}
+	int Heuristic (node_t &node, uint32_t set, bool honorNoSplit, TArray<int> &touched, TArray<int> &colinear);
 
 	// Returns:
 	//	0 = seg is in front
@@ -371,6 +371,31 @@ unsigned int FRandom::GenRand32()
 	r = sfmt.u[idx++];
 	return r;
 }
+
+/**
+* Fills out[] with the next count 32-bit numbers. The sequence is the
+* same as calling GenRand32() count times, so it can be mixed freely
+* with the other calls, but whole runs are copied out of the state
+* at once instead of being fetched one by one.
+*/
+void FRandom::GenRand32(uint32_t *out, int count)
+{
+	assert(initialized);
+	while (count > 0)
+	{
+		if (idx >= SFMT::N32)
+		{
+			GenRandAll();
+			idx = 0;
+		}
+		int run = SFMT::N32 - idx;
+		if (run > count) run = count;
+		memcpy(out, &sfmt.u[idx], run * sizeof(uint32_t));
+		idx += run;
+		out += run;
+		count -= run;
+	}
+}
 #endif
 /**
 * This function generates and returns 64-bit pseudorandom number.
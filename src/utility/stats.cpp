@@ -32,11 +32,14 @@
 **
 */
 
+#include <mutex>
 #include "doomtype.h"
 #include "stats.h"
 #include "v_video.h"
 #include "v_text.h"
 #include "c_dispatch.h"
+#include "i_time.h"
+#include "files.h"
 
 FStat *FStat::FirstStat;
 
@@ -139,3 +142,133 @@ CCMD (stat)
 		FStat::ToggleStat (argv[1]);
 	}
 }
+
+//==========================================================================
+//
+// Trace recording
+//
+// Each thread that closes a zone gets its own ring of the most recent
+// events, so the lock on a ring is only contended while it gets dumped.
+// Zones that were opened before recording stopped may still be closing
+// at that time. Rings are never freed, which keeps the events of threads
+// that have already finished around for the dump.
+//
+//==========================================================================
+
+struct FTraceEvent
+{
+	const char *Name;
+	uint64_t Start;
+	uint64_t End;
+};
+
+enum
+{
+	TRACE_RING_SIZE = 1 << 16,
+};
+
+struct FTraceRing
+{
+	std::mutex Lock;
+	FTraceEvent Events[TRACE_RING_SIZE];
+	unsigned Head = 0;
+};
+
+std::atomic<bool> TraceEnabled;
+static uint64_t TraceStartTime;
+static std::mutex TraceRingLock;
+static TArray<FTraceRing *> TraceRings;
+static thread_local FTraceRing *ThreadTraceRing;
+
+uint64_t TraceTime()
+{
+	// Never 0, which FTraceZone uses for "not recording".
+	return I_nsTime() | 1;
+}
+
+void TraceZoneEnd(const char *name, uint64_t start)
+{
+	FTraceRing *ring = ThreadTraceRing;
+	if (ring == nullptr)
+	{
+		ring = ThreadTraceRing = new FTraceRing;
+		std::lock_guard<std::mutex> lock(TraceRingLock);
+		TraceRings.Push(ring);
+	}
+	uint64_t end = TraceTime();
+	std::lock_guard<std::mutex> lock(ring->Lock);
+	FTraceEvent &ev = ring->Events[ring->Head++ & (TRACE_RING_SIZE - 1)];
+	ev.Name = name;
+	ev.Start = start;
+	ev.End = end;
+}
+
+static bool TraceDump(const char *filename)
+{
+	FileWriter *fw = FileWriter::Open(filename);
+	if (fw == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(TraceRingLock);
+	bool first = true;
+	fw->Printf("{\"traceEvents\":[\n");
+	for (unsigned tid = 0; tid < TraceRings.Size(); tid++)
+	{
+		FTraceRing *ring = TraceRings[tid];
+		std::lock_guard<std::mutex> ringlock(ring->Lock);
+		unsigned head = ring->Head;
+		unsigned count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+		for (unsigned i = head - count; i != head; i++)
+		{
+			const FTraceEvent &ev = ring->Events[i & (TRACE_RING_SIZE - 1)];
+			// Rings are not cleared between recordings, so skip anything older.
+			if (ev.Start < TraceStartTime) continue;
+			fw->Printf("%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				first ? "" : ",\n", ev.Name, tid, (ev.Start - TraceStartTime) / 1000., (ev.End - ev.Start) / 1000.);
+			first = false;
+		}
+	}
+	fw->Printf("\n]}\n");
+	delete fw;
+	return true;
+}
+
+CCMD (trace)
+{
+	if (argv.argc() >= 2)
+	{
+		if (stricmp(argv[1], "start") == 0)
+		{
+			TraceStartTime = TraceTime();
+			TraceEnabled = true;
+			Printf("Trace recording started\n");
+			return;
+		}
+		else if (stricmp(argv[1], "stop") == 0)
+		{
+			TraceEnabled = false;
+			Printf("Trace recording stopped\n");
+			return;
+		}
+		else if (stricmp(argv[1], "dump") == 0)
+		{
+			const char *filename = argv.argc() >= 3 ? argv[2] : "trace.json";
+			if (TraceEnabled)
+			{
+				Printf(TEXTCOLOR_ORANGE "Stop recording before dumping the trace.\n");
+			}
+			else if (!TraceDump(filename))
+			{
+				Printf(TEXTCOLOR_RED "Unable to write %s\n", filename);
+			}
+			else
+			{
+				Printf("Trace written to %s\n", filename);
+			}
+			return;
+		}
+	}
+	Printf("Usage: trace <start|stop|dump [filename]>\n");
+}
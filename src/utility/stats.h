@@ -34,6 +34,7 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
+#include <atomic>
 #include "zstring.h"
 
 #if !defined _WIN32 && !defined __APPLE__
@@ -251,6 +252,37 @@ private:
 	static FStat *FirstStat;
 };
 
+// Trace zones --------------------------------------------------------------
+// Scoped timeline markers. While the trace command is recording, every zone
+// that closes is stored in a ring buffer belonging to its thread, and the
+// collected events can be written out in Chrome's trace event format for
+// chrome://tracing, Perfetto and similar viewers. When not recording, a
+// zone costs a single flag check. Names must be string literals.
+
+extern std::atomic<bool> TraceEnabled;
+uint64_t TraceTime();
+void TraceZoneEnd(const char *name, uint64_t start);
+
+class FTraceZone
+{
+public:
+	explicit FTraceZone(const char *name)
+		: Name(name), Start(TraceEnabled.load(std::memory_order_relaxed) ? TraceTime() : 0)
+	{
+	}
+
+	~FTraceZone()
+	{
+		if (Start != 0) TraceZoneEnd(Name, Start);
+	}
+
+	FTraceZone(const FTraceZone&) = delete;
+	FTraceZone& operator=(const FTraceZone&) = delete;
+private:
+	const char *Name;
+	uint64_t Start;
+};
+
 #define ADD_STAT(n) \
 	static class Stat_##n : public FStat { \
 		public: \
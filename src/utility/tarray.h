@@ -54,6 +54,7 @@
 #include <new>
 #include <utility>
 #include <iterator>
+#include <type_traits>
 
 #if !defined(_WIN32)
 #include <inttypes.h>		// for intptr_t
@@ -576,6 +577,82 @@ private:
 	}
 };
 
+// TSmallArray --------------------------------------------------------------
+// A growable array for short lived local lists that usually stay small.
+// The first N elements are stored inside the object itself so that the
+// common case never touches the heap. Elements are relocated with memcpy,
+// so this is only meant for plain data like pointers and indices.
+
+template<class T, unsigned int N>
+class TSmallArray
+{
+	static_assert(std::is_trivially_copyable<T>::value, "TSmallArray can only hold plain data");
+
+public:
+	typedef TIterator<T>                       iterator;
+	typedef TIterator<const T>                 const_iterator;
+	typedef T							value_type;
+
+	TSmallArray() : Array(Inline), Most(N), Count(0) {}
+	TSmallArray(const TSmallArray &) = delete;
+	TSmallArray &operator=(const TSmallArray &) = delete;
+
+	~TSmallArray()
+	{
+		if (Array != Inline) M_Free(Array);
+	}
+
+	iterator begin() { return &Array[0]; }
+	const_iterator begin() const { return &Array[0]; }
+	iterator end() { return &Array[Count]; }
+	const_iterator end() const { return &Array[Count]; }
+
+	T &operator[] (size_t index) const { return Array[index]; }
+	T *Data() const { return Array; }
+	T &Last() const { return Array[Count - 1]; }
+	unsigned int Size() const { return Count; }
+
+	unsigned int Push(const T &item)
+	{
+		if (Count >= Most)
+		{
+			Grow();
+		}
+		Array[Count] = item;
+		return Count++;
+	}
+
+	bool Pop(T &item)
+	{
+		if (Count > 0)
+		{
+			item = Array[--Count];
+			return true;
+		}
+		return false;
+	}
+
+	void Clear()
+	{
+		Count = 0;
+	}
+
+private:
+	T *Array;
+	unsigned int Most;
+	unsigned int Count;
+	T Inline[N];
+
+	void Grow()
+	{
+		Most *= 2;
+		T *newarray = (T *)M_Malloc(sizeof(T) * Most);
+		memcpy(newarray, Array, sizeof(T) * Count);
+		if (Array != Inline) M_Free(Array);
+		Array = newarray;
+	}
+};
+
 // TDeletingArray -----------------------------------------------------------
 // An array that deletes its elements when it gets deleted.
 template<class T, class TT=T>
@@ -773,6 +850,19 @@ template<> struct THashTraits<double>
 	int Compare(double left, double right) { return left != right; }
 };
 
+template<class T> struct THashTraits<T *>
+{
+	// Pointers are aligned, so their low bits are almost always the same and
+	// using them as is would pile every key into a few main positions. Mix
+	// the high bits down before the table masks the hash.
+	hash_t Hash(T *key)
+	{
+		uint64_t v = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull;
+		return (hash_t)(v >> 32);
+	}
+	int Compare(T *left, T *right) { return left != right; }
+};
+
 template<class VT> struct TValueTraits
 {
 	// Initializes a value for TMap. If a regular constructor isn't